@@ -0,0 +1,58 @@
+#include "bench/harness.hpp"
+
+#include "brasstacks/math/Arena.hpp"
+#include "brasstacks/math/VecArray.hpp"
+
+#include <memory>
+
+namespace btx::math::bench {
+
+namespace {
+
+// A bulk chain that needs a temporary array every pass, the way per-frame
+// code does, with the temporary from the heap or from an arena rewound at
+// the end of each pass
+
+// =============================================================================
+// Unit normals of triangles from two of their edges, through a temporary
+Benchmark scratch_normals(std::string name, bool const arena) {
+    return {
+        std::move(name),
+        [arena](std::size_t const count) {
+            Vec3Array a { random_vectors<Vec3>(count) };
+            Vec3Array b { random_vectors<Vec3>(count) };
+            Vec3Array out { count };
+
+            // Room for the temporary, lanes and padding included
+            auto const frame = std::make_shared<Arena>(
+                3u * (count + Vec3Array::lane_width) * sizeof(float)
+              + Vec3Array::alignment);
+            auto const resource = std::make_shared<ArenaResource>(*frame);
+
+            return Pass {
+                [=]() mutable {
+                    Arena::Scope const scope { *frame };
+
+                    Vec3Array crossed {
+                        count,
+                        arena ? resource.get()
+                              : std::pmr::get_default_resource()
+                    };
+                    cross(a, b, crossed);
+                    normalize(crossed, out);
+                    do_not_optimize(out.lane(0u));
+                },
+                count * 3u * sizeof(Vec3)
+            };
+        }
+    };
+}
+
+} // namespace
+
+void add_arena_benchmarks(std::vector<Benchmark> &benchmarks) {
+    benchmarks.push_back(scratch_normals("scratch/heap/normals", false));
+    benchmarks.push_back(scratch_normals("scratch/arena/normals", true));
+}
+
+} // namespace btx::math::bench
\ No newline at end of file
@@ -0,0 +1,533 @@
+#include "bench/harness.hpp"
+
+#include "brasstacks/math/batch.hpp"
+#include "brasstacks/math/dispatch.hpp"
+#include "brasstacks/math/packed.hpp"
+#include "brasstacks/math/skinning.hpp"
+#include "brasstacks/math/VecArray.hpp"
+
+namespace btx::math::bench {
+
+namespace {
+
+// Every kernel in batch.hpp and VecArray.hpp is dispatched at runtime, so
+// each of these runs once per SIMD level the CPU supports. The setup forces
+// the level, and run() puts it back afterwards.
+
+template <typename Vector>
+Benchmark batch_dot(std::string name, SimdLevel const level) {
+    return {
+        std::move(name),
+        [level](std::size_t const count) {
+            force_simd_level(level);
+
+            std::vector<Vector> a = random_vectors<Vector>(count);
+            std::vector<Vector> b = random_vectors<Vector>(count);
+            std::vector<float>  out(count);
+
+            std::vector<Reference> reference(count);
+            for(std::size_t i = 0u; i < count; ++i) {
+                reference[i] = reference_dot(a[i], b[i]);
+            }
+            dot(std::span<Vector const> { a }, b, out);
+
+            return Pass {
+                [=]() mutable {
+                    dot(std::span<Vector const> { a }, b, out);
+                    do_not_optimize(out.data());
+                },
+                count * (2u * sizeof(Vector) + sizeof(float)),
+                mean_ulps(out, reference)
+            };
+        }
+    };
+}
+
+Benchmark batch_cross(std::string name, SimdLevel const level) {
+    return {
+        std::move(name),
+        [level](std::size_t const count) {
+            force_simd_level(level);
+
+            std::vector<Vec3> a = random_vectors<Vec3>(count);
+            std::vector<Vec3> b = random_vectors<Vec3>(count);
+            std::vector<Vec3> out(count);
+
+            return Pass {
+                [=]() mutable {
+                    cross(a, b, out);
+                    do_not_optimize(out.data());
+                },
+                count * 3u * sizeof(Vec3)
+            };
+        }
+    };
+}
+
+template <typename Vector>
+Benchmark batch_normalize(std::string name, SimdLevel const level,
+                          Accuracy const accuracy)
+{
+    return {
+        std::move(name),
+        [level, accuracy](std::size_t const count) {
+            force_simd_level(level);
+
+            std::vector<Vector> v = random_vectors<Vector>(count);
+            std::vector<Vector> out(count);
+
+            return Pass {
+                [=]() mutable {
+                    normalize(v, out, accuracy);
+                    do_not_optimize(out.data());
+                },
+                count * 2u * sizeof(Vector)
+            };
+        }
+    };
+}
+
+Benchmark batch_transform(std::string name, SimdLevel const level) {
+    return {
+        std::move(name),
+        [level](std::size_t const count) {
+            force_simd_level(level);
+
+            Mat4 const m {
+                random_vector<Vec4>(), random_vector<Vec4>(),
+                random_vector<Vec4>(), random_vector<Vec4>(),
+            };
+            std::vector<Vec4> v = random_vectors<Vec4>(count);
+            std::vector<Vec4> out(count);
+
+            return Pass {
+                [=]() mutable {
+                    transform(m, v, out);
+                    do_not_optimize(out.data());
+                },
+                count * 2u * sizeof(Vec4)
+            };
+        }
+    };
+}
+
+Benchmark batch_rotate(std::string name, SimdLevel const level) {
+    return {
+        std::move(name),
+        [level](std::size_t const count) {
+            force_simd_level(level);
+
+            Quat const q = random_vector<Quat>();
+            std::vector<Vec3> v = random_vectors<Vec3>(count);
+            std::vector<Vec3> out(count);
+
+            return Pass {
+                [=]() mutable {
+                    rotate(q, v, out);
+                    do_not_optimize(out.data());
+                },
+                count * 2u * sizeof(Vec3)
+            };
+        }
+    };
+}
+
+// slerp() if spherical is set, otherwise nlerp()
+Benchmark batch_blend(std::string name, SimdLevel const level,
+                      bool const spherical)
+{
+    return {
+        std::move(name),
+        [level, spherical](std::size_t const count) {
+            force_simd_level(level);
+
+            std::vector<Quat> a = random_vectors<Quat>(count);
+            std::vector<Quat> b = random_vectors<Quat>(count);
+            std::vector<Quat> out(count);
+
+            return Pass {
+                [=]() mutable {
+                    if(spherical) {
+                        slerp(a, b, 0.3f, out);
+                    }
+                    else {
+                        nlerp(a, b, 0.3f, out);
+                    }
+                    do_not_optimize(out.data());
+                },
+                count * 3u * sizeof(Quat)
+            };
+        }
+    };
+}
+
+// One observer against every target, either packing the visible indices or
+// writing the bitmask
+Benchmark batch_visible(std::string name, SimdLevel const level,
+                        bool const indices)
+{
+    return {
+        std::move(name),
+        [level, indices](std::size_t const count) {
+            force_simd_level(level);
+
+            ViewCone const cone {
+                random_vector<Vec3>(), random_vector<Vec3>(), 60.0f
+            };
+            std::vector<Vec3> targets = random_vectors<Vec3>(count);
+            std::vector<uint32_t> out(count);
+            std::vector<uint64_t> mask((count + 63u) / 64u);
+
+            return Pass {
+                [=]() mutable {
+                    if(indices) {
+                        std::size_t const visible =
+                            visible_indices(cone, targets, out);
+                        do_not_optimize(&visible);
+                        do_not_optimize(out.data());
+                    }
+                    else {
+                        visible_mask(cone, targets, mask);
+                        do_not_optimize(mask.data());
+                    }
+                },
+                count * sizeof(Vec3)
+            };
+        }
+    };
+}
+
+// Pairs that mostly match, as when checking what changed since last frame
+Benchmark batch_equal(std::string name, SimdLevel const level,
+                      Tolerance const tolerance)
+{
+    return {
+        std::move(name),
+        [level, tolerance](std::size_t const count) {
+            force_simd_level(level);
+
+            std::vector<Vec4> a = random_vectors<Vec4>(count);
+            std::vector<Vec4> b = a;
+            for(std::size_t i = 0u; i < count; i += 7u) {
+                b[i].y += 1.0f;
+            }
+            std::vector<uint64_t> mask((count + 63u) / 64u);
+
+            return Pass {
+                [=]() mutable {
+                    std::size_t const different =
+                        approx_equal(a, b, mask, tolerance);
+                    do_not_optimize(&different);
+                    do_not_optimize(mask.data());
+                },
+                count * 2u * sizeof(Vec4)
+            };
+        }
+    };
+}
+
+// Packing to halves and back, as when filling a vertex buffer and reading
+// it again
+Benchmark batch_half(std::string name, SimdLevel const level,
+                     bool const pack)
+{
+    return {
+        std::move(name),
+        [level, pack](std::size_t const count) {
+            force_simd_level(level);
+
+            std::vector<Vec4>  v = random_vectors<Vec4>(count);
+            std::vector<Half4> h(count);
+            to_half(v, h);
+
+            return Pass {
+                [=]() mutable {
+                    if(pack) {
+                        to_half(v, h);
+                        do_not_optimize(h.data());
+                    }
+                    else {
+                        from_half(h, v);
+                        do_not_optimize(v.data());
+                    }
+                },
+                count * (sizeof(Vec4) + sizeof(Half4))
+            };
+        }
+    };
+}
+
+Benchmark batch_quantize(std::string name, SimdLevel const level,
+                         bool const pack)
+{
+    return {
+        std::move(name),
+        [level, pack](std::size_t const count) {
+            force_simd_level(level);
+
+            std::vector<Vec3>    v = random_vectors<Vec3>(count);
+            std::vector<Q16Vec3> q(count);
+            AABB const box { Vec3(-1.0f, -1.0f, -1.0f),
+                             Vec3(1.0f, 1.0f, 1.0f) };
+            quantize(box, v, q);
+
+            return Pass {
+                [=]() mutable {
+                    if(pack) {
+                        quantize(box, v, q);
+                        do_not_optimize(q.data());
+                    }
+                    else {
+                        dequantize(box, q, v);
+                        do_not_optimize(v.data());
+                    }
+                },
+                count * (sizeof(Vec3) + sizeof(Q16Vec3))
+            };
+        }
+    };
+}
+
+// Normals to 2x16-bit octahedral and back
+Benchmark batch_oct(std::string name, SimdLevel const level,
+                    bool const pack)
+{
+    return {
+        std::move(name),
+        [level, pack](std::size_t const count) {
+            force_simd_level(level);
+
+            std::vector<Vec3> n = random_vectors<Vec3>(count);
+            for(auto &each : n) {
+                each = normalize(each);
+            }
+            std::vector<Oct16> o(count);
+            to_oct16(n, o);
+
+            return Pass {
+                [=]() mutable {
+                    if(pack) {
+                        to_oct16(n, o);
+                        do_not_optimize(o.data());
+                    }
+                    else {
+                        from_oct(o, n);
+                        do_not_optimize(n.data());
+                    }
+                },
+                count * (sizeof(Vec3) + sizeof(Oct16))
+            };
+        }
+    };
+}
+
+// =============================================================================
+Benchmark array_add(std::string name, SimdLevel const level) {
+    return {
+        std::move(name),
+        [level](std::size_t const count) {
+            force_simd_level(level);
+
+            Vec3Array a { random_vectors<Vec3>(count) };
+            Vec3Array b { random_vectors<Vec3>(count) };
+            Vec3Array out { count };
+
+            return Pass {
+                [=]() mutable {
+                    add(a, b, out);
+                    do_not_optimize(out.lane(0u));
+                },
+                count * 3u * sizeof(Vec3)
+            };
+        }
+    };
+}
+
+Benchmark array_dot(std::string name, SimdLevel const level) {
+    return {
+        std::move(name),
+        [level](std::size_t const count) {
+            force_simd_level(level);
+
+            Vec3Array a { random_vectors<Vec3>(count) };
+            Vec3Array b { random_vectors<Vec3>(count) };
+            std::vector<float> out(count);
+
+            return Pass {
+                [=]() mutable {
+                    dot(a, b, out);
+                    do_not_optimize(out.data());
+                },
+                count * (2u * sizeof(Vec3) + sizeof(float))
+            };
+        }
+    };
+}
+
+Benchmark array_cross(std::string name, SimdLevel const level) {
+    return {
+        std::move(name),
+        [level](std::size_t const count) {
+            force_simd_level(level);
+
+            Vec3Array a { random_vectors<Vec3>(count) };
+            Vec3Array b { random_vectors<Vec3>(count) };
+            Vec3Array out { count };
+
+            return Pass {
+                [=]() mutable {
+                    cross(a, b, out);
+                    do_not_optimize(out.lane(0u));
+                },
+                count * 3u * sizeof(Vec3)
+            };
+        }
+    };
+}
+
+Benchmark array_normalize(std::string name, SimdLevel const level) {
+    return {
+        std::move(name),
+        [level](std::size_t const count) {
+            force_simd_level(level);
+
+            Vec4Array v { random_vectors<Vec4>(count) };
+            Vec4Array out { count };
+
+            return Pass {
+                [=]() mutable {
+                    normalize(v, out);
+                    do_not_optimize(out.lane(0u));
+                },
+                count * 2u * sizeof(Vec4)
+            };
+        }
+    };
+}
+
+// A 64-bone character with every vertex on four of them. Meshes tend to list
+// the vertices of each limb together, so neighbouring vertices share most of
+// their bones, and the palette stays in cache.
+Benchmark array_skin(std::string name, SimdLevel const level) {
+    return {
+        std::move(name),
+        [level](std::size_t const count) {
+            force_simd_level(level);
+
+            std::size_t constexpr bone_count = 64u;
+
+            std::vector<Mat4> palette(bone_count);
+            for(auto &bone : palette) {
+                bone = { random_vector<Vec4>(), random_vector<Vec4>(),
+                         random_vector<Vec4>(), random_vector<Vec4>() };
+            }
+
+            std::vector<BoneIndices> bones(count);
+            std::vector<Vec4> weights(count);
+            for(std::size_t i = 0u; i < count; ++i) {
+                std::size_t const first = i * bone_count / count;
+                for(uint8_t k = 0u; k < 4u; ++k) {
+                    bones[i][k] = static_cast<uint16_t>(
+                        (first + k * (i % 3u + 1u)) % bone_count);
+                }
+
+                Vec4 const w = random_vector<Vec4>();
+                Vec4 const positive { std::abs(w.x) + 0.1f,
+                                      std::abs(w.y) + 0.1f,
+                                      std::abs(w.z) + 0.1f,
+                                      std::abs(w.w) + 0.1f };
+                weights[i] = positive / (positive.x + positive.y +
+                                         positive.z + positive.w);
+            }
+
+            Vec4Array w { weights };
+            Vec3Array positions { random_vectors<Vec3>(count) };
+            Vec3Array normals { random_vectors<Vec3>(count) };
+            Vec3Array out_positions { count };
+            Vec3Array out_normals { count };
+
+            return Pass {
+                [=]() mutable {
+                    skin(palette, bones, w, positions, normals,
+                         out_positions, out_normals);
+                    do_not_optimize(out_positions.lane(0u));
+                    do_not_optimize(out_normals.lane(0u));
+                },
+                count * (sizeof(BoneIndices) + sizeof(Vec4)
+                         + 4u * sizeof(Vec3))
+            };
+        }
+    };
+}
+
+} // namespace
+
+void add_batch_benchmarks(std::vector<Benchmark> &benchmarks) {
+    SimdLevel const levels[] = {
+        SimdLevel::scalar, SimdLevel::sse2, SimdLevel::sse41,
+        SimdLevel::avx2,   SimdLevel::avx512,
+    };
+
+    for(auto const level : levels) {
+        if(level > detected_simd_level()) {
+            break;
+        }
+
+        std::string const suffix = std::string { "/" } + to_string(level);
+
+        benchmarks.push_back(batch_dot<Vec3>("batch/dot/Vec3" + suffix, level));
+        benchmarks.push_back(batch_dot<Vec4>("batch/dot/Vec4" + suffix, level));
+        benchmarks.push_back(batch_cross("batch/cross/Vec3" + suffix, level));
+
+        benchmarks.push_back(batch_normalize<Vec3>(
+            "batch/normalize/Vec3" + suffix, level, Accuracy::exact));
+        benchmarks.push_back(batch_normalize<Vec3>(
+            "batch/normalize_fast/Vec3" + suffix, level, Accuracy::fast));
+        benchmarks.push_back(batch_normalize<Vec3>(
+            "batch/normalize_fastest/Vec3" + suffix, level,
+            Accuracy::fastest));
+
+        benchmarks.push_back(
+            batch_transform("batch/transform/Vec4" + suffix, level));
+
+        benchmarks.push_back(
+            batch_rotate("batch/rotate/Vec3" + suffix, level));
+        benchmarks.push_back(
+            batch_blend("batch/nlerp/Quat" + suffix, level, false));
+        benchmarks.push_back(
+            batch_blend("batch/slerp/Quat" + suffix, level, true));
+
+        benchmarks.push_back(batch_visible(
+            "batch/visible_indices/Vec3" + suffix, level, true));
+        benchmarks.push_back(batch_visible(
+            "batch/visible_mask/Vec3" + suffix, level, false));
+
+        benchmarks.push_back(batch_equal(
+            "batch/approx_equal/Vec4" + suffix, level, { }));
+        benchmarks.push_back(batch_equal(
+            "batch/approx_equal_ulps/Vec4" + suffix, level,
+            Tolerance::ulps(4u)));
+
+        benchmarks.push_back(
+            batch_half("batch/to_half/Vec4" + suffix, level, true));
+        benchmarks.push_back(
+            batch_half("batch/from_half/Vec4" + suffix, level, false));
+        benchmarks.push_back(
+            batch_quantize("batch/quantize/Vec3" + suffix, level, true));
+        benchmarks.push_back(
+            batch_quantize("batch/dequantize/Vec3" + suffix, level, false));
+        benchmarks.push_back(
+            batch_oct("batch/to_oct16/Vec3" + suffix, level, true));
+        benchmarks.push_back(
+            batch_oct("batch/from_oct16/Vec3" + suffix, level, false));
+
+        benchmarks.push_back(array_add("Vec3Array/add" + suffix, level));
+        benchmarks.push_back(array_dot("Vec3Array/dot" + suffix, level));
+        benchmarks.push_back(array_cross("Vec3Array/cross" + suffix, level));
+        benchmarks.push_back(
+            array_normalize("Vec4Array/normalize" + suffix, level));
+        benchmarks.push_back(array_skin("skin/Vec3Array" + suffix, level));
+    }
+}
+
+} // namespace btx::math::bench
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include "bench/harness.hpp"
+
+#include "brasstacks/math/expression.hpp"
+#include "brasstacks/math/VecArray.hpp"
+
+namespace btx::math::bench {
+
+namespace {
+
+// The same work done as one fused expression and as a chain of bulk calls
+// through temporaries, which run at the best SIMD level the CPU has
+
+// =============================================================================
+// Euler integration, positions += velocities * dt + accelerations * dt^2 / 2
+Benchmark integrate(std::string name, bool const fused) {
+    return {
+        std::move(name),
+        [fused](std::size_t const count) {
+            Vec3Array positions     { random_vectors<Vec3>(count) };
+            Vec3Array velocities    { random_vectors<Vec3>(count) };
+            Vec3Array accelerations { random_vectors<Vec3>(count) };
+            Vec3Array moved         { count };
+            Vec3Array accelerated   { count };
+
+            float const dt = 1.0f / 60.0f;
+
+            return Pass {
+                [=]() mutable {
+                    if(fused) {
+                        positions += velocities * dt
+                                   + accelerations * (0.5f * dt * dt);
+                    }
+                    else {
+                        scale(velocities, dt, moved);
+                        scale(accelerations, 0.5f * dt * dt, accelerated);
+                        add(moved, accelerated, moved);
+                        add(positions, moved, positions);
+                    }
+                    do_not_optimize(positions.lane(0u));
+                },
+                count * 4u * sizeof(Vec3)
+            };
+        }
+    };
+}
+
+// =============================================================================
+// Unit normals of triangles from two of their edges
+Benchmark normals(std::string name, bool const fused) {
+    return {
+        std::move(name),
+        [fused](std::size_t const count) {
+            Vec3Array a { random_vectors<Vec3>(count) };
+            Vec3Array b { random_vectors<Vec3>(count) };
+            Vec3Array out { count };
+
+            return Pass {
+                [=]() mutable {
+                    if(fused) {
+                        out = normalize(cross(a, b));
+                    }
+                    else {
+                        cross(a, b, out);
+                        normalize(out, out);
+                    }
+                    do_not_optimize(out.lane(0u));
+                },
+                count * 3u * sizeof(Vec3)
+            };
+        }
+    };
+}
+
+} // namespace
+
+void add_expression_benchmarks(std::vector<Benchmark> &benchmarks) {
+    benchmarks.push_back(integrate("expression/integrate/fused", true));
+    benchmarks.push_back(integrate("expression/integrate/bulk", false));
+    benchmarks.push_back(normals("expression/normals/fused", true));
+    benchmarks.push_back(normals("expression/normals/bulk", false));
+}
+
+} // namespace btx::math::bench
\ No newline at end of file
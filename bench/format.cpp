@@ -0,0 +1,154 @@
+#include "bench/harness.hpp"
+
+#include "brasstacks/math/format.hpp"
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+namespace btx::math::bench {
+
+namespace {
+
+// Writing vectors out as text, one per line, the way a debug dump or a
+// telemetry log would, and reading them back. Both ways of writing write the
+// same characters; bytes counts the vectors and the text.
+
+// The text for a whole pass is held in memory, so the largest size is left
+// out
+std::vector<std::size_t> const text_sizes = { SIZES[0], SIZES[1], SIZES[2] };
+
+template <typename Vector>
+std::size_t text_length(std::vector<Vector> const &vectors) {
+    std::vector<char> text(vectors.size() * (max_chars<Vector> + 1u));
+    auto const result = to_chars(text.data(), text.data() + text.size(),
+                                 vectors);
+    return static_cast<std::size_t>(result.ptr - text.data());
+}
+
+// Into a std::ostringstream that's rewound before each pass, so its buffer
+// is only allocated once
+template <typename Vector>
+Benchmark ostream_text(std::string name) {
+    return {
+        std::move(name),
+        [](std::size_t const count) {
+            std::vector<Vector> const vectors = random_vectors<Vector>(count);
+            std::size_t const length = text_length(vectors);
+
+            // std::function needs a copyable pass, which a stream isn't
+            auto const out = std::make_shared<std::ostringstream>();
+
+            return Pass {
+                [=]() {
+                    out->seekp(0);
+                    for(auto const &v : vectors) {
+                        *out << v << '\n';
+                    }
+                    do_not_optimize(out.get());
+                },
+                count * sizeof(Vector) + length
+            };
+        },
+        text_sizes
+    };
+}
+
+template <typename Vector>
+Benchmark to_chars_text(std::string name) {
+    return {
+        std::move(name),
+        [](std::size_t const count) {
+            std::vector<Vector> const vectors = random_vectors<Vector>(count);
+            std::size_t const length = text_length(vectors);
+            std::vector<char> text(count * (max_chars<Vector> + 1u));
+
+            return Pass {
+                [=]() mutable {
+                    auto const result =
+                        to_chars(text.data(), text.data() + text.size(),
+                                 vectors);
+                    do_not_optimize(result.ptr);
+                },
+                count * sizeof(Vector) + length
+            };
+        },
+        text_sizes
+    };
+}
+
+// Reading the text above back, with std::istringstream reading a float at a
+// time, since the library has no operator>>, and with from_chars()
+template <typename Vector>
+std::string text_of(std::vector<Vector> const &vectors) {
+    std::string text(vectors.size() * (max_chars<Vector> + 1u), '\0');
+    auto const result = to_chars(text.data(), text.data() + text.size(),
+                                 vectors);
+    text.resize(static_cast<std::size_t>(result.ptr - text.data()));
+    return text;
+}
+
+template <typename Vector>
+Benchmark istream_parse(std::string name) {
+    return {
+        std::move(name),
+        [](std::size_t const count) {
+            std::string const text =
+                text_of(random_vectors<Vector>(count));
+            std::vector<Vector> out(count);
+
+            return Pass {
+                [=]() mutable {
+                    std::istringstream in { text };
+                    for(auto &v : out) {
+                        for(uint8_t c = 0u; c < Vector::components; ++c) {
+                            in >> v[c];
+                        }
+                    }
+                    do_not_optimize(out.data());
+                },
+                text.size() + count * sizeof(Vector)
+            };
+        },
+        text_sizes
+    };
+}
+
+template <typename Vector>
+Benchmark from_chars_parse(std::string name) {
+    return {
+        std::move(name),
+        [](std::size_t const count) {
+            std::string const text =
+                text_of(random_vectors<Vector>(count));
+            std::vector<Vector> out(count);
+
+            return Pass {
+                [=]() mutable {
+                    auto const result = from_chars(
+                        text.data(), text.data() + text.size(), out);
+                    do_not_optimize(&result);
+                    do_not_optimize(out.data());
+                },
+                text.size() + count * sizeof(Vector)
+            };
+        },
+        text_sizes
+    };
+}
+
+} // namespace
+
+void add_format_benchmarks(std::vector<Benchmark> &benchmarks) {
+    benchmarks.push_back(ostream_text<Vec3>("format/ostream/Vec3"));
+    benchmarks.push_back(to_chars_text<Vec3>("format/to_chars/Vec3"));
+    benchmarks.push_back(ostream_text<Vec4>("format/ostream/Vec4"));
+    benchmarks.push_back(to_chars_text<Vec4>("format/to_chars/Vec4"));
+
+    benchmarks.push_back(istream_parse<Vec3>("parse/istream/Vec3"));
+    benchmarks.push_back(from_chars_parse<Vec3>("parse/from_chars/Vec3"));
+    benchmarks.push_back(istream_parse<Vec4>("parse/istream/Vec4"));
+    benchmarks.push_back(from_chars_parse<Vec4>("parse/from_chars/Vec4"));
+}
+
+} // namespace btx::math::bench
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include "bench/harness.hpp"
+
+namespace btx::math::bench {
+
+namespace {
+
+// Dot products, cross products, and lengths, fused or unfused depending on
+// BTX_MATH_FMA. Build once with it and once without to compare; the JSON
+// output records which build is which. Without FMA instructions enabled for
+// the whole build, with -mfma or a -march that has them, the fused scalar
+// functions call fmaf() instead.
+//
+// Each benchmark feeds every result into the next call, so ns/op is the
+// latency of one call rather than its throughput, which is where fusing shows
+// up. The ulps column is the mean error of the same function over independent
+// random inputs, which is where rounding once instead of twice shows up.
+
+// The latency doesn't depend on where the inputs live, so one size will do
+std::vector<std::size_t> const chain_sizes = { SIZES[1] };
+
+// Random vectors of the given length, which keeps the chains from growing
+// without bound or decaying into denormals
+template <typename Vector>
+std::vector<Vector> scaled_vectors(std::size_t const count, float const scale)
+{
+    std::vector<Vector> vectors(count);
+    for(auto &v : vectors) {
+        Vector random = random_vector<Vector>();
+        while(length_squared(random) < epsilon) {
+            random = random_vector<Vector>();
+        }
+        v = normalize(random) * scale;
+    }
+    return vectors;
+}
+
+template <typename Vector>
+double dot_ulps(std::size_t const count) {
+    std::vector<Vector> const a = random_vectors<Vector>(count);
+    std::vector<Vector> const b = random_vectors<Vector>(count);
+
+    std::vector<float>  results(count);
+    std::vector<Reference> reference(count);
+    for(std::size_t i = 0u; i < count; ++i) {
+        results[i] = dot(a[i], b[i]);
+        reference[i] = reference_dot(a[i], b[i]);
+    }
+
+    return mean_ulps(results, reference);
+}
+
+template <typename Vector>
+double length_squared_ulps(std::size_t const count) {
+    std::vector<Vector> const v = random_vectors<Vector>(count);
+
+    std::vector<float>  results(count);
+    std::vector<Reference> reference(count);
+    for(std::size_t i = 0u; i < count; ++i) {
+        results[i] = length_squared(v[i]);
+        reference[i] = reference_dot(v[i], v[i]);
+    }
+
+    return mean_ulps(results, reference);
+}
+
+double cross_ulps(std::size_t const count) {
+    std::vector<Vec3> const a = random_vectors<Vec3>(count);
+    std::vector<Vec3> const b = random_vectors<Vec3>(count);
+
+    std::vector<float>  results(count * 3u);
+    std::vector<Reference> reference(count * 3u);
+    for(std::size_t i = 0u; i < count; ++i) {
+        Vec3 const result = cross(a[i], b[i]);
+        for(uint8_t c = 0u; c < 3u; ++c) {
+            uint8_t const c1 = (c + 1u) % 3u;
+            uint8_t const c2 = (c + 2u) % 3u;
+
+            results[i * 3u + c] = result[c];
+            reference[i * 3u + c] = reference_dot(
+                Vec2(a[i][c1], -a[i][c2]), Vec2(b[i][c2], b[i][c1]));
+        }
+    }
+
+    return mean_ulps(results, reference);
+}
+
+// x = dot((x, a.y, a.z...), b), with |a| = 1 and |b| = 1/2 so that x stays
+// below one
+template <typename Vector>
+Benchmark dot_chain(std::string name) {
+    return {
+        std::move(name),
+        [](std::size_t const count) {
+            std::vector<Vector> const a = scaled_vectors<Vector>(count, 1.0f);
+            std::vector<Vector> const b = scaled_vectors<Vector>(count, 0.5f);
+            double const ulps = dot_ulps<Vector>(count);
+
+            return Pass {
+                [=]() {
+                    float x = 0.0f;
+                    for(std::size_t i = 0u; i < count; ++i) {
+                        Vector v = a[i];
+                        v.x = x;
+                        x = dot(v, b[i]);
+                    }
+                    do_not_optimize(&x);
+                },
+                count * 2u * sizeof(Vector),
+                ulps
+            };
+        },
+        chain_sizes
+    };
+}
+
+// x = length_squared((x, a.y, a.z...)), with |a| = 2/5 so that x settles
+// toward a fixed point below one
+template <typename Vector>
+Benchmark length_squared_chain(std::string name) {
+    return {
+        std::move(name),
+        [](std::size_t const count) {
+            std::vector<Vector> const a = scaled_vectors<Vector>(count, 0.4f);
+            double const ulps = length_squared_ulps<Vector>(count);
+
+            return Pass {
+                [=]() {
+                    float x = 0.0f;
+                    for(std::size_t i = 0u; i < count; ++i) {
+                        Vector v = a[i];
+                        v.x = x;
+                        x = length_squared(v);
+                    }
+                    do_not_optimize(&x);
+                },
+                count * sizeof(Vector),
+                ulps
+            };
+        },
+        chain_sizes
+    };
+}
+
+// v = cross(v, b) + a, with |a| = 1 and |b| = 1/2 so that |v| stays below
+// two. The add is the same in both builds.
+Benchmark cross_chain(std::string name) {
+    return {
+        std::move(name),
+        [](std::size_t const count) {
+            std::vector<Vec3> const a = scaled_vectors<Vec3>(count, 1.0f);
+            std::vector<Vec3> const b = scaled_vectors<Vec3>(count, 0.5f);
+            double const ulps = cross_ulps(count);
+
+            return Pass {
+                [=]() {
+                    Vec3 v = Vec3::unit_x;
+                    for(std::size_t i = 0u; i < count; ++i) {
+                        v = cross(v, b[i]) + a[i];
+                    }
+                    do_not_optimize(&v);
+                },
+                count * 2u * sizeof(Vec3),
+                ulps
+            };
+        },
+        chain_sizes
+    };
+}
+
+} // namespace
+
+void add_fused_benchmarks(std::vector<Benchmark> &benchmarks) {
+    benchmarks.push_back(dot_chain<Vec3>("fma/dot/Vec3"));
+    benchmarks.push_back(dot_chain<Vec4>("fma/dot/Vec4"));
+    benchmarks.push_back(cross_chain("fma/cross/Vec3"));
+    benchmarks.push_back(
+        length_squared_chain<Vec3>("fma/length_squared/Vec3"));
+    benchmarks.push_back(
+        length_squared_chain<Vec4>("fma/length_squared/Vec4"));
+}
+
+} // namespace btx::math::bench
\ No newline at end of file
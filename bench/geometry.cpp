@@ -0,0 +1,249 @@
+#include "bench/harness.hpp"
+
+#include "brasstacks/math/BVH.hpp"
+#include "brasstacks/math/SpatialGrid.hpp"
+
+#include <cmath>
+#include <memory>
+#include <thread>
+
+namespace btx::math::bench {
+
+namespace {
+
+// Scenes of 10K to 1M boxes or positions. Each pass builds once or queries
+// once per element, so ns/op is per element built or per query.
+std::vector<std::size_t> const scene_sizes = { 10'000u, 100'000u, 1'000'000u };
+
+// Boxes scattered through a cube 200 units across, shrinking as there are
+// more of them so that a ray passes through about as many at every size
+std::vector<AABB> random_scene(std::size_t const count) {
+    float const size = 200.0f / std::cbrt(static_cast<float>(count));
+
+    std::vector<AABB> boxes(count);
+    for(auto &box : boxes) {
+        Vec3 const corner = random_vector<Vec3>() * 10.0f;
+        Vec3 const extent(random_float(0.1f, 1.0f) * size,
+                          random_float(0.1f, 1.0f) * size,
+                          random_float(0.1f, 1.0f) * size);
+        box = { corner, corner + extent };
+    }
+    return boxes;
+}
+
+std::vector<Ray> random_rays(std::size_t const count) {
+    std::vector<Ray> rays(count);
+    for(auto &ray : rays) {
+        Vec3 direction = random_vector<Vec3>();
+        while(length_squared(direction) < epsilon) {
+            direction = random_vector<Vec3>();
+        }
+        ray = { random_vector<Vec3>() * 10.0f, normalize(direction) };
+    }
+    return rays;
+}
+
+Benchmark bvh_build(std::string name) {
+    return {
+        std::move(name),
+        [](std::size_t const count) {
+            auto const boxes =
+                std::make_shared<std::vector<AABB>>(random_scene(count));
+
+            return Pass {
+                [=] {
+                    BVH const bvh { *boxes };
+                    do_not_optimize(bvh.nodes().data());
+                },
+                count * sizeof(AABB)
+            };
+        },
+        scene_sizes
+    };
+}
+
+Benchmark bvh_intersect(std::string name, std::size_t const threads) {
+    return {
+        std::move(name),
+        [threads](std::size_t const count) {
+            auto const bvh = std::make_shared<BVH>(random_scene(count));
+            auto const pool = std::make_shared<ThreadPool>(threads);
+
+            std::vector<Ray> rays = random_rays(count);
+            std::vector<BVH::RayHit> hits(count);
+
+            return Pass {
+                [=]() mutable {
+                    bvh->intersect(Parallel { 1024u, pool.get() }, rays, hits);
+                    do_not_optimize(hits.data());
+                },
+                count * (sizeof(Ray) + sizeof(BVH::RayHit))
+            };
+        },
+        scene_sizes
+    };
+}
+
+Benchmark bvh_overlapping(std::string name) {
+    return {
+        std::move(name),
+        [](std::size_t const count) {
+            auto const bvh = std::make_shared<BVH>(random_scene(count));
+
+            // Queries about the size of the boxes themselves
+            std::vector<AABB> queries = random_scene(count);
+            std::vector<uint32_t> found;
+            std::vector<std::size_t> offsets(count + 1u);
+
+            return Pass {
+                [=]() mutable {
+                    bvh->overlapping(queries, found, offsets);
+                    do_not_optimize(found.data());
+                },
+                count * (sizeof(AABB) + sizeof(std::size_t))
+            };
+        },
+        scene_sizes
+    };
+}
+
+// Agents spread evenly enough that each one has about four others within
+// agent_radius at every size, which is what a crowd or flocking update sees
+float constexpr agent_radius = 2.0f;
+
+std::vector<Vec3> random_agents(std::size_t const count) {
+    float const side = 2.0f * std::cbrt(static_cast<float>(count));
+
+    std::vector<Vec3> agents(count);
+    for(auto &agent : agents) {
+        agent = Vec3(random_float(0.0f, side), random_float(0.0f, side),
+                     random_float(0.0f, side));
+    }
+    return agents;
+}
+
+Benchmark grid_build(std::string name) {
+    return {
+        std::move(name),
+        [](std::size_t const count) {
+            auto const grid = std::make_shared<SpatialGrid3>(agent_radius);
+            std::vector<Vec3> agents = random_agents(count);
+
+            return Pass {
+                [=] {
+                    grid->build(agents);
+                    do_not_optimize(grid.get());
+                },
+                count * sizeof(Vec3)
+            };
+        },
+        scene_sizes
+    };
+}
+
+// Every agent's neighbors within agent_radius, through the grid or by
+// testing every pair, which only runs at the smallest size
+Benchmark grid_within(std::string name) {
+    return {
+        std::move(name),
+        [](std::size_t const count) {
+            auto const grid = std::make_shared<SpatialGrid3>(agent_radius);
+            std::vector<Vec3> agents = random_agents(count);
+            grid->build(agents);
+
+            std::vector<uint32_t> found;
+
+            return Pass {
+                [=]() mutable {
+                    for(auto const &agent : agents) {
+                        found.clear();
+                        grid->within(agent, agent_radius, found);
+                        do_not_optimize(found.data());
+                    }
+                },
+                count * sizeof(Vec3)
+            };
+        },
+        scene_sizes
+    };
+}
+
+Benchmark brute_force_within(std::string name) {
+    return {
+        std::move(name),
+        [](std::size_t const count) {
+            std::vector<Vec3> agents = random_agents(count);
+            std::vector<uint32_t> found;
+
+            return Pass {
+                [=]() mutable {
+                    for(auto const &agent : agents) {
+                        found.clear();
+                        for(std::size_t i = 0u; i < agents.size(); ++i) {
+                            if(length_squared(agents[i] - agent) <=
+                               agent_radius * agent_radius)
+                            {
+                                found.push_back(static_cast<uint32_t>(i));
+                            }
+                        }
+                        do_not_optimize(found.data());
+                    }
+                },
+                count * sizeof(Vec3)
+            };
+        },
+        { scene_sizes.front() }
+    };
+}
+
+Benchmark grid_nearest(std::string name) {
+    return {
+        std::move(name),
+        [](std::size_t const count) {
+            auto const grid = std::make_shared<SpatialGrid3>(agent_radius);
+            std::vector<Vec3> agents = random_agents(count);
+            grid->build(agents);
+
+            std::vector<SpatialGrid3::Neighbor> nearest(8u);
+
+            return Pass {
+                [=]() mutable {
+                    for(auto const &agent : agents) {
+                        grid->nearest(agent, nearest);
+                        do_not_optimize(nearest.data());
+                    }
+                },
+                count * sizeof(Vec3)
+            };
+        },
+        scene_sizes
+    };
+}
+
+} // namespace
+
+void add_geometry_benchmarks(std::vector<Benchmark> &benchmarks) {
+    benchmarks.push_back(bvh_build("BVH/build"));
+    benchmarks.push_back(bvh_overlapping("BVH/overlapping"));
+
+    benchmarks.push_back(grid_build("SpatialGrid3/build"));
+    benchmarks.push_back(grid_within("SpatialGrid3/within"));
+    benchmarks.push_back(brute_force_within("SpatialGrid3/brute_force"));
+    benchmarks.push_back(grid_nearest("SpatialGrid3/nearest/8"));
+
+    std::size_t const hardware =
+        std::max(std::thread::hardware_concurrency(), 1u);
+
+    for(std::size_t const threads : { std::size_t { 1u }, hardware }) {
+        std::string suffix = "/";
+        suffix += std::to_string(threads);
+
+        benchmarks.push_back(bvh_intersect("BVH/intersect" + suffix, threads));
+
+        if(hardware == 1u) {
+            break;
+        }
+    }
+}
+
+} // namespace btx::math::bench
\ No newline at end of file
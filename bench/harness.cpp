@@ -0,0 +1,216 @@
+#include "bench/harness.hpp"
+
+#include "brasstacks/math/dispatch.hpp"
+
+#include <chrono>
+
+namespace btx::math::bench {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Individual timings shorter than this are mostly clock overhead
+std::chrono::nanoseconds constexpr min_batch_time =
+    std::chrono::milliseconds(10);
+
+std::chrono::nanoseconds time_passes(Pass const &pass, std::size_t const passes)
+{
+    auto const start = Clock::now();
+    for(std::size_t i = 0u; i < passes; ++i) {
+        pass.run();
+    }
+    return Clock::now() - start;
+}
+
+Result measure(std::string const &name, Pass const &pass,
+               std::size_t const count, double const min_time)
+{
+    // Warm the caches and the branch predictors, then double the number of
+    // passes per batch until a batch takes long enough to time reliably
+    pass.run();
+
+    std::size_t passes = 1u;
+    auto elapsed = time_passes(pass, passes);
+    while(elapsed < min_batch_time) {
+        passes *= 2u;
+        elapsed = time_passes(pass, passes);
+    }
+
+    // Keep timing batches until min_time is up, and report the fastest one.
+    // Anything slower was interrupted by something other than the benchmark.
+    auto best = elapsed;
+    auto total = elapsed;
+    std::size_t iterations = passes;
+
+    std::chrono::duration<double> const budget { min_time };
+    while(total < budget) {
+        elapsed = time_passes(pass, passes);
+        best = std::min(best, elapsed);
+        total += elapsed;
+        iterations += passes;
+    }
+
+    double const seconds = std::chrono::duration<double>(best).count();
+
+    return {
+        name,
+        count,
+        pass.bytes,
+        iterations,
+        seconds * 1.0e9 / static_cast<double>(passes * count),
+        static_cast<double>(pass.bytes * passes) / seconds / 1.0e9,
+        pass.ulps,
+    };
+}
+
+void print_row(std::string_view const name, std::string_view const size,
+               std::string_view const ns, std::string_view const gb,
+               std::string_view const ulps)
+{
+    std::cout << std::left  << std::setw(36) << name
+              << std::right << std::setw(10) << size
+              << std::setw(12) << ns
+              << std::setw(12) << gb
+              << std::setw(10) << ulps << '\n';
+}
+
+// Names are plain ASCII, but quotes and backslashes still need escaping
+void write_string(std::ostream &out, std::string_view const text) {
+    out << '"';
+    for(char const c : text) {
+        if(c == '"' || c == '\\') {
+            out << '\\';
+        }
+        out << c;
+    }
+    out << '"';
+}
+
+} // namespace
+
+// =============================================================================
+float random_float(float const min, float const max) {
+    return std::uniform_real_distribution<float> { min, max }(rng());
+}
+
+double mean_ulps(std::span<float const> const results,
+                 std::span<Reference const> const reference)
+{
+    double total = 0.0;
+    for(std::size_t i = 0u; i < results.size(); ++i) {
+        float const magnitude = static_cast<float>(reference[i].magnitude);
+        float const ulp = std::nextafter(
+            magnitude, std::numeric_limits<float>::infinity()) - magnitude;
+
+        total += std::abs(static_cast<double>(results[i]) - reference[i].value)
+               / static_cast<double>(ulp);
+    }
+
+    return results.empty()
+         ? 0.0 : total / static_cast<double>(results.size());
+}
+
+// =============================================================================
+std::vector<Result> run(std::vector<Benchmark> const &benchmarks,
+                        Options const &options)
+{
+    std::vector<Result> results;
+
+    print_row("benchmark", "size", "ns/op", "GB/s", "ulps");
+
+    for(auto const &benchmark : benchmarks) {
+        if(benchmark.name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+
+        std::vector<std::size_t> sizes = benchmark.sizes;
+        if(sizes.empty()) {
+            sizes.assign(std::begin(SIZES), std::end(SIZES));
+        }
+
+        for(auto const size : sizes) {
+            if(size > options.max_size) {
+                continue;
+            }
+
+            Pass const pass = benchmark.setup(size);
+            Result const result = measure(benchmark.name, pass, size,
+                                          options.min_time);
+
+            std::ostringstream ns;
+            std::ostringstream gb;
+            std::ostringstream ulps;
+            ns << std::fixed << std::setprecision(3) << result.ns_per_op;
+            gb << std::fixed << std::setprecision(2) << result.gb_per_s;
+            if(result.ulps) {
+                ulps << std::fixed << std::setprecision(3) << *result.ulps;
+            }
+            print_row(result.name, std::to_string(size), ns.str(), gb.str(),
+                      ulps.str());
+
+            results.push_back(result);
+        }
+
+        // Benchmarks of the dispatched kernels may have forced a level
+        reset_simd_level();
+    }
+
+    return results;
+}
+
+// =============================================================================
+void write_json(std::ostream &out, std::vector<Result> const &results) {
+    out << "{\n  \"context\": {\n";
+
+    out << "    \"simd_level\": ";
+    write_string(out, to_string(detected_simd_level()));
+    out << ",\n";
+
+#if defined(NDEBUG)
+    out << "    \"assertions\": false,\n";
+#else
+    out << "    \"assertions\": true,\n";
+#endif
+
+#if defined(BTX_MATH_HEADER_ONLY)
+    out << "    \"header_only\": true,\n";
+#else
+    out << "    \"header_only\": false,\n";
+#endif
+
+#if defined(BTX_MATH_FMA)
+    out << "    \"fma\": true,\n";
+#else
+    out << "    \"fma\": false,\n";
+#endif
+
+#if defined(BTX_MATH_SIMD)
+    out << "    \"simd\": true\n";
+#else
+    out << "    \"simd\": false\n";
+#endif
+
+    out << "  },\n  \"benchmarks\": [";
+
+    for(std::size_t i = 0u; i < results.size(); ++i) {
+        auto const &result = results[i];
+
+        out << (i == 0u ? "\n" : ",\n") << "    { \"name\": ";
+        write_string(out, result.name);
+        out << ", \"size\": " << result.size
+            << ", \"bytes\": " << result.bytes
+            << ", \"iterations\": " << result.iterations
+            << std::setprecision(6)
+            << ", \"ns_per_op\": " << result.ns_per_op
+            << ", \"gb_per_s\": " << result.gb_per_s;
+        if(result.ulps) {
+            out << ", \"mean_ulps\": " << *result.ulps;
+        }
+        out << " }";
+    }
+
+    out << "\n  ]\n}\n";
+}
+
+} // namespace btx::math::bench
\ No newline at end of file
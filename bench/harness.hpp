@@ -0,0 +1,212 @@
+#ifndef BRASSTACKS_MATH_BENCH_HARNESS_HPP
+#define BRASSTACKS_MATH_BENCH_HARNESS_HPP
+
+#include "brasstacks/math/math.hpp"
+
+#include <functional>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
+namespace btx::math::bench {
+
+// Element counts for each benchmark, chosen so that a Vec4 operation's
+// working set lands in L1, L2, the last level cache, and main memory in turn
+static std::size_t constexpr SIZES[] = {
+    std::size_t { 1u } << 9u,   //   8 KiB per Vec4 array
+    std::size_t { 1u } << 13u,  // 128 KiB
+    std::size_t { 1u } << 17u,  //   2 MiB
+    std::size_t { 1u } << 22u,  //  64 MiB
+};
+
+// One pass of a benchmark over its inputs, plus the number of bytes that pass
+// reads and writes, for the throughput figures
+struct Pass {
+    std::function<void()> run;
+    std::size_t bytes = 0u;
+
+    // For the benchmarks that check their accuracy, the mean error of the
+    // function's results against a double precision reference, in ulps
+    std::optional<double> ulps = { };
+};
+
+struct Benchmark {
+    std::string name;
+
+    // Allocates and fills the inputs for `count` elements, then returns the
+    // pass that works through them
+    std::function<Pass(std::size_t count)> setup;
+
+    // The counts to run at, if not SIZES
+    std::vector<std::size_t> sizes = { };
+};
+
+struct Result {
+    std::string name;
+    std::size_t size       = 0u;
+    std::size_t bytes      = 0u;
+    std::size_t iterations = 0u;
+    double      ns_per_op  = 0.0;
+    double      gb_per_s   = 0.0;
+
+    std::optional<double> ulps = { };
+};
+
+struct Options {
+    std::string filter;             // Only run names containing this
+    std::string json_path;          // Also write results here, if not empty
+    double      min_time = 0.25;    // Seconds spent timing each size
+    std::size_t max_size = SIZES[std::size(SIZES) - 1u];
+};
+
+// =============================================================================
+// Keeps the optimizer from discarding a result it can prove is never read
+template <typename T>
+inline void do_not_optimize(T const *data) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    static_cast<void>(*reinterpret_cast<char const volatile *>(data));
+    _ReadWriteBarrier();
+#else
+    __asm__ __volatile__("" : : "r"(data) : "memory");
+#endif
+}
+
+// The same inputs on every run, so results are comparable between builds
+inline std::mt19937 & rng() {
+    static std::mt19937 engine { 0x5EED };
+    return engine;
+}
+
+[[nodiscard]] float random_float(float min = -10.0f, float max = 10.0f);
+
+template <typename Vector>
+[[nodiscard]] Vector random_vector() {
+    Vector v;
+    for(uint8_t c = 0u; c < sizeof(Vector) / sizeof(float); ++c) {
+        v[c] = random_float();
+    }
+    return v;
+}
+
+// Quaternions are only rotations at unit length
+template <>
+[[nodiscard]] inline Quat random_vector<Quat>() {
+    Quat q;
+    for(uint8_t c = 0u; c < 4u; ++c) {
+        q[c] = random_float();
+    }
+    return normalize(q);
+}
+
+template <typename Vector>
+[[nodiscard]] std::vector<Vector> random_vectors(std::size_t const count) {
+    std::vector<Vector> vectors(count);
+    for(auto &v : vectors) {
+        v = random_vector<Vector>();
+    }
+    return vectors;
+}
+
+// =============================================================================
+// Accuracy against double precision, for Pass::ulps
+
+// A dot product, and the sum of the magnitudes of its products. The products
+// of floats are exact as doubles, so this only rounds the sums, and far more
+// finely than a float would.
+struct Reference {
+    double value = 0.0;
+    double magnitude = 0.0;
+};
+
+template <typename Vector>
+[[nodiscard]] Reference reference_dot(Vector const &a, Vector const &b) {
+    Reference result;
+    for(uint8_t c = 0u; c < sizeof(Vector) / sizeof(float); ++c) {
+        double const product = static_cast<double>(a[c])
+                             * static_cast<double>(b[c]);
+        result.value += product;
+        result.magnitude += std::abs(product);
+    }
+    return result;
+}
+
+// How far each result is from its reference on average, in units of the
+// spacing between floats at the reference's magnitude. Measuring against
+// the size of the products rather than the result keeps the sums that
+// nearly cancel from swamping everything else.
+[[nodiscard]] double mean_ulps(std::span<float const> results,
+                               std::span<Reference const> reference);
+
+// =============================================================================
+// Element-wise benchmarks: out[i] = op(a[i]) and out[i] = op(a[i], b[i])
+template <typename In, typename Out, typename Op>
+[[nodiscard]] Benchmark unary(std::string name, Op op) {
+    return {
+        std::move(name),
+        [op](std::size_t const count) {
+            std::vector<In>  a = random_vectors<In>(count);
+            std::vector<Out> out(count);
+
+            return Pass {
+                [=]() mutable {
+                    for(std::size_t i = 0u; i < count; ++i) {
+                        out[i] = op(a[i]);
+                    }
+                    do_not_optimize(out.data());
+                },
+                count * (sizeof(In) + sizeof(Out))
+            };
+        }
+    };
+}
+
+template <typename In, typename Out, typename Op>
+[[nodiscard]] Benchmark binary(std::string name, Op op) {
+    return {
+        std::move(name),
+        [op](std::size_t const count) {
+            std::vector<In>  a = random_vectors<In>(count);
+            std::vector<In>  b = random_vectors<In>(count);
+            std::vector<Out> out(count);
+
+            return Pass {
+                [=]() mutable {
+                    for(std::size_t i = 0u; i < count; ++i) {
+                        out[i] = op(a[i], b[i]);
+                    }
+                    do_not_optimize(out.data());
+                },
+                count * (2u * sizeof(In) + sizeof(Out))
+            };
+        }
+    };
+}
+
+// =============================================================================
+// Each file of benchmarks adds its own to the list
+void add_vector_benchmarks(std::vector<Benchmark> &benchmarks);
+void add_batch_benchmarks(std::vector<Benchmark> &benchmarks);
+void add_parallel_benchmarks(std::vector<Benchmark> &benchmarks);
+void add_expression_benchmarks(std::vector<Benchmark> &benchmarks);
+void add_geometry_benchmarks(std::vector<Benchmark> &benchmarks);
+void add_fused_benchmarks(std::vector<Benchmark> &benchmarks);
+void add_format_benchmarks(std::vector<Benchmark> &benchmarks);
+void add_vec_file_benchmarks(std::vector<Benchmark> &benchmarks);
+void add_arena_benchmarks(std::vector<Benchmark> &benchmarks);
+
+// Times every benchmark that matches options.filter at each size, printing a
+// table as it goes
+[[nodiscard]] std::vector<Result> run(std::vector<Benchmark> const &benchmarks,
+                                      Options const &options);
+
+// Writes results, along with the build configuration, as JSON
+void write_json(std::ostream &out, std::vector<Result> const &results);
+
+} // namespace btx::math::bench
+
+#endif // BRASSTACKS_MATH_BENCH_HARNESS_HPP
\ No newline at end of file
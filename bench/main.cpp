@@ -0,0 +1,99 @@
+#include "bench/harness.hpp"
+
+#include <charconv>
+#include <fstream>
+
+using namespace btx::math;
+
+namespace {
+
+void print_usage(char const *program) {
+    std::cout
+        << "Usage: " << program << " [options]\n"
+        << "  --filter <text>     Only run benchmarks with text in their name\n"
+        << "  --json <path>       Also write the results to path as JSON\n"
+        << "  --min-time <secs>   Time spent measuring each size (default "
+        << bench::Options { }.min_time << ")\n"
+        << "  --max-size <count>  Skip sizes above count elements\n"
+        << "  --list              Print the benchmark names and exit\n";
+}
+
+template <typename T>
+bool parse(std::string_view const text, T &value) {
+    auto const [end, error] =
+        std::from_chars(text.data(), text.data() + text.size(), value);
+    return error == std::errc { } && end == text.data() + text.size();
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    bench::Options options;
+    bool list_only = false;
+
+    for(int i = 1; i < argc; ++i) {
+        std::string_view const arg = argv[i];
+        char const *value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if(arg == "--list") {
+            list_only = true;
+            continue;
+        }
+
+        bool valid = value != nullptr;
+        if(valid && arg == "--filter") {
+            options.filter = value;
+        }
+        else if(valid && arg == "--json") {
+            options.json_path = value;
+        }
+        else if(valid && arg == "--min-time") {
+            valid = parse(value, options.min_time);
+        }
+        else if(valid && arg == "--max-size") {
+            valid = parse(value, options.max_size);
+        }
+        else {
+            valid = false;
+        }
+
+        if(!valid) {
+            print_usage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+
+        ++i;
+    }
+
+    std::vector<bench::Benchmark> benchmarks;
+    bench::add_vector_benchmarks(benchmarks);
+    bench::add_batch_benchmarks(benchmarks);
+    bench::add_parallel_benchmarks(benchmarks);
+    bench::add_expression_benchmarks(benchmarks);
+    bench::add_geometry_benchmarks(benchmarks);
+    bench::add_fused_benchmarks(benchmarks);
+    bench::add_format_benchmarks(benchmarks);
+    bench::add_vec_file_benchmarks(benchmarks);
+    bench::add_arena_benchmarks(benchmarks);
+
+    if(list_only) {
+        for(auto const &benchmark : benchmarks) {
+            std::cout << benchmark.name << '\n';
+        }
+        return 0;
+    }
+
+    auto const results = bench::run(benchmarks, options);
+
+    if(!options.json_path.empty()) {
+        std::ofstream file { options.json_path };
+        if(!file) {
+            std::cerr << "Couldn't open " << options.json_path << '\n';
+            return 1;
+        }
+
+        bench::write_json(file, results);
+    }
+
+    return 0;
+}
\ No newline at end of file
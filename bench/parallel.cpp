@@ -0,0 +1,80 @@
+#include "bench/harness.hpp"
+
+#include "brasstacks/math/parallel.hpp"
+
+#include <memory>
+#include <thread>
+
+namespace btx::math::bench {
+
+namespace {
+
+// The same kernels as in batch.cpp, at the detected SIMD level, spread over a
+// pool of the given size. One thread measures the cost of the pool itself.
+Benchmark parallel_transform(std::string name, std::size_t const threads) {
+    return {
+        std::move(name),
+        [threads](std::size_t const count) {
+            auto const pool = std::make_shared<ThreadPool>(threads);
+
+            Mat4 const m {
+                random_vector<Vec4>(), random_vector<Vec4>(),
+                random_vector<Vec4>(), random_vector<Vec4>()
+            };
+            std::vector<Vec4> v = random_vectors<Vec4>(count);
+            std::vector<Vec4> out(count);
+
+            return Pass {
+                [=]() mutable {
+                    transform(Parallel { 16384u, pool.get() }, m, v, out);
+                    do_not_optimize(out.data());
+                },
+                count * 2u * sizeof(Vec4)
+            };
+        }
+    };
+}
+
+Benchmark parallel_normalize(std::string name, std::size_t const threads) {
+    return {
+        std::move(name),
+        [threads](std::size_t const count) {
+            auto const pool = std::make_shared<ThreadPool>(threads);
+
+            Vec4Array v { random_vectors<Vec4>(count) };
+            Vec4Array out { count };
+
+            return Pass {
+                [=]() mutable {
+                    normalize(Parallel { 16384u, pool.get() }, v, out);
+                    do_not_optimize(out.lane(0u));
+                },
+                count * 2u * sizeof(Vec4)
+            };
+        }
+    };
+}
+
+} // namespace
+
+void add_parallel_benchmarks(std::vector<Benchmark> &benchmarks) {
+    std::size_t const hardware =
+        std::max(std::thread::hardware_concurrency(), 1u);
+
+    for(std::size_t const threads : { std::size_t { 1u }, hardware }) {
+        std::string suffix = "/";
+        suffix += std::to_string(threads);
+
+        benchmarks.push_back(
+            parallel_transform("parallel/transform/Vec4" + suffix, threads));
+        benchmarks.push_back(
+            parallel_normalize("Vec4Array/parallel_normalize" + suffix,
+                               threads));
+
+        if(hardware == 1u) {
+            break;
+        }
+    }
+}
+
+} // namespace btx::math::bench
\ No newline at end of file
@@ -0,0 +1,172 @@
+#include "bench/harness.hpp"
+
+#include "brasstacks/math/format.hpp"
+#include "brasstacks/math/VecFile.hpp"
+#include "brasstacks/math/stream.hpp"
+
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+namespace btx::math::bench {
+
+namespace {
+
+// Loading a point cloud at startup, from text and from a vector file. The
+// files are written once during setup, so they're in the page cache and
+// these measure the CPU side of loading rather than the disk.
+
+// A file in the temporary directory, removed when the pass that reads it is
+// done with it
+struct TempFile {
+    std::filesystem::path path;
+
+    explicit TempFile(std::string const &name) :
+        path { std::filesystem::temp_directory_path()
+               / ("btx_math_bench_" + name) }
+    { }
+
+    ~TempFile() {
+        std::error_code ignored;
+        std::filesystem::remove(path, ignored);
+    }
+
+    TempFile(TempFile const &) = delete;
+    TempFile & operator=(TempFile const &) = delete;
+};
+
+// Reads the whole file, then parses it with from_chars()
+Benchmark load_text(std::string name) {
+    return {
+        std::move(name),
+        [](std::size_t const count) {
+            std::vector<Vec3> const points = random_vectors<Vec3>(count);
+
+            std::string text(count * (max_chars<Vec3> + 1u), '\0');
+            auto const written =
+                to_chars(text.data(), text.data() + text.size(), points);
+            text.resize(static_cast<std::size_t>(written.ptr - text.data()));
+
+            auto const file = std::make_shared<TempFile>("points.txt");
+            std::ofstream { file->path, std::ios::binary } << text;
+
+            return Pass {
+                [file, count]() {
+                    std::ifstream in { file->path, std::ios::binary };
+                    std::stringstream contents;
+                    contents << in.rdbuf();
+                    std::string const text = std::move(contents).str();
+
+                    std::vector<Vec3> points(count);
+                    auto const result = from_chars(
+                        text.data(), text.data() + text.size(), points);
+                    do_not_optimize(&result);
+                    do_not_optimize(points.data());
+                },
+                count * sizeof(Vec3)
+            };
+        }
+    };
+}
+
+// Maps the file and copies the vectors out, or only maps it and checks the
+// checksum, which touches every page just the same
+Benchmark load_vec_file(std::string name, bool const verify) {
+    return {
+        std::move(name),
+        [verify](std::size_t const count) {
+            auto const file = std::make_shared<TempFile>("points.vecs");
+            static_cast<void>(write_vec_file(file->path,
+                                             random_vectors<Vec3>(count)));
+
+            return Pass {
+                [file, verify]() {
+                    VecFile vectors;
+                    static_cast<void>(vectors.open(file->path));
+
+                    if(verify) {
+                        auto const error = vectors.verify();
+                        do_not_optimize(&error);
+                    }
+                    else {
+                        auto const view = vectors.vectors<Vec3>();
+                        std::vector<Vec3> points(view.begin(), view.end());
+                        do_not_optimize(points.data());
+                    }
+                },
+                count * sizeof(Vec3)
+            };
+        }
+    };
+}
+
+// Transforms a file into another one a chunk at a time, with reads and writes
+// overlapping the math through a Pipeline, or the same chunks one step after
+// another on one thread
+Benchmark stream_file(std::string name, bool const overlap) {
+    return {
+        std::move(name),
+        [overlap](std::size_t const count) {
+            auto const in = std::make_shared<TempFile>("stream_in.vecs");
+            auto const out = std::make_shared<TempFile>("stream_out.vecs");
+            static_cast<void>(write_vec_file(in->path,
+                                             random_vectors<Vec3>(count)));
+
+            Mat4 const m {
+                Vec4(0.0f, 1.0f, 0.0f, 0.0f), Vec4(-1.0f, 0.0f, 0.0f, 0.0f),
+                Vec4(0.0f, 0.0f, 1.0f, 0.0f), Vec4(1.0f, 2.0f, 3.0f, 1.0f),
+            };
+
+            return Pass {
+                [in, out, m, overlap]() {
+                    std::size_t constexpr chunk = 1u << 14u;
+
+                    VecFileReader reader;
+                    VecFileWriter writer;
+                    static_cast<void>(reader.open(in->path));
+                    static_cast<void>(writer.open<Vec3>(out->path));
+
+                    AABB box = AABB::empty;
+                    if(overlap) {
+                        auto const stats = Pipeline { chunk }
+                            .transform(m).bounds(box).normalize()
+                            .run(reader, writer);
+                        do_not_optimize(&stats);
+                    }
+                    else {
+                        std::vector<Vec3> points(chunk);
+                        while(std::size_t const read =
+                                  reader.read(std::span { points }))
+                        {
+                            std::span<Vec3> const span { points.data(),
+                                                         read };
+                            transform_points(m, span, span);
+                            for(auto const &p : span) {
+                                box = merge(box, p);
+                            }
+                            normalize(span, span);
+                            static_cast<void>(writer.write(
+                                std::span<Vec3 const> { span }));
+                        }
+                    }
+
+                    static_cast<void>(writer.close());
+                    do_not_optimize(&box);
+                },
+                count * sizeof(Vec3)
+            };
+        }
+    };
+}
+
+} // namespace
+
+void add_vec_file_benchmarks(std::vector<Benchmark> &benchmarks) {
+    benchmarks.push_back(load_text("load/text/Vec3"));
+    benchmarks.push_back(load_vec_file("load/vec_file/Vec3", false));
+    benchmarks.push_back(load_vec_file("load/vec_file_verify/Vec3", true));
+    benchmarks.push_back(stream_file("stream/sequential/Vec3", false));
+    benchmarks.push_back(stream_file("stream/pipeline/Vec3", true));
+}
+
+} // namespace btx::math::bench
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "bench/harness.hpp"
+
+namespace btx::math::bench {
+
+namespace {
+
+// Operators from Vec2.cpp, Vec3.cpp, and Vec4.cpp, which are the same for
+// every vector type
+template <typename Vector>
+void add_operators(std::vector<Benchmark> &benchmarks,
+                   std::string const &type)
+{
+    benchmarks.push_back(binary<Vector, Vector>(type + "/add",
+        [](Vector const &a, Vector const &b) { return a + b; }));
+
+    benchmarks.push_back(binary<Vector, Vector>(type + "/sub",
+        [](Vector const &a, Vector const &b) { return a - b; }));
+
+    benchmarks.push_back(unary<Vector, Vector>(type + "/negate",
+        [](Vector const &a) { return -a; }));
+
+    benchmarks.push_back(unary<Vector, Vector>(type + "/scale",
+        [](Vector const &a) { return a * 1.5f; }));
+
+    benchmarks.push_back(unary<Vector, Vector>(type + "/divide",
+        [](Vector const &a) { return a / 1.5f; }));
+
+    benchmarks.push_back(binary<Vector, Vector>(type + "/add_assign",
+        [](Vector a, Vector const &b) { return a += b; }));
+
+    benchmarks.push_back(unary<Vector, Vector>(type + "/scale_assign",
+        [](Vector a) { return a *= 1.5f; }));
+
+    benchmarks.push_back(binary<Vector, uint8_t>(type + "/equal",
+        [](Vector const &a, Vector const &b) { return a == b; }));
+}
+
+// Free functions from math.hpp and math.cpp
+template <typename Vector>
+void add_functions(std::vector<Benchmark> &benchmarks,
+                   std::string const &type)
+{
+    benchmarks.push_back(binary<Vector, float>(type + "/dot",
+        [](Vector const &a, Vector const &b) { return dot(a, b); }));
+
+    benchmarks.push_back(unary<Vector, float>(type + "/length_squared",
+        [](Vector const &a) { return length_squared(a); }));
+
+    benchmarks.push_back(unary<Vector, float>(type + "/length",
+        [](Vector const &a) { return length(a); }));
+
+    benchmarks.push_back(unary<Vector, Vector>(type + "/normalize",
+        [](Vector const &a) { return normalize(a); }));
+}
+
+Mat4 random_mat4() {
+    return {
+        random_vector<Vec4>(), random_vector<Vec4>(),
+        random_vector<Vec4>(), random_vector<Vec4>(),
+    };
+}
+
+} // namespace
+
+void add_vector_benchmarks(std::vector<Benchmark> &benchmarks) {
+    add_operators<Vec2>(benchmarks, "Vec2");
+    add_functions<Vec2>(benchmarks, "Vec2");
+
+    add_operators<Vec3>(benchmarks, "Vec3");
+    add_functions<Vec3>(benchmarks, "Vec3");
+    benchmarks.push_back(binary<Vec3, Vec3>("Vec3/cross",
+        [](Vec3 const &a, Vec3 const &b) { return cross(a, b); }));
+
+    // With BTX_MATH_SIMD these are the SSE implementations
+    add_operators<Vec4>(benchmarks, "Vec4");
+    add_functions<Vec4>(benchmarks, "Vec4");
+
+    // Mat4 and the matrix functions from math.hpp
+    benchmarks.push_back(binary<Vec4, Vec4>("Mat4/transform",
+        [m = random_mat4()](Vec4 const &a, Vec4 const &) { return m * a; }));
+
+    benchmarks.push_back(binary<Vec4, Mat4>("Mat4/multiply",
+        [m = random_mat4()](Vec4 const &a, Vec4 const &b) {
+            return m * Mat4 { a, b, a, b };
+        }));
+
+    benchmarks.push_back(unary<Vec4, Mat4>("Mat4/transpose",
+        [m = random_mat4()](Vec4 const &a) {
+            return transpose(Mat4 { a, m.y, m.z, m.w });
+        }));
+
+    benchmarks.push_back(unary<Vec4, Mat4>("Mat4/inverse",
+        [m = random_mat4()](Vec4 const &a) {
+            return inverse(Mat4 { a, m.y, m.z, m.w });
+        }));
+
+    benchmarks.push_back(unary<Vec4, Mat4>("Mat4/inverse_affine",
+        [m = random_mat4()](Vec4 const &a) {
+            return inverse_affine(Mat4 { a, m.y, m.z, Vec4::unit_w });
+        }));
+
+    // Quat and the quaternion functions from math.hpp
+    benchmarks.push_back(binary<Quat, Quat>("Quat/multiply",
+        [](Quat const &a, Quat const &b) { return a * b; }));
+
+    benchmarks.push_back(unary<Vec3, Vec3>("Quat/rotate",
+        [q = random_vector<Quat>()](Vec3 const &v) { return rotate(q, v); }));
+
+    benchmarks.push_back(binary<Quat, Quat>("Quat/nlerp",
+        [](Quat const &a, Quat const &b) { return nlerp(a, b, 0.3f); }));
+
+    benchmarks.push_back(binary<Quat, Quat>("Quat/slerp",
+        [](Quat const &a, Quat const &b) { return slerp(a, b, 0.3f); }));
+}
+
+} // namespace btx::math::bench
\ No newline at end of file
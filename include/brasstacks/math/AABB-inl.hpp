@@ -0,0 +1,135 @@
+#ifndef BRASSTACKS_MATH_AABB_INL_HPP
+#define BRASSTACKS_MATH_AABB_INL_HPP
+
+#include "brasstacks/math/AABB.hpp"
+
+namespace btx::math {
+
+// =============================================================================
+BTX_MATH_CONSTEXPR AABB::AABB(Vec3 const &min, Vec3 const &max) :
+    min { min },
+    max { max }
+{ }
+
+// =============================================================================
+BTX_MATH_CONSTEXPR AABB merge(AABB const &a, AABB const &b) {
+    return {
+        { std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y),
+          std::min(a.min.z, b.min.z) },
+        { std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y),
+          std::max(a.max.z, b.max.z) },
+    };
+}
+
+BTX_MATH_CONSTEXPR AABB merge(AABB const &box, Vec3 const &p) {
+    return merge(box, AABB { p, p });
+}
+
+BTX_MATH_CONSTEXPR AABB intersection(AABB const &a, AABB const &b) {
+    return {
+        { std::max(a.min.x, b.min.x), std::max(a.min.y, b.min.y),
+          std::max(a.min.z, b.min.z) },
+        { std::min(a.max.x, b.max.x), std::min(a.max.y, b.max.y),
+          std::min(a.max.z, b.max.z) },
+    };
+}
+
+// =============================================================================
+BTX_MATH_CONSTEXPR bool is_empty(AABB const &box) {
+    return box.min.x > box.max.x || box.min.y > box.max.y ||
+           box.min.z > box.max.z;
+}
+
+BTX_MATH_CONSTEXPR Vec3 center(AABB const &box) {
+    return (box.min + box.max) * 0.5f;
+}
+
+BTX_MATH_CONSTEXPR Vec3 extent(AABB const &box) {
+    return box.max - box.min;
+}
+
+BTX_MATH_CONSTEXPR float surface_area(AABB const &box) {
+    if(is_empty(box)) {
+        return 0.0f;
+    }
+
+    Vec3 const e = extent(box);
+    return 2.0f * ((e.x * e.y) + (e.y * e.z) + (e.z * e.x));
+}
+
+// =============================================================================
+BTX_MATH_CONSTEXPR bool overlaps(AABB const &a, AABB const &b) {
+    return a.min.x <= b.max.x && b.min.x <= a.max.x &&
+           a.min.y <= b.max.y && b.min.y <= a.max.y &&
+           a.min.z <= b.max.z && b.min.z <= a.max.z;
+}
+
+BTX_MATH_CONSTEXPR bool contains(AABB const &box, Vec3 const &p) {
+    return box.min.x <= p.x && p.x <= box.max.x &&
+           box.min.y <= p.y && p.y <= box.max.y &&
+           box.min.z <= p.z && p.z <= box.max.z;
+}
+
+BTX_MATH_CONSTEXPR bool contains(AABB const &outer, AABB const &inner) {
+    return outer.min.x <= inner.min.x && inner.max.x <= outer.max.x &&
+           outer.min.y <= inner.min.y && inner.max.y <= outer.max.y &&
+           outer.min.z <= inner.min.z && inner.max.z <= outer.max.z;
+}
+
+BTX_MATH_CONSTEXPR std::optional<float> intersect(Ray const &ray,
+                                                  AABB const &box,
+                                                  float const max_distance)
+{
+    // Narrow [near, far] down to the part of the ray inside each pair of
+    // faces in turn
+    float near = 0.0f;
+    float far  = max_distance;
+
+    for(uint8_t c = 0u; c < 3u; ++c) {
+        float const origin = ray.origin[c];
+
+        // Dividing by zero would give infinities, which -ffast-math builds
+        // assume never happen
+        if(ray.direction[c] == 0.0f) {
+            if(origin < box.min[c] || origin > box.max[c]) {
+                return std::nullopt;
+            }
+            continue;
+        }
+
+        float const inverse = 1.0f / ray.direction[c];
+        float const t0 = (box.min[c] - origin) * inverse;
+        float const t1 = (box.max[c] - origin) * inverse;
+
+        near = std::max(near, std::min(t0, t1));
+        far  = std::min(far, std::max(t0, t1));
+    }
+
+    if(near > far) {
+        return std::nullopt;
+    }
+
+    return near;
+}
+
+// =============================================================================
+BTX_MATH_INLINE std::ostream & operator<<(std::ostream& out, AABB const& box) {
+    out << box.min << " to " << box.max;
+    return out;
+}
+
+#if defined(BTX_MATH_HEADER_ONLY)
+// =============================================================================
+// In header-only mode, the constant is defined here instead of in AABB.cpp
+inline constexpr AABB AABB::empty {
+    { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+      std::numeric_limits<float>::max() },
+    { std::numeric_limits<float>::lowest(),
+      std::numeric_limits<float>::lowest(),
+      std::numeric_limits<float>::lowest() },
+};
+#endif
+
+} // namespace btx::math
+
+#endif // BRASSTACKS_MATH_AABB_INL_HPP
\ No newline at end of file
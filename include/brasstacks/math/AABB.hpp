@@ -0,0 +1,90 @@
+#ifndef BRASSTACKS_MATH_AABB_HPP
+#define BRASSTACKS_MATH_AABB_HPP
+
+#include "brasstacks/math/common.hpp"
+#include "brasstacks/math/Vec.hpp"
+
+#include <optional>
+
+namespace btx::math {
+
+// An axis-aligned bounding box, the points p with min <= p <= max in every
+// component. Boxes are closed, so two that only share a face still overlap,
+// and a box with min == max holds a single point.
+struct AABB {
+    // Inside out, with min at the largest float and max at the lowest, so it
+    // contains nothing and merging anything into it gives that thing back.
+    // Start from this, rather than the default box at the origin, when
+    // growing a box around a set of points.
+    static AABB const empty;
+
+// =============================================================================
+    Vec3 min;
+    Vec3 max;
+
+// =============================================================================
+    AABB() = default;
+    ~AABB() = default;
+
+    BTX_MATH_CONSTEXPR AABB(Vec3 const &min, Vec3 const &max);
+
+    AABB(AABB &&) = default;
+    AABB(AABB const &) = default;
+
+    AABB & operator=(AABB &&) = default;
+    AABB & operator=(AABB const &) = default;
+};
+
+// A half-line starting at origin. direction doesn't have to be unit length,
+// but distances along the ray are measured in multiples of it.
+struct Ray {
+    Vec3 origin;
+    Vec3 direction;
+};
+
+// =============================================================================
+// Construction
+// The smallest box holding both arguments, the union of the two boxes
+[[nodiscard]] BTX_MATH_CONSTEXPR AABB merge(AABB const &a, AABB const &b);
+[[nodiscard]] BTX_MATH_CONSTEXPR AABB merge(AABB const &box, Vec3 const &p);
+
+// The box where a and b overlap, which is empty when they don't
+[[nodiscard]] BTX_MATH_CONSTEXPR AABB intersection(AABB const &a,
+                                                   AABB const &b);
+
+// =============================================================================
+// Measurements
+// True when min > max in some component, as with AABB::empty
+[[nodiscard]] BTX_MATH_CONSTEXPR bool is_empty(AABB const &box);
+
+[[nodiscard]] BTX_MATH_CONSTEXPR Vec3 center(AABB const &box);
+[[nodiscard]] BTX_MATH_CONSTEXPR Vec3 extent(AABB const &box);
+
+// The area of all six faces, which the BVH builder uses to estimate how
+// likely a random ray is to hit the box. Empty boxes have none.
+[[nodiscard]] BTX_MATH_CONSTEXPR float surface_area(AABB const &box);
+
+// =============================================================================
+// Tests
+[[nodiscard]] BTX_MATH_CONSTEXPR bool overlaps(AABB const &a, AABB const &b);
+[[nodiscard]] BTX_MATH_CONSTEXPR bool contains(AABB const &box,
+                                               Vec3 const &p);
+[[nodiscard]] BTX_MATH_CONSTEXPR bool contains(AABB const &outer,
+                                               AABB const &inner);
+
+// The slab test: how far along the ray it enters the box, or 0 when it
+// starts inside, as long as that's no further than max_distance. Rays
+// parallel to a pair of faces hit only when the origin lies between them.
+[[nodiscard]] BTX_MATH_CONSTEXPR std::optional<float>
+intersect(Ray const &ray, AABB const &box,
+          float max_distance = std::numeric_limits<float>::max());
+
+BTX_MATH_INLINE std::ostream & operator<<(std::ostream& out, AABB const& box);
+
+} // namespace btx::math
+
+#if defined(BTX_MATH_HEADER_ONLY)
+    #include "brasstacks/math/AABB-inl.hpp"
+#endif
+
+#endif // BRASSTACKS_MATH_AABB_HPP
\ No newline at end of file
@@ -0,0 +1,180 @@
+#ifndef BRASSTACKS_MATH_ARENA_HPP
+#define BRASSTACKS_MATH_ARENA_HPP
+
+#include "brasstacks/math/common.hpp"
+
+#include <memory>
+#include <memory_resource>
+
+namespace btx::math {
+
+// A linear allocator over one fixed block, for scratch memory that lives no
+// longer than a frame. Allocating bumps an offset, freeing one allocation
+// does nothing, and everything allocated since a mark() is freed at once by
+// rewinding to it. reset() at the top of each frame rewinds to the start.
+//
+// Nothing is constructed or destroyed, so whatever lives in the arena must be
+// trivially destructible or destroyed by its owner before a rewind. An arena
+// isn't thread-safe: give each thread its own.
+class Arena {
+public:
+    // Where the arena was at some point, to rewind() to later
+    struct Marker {
+        std::size_t offset = 0u;
+    };
+
+    // Rewinds the arena to where it was when the scope started, once the
+    // scope ends
+    class Scope {
+    public:
+        explicit Scope(Arena &arena) :
+            _arena  { &arena },
+            _marker { arena.mark() }
+        { }
+
+        ~Scope() { _arena->rewind(_marker); }
+
+        Scope(Scope &&) = delete;
+        Scope(Scope const &) = delete;
+
+        Scope & operator=(Scope &&) = delete;
+        Scope & operator=(Scope const &) = delete;
+
+    private:
+        Arena  *_arena;
+        Marker  _marker;
+    };
+
+    // Owned blocks start on a cache line, like VecArray's lanes
+    static std::size_t constexpr block_alignment = 64u;
+
+// =============================================================================
+    // bytes aligned to alignment, a power of two, or nullptr when there isn't
+    // room left
+    [[nodiscard]] void * allocate(
+        std::size_t bytes,
+        std::size_t alignment = alignof(std::max_align_t)
+    );
+
+    // count default-initialized Ts, which for the vector types means left
+    // uninitialized. Empty when there isn't room.
+    template <typename T>
+        requires std::is_trivially_destructible_v<T>
+    [[nodiscard]] std::span<T> allocate(std::size_t count);
+
+    [[nodiscard]] Marker mark() const { return { _used }; }
+
+    // Frees everything allocated since marker was taken. Markers taken since
+    // then become invalid, and rewinding to one is undefined.
+    void rewind(Marker marker);
+
+    // Frees everything, for the start of a frame
+    void reset() { _used = 0u; }
+
+    // Whether p points into the arena's block
+    [[nodiscard]] bool owns(void const *p) const;
+
+// =============================================================================
+    [[nodiscard]] std::size_t capacity() const { return _capacity; }
+    [[nodiscard]] std::size_t used()     const { return _used; }
+
+    // The most that was ever in use at once, padding included, which is how
+    // big the arena needs to be for the same work
+    [[nodiscard]] std::size_t peak() const { return _peak; }
+
+// =============================================================================
+    Arena() = delete;
+    ~Arena();
+
+    // A block of capacity bytes of the arena's own
+    explicit Arena(std::size_t capacity);
+
+    // The caller's memory, which must outlive the arena
+    explicit Arena(std::span<std::byte> buffer);
+
+    Arena(Arena &&) = delete;
+    Arena(Arena const &) = delete;
+
+    Arena & operator=(Arena &&) = delete;
+    Arena & operator=(Arena const &) = delete;
+
+private:
+    std::byte   *_data     = nullptr;
+    std::size_t  _capacity = 0u;
+    std::size_t  _used     = 0u;
+    std::size_t  _peak     = 0u;
+    bool         _owned    = false;
+};
+
+// =============================================================================
+// An Arena as a std::pmr::memory_resource, for std::pmr containers and the
+// library calls that take a scratch resource. Allocations that don't fit go
+// to upstream instead, and are freed back to it as usual, so running out of
+// room costs speed rather than failing. Make upstream
+// std::pmr::null_memory_resource() to throw std::bad_alloc instead.
+class ArenaResource : public std::pmr::memory_resource {
+public:
+    explicit ArenaResource(
+        Arena &arena,
+        std::pmr::memory_resource *upstream = std::pmr::get_default_resource()
+    );
+
+    [[nodiscard]] Arena & arena() const { return *_arena; }
+    [[nodiscard]] std::pmr::memory_resource * upstream() const {
+        return _upstream;
+    }
+
+private:
+    Arena                     *_arena;
+    std::pmr::memory_resource *_upstream;
+
+    void * do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void *p, std::size_t bytes,
+                       std::size_t alignment) override;
+    [[nodiscard]] bool do_is_equal(
+        std::pmr::memory_resource const &other
+    ) const noexcept override;
+};
+
+// =============================================================================
+inline void * Arena::allocate(std::size_t const bytes,
+                              std::size_t const alignment)
+{
+    assert(std::has_single_bit(alignment));
+
+    // Aligning the address rather than the offset, which handles alignments
+    // larger than the block's own
+    auto const address = reinterpret_cast<std::uintptr_t>(_data + _used);
+    std::size_t const padding = (0u - address) & (alignment - 1u);
+
+    std::size_t const free = _capacity - _used;
+    if(padding > free || bytes > free - padding) {
+        return nullptr;
+    }
+
+    void *const p = _data + _used + padding;
+    _used += padding + bytes;
+    _peak = std::max(_peak, _used);
+    return p;
+}
+
+template <typename T>
+    requires std::is_trivially_destructible_v<T>
+std::span<T> Arena::allocate(std::size_t const count) {
+    if(count > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+        return { };
+    }
+
+    void *const p = allocate(count * sizeof(T), alignof(T));
+    if(p == nullptr) {
+        return { };
+    }
+
+    T *const first = static_cast<T *>(p);
+    std::uninitialized_default_construct_n(first, count);
+    return { first, count };
+}
+
+} // namespace btx::math
+
+#endif // BRASSTACKS_MATH_ARENA_HPP
\ No newline at end of file
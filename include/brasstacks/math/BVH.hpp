@@ -0,0 +1,120 @@
+#ifndef BRASSTACKS_MATH_BVH_HPP
+#define BRASSTACKS_MATH_BVH_HPP
+
+#include "brasstacks/math/common.hpp"
+#include "brasstacks/math/AABB.hpp"
+#include "brasstacks/math/parallel.hpp"
+
+#include <memory_resource>
+#include <vector>
+
+namespace btx::math {
+
+// A bounding volume hierarchy over a fixed set of boxes, for finding which
+// of them a ray hits or a box overlaps without testing every one.
+//
+// Building splits each node's boxes in two along whichever of up to 16 evenly
+// spaced planes per axis gives the lowest surface area heuristic (SAH) cost,
+// the expected cost of tracing a random ray through the result, and stops
+// once splitting costs more than testing the boxes directly. The nodes live
+// in one flat array, with the two children of every interior node next to
+// each other.
+//
+// A built BVH is never modified, so any number of threads can query it at
+// once.
+class BVH {
+public:
+    struct Node {
+        AABB bounds;
+
+        // Leaves: where their boxes start in indices(). Interior nodes: the
+        // left child, with the right one at first + 1.
+        uint32_t first = 0u;
+
+        // How many boxes a leaf holds, or 0 for an interior node
+        uint32_t count = 0u;
+    };
+
+    // The nearest box a ray hits, if any
+    struct RayHit {
+        static uint32_t constexpr none = std::numeric_limits<uint32_t>::max();
+
+        uint32_t index    = none;   // Into the boxes the BVH was built from
+        float    distance = std::numeric_limits<float>::max();
+    };
+
+    // Leaves hold at most this many boxes, unless the boxes can't be split
+    // any further because their centers all coincide
+    static uint32_t constexpr default_max_leaf_size = 4u;
+
+// =============================================================================
+    [[nodiscard]] std::size_t size()  const { return _boxes.size(); }
+    [[nodiscard]] bool        empty() const { return _boxes.empty(); }
+
+    // Everything in the hierarchy, or AABB::empty when there's nothing
+    [[nodiscard]] AABB bounds() const;
+
+    [[nodiscard]] std::span<Node const> nodes() const { return _nodes; }
+
+    // The original index of each box, in leaf order
+    [[nodiscard]] std::span<uint32_t const> indices() const {
+        return _indices;
+    }
+
+// =============================================================================
+    // Appends the index of every box overlapping `box` to out, in no
+    // particular order
+    void overlapping(AABB const &box, std::vector<uint32_t> &out) const;
+
+    // The same for several query boxes at once. out is replaced by the
+    // results for each query in turn, the ones for queries[i] running from
+    // out[offsets[i]] up to out[offsets[i + 1]], so offsets needs room for
+    // queries.size() + 1 entries.
+    void overlapping(std::span<AABB const> queries,
+                     std::vector<uint32_t> &out,
+                     std::span<std::size_t> offsets) const;
+
+    // The first box along the ray, within max_distance, measured the same way
+    // as intersect() in AABB.hpp. Ties go to whichever box is found first.
+    [[nodiscard]] RayHit intersect(
+        Ray const &ray,
+        float max_distance = std::numeric_limits<float>::max()
+    ) const;
+
+    // hits[i] = intersect(rays[i]), optionally split across a thread pool
+    void intersect(std::span<Ray const> rays, std::span<RayHit> hits) const;
+    void intersect(Parallel const &policy, std::span<Ray const> rays,
+                   std::span<RayHit> hits) const;
+
+// =============================================================================
+    BVH() = default;
+    ~BVH() = default;
+
+    // boxes.size() must fit in a uint32_t. The working arrays the build
+    // throws away afterwards come from scratch, which can be an
+    // ArenaResource for a BVH rebuilt every frame.
+    explicit BVH(
+        std::span<AABB const> boxes,
+        uint32_t max_leaf_size = default_max_leaf_size,
+        std::pmr::memory_resource *scratch = std::pmr::get_default_resource()
+    );
+
+    BVH(BVH &&) = default;
+    BVH(BVH const &) = default;
+
+    BVH & operator=(BVH &&) = default;
+    BVH & operator=(BVH const &) = default;
+
+private:
+    std::vector<Node>     _nodes;
+    std::vector<uint32_t> _indices;
+
+    // The boxes themselves, in leaf order, so a leaf's boxes are contiguous
+    std::vector<AABB> _boxes;
+
+    void _build(uint32_t max_leaf_size, std::pmr::memory_resource *scratch);
+};
+
+} // namespace btx::math
+
+#endif // BRASSTACKS_MATH_BVH_HPP
\ No newline at end of file
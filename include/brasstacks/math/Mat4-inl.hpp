@@ -0,0 +1,146 @@
+#ifndef BRASSTACKS_MATH_MAT4_INL_HPP
+#define BRASSTACKS_MATH_MAT4_INL_HPP
+
+#include "brasstacks/math/Mat4.hpp"
+#include "brasstacks/math/simd.hpp"
+
+namespace btx::math {
+
+#if defined(BTX_MATH_SSE)
+namespace simd {
+
+// m * v for a v that's already in a register. Each column is scaled by the
+// matching component of v, and the sums happen in the same order as the
+// scalar code, so both paths give the same result.
+[[nodiscard]] inline __m128 transform(Mat4 const &m, __m128 const v) {
+    __m128 result = _mm_mul_ps(load(m.x), splat<0>(v));
+    result = _mm_add_ps(result, _mm_mul_ps(load(m.y), splat<1>(v)));
+    result = _mm_add_ps(result, _mm_mul_ps(load(m.z), splat<2>(v)));
+    result = _mm_add_ps(result, _mm_mul_ps(load(m.w), splat<3>(v)));
+    return result;
+}
+
+} // namespace simd
+#endif // BTX_MATH_SSE
+
+// =============================================================================
+BTX_MATH_CONSTEXPR bool Mat4::operator==(Mat4 const &other) const {
+    // Equal if every column is, within epsilon
+    return x == other.x && y == other.y && z == other.z && w == other.w;
+}
+
+BTX_MATH_CONSTEXPR Mat4 Mat4::operator+(Mat4 const &other) const {
+    return { x + other.x, y + other.y, z + other.z, w + other.w };
+}
+
+BTX_MATH_CONSTEXPR Mat4 Mat4::operator-(Mat4 const &other) const {
+    return { x - other.x, y - other.y, z - other.z, w - other.w };
+}
+
+BTX_MATH_CONSTEXPR Mat4 Mat4::operator*(Mat4 const &other) const {
+    // Column i of the product is this matrix applied to column i of other
+    return {
+        *this * other.x,
+        *this * other.y,
+        *this * other.z,
+        *this * other.w,
+    };
+}
+
+BTX_MATH_CONSTEXPR Vec4 Mat4::operator*(Vec4 const &v) const {
+#if defined(BTX_MATH_SSE)
+    if(BTX_MATH_IS_RUNTIME()) {
+        Vec4 result;
+        simd::store(result, simd::transform(*this, simd::load(v)));
+        return result;
+    }
+#endif
+
+    return {
+        (x.x * v.x) + (y.x * v.y) + (z.x * v.z) + (w.x * v.w),
+        (x.y * v.x) + (y.y * v.y) + (z.y * v.z) + (w.y * v.w),
+        (x.z * v.x) + (y.z * v.y) + (z.z * v.z) + (w.z * v.w),
+        (x.w * v.x) + (y.w * v.y) + (z.w * v.z) + (w.w * v.w),
+    };
+}
+
+BTX_MATH_CONSTEXPR Mat4 & Mat4::operator+=(Mat4 const &other) {
+    x += other.x;
+    y += other.y;
+    z += other.z;
+    w += other.w;
+
+    return *this;
+}
+
+BTX_MATH_CONSTEXPR Mat4 & Mat4::operator-=(Mat4 const &other) {
+    x -= other.x;
+    y -= other.y;
+    z -= other.z;
+    w -= other.w;
+
+    return *this;
+}
+
+BTX_MATH_CONSTEXPR Mat4 & Mat4::operator*=(Mat4 const &other) {
+    *this = *this * other;
+    return *this;
+}
+
+// =============================================================================
+BTX_MATH_CONSTEXPR Mat4 operator*(float scalar, Mat4 const &m) {
+    return { m.x * scalar, m.y * scalar, m.z * scalar, m.w * scalar };
+}
+
+BTX_MATH_CONSTEXPR Mat4 operator*(Mat4 const &m, float scalar) {
+    return { m.x * scalar, m.y * scalar, m.z * scalar, m.w * scalar };
+}
+
+// =============================================================================
+BTX_MATH_CONSTEXPR Mat4::Mat4(Vec4 const &x, Vec4 const &y, Vec4 const &z,
+                              Vec4 const &w) :
+    x { x },
+    y { y },
+    z { z },
+    w { w }
+{ }
+
+// =============================================================================
+BTX_MATH_INLINE std::ostream & operator<<(std::ostream& out, Mat4 const& m) {
+    out << std::fixed << std::setprecision(print_precs);
+
+    for(uint8_t row = 0u; row < 4u; ++row) {
+        if(row > 0u) {
+            out << "\n";
+        }
+
+        out << std::setw(print_width) << m.x[row] << " "
+            << std::setw(print_width) << m.y[row] << " "
+            << std::setw(print_width) << m.z[row] << " "
+            << std::setw(print_width) << m.w[row];
+    }
+
+    return out;
+}
+
+#if defined(BTX_MATH_HEADER_ONLY)
+// =============================================================================
+// In header-only mode, the constants are defined here instead of in math.cpp
+inline constexpr Mat4 Mat4::zero {
+    Vec4 { 0.0f, 0.0f, 0.0f, 0.0f },
+    Vec4 { 0.0f, 0.0f, 0.0f, 0.0f },
+    Vec4 { 0.0f, 0.0f, 0.0f, 0.0f },
+    Vec4 { 0.0f, 0.0f, 0.0f, 0.0f },
+};
+
+inline constexpr Mat4 Mat4::identity {
+    Vec4 { 1.0f, 0.0f, 0.0f, 0.0f },
+    Vec4 { 0.0f, 1.0f, 0.0f, 0.0f },
+    Vec4 { 0.0f, 0.0f, 1.0f, 0.0f },
+    Vec4 { 0.0f, 0.0f, 0.0f, 1.0f },
+};
+#endif
+
+} // namespace btx::math
+
+#endif // BRASSTACKS_MATH_MAT4_INL_HPP
\ No newline at end of file
@@ -0,0 +1,98 @@
+#ifndef BRASSTACKS_MATH_MAT4_HPP
+#define BRASSTACKS_MATH_MAT4_HPP
+
+#include "brasstacks/math/common.hpp"
+#include "brasstacks/math/simd.hpp"
+#include "brasstacks/math/Vec.hpp"
+
+namespace btx::math {
+
+// A 4x4 matrix stored column-major, as four Vec4 columns. Matrices multiply
+// column vectors on their right, so m * v transforms v, and (a * b) * v
+// applies b first, then a. With BTX_MATH_SIMD, each column is one SSE
+// register.
+struct Mat4 {
+    static Mat4 const zero;
+    static Mat4 const identity;
+
+// =============================================================================
+    Vec4 x; // First column, the image of the x axis
+    Vec4 y;
+    Vec4 z;
+    Vec4 w; // Last column, the translation for an affine transform
+
+// =============================================================================
+    // Column access
+    [[nodiscard]] constexpr Vec4 & operator[](uint8_t i);
+    [[nodiscard]] constexpr Vec4 const & operator[](uint8_t i) const;
+
+// =============================================================================
+    [[nodiscard]] BTX_MATH_CONSTEXPR bool operator==(Mat4 const &other) const;
+
+    [[nodiscard]] BTX_MATH_CONSTEXPR Mat4 operator+(Mat4 const &other) const;
+    [[nodiscard]] BTX_MATH_CONSTEXPR Mat4 operator-(Mat4 const &other) const;
+
+    [[nodiscard]] BTX_MATH_CONSTEXPR Mat4 operator*(Mat4 const &other) const;
+    [[nodiscard]] BTX_MATH_CONSTEXPR Vec4 operator*(Vec4 const &v) const;
+
+    BTX_MATH_CONSTEXPR Mat4 & operator+=(Mat4 const &other);
+    BTX_MATH_CONSTEXPR Mat4 & operator-=(Mat4 const &other);
+
+    // this = this * other
+    BTX_MATH_CONSTEXPR Mat4 & operator*=(Mat4 const &other);
+
+// =============================================================================
+    Mat4() = default;
+    ~Mat4() = default;
+
+    BTX_MATH_CONSTEXPR Mat4(Vec4 const &x, Vec4 const &y, Vec4 const &z,
+                            Vec4 const &w);
+
+    Mat4(Mat4 &&) = default;
+    Mat4(Mat4 const &) = default;
+
+    Mat4 & operator=(Mat4 &&) = default;
+    Mat4 & operator=(Mat4 const &) = default;
+};
+
+[[nodiscard]] BTX_MATH_CONSTEXPR Mat4 operator*(float scalar, Mat4 const &m);
+[[nodiscard]] BTX_MATH_CONSTEXPR Mat4 operator*(Mat4 const &m, float scalar);
+
+// Prints one row per line, so the output reads like the matrix on paper
+BTX_MATH_INLINE std::ostream & operator<<(std::ostream& out, Mat4 const& m);
+
+// =============================================================================
+constexpr Vec4 & Mat4::operator[](uint8_t i) {
+    if(std::is_constant_evaluated()) {
+        // Indexing past x isn't allowed during constant evaluation
+        switch(i) {
+            case 0: return x;
+            case 1: return y;
+            case 2: return z;
+            default: return w;
+        }
+    }
+
+    return ((&x)[i]);
+}
+
+constexpr Vec4 const & Mat4::operator[](uint8_t i) const {
+    if(std::is_constant_evaluated()) {
+        switch(i) {
+            case 0: return x;
+            case 1: return y;
+            case 2: return z;
+            default: return w;
+        }
+    }
+
+    return ((&x)[i]);
+}
+
+} // namespace btx::math
+
+#if defined(BTX_MATH_HEADER_ONLY)
+    #include "brasstacks/math/Mat4-inl.hpp"
+#endif
+
+#endif // BRASSTACKS_MATH_MAT4_HPP
\ No newline at end of file
@@ -0,0 +1,116 @@
+#ifndef BRASSTACKS_MATH_QUAT_INL_HPP
+#define BRASSTACKS_MATH_QUAT_INL_HPP
+
+#include "brasstacks/math/Quat.hpp"
+#include "brasstacks/math/simd.hpp"
+
+namespace btx::math {
+
+// =============================================================================
+BTX_MATH_CONSTEXPR bool Quat::operator==(Quat const &other) const {
+    return (
+        detail::abs(x - other.x) < epsilon &&
+        detail::abs(y - other.y) < epsilon &&
+        detail::abs(z - other.z) < epsilon &&
+        detail::abs(w - other.w) < epsilon
+    );
+}
+
+BTX_MATH_CONSTEXPR Quat Quat::operator+(Quat const &other) const {
+    return { x + other.x, y + other.y, z + other.z, w + other.w };
+}
+
+BTX_MATH_CONSTEXPR Quat Quat::operator-(Quat const &other) const {
+    return { x - other.x, y - other.y, z - other.z, w - other.w };
+}
+
+BTX_MATH_CONSTEXPR Quat Quat::operator-() const {
+    return { -x, -y, -z, -w };
+}
+
+BTX_MATH_CONSTEXPR Quat Quat::operator*(Quat const &other) const {
+#if defined(BTX_MATH_SSE)
+    if(BTX_MATH_IS_RUNTIME()) {
+        // Each output lane is a sum of four products. Lining up the factors
+        // of each term with shuffles gives four register-wide products,
+        // where only the w lane's middle two terms need their sign flipped.
+        __m128 const a = simd::load(*this);
+        __m128 const b = simd::load(other);
+
+        __m128 const flip_w = _mm_set_ps(-0.0f, 0.0f, 0.0f, 0.0f);
+
+        __m128 const t0 = _mm_mul_ps(simd::splat<3>(a), b);
+        __m128 const t1 = _mm_mul_ps(
+            _mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 2, 1, 0)),
+            _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 3, 3))
+        );
+        __m128 const t2 = _mm_mul_ps(
+            _mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 0, 2, 1)),
+            _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 1, 0, 2))
+        );
+        __m128 const t3 = _mm_mul_ps(
+            _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 1, 0, 2)),
+            _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 0, 2, 1))
+        );
+
+        __m128 result = _mm_add_ps(t0, _mm_xor_ps(t1, flip_w));
+        result = _mm_add_ps(result, _mm_xor_ps(t2, flip_w));
+        result = _mm_sub_ps(result, t3);
+
+        Quat product;
+        simd::store(product, result);
+        return product;
+    }
+#endif
+
+    // Terms are ordered to match the SSE path above
+    return {
+        (w * other.x) + (x * other.w) + (y * other.z) - (z * other.y),
+        (w * other.y) + (y * other.w) + (z * other.x) - (x * other.z),
+        (w * other.z) + (z * other.w) + (x * other.y) - (y * other.x),
+        (w * other.w) - (x * other.x) - (y * other.y) - (z * other.z),
+    };
+}
+
+BTX_MATH_CONSTEXPR Quat & Quat::operator*=(Quat const &other) {
+    *this = *this * other;
+    return *this;
+}
+
+// =============================================================================
+BTX_MATH_CONSTEXPR Quat operator*(float scalar, Quat const &q) {
+    return { q.x * scalar, q.y * scalar, q.z * scalar, q.w * scalar };
+}
+
+BTX_MATH_CONSTEXPR Quat operator*(Quat const &q, float scalar) {
+    return { q.x * scalar, q.y * scalar, q.z * scalar, q.w * scalar };
+}
+
+// =============================================================================
+BTX_MATH_CONSTEXPR Quat::Quat(float x, float y, float z, float w) :
+    x { x },
+    y { y },
+    z { z },
+    w { w }
+{ }
+
+// =============================================================================
+BTX_MATH_INLINE std::ostream & operator<<(std::ostream& out, Quat const& q) {
+    out << std::fixed << std::setprecision(print_precs)
+        << std::setw(print_width) << q.x << " "
+        << std::setw(print_width) << q.y << " "
+        << std::setw(print_width) << q.z << " "
+        << std::setw(print_width) << q.w;
+
+    return out;
+}
+
+#if defined(BTX_MATH_HEADER_ONLY)
+// =============================================================================
+// In header-only mode, the constants are defined here instead of in math.cpp
+inline constexpr Quat Quat::identity { 0.0f, 0.0f, 0.0f, 1.0f };
+#endif
+
+} // namespace btx::math
+
+#endif // BRASSTACKS_MATH_QUAT_INL_HPP
\ No newline at end of file
@@ -0,0 +1,100 @@
+#ifndef BRASSTACKS_MATH_QUAT_HPP
+#define BRASSTACKS_MATH_QUAT_HPP
+
+#include "brasstacks/math/common.hpp"
+#include "brasstacks/math/simd.hpp"
+#include "brasstacks/math/Vec.hpp"
+
+namespace btx::math {
+
+// A rotation, stored as the quaternion w + xi + yj + zk. Only unit
+// quaternions represent rotations, and q and -q represent the same one.
+// Products compose like matrices do: (a * b) rotates by b first, then a.
+struct BTX_MATH_SIMD_ALIGN Quat {
+    static Quat const identity;
+
+    // A rotation of `deg` degrees about axis, counterclockwise when looking
+    // down the axis toward the origin. The axis doesn't have to be unit
+    // length, but it can't be the zero vector.
+    [[nodiscard]] BTX_MATH_INLINE static Quat from_axis_angle(Vec3 const &axis,
+                                                              float deg);
+
+// =============================================================================
+    float x = 0.0f; // The vector part
+    float y = 0.0f;
+    float z = 0.0f;
+    float w = 1.0f; // The scalar part
+
+// =============================================================================
+    [[nodiscard]] constexpr float & operator[](uint8_t i);
+    [[nodiscard]] constexpr float   operator[](uint8_t i) const;
+
+// =============================================================================
+    // Compares components within epsilon, so q != -q here even though they
+    // rotate the same way
+    [[nodiscard]] BTX_MATH_CONSTEXPR bool operator==(Quat const &other) const;
+
+    [[nodiscard]] BTX_MATH_CONSTEXPR Quat operator+(Quat const &other) const;
+    [[nodiscard]] BTX_MATH_CONSTEXPR Quat operator-(Quat const &other) const;
+
+    [[nodiscard]] BTX_MATH_CONSTEXPR Quat operator-() const;
+
+    // The Hamilton product
+    [[nodiscard]] BTX_MATH_CONSTEXPR Quat operator*(Quat const &other) const;
+
+    // this = this * other
+    BTX_MATH_CONSTEXPR Quat & operator*=(Quat const &other);
+
+// =============================================================================
+    Quat() = default;
+    ~Quat() = default;
+
+    BTX_MATH_CONSTEXPR Quat(float x, float y, float z, float w);
+
+    Quat(Quat &&) = default;
+    Quat(Quat const &) = default;
+
+    Quat & operator=(Quat &&) = default;
+    Quat & operator=(Quat const &) = default;
+};
+
+[[nodiscard]] BTX_MATH_CONSTEXPR Quat operator*(float scalar, Quat const &q);
+[[nodiscard]] BTX_MATH_CONSTEXPR Quat operator*(Quat const &q, float scalar);
+
+BTX_MATH_INLINE std::ostream & operator<<(std::ostream& out, Quat const& q);
+
+// =============================================================================
+constexpr float & Quat::operator[](uint8_t i) {
+    if(std::is_constant_evaluated()) {
+        // Indexing past x isn't allowed during constant evaluation
+        switch(i) {
+            case 0: return x;
+            case 1: return y;
+            case 2: return z;
+            default: return w;
+        }
+    }
+
+    return ((&x)[i]);
+}
+
+constexpr float Quat::operator[](uint8_t i) const {
+    if(std::is_constant_evaluated()) {
+        switch(i) {
+            case 0: return x;
+            case 1: return y;
+            case 2: return z;
+            default: return w;
+        }
+    }
+
+    return ((&x)[i]);
+}
+
+} // namespace btx::math
+
+#if defined(BTX_MATH_HEADER_ONLY)
+    #include "brasstacks/math/Quat-inl.hpp"
+#endif
+
+#endif // BRASSTACKS_MATH_QUAT_HPP
\ No newline at end of file
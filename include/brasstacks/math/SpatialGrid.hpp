@@ -0,0 +1,438 @@
+#ifndef BRASSTACKS_MATH_SPATIALGRID_HPP
+#define BRASSTACKS_MATH_SPATIALGRID_HPP
+
+#include "brasstacks/math/common.hpp"
+#include "brasstacks/math/math.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace btx::math {
+
+// A uniform grid over a set of 2D or 3D positions, for finding the ones near
+// a point without checking every one. Space is cut into cubes of cell_size,
+// and each occupied cube hashes to one of a fixed number of buckets, so the
+// grid covers any extent without storing the empty cells.
+//
+// build() sorts the positions by bucket with a counting sort, which takes
+// linear time and leaves each bucket's positions contiguous. Its storage is
+// reused from one build to the next, so rebuilding every frame for moving
+// positions doesn't allocate once the grid has grown to fit them.
+//
+// Queries are fastest with the cell size close to the usual query radius.
+// Much smaller cells mean visiting many cells per query, and much larger
+// ones mean testing many positions that are too far away.
+template <typename Vector>
+class SpatialGrid {
+public:
+    static std::size_t constexpr dimensions = sizeof(Vector) / sizeof(float);
+    static_assert(dimensions == 2u || dimensions == 3u);
+
+    // A position found by nearest(), by its index into the built span
+    struct Neighbor {
+        uint32_t index            = 0u;
+        float    distance_squared = 0.0f;
+    };
+
+// =============================================================================
+    [[nodiscard]] float       cell_size()    const { return _cell_size; }
+    [[nodiscard]] std::size_t size()         const { return _indices.size(); }
+    [[nodiscard]] bool        empty()        const { return _indices.empty(); }
+    [[nodiscard]] std::size_t bucket_count() const {
+        return _starts.empty() ? 0u : _starts.size() - 1u;
+    }
+
+    // Replaces the contents with positions, which must number no more than
+    // a uint32_t can index. With no bucket count given to the constructor,
+    // there's one per position, rounded up to a power of two.
+    void build(std::span<Vector const> positions);
+
+// =============================================================================
+    // Appends the index of every position within radius of p, inclusive, to
+    // out in no particular order
+    void within(Vector const &p, float radius,
+                std::vector<uint32_t> &out) const;
+
+    // Fills out with the positions closest to p, up to out.size() of them
+    // and no further away than max_distance, nearest first. Returns how many
+    // were found.
+    std::size_t nearest(
+        Vector const &p, std::span<Neighbor> out,
+        float max_distance = std::numeric_limits<float>::max()
+    ) const;
+
+// =============================================================================
+    SpatialGrid() = delete;
+    ~SpatialGrid() = default;
+
+    // bucket_count is rounded up to a power of two, and 0 sizes the table to
+    // the positions on each build
+    explicit SpatialGrid(float cell_size, std::size_t bucket_count = 0u);
+
+    SpatialGrid(SpatialGrid &&) = default;
+    SpatialGrid(SpatialGrid const &) = default;
+
+    SpatialGrid & operator=(SpatialGrid &&) = default;
+    SpatialGrid & operator=(SpatialGrid const &) = default;
+
+private:
+    using Cell = std::array<int32_t, dimensions>;
+
+    float       _cell_size = 0.0f;
+    float       _inverse   = 0.0f;
+    std::size_t _requested = 0u;
+
+    // Where each bucket's positions start in the arrays below, plus one past
+    // the last bucket's end
+    std::vector<uint32_t> _starts;
+
+    // Sorted by bucket: each position's original index, the position itself
+    // and the cell it's in. Buckets can hold more than one cell, so queries
+    // check the cell before reporting a position.
+    std::vector<uint32_t> _indices;
+    std::vector<Vector>   _positions;
+    std::vector<Cell>     _cells;
+
+    // Each position's bucket during build(), kept to save reallocating it
+    std::vector<uint32_t> _buckets;
+
+    // The range of cells holding anything, which bounds nearest()'s search
+    Cell _lowest  { };
+    Cell _highest { };
+
+    [[nodiscard]] Cell     _cell_of(Vector const &p) const;
+    [[nodiscard]] uint32_t _bucket_of(Cell const &cell) const;
+
+    // Calls visit(position, index) for each position in the given cell
+    template <typename Visit>
+    void _for_each_in(Cell const &cell, Visit &&visit) const;
+
+    // The same for every occupied cell whose furthest coordinate from center
+    // is exactly ring cells away
+    template <typename Visit>
+    void _for_each_on_ring(Cell const &center, int32_t ring,
+                           Visit &&visit) const;
+};
+
+using SpatialGrid2 = SpatialGrid<Vec2>;
+using SpatialGrid3 = SpatialGrid<Vec3>;
+
+// =============================================================================
+template <typename Vector>
+SpatialGrid<Vector>::SpatialGrid(float const cell_size,
+                                 std::size_t const bucket_count) :
+    _cell_size { cell_size },
+    _inverse   { 1.0f / cell_size },
+    _requested { bucket_count }
+{
+    assert(cell_size > 0.0f);
+}
+
+// =============================================================================
+template <typename Vector>
+void SpatialGrid<Vector>::build(std::span<Vector const> positions) {
+    assert(positions.size() <= std::numeric_limits<uint32_t>::max());
+    auto const count = static_cast<uint32_t>(positions.size());
+
+    std::size_t const wanted = _requested > 0u ? _requested : count;
+    std::size_t buckets = 1u;
+    while(buckets < wanted) {
+        buckets *= 2u;
+    }
+
+    _starts.assign(buckets + 1u, 0u);
+    _indices.resize(count);
+    _positions.resize(count);
+    _cells.resize(count);
+    _buckets.resize(count);
+
+    _lowest.fill(std::numeric_limits<int32_t>::max());
+    _highest.fill(std::numeric_limits<int32_t>::min());
+
+    // Count the positions in each bucket...
+    for(uint32_t i = 0u; i < count; ++i) {
+        Cell const cell = _cell_of(positions[i]);
+        for(std::size_t c = 0u; c < dimensions; ++c) {
+            _lowest[c]  = std::min(_lowest[c], cell[c]);
+            _highest[c] = std::max(_highest[c], cell[c]);
+        }
+
+        _buckets[i] = _bucket_of(cell);
+        ++_starts[_buckets[i]];
+    }
+
+    // ...turn the counts into where each bucket ends...
+    for(std::size_t b = 1u; b < buckets; ++b) {
+        _starts[b] += _starts[b - 1u];
+    }
+    _starts[buckets] = count;
+
+    // ...and place each position, counting every bucket's end back down to
+    // its start. Going backwards keeps each bucket in the original order.
+    for(uint32_t i = count; i-- > 0u; ) {
+        uint32_t const slot = --_starts[_buckets[i]];
+        _indices[slot]   = i;
+        _positions[slot] = positions[i];
+        _cells[slot]     = _cell_of(positions[i]);
+    }
+}
+
+// =============================================================================
+template <typename Vector>
+void SpatialGrid<Vector>::within(Vector const &p, float const radius,
+                                 std::vector<uint32_t> &out) const
+{
+    if(empty() || radius < 0.0f) {
+        return;
+    }
+
+    float const radius_squared = radius * radius;
+    auto const test = [&](Vector const &position, uint32_t const index) {
+        if(length_squared(position - p) <= radius_squared) {
+            out.push_back(index);
+        }
+    };
+
+    Vector offset;
+    for(uint8_t c = 0u; c < dimensions; ++c) {
+        offset[c] = radius;
+    }
+    Cell low = _cell_of(p - offset);
+    Cell high = _cell_of(p + offset);
+
+    // No further than the occupied cells, and when that's still more cells
+    // than buckets, it's cheaper to test everything once
+    std::size_t cells = 1u;
+    for(std::size_t c = 0u; c < dimensions; ++c) {
+        low[c] = std::max(low[c], _lowest[c]);
+        high[c] = std::min(high[c], _highest[c]);
+        if(low[c] > high[c]) {
+            return;
+        }
+        cells *= static_cast<std::size_t>(high[c] - low[c]) + 1u;
+        cells = std::min(cells, bucket_count());
+    }
+
+    if(cells == bucket_count()) {
+        for(std::size_t i = 0u; i < _positions.size(); ++i) {
+            test(_positions[i], _indices[i]);
+        }
+        return;
+    }
+
+    Cell cell = low;
+    for(;;) {
+        _for_each_in(cell, test);
+
+        // Step to the next cell in the range, like an odometer
+        std::size_t c = 0u;
+        while(c < dimensions && cell[c] == high[c]) {
+            cell[c] = low[c];
+            ++c;
+        }
+        if(c == dimensions) {
+            return;
+        }
+        ++cell[c];
+    }
+}
+
+// =============================================================================
+template <typename Vector>
+std::size_t SpatialGrid<Vector>::nearest(Vector const &p,
+                                         std::span<Neighbor> out,
+                                         float const max_distance) const
+{
+    if(empty() || out.empty() || max_distance < 0.0f) {
+        return 0u;
+    }
+
+    // The best found so far, as a heap with the furthest on top
+    float const max_squared = max_distance * max_distance;
+    std::size_t found = 0u;
+    auto const further = [](Neighbor const &a, Neighbor const &b) {
+        return a.distance_squared < b.distance_squared;
+    };
+    auto const limit = [&] {
+        return found < out.size() ? max_squared : out[0].distance_squared;
+    };
+
+    auto const test = [&](Vector const &position, uint32_t const index) {
+        float const distance_squared = length_squared(position - p);
+        if(distance_squared > limit()) {
+            return;
+        }
+
+        if(found == out.size()) {
+            std::pop_heap(out.begin(), out.end(), further);
+            out[found - 1u] = { index, distance_squared };
+        }
+        else {
+            out[found++] = { index, distance_squared };
+        }
+        std::push_heap(out.begin(), out.begin() + found, further);
+    };
+
+    // Search outward in rings of cells around the one holding p, starting
+    // from the first that reaches anything. Once the rings reach ring cells
+    // out, nothing unvisited is closer than the nearest face of the cube
+    // they cover.
+    Cell const center = _cell_of(p);
+
+    int32_t first_ring = 0;
+    for(std::size_t c = 0u; c < dimensions; ++c) {
+        first_ring = std::max({ first_ring, _lowest[c] - center[c],
+                                center[c] - _highest[c] });
+    }
+
+    // Once the rings cover more cells than there are buckets or positions,
+    // visiting them costs more than testing everything once, as in within().
+    // Without this, one far outlier makes every ring up to it a search.
+    std::size_t const most_cells = std::min(bucket_count(), size());
+
+    for(int32_t ring = first_ring; ; ++ring) {
+        std::size_t cells = 1u;
+        for(std::size_t c = 0u; c < dimensions; ++c) {
+            cells *= static_cast<std::size_t>(
+                std::min(center[c] + ring, _highest[c])
+                - std::max(center[c] - ring, _lowest[c])
+            ) + 1u;
+            cells = std::min(cells, most_cells + 1u);
+        }
+
+        if(cells > most_cells) {
+            found = 0u;
+            for(std::size_t i = 0u; i < _positions.size(); ++i) {
+                test(_positions[i], _indices[i]);
+            }
+            break;
+        }
+
+        _for_each_on_ring(center, ring, test);
+
+        float gap = std::numeric_limits<float>::max();
+        bool covered = true;
+        for(std::size_t c = 0u; c < dimensions; ++c) {
+            float const below = p[static_cast<uint8_t>(c)]
+                - static_cast<float>(center[c] - ring) * _cell_size;
+            float const above =
+                static_cast<float>(center[c] + ring + 1) * _cell_size
+                - p[static_cast<uint8_t>(c)];
+            gap = std::min(gap, std::min(below, above));
+
+            covered = covered && center[c] - ring <= _lowest[c]
+                              && center[c] + ring >= _highest[c];
+        }
+
+        // Done once nothing further out could make the list, or there's
+        // nothing further out at all
+        bool const full = found == out.size();
+        if(covered || gap > max_distance || (full && limit() <= gap * gap)) {
+            break;
+        }
+    }
+
+    std::sort_heap(out.begin(), out.begin() + found, further);
+    return found;
+}
+
+// =============================================================================
+template <typename Vector>
+typename SpatialGrid<Vector>::Cell
+SpatialGrid<Vector>::_cell_of(Vector const &p) const {
+    // Clamped well inside int32_t, so far away positions share the outermost
+    // cells rather than overflowing
+    float constexpr bound = static_cast<float>(1 << 29);
+
+    Cell cell;
+    for(std::size_t c = 0u; c < dimensions; ++c) {
+        float const scaled = std::floor(p[static_cast<uint8_t>(c)] * _inverse);
+        cell[c] = static_cast<int32_t>(std::clamp(scaled, -bound, bound));
+    }
+    return cell;
+}
+
+template <typename Vector>
+uint32_t SpatialGrid<Vector>::_bucket_of(Cell const &cell) const {
+    // The usual large primes from Teschner et al., "Optimized Spatial
+    // Hashing for Collision Detection of Deformable Objects"
+    uint32_t constexpr primes[] = { 73856093u, 19349663u, 83492791u };
+
+    uint32_t hash = 0u;
+    for(std::size_t c = 0u; c < dimensions; ++c) {
+        hash ^= static_cast<uint32_t>(cell[c]) * primes[c];
+    }
+    return hash & static_cast<uint32_t>(bucket_count() - 1u);
+}
+
+template <typename Vector>
+template <typename Visit>
+void SpatialGrid<Vector>::_for_each_in(Cell const &cell, Visit &&visit) const
+{
+    uint32_t const bucket = _bucket_of(cell);
+    for(uint32_t i = _starts[bucket]; i < _starts[bucket + 1u]; ++i) {
+        if(_cells[i] == cell) {
+            visit(_positions[i], _indices[i]);
+        }
+    }
+}
+
+template <typename Vector>
+template <typename Visit>
+void SpatialGrid<Vector>::_for_each_on_ring(Cell const &center,
+                                            int32_t const ring,
+                                            Visit &&visit) const
+{
+    // The ring's cells, clipped to the occupied ones
+    Cell low;
+    Cell high;
+    for(std::size_t c = 0u; c < dimensions; ++c) {
+        low[c] = std::max(center[c] - ring, _lowest[c]);
+        high[c] = std::min(center[c] + ring, _highest[c]);
+        if(low[c] > high[c]) {
+            return;
+        }
+    }
+
+    // Rows along x. Where y or z is on the ring, so is the whole row, and
+    // elsewhere only its two ends are.
+    Cell cell;
+    auto const visit_row = [&](bool const on_ring) {
+        if(on_ring) {
+            for(cell[0] = low[0]; cell[0] <= high[0]; ++cell[0]) {
+                _for_each_in(cell, visit);
+            }
+            return;
+        }
+
+        cell[0] = center[0] - ring;
+        if(cell[0] >= _lowest[0]) {
+            _for_each_in(cell, visit);
+        }
+        cell[0] = center[0] + ring;
+        if(cell[0] <= _highest[0]) {
+            _for_each_in(cell, visit);
+        }
+    };
+
+    if constexpr(dimensions == 2u) {
+        for(cell[1] = low[1]; cell[1] <= high[1]; ++cell[1]) {
+            visit_row(ring == 0 || std::abs(cell[1] - center[1]) == ring);
+        }
+    }
+    else {
+        for(cell[2] = low[2]; cell[2] <= high[2]; ++cell[2]) {
+            bool const z_on_ring = std::abs(cell[2] - center[2]) == ring;
+            for(cell[1] = low[1]; cell[1] <= high[1]; ++cell[1]) {
+                visit_row(ring == 0 || z_on_ring ||
+                          std::abs(cell[1] - center[1]) == ring);
+            }
+        }
+    }
+}
+
+} // namespace btx::math
+
+#endif // BRASSTACKS_MATH_SPATIALGRID_HPP
\ No newline at end of file
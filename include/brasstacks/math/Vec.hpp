@@ -0,0 +1,418 @@
+#ifndef BRASSTACKS_MATH_VEC_HPP
+#define BRASSTACKS_MATH_VEC_HPP
+
+#include "brasstacks/math/common.hpp"
+#include "brasstacks/math/simd.hpp"
+
+namespace btx::math {
+
+namespace detail {
+
+// The named components, one specialization per size. Keeping them in a base
+// of their own lets Vec share every operation across sizes while v.x, v.y,
+// and so on stay plain data members, laid out back to back with no padding.
+template <typename T, std::size_t N>
+struct VecComponents;
+
+template <typename T>
+struct VecComponents<T, 2u> {
+    T x = T { };
+    T y = T { };
+
+    // For indexing during constant evaluation, where stepping a pointer from
+    // one member to the next isn't allowed
+    static constexpr T VecComponents::* members[] {
+        &VecComponents::x, &VecComponents::y,
+    };
+};
+
+template <typename T>
+struct VecComponents<T, 3u> {
+    T x = T { };
+    T y = T { };
+    T z = T { };
+
+    static constexpr T VecComponents::* members[] {
+        &VecComponents::x, &VecComponents::y, &VecComponents::z,
+    };
+};
+
+// Only the float Vec4 is ever loaded into an SSE register, but giving every
+// four-component vector the same alignment keeps the layout rules simple
+template <typename T>
+struct BTX_MATH_SIMD_ALIGN VecComponents<T, 4u> {
+    T x = T { };
+    T y = T { };
+    T z = T { };
+    T w = T { };
+
+    static constexpr T VecComponents::* members[] {
+        &VecComponents::x, &VecComponents::y, &VecComponents::z,
+        &VecComponents::w,
+    };
+};
+
+} // namespace detail
+
+// A vector of N components of type T, for N from 2 to 4. Vec2, Vec3, and
+// Vec4 are the float versions the rest of the library is built on; DVec* and
+// IVec* are the double and 32-bit integer versions, for things like positions
+// in very large worlds and grid cell coordinates. Every operation is defined
+// here and is constexpr in every build mode, like the other templates in the
+// library. The float Vec4 keeps its SSE paths when BTX_MATH_SIMD is on.
+template <typename T, std::size_t N>
+struct Vec : detail::VecComponents<T, N> {
+    static_assert(N >= 2u && N <= 4u, "Vec has 2, 3, or 4 components");
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>,
+                  "Vec components must be a number type");
+
+    using value_type = T;
+    static std::size_t constexpr components = N;
+
+    static Vec const zero;
+    static Vec const unit_x;
+    static Vec const unit_y;
+    static Vec const unit_z;
+    static Vec const unit_w;
+
+// =============================================================================
+    [[nodiscard]] constexpr T & operator[](uint8_t i);
+    [[nodiscard]] constexpr T   operator[](uint8_t i) const;
+
+// =============================================================================
+    // Floating point components compare within epsilon, integers exactly
+    [[nodiscard]] constexpr bool operator==(Vec const &other) const;
+
+    [[nodiscard]] constexpr Vec operator+(Vec const &other) const;
+    [[nodiscard]] constexpr Vec operator-(Vec const &other) const;
+
+    [[nodiscard]] constexpr Vec operator-() const;
+
+    constexpr Vec & operator+=(Vec const &other);
+    constexpr Vec & operator-=(Vec const &other);
+
+    constexpr Vec & operator*=(T scalar);
+    constexpr Vec & operator/=(T scalar);
+
+// =============================================================================
+    Vec() = default;
+    ~Vec() = default;
+
+    constexpr Vec(T x, T y) requires (N == 2u);
+    constexpr Vec(T x, T y, T z) requires (N == 3u);
+    constexpr Vec(T x, T y, T z, T w) requires (N == 4u);
+
+    // Between component types, converting each component with static_cast,
+    // so float to int truncates toward zero
+    template <typename U>
+        requires (!std::is_same_v<U, T>)
+    constexpr explicit Vec(Vec<U, N> const &other);
+
+    Vec(Vec &&) = default;
+    Vec(Vec const &) = default;
+
+    Vec & operator=(Vec &&) = default;
+    Vec & operator=(Vec const &) = default;
+
+private:
+    using Components = detail::VecComponents<T, N>;
+
+    // Whether the SSE paths apply, which needs the aligned float Vec4
+#if defined(BTX_MATH_SSE)
+    static bool constexpr sse = std::is_same_v<T, float> && N == 4u;
+#else
+    static bool constexpr sse = false;
+#endif
+
+    template <std::size_t Axis>
+    [[nodiscard]] static constexpr Vec axis();
+};
+
+template <typename T, std::size_t N>
+[[nodiscard]] constexpr Vec<T, N> operator*(std::type_identity_t<T> scalar,
+                                            Vec<T, N> const &v);
+template <typename T, std::size_t N>
+[[nodiscard]] constexpr Vec<T, N> operator*(Vec<T, N> const &v,
+                                            std::type_identity_t<T> scalar);
+template <typename T, std::size_t N>
+[[nodiscard]] constexpr Vec<T, N> operator/(Vec<T, N> const &v,
+                                            std::type_identity_t<T> scalar);
+
+template <typename T, std::size_t N>
+std::ostream & operator<<(std::ostream &out, Vec<T, N> const &v);
+
+using Vec2 = Vec<float, 2u>;
+using Vec3 = Vec<float, 3u>;
+using Vec4 = Vec<float, 4u>;
+
+using DVec2 = Vec<double, 2u>;
+using DVec3 = Vec<double, 3u>;
+using DVec4 = Vec<double, 4u>;
+
+using IVec2 = Vec<int32_t, 2u>;
+using IVec3 = Vec<int32_t, 3u>;
+using IVec4 = Vec<int32_t, 4u>;
+
+// =============================================================================
+template <typename T, std::size_t N>
+constexpr T & Vec<T, N>::operator[](uint8_t i) {
+    if(std::is_constant_evaluated()) {
+        // Indexing past x isn't allowed during constant evaluation
+        return this->*Components::members[i];
+    }
+
+    return ((&this->x)[i]);
+}
+
+template <typename T, std::size_t N>
+constexpr T Vec<T, N>::operator[](uint8_t i) const {
+    if(std::is_constant_evaluated()) {
+        return this->*Components::members[i];
+    }
+
+    return ((&this->x)[i]);
+}
+
+// =============================================================================
+template <typename T, std::size_t N>
+constexpr bool Vec<T, N>::operator==(Vec const &other) const {
+    if constexpr(std::is_integral_v<T>) {
+        for(uint8_t i = 0u; i < N; ++i) {
+            if((*this)[i] != other[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+    else {
+        // If the absolute value of the difference between this.x and other.x
+        // is less than the chosen float epsilon, then the x components of the
+        // two vectors are the same. If all members hit this criterion, the
+        // vectors are equal.
+#if defined(BTX_MATH_SSE)
+        if constexpr(sse) {
+            if(!std::is_constant_evaluated()) {
+                // Clearing the sign bit gives the absolute value of each
+                // difference, then all four comparisons are gathered into one
+                // bitmask
+                __m128 const diff = _mm_andnot_ps(
+                    simd::sign_mask(),
+                    _mm_sub_ps(simd::load(*this), simd::load(other))
+                );
+
+                return _mm_movemask_ps(
+                    _mm_cmplt_ps(diff, _mm_set1_ps(epsilon))
+                ) == 0xF;
+            }
+        }
+#endif
+
+        for(uint8_t i = 0u; i < N; ++i) {
+            if(!(detail::abs((*this)[i] - other[i]) < T { epsilon })) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+template <typename T, std::size_t N>
+constexpr Vec<T, N> Vec<T, N>::operator+(Vec const &other) const {
+    Vec result = *this;
+    result += other;
+    return result;
+}
+
+template <typename T, std::size_t N>
+constexpr Vec<T, N> Vec<T, N>::operator-(Vec const &other) const {
+    Vec result = *this;
+    result -= other;
+    return result;
+}
+
+template <typename T, std::size_t N>
+constexpr Vec<T, N> Vec<T, N>::operator-() const {
+#if defined(BTX_MATH_SSE)
+    if constexpr(sse) {
+        if(!std::is_constant_evaluated()) {
+            Vec result;
+            simd::store(result,
+                        _mm_xor_ps(simd::load(*this), simd::sign_mask()));
+            return result;
+        }
+    }
+#endif
+
+    Vec result;
+    for(uint8_t i = 0u; i < N; ++i) {
+        result[i] = -(*this)[i];
+    }
+    return result;
+}
+
+template <typename T, std::size_t N>
+constexpr Vec<T, N> & Vec<T, N>::operator+=(Vec const &other) {
+#if defined(BTX_MATH_SSE)
+    if constexpr(sse) {
+        if(!std::is_constant_evaluated()) {
+            simd::store(*this,
+                        _mm_add_ps(simd::load(*this), simd::load(other)));
+            return *this;
+        }
+    }
+#endif
+
+    for(uint8_t i = 0u; i < N; ++i) {
+        (*this)[i] += other[i];
+    }
+    return *this;
+}
+
+template <typename T, std::size_t N>
+constexpr Vec<T, N> & Vec<T, N>::operator-=(Vec const &other) {
+#if defined(BTX_MATH_SSE)
+    if constexpr(sse) {
+        if(!std::is_constant_evaluated()) {
+            simd::store(*this,
+                        _mm_sub_ps(simd::load(*this), simd::load(other)));
+            return *this;
+        }
+    }
+#endif
+
+    for(uint8_t i = 0u; i < N; ++i) {
+        (*this)[i] -= other[i];
+    }
+    return *this;
+}
+
+template <typename T, std::size_t N>
+constexpr Vec<T, N> & Vec<T, N>::operator*=(T const scalar) {
+#if defined(BTX_MATH_SSE)
+    if constexpr(sse) {
+        if(!std::is_constant_evaluated()) {
+            simd::store(*this,
+                        _mm_mul_ps(simd::load(*this), _mm_set1_ps(scalar)));
+            return *this;
+        }
+    }
+#endif
+
+    for(uint8_t i = 0u; i < N; ++i) {
+        (*this)[i] *= scalar;
+    }
+    return *this;
+}
+
+template <typename T, std::size_t N>
+constexpr Vec<T, N> & Vec<T, N>::operator/=(T const scalar) {
+#if defined(BTX_MATH_SSE)
+    if constexpr(sse) {
+        if(!std::is_constant_evaluated()) {
+            simd::store(*this,
+                        _mm_div_ps(simd::load(*this), _mm_set1_ps(scalar)));
+            return *this;
+        }
+    }
+#endif
+
+    for(uint8_t i = 0u; i < N; ++i) {
+        (*this)[i] /= scalar;
+    }
+    return *this;
+}
+
+// =============================================================================
+template <typename T, std::size_t N>
+constexpr Vec<T, N> operator*(std::type_identity_t<T> const scalar,
+                              Vec<T, N> const &v)
+{
+    Vec<T, N> result = v;
+    result *= scalar;
+    return result;
+}
+
+template <typename T, std::size_t N>
+constexpr Vec<T, N> operator*(Vec<T, N> const &v,
+                              std::type_identity_t<T> const scalar)
+{
+    Vec<T, N> result = v;
+    result *= scalar;
+    return result;
+}
+
+template <typename T, std::size_t N>
+constexpr Vec<T, N> operator/(Vec<T, N> const &v,
+                              std::type_identity_t<T> const scalar)
+{
+    Vec<T, N> result = v;
+    result /= scalar;
+    return result;
+}
+
+// =============================================================================
+template <typename T, std::size_t N>
+constexpr Vec<T, N>::Vec(T const x, T const y) requires (N == 2u) :
+    Components { x, y }
+{ }
+
+template <typename T, std::size_t N>
+constexpr Vec<T, N>::Vec(T const x, T const y, T const z) requires (N == 3u) :
+    Components { x, y, z }
+{ }
+
+template <typename T, std::size_t N>
+constexpr Vec<T, N>::Vec(T const x, T const y, T const z, T const w)
+    requires (N == 4u) :
+    Components { x, y, z, w }
+{ }
+
+template <typename T, std::size_t N>
+template <typename U>
+    requires (!std::is_same_v<U, T>)
+constexpr Vec<T, N>::Vec(Vec<U, N> const &other) {
+    for(uint8_t i = 0u; i < N; ++i) {
+        (*this)[i] = static_cast<T>(other[i]);
+    }
+}
+
+// =============================================================================
+template <typename T, std::size_t N>
+std::ostream & operator<<(std::ostream &out, Vec<T, N> const &v) {
+    out << std::fixed << std::setprecision(print_precs);
+    for(uint8_t i = 0u; i < N; ++i) {
+        out << (i == 0u ? "" : " ") << std::setw(print_width) << v[i];
+    }
+
+    return out;
+}
+
+// =============================================================================
+template <typename T, std::size_t N>
+template <std::size_t Axis>
+constexpr Vec<T, N> Vec<T, N>::axis() {
+    static_assert(Axis < N, "This vector has no such axis");
+
+    Vec result;
+    result[Axis] = T { 1 };
+    return result;
+}
+
+template <typename T, std::size_t N>
+inline constexpr Vec<T, N> Vec<T, N>::zero { };
+
+template <typename T, std::size_t N>
+inline constexpr Vec<T, N> Vec<T, N>::unit_x = Vec<T, N>::axis<0u>();
+
+template <typename T, std::size_t N>
+inline constexpr Vec<T, N> Vec<T, N>::unit_y = Vec<T, N>::axis<1u>();
+
+template <typename T, std::size_t N>
+inline constexpr Vec<T, N> Vec<T, N>::unit_z = Vec<T, N>::axis<2u>();
+
+template <typename T, std::size_t N>
+inline constexpr Vec<T, N> Vec<T, N>::unit_w = Vec<T, N>::axis<3u>();
+
+} // namespace btx::math
+
+#endif // BRASSTACKS_MATH_VEC_HPP
\ No newline at end of file
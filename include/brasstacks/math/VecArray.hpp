@@ -0,0 +1,473 @@
+#ifndef BRASSTACKS_MATH_VECARRAY_HPP
+#define BRASSTACKS_MATH_VECARRAY_HPP
+
+#include "brasstacks/math/common.hpp"
+#include "brasstacks/math/Vec.hpp"
+
+#include <memory_resource>
+
+namespace btx::math {
+
+// The base of the lazy array expressions from expression.hpp. Being in this
+// namespace is what lets argument-dependent lookup find their operators.
+struct ArrayExpressionBase { };
+
+// Any of those expressions, which a VecArray can be built from, assigned
+// from, or have added or subtracted
+template <typename T>
+concept ArrayExpression = std::derived_from<T, ArrayExpressionBase>;
+
+// A structure-of-arrays container of vectors. Each component (x, y, ...) is
+// stored in its own contiguous lane, so bulk operations stream through plain
+// float arrays the compiler can vectorize. Every lane starts on a cache line
+// and is padded with zeros up to a multiple of lane_width floats, which lets
+// kernels run whole SIMD registers over the tail without bounds checks.
+//
+// The lanes come from a std::pmr::memory_resource, the default resource
+// unless the array was given one, such as an ArenaResource for a temporary
+// that only lasts a frame. Like the std::pmr containers, an array keeps its
+// resource for life: copies get the default resource unless given another,
+// and assigning between arrays with different resources copies the lanes.
+template <typename Vector>
+class VecArray {
+public:
+    static std::size_t constexpr components = sizeof(Vector) / sizeof(float);
+    static std::size_t constexpr alignment  = 64u;
+    static std::size_t constexpr lane_width = alignment / sizeof(float);
+
+// =============================================================================
+    [[nodiscard]] std::size_t size()   const { return _size; }
+    [[nodiscard]] std::size_t stride() const { return _stride; }
+    [[nodiscard]] bool        empty()  const { return _size == 0u; }
+
+    [[nodiscard]] std::pmr::memory_resource * resource() const {
+        return _resource;
+    }
+
+    // Changes the number of vectors, keeping existing elements and zeroing
+    // any new ones
+    void resize(std::size_t size);
+
+// =============================================================================
+    // Element access gathers a vector from, or scatters it into, the lanes
+    [[nodiscard]] Vector operator[](std::size_t i) const;
+    void set(std::size_t i, Vector const &v);
+
+    // Conversion to and from arrays of vectors
+    void load(std::span<Vector const> vectors);
+    void store(std::span<Vector> vectors) const;
+
+// =============================================================================
+    // Evaluating an expression of this array's vector type over every element
+    // in a single pass, with no temporary arrays. Building from or assigning
+    // an expression resizes the array to match it, while adding and
+    // subtracting need the sizes to match already. The expression may read
+    // from this array too, since each element only depends on the elements
+    // at the same index.
+    template <ArrayExpression Expr>
+        requires std::same_as<typename Expr::value_type, Vector>
+    explicit VecArray(Expr const &expr);
+
+    template <ArrayExpression Expr>
+        requires std::same_as<typename Expr::value_type, Vector>
+    VecArray & operator=(Expr const &expr);
+
+    template <ArrayExpression Expr>
+        requires std::same_as<typename Expr::value_type, Vector>
+    VecArray & operator+=(Expr const &expr);
+
+    template <ArrayExpression Expr>
+        requires std::same_as<typename Expr::value_type, Vector>
+    VecArray & operator-=(Expr const &expr);
+
+// =============================================================================
+    // Raw component lanes, each aligned to the `alignment` boundary
+    [[nodiscard]] float * lane(std::size_t component) {
+        return _data + component * _stride;
+    }
+    [[nodiscard]] float const * lane(std::size_t component) const {
+        return _data + component * _stride;
+    }
+
+    [[nodiscard]] std::span<float> x() { return { lane(0u), _size }; }
+    [[nodiscard]] std::span<float> y() { return { lane(1u), _size }; }
+    [[nodiscard]] std::span<float> z() requires (components > 2u) {
+        return { lane(2u), _size };
+    }
+    [[nodiscard]] std::span<float> w() requires (components > 3u) {
+        return { lane(3u), _size };
+    }
+
+    [[nodiscard]] std::span<float const> x() const {
+        return { lane(0u), _size };
+    }
+    [[nodiscard]] std::span<float const> y() const {
+        return { lane(1u), _size };
+    }
+    [[nodiscard]] std::span<float const> z() const requires (components > 2u) {
+        return { lane(2u), _size };
+    }
+    [[nodiscard]] std::span<float const> w() const requires (components > 3u) {
+        return { lane(3u), _size };
+    }
+
+// =============================================================================
+    VecArray() = default;
+    ~VecArray();
+
+    explicit VecArray(
+        std::size_t size,
+        std::pmr::memory_resource *resource = std::pmr::get_default_resource()
+    );
+    explicit VecArray(
+        std::span<Vector const> vectors,
+        std::pmr::memory_resource *resource = std::pmr::get_default_resource()
+    );
+
+    VecArray(VecArray &&other) noexcept;
+    VecArray(VecArray const &other);
+    VecArray(VecArray const &other, std::pmr::memory_resource *resource);
+
+    // Only noexcept, and only keeps other's lanes, when the two resources
+    // compare equal. Otherwise the lanes are copied into this array's.
+    VecArray & operator=(VecArray &&other);
+    VecArray & operator=(VecArray const &other);
+
+private:
+    float       *_data   = nullptr;
+    std::size_t  _size   = 0u;
+    std::size_t  _stride = 0u;
+
+    std::pmr::memory_resource *_resource = std::pmr::get_default_resource();
+
+    [[nodiscard]] static std::size_t _round_up(std::size_t const size) {
+        return (size + lane_width - 1u) / lane_width * lane_width;
+    }
+
+    [[nodiscard]] float * _allocate(std::size_t floats) const;
+    void _deallocate(float *data, std::size_t floats) const;
+
+    template <typename Expr, typename Op>
+    void _evaluate(Expr const &expr, Op const &op);
+};
+
+using Vec2Array = VecArray<Vec2>;
+using Vec3Array = VecArray<Vec3>;
+using Vec4Array = VecArray<Vec4>;
+
+// =============================================================================
+template <typename Vector>
+void VecArray<Vector>::resize(std::size_t const size) {
+    std::size_t const stride = _round_up(size);
+
+    if(stride == _stride) {
+        // Same storage. Zero everything from the new end or the old one,
+        // whichever comes first, so the padding stays zeroed and new
+        // elements don't trust the padding they were taken from.
+        std::size_t const first = std::min(size, _size);
+        for(std::size_t c = 0u; c < components; ++c) {
+            std::fill(lane(c) + first, lane(c) + stride, 0.0f);
+        }
+
+        _size = size;
+        return;
+    }
+
+    float *data = _allocate(stride * components);
+    std::size_t const keep = std::min(size, _size);
+
+    for(std::size_t c = 0u; c < components; ++c) {
+        float *dst = data + c * stride;
+        std::copy(lane(c), lane(c) + keep, dst);
+        std::fill(dst + keep, dst + stride, 0.0f);
+    }
+
+    _deallocate(_data, _stride * components);
+
+    _data   = data;
+    _size   = size;
+    _stride = stride;
+}
+
+// =============================================================================
+template <typename Vector>
+Vector VecArray<Vector>::operator[](std::size_t const i) const {
+    assert(i < _size);
+
+    Vector result;
+    for(std::size_t c = 0u; c < components; ++c) {
+        result[static_cast<uint8_t>(c)] = lane(c)[i];
+    }
+
+    return result;
+}
+
+template <typename Vector>
+void VecArray<Vector>::set(std::size_t const i, Vector const &v) {
+    assert(i < _size);
+
+    for(std::size_t c = 0u; c < components; ++c) {
+        lane(c)[i] = v[static_cast<uint8_t>(c)];
+    }
+}
+
+template <typename Vector>
+void VecArray<Vector>::load(std::span<Vector const> vectors) {
+    resize(vectors.size());
+
+    for(std::size_t i = 0u; i < vectors.size(); ++i) {
+        set(i, vectors[i]);
+    }
+}
+
+template <typename Vector>
+void VecArray<Vector>::store(std::span<Vector> vectors) const {
+    assert(vectors.size() >= _size);
+
+    for(std::size_t i = 0u; i < _size; ++i) {
+        vectors[i] = (*this)[i];
+    }
+}
+
+// =============================================================================
+namespace detail {
+
+// How many floats make up each element of an expression
+template <typename Value>
+std::size_t constexpr value_components = Value::components;
+
+template <>
+inline std::size_t constexpr value_components<float> = 1u;
+
+// Evaluates expr a block of elements at a time into a buffer on the stack,
+// laid out lane by lane like a VecArray, and hands each block to
+// write(first, count, block). The arithmetic only ever stores into the
+// buffer, which nothing else can point to, so the compiler can vectorize it
+// without checking whether the destination overlaps the inputs.
+template <typename Expr, typename Write>
+void evaluate_blocks(Expr const &expr, Write const &write) {
+    using Value = typename Expr::value_type;
+    static std::size_t constexpr components = value_components<Value>;
+    static std::size_t constexpr block_size = 64u;
+
+    alignas(64) float block[components][block_size];
+
+    auto const fill = [&expr, &block](std::size_t const first,
+                                      std::size_t const count)
+    {
+        for(std::size_t i = 0u; i < count; ++i) {
+            Value const value = expr.at(first + i);
+
+            if constexpr(components == 1u) {
+                block[0][i] = value;
+            }
+            else {
+                for(std::size_t c = 0u; c < components; ++c) {
+                    block[c][i] = value[static_cast<uint8_t>(c)];
+                }
+            }
+        }
+    };
+
+    // Whole blocks have a fixed length, which spares their loops the
+    // remainder handling only the last block needs
+    std::size_t const size = expr.size();
+    std::size_t first = 0u;
+    for(; first + block_size <= size; first += block_size) {
+        fill(first, block_size);
+        write(first, block_size, block);
+    }
+
+    if(first < size) {
+        fill(first, size - first);
+        write(first, size - first, block);
+    }
+}
+
+} // namespace detail
+
+template <typename Vector>
+template <typename Expr, typename Op>
+void VecArray<Vector>::_evaluate(Expr const &expr, Op const &op) {
+    detail::evaluate_blocks(expr, [this, &op](std::size_t const first,
+                                              std::size_t const count,
+                                              auto const &block)
+    {
+        for(std::size_t c = 0u; c < components; ++c) {
+            float *dst = lane(c) + first;
+            for(std::size_t i = 0u; i < count; ++i) {
+                dst[i] = op(dst[i], block[c][i]);
+            }
+        }
+    });
+}
+
+template <typename Vector>
+template <ArrayExpression Expr>
+    requires std::same_as<typename Expr::value_type, Vector>
+VecArray<Vector>::VecArray(Expr const &expr) {
+    *this = expr;
+}
+
+template <typename Vector>
+template <ArrayExpression Expr>
+    requires std::same_as<typename Expr::value_type, Vector>
+VecArray<Vector> & VecArray<Vector>::operator=(Expr const &expr) {
+    // Anything the expression reads from this array is already the right
+    // size, so this never moves lanes out from under it
+    resize(expr.size());
+    _evaluate(expr, [](float, float const value) { return value; });
+    return *this;
+}
+
+template <typename Vector>
+template <ArrayExpression Expr>
+    requires std::same_as<typename Expr::value_type, Vector>
+VecArray<Vector> & VecArray<Vector>::operator+=(Expr const &expr) {
+    assert(expr.size() == _size);
+    _evaluate(expr, [](float const current, float const value) {
+        return current + value;
+    });
+    return *this;
+}
+
+template <typename Vector>
+template <ArrayExpression Expr>
+    requires std::same_as<typename Expr::value_type, Vector>
+VecArray<Vector> & VecArray<Vector>::operator-=(Expr const &expr) {
+    assert(expr.size() == _size);
+    _evaluate(expr, [](float const current, float const value) {
+        return current - value;
+    });
+    return *this;
+}
+
+// =============================================================================
+template <typename Vector>
+VecArray<Vector>::~VecArray() {
+    _deallocate(_data, _stride * components);
+}
+
+template <typename Vector>
+VecArray<Vector>::VecArray(std::size_t const size,
+                           std::pmr::memory_resource *const resource) :
+    _resource { resource }
+{
+    resize(size);
+}
+
+template <typename Vector>
+VecArray<Vector>::VecArray(std::span<Vector const> vectors,
+                           std::pmr::memory_resource *const resource) :
+    _resource { resource }
+{
+    load(vectors);
+}
+
+template <typename Vector>
+VecArray<Vector>::VecArray(VecArray &&other) noexcept :
+    _data     { std::exchange(other._data, nullptr) },
+    _size     { std::exchange(other._size, 0u) },
+    _stride   { std::exchange(other._stride, 0u) },
+    _resource { other._resource }
+{ }
+
+template <typename Vector>
+VecArray<Vector>::VecArray(VecArray const &other) :
+    VecArray(other, std::pmr::get_default_resource())
+{ }
+
+template <typename Vector>
+VecArray<Vector>::VecArray(VecArray const &other,
+                           std::pmr::memory_resource *const resource) :
+    _size     { other._size },
+    _stride   { other._stride },
+    _resource { resource }
+{
+    _data = _allocate(_stride * components);
+    std::copy(other._data, other._data + _stride * components, _data);
+}
+
+template <typename Vector>
+VecArray<Vector> & VecArray<Vector>::operator=(VecArray &&other) {
+    if(this == &other) {
+        return *this;
+    }
+
+    if(!_resource->is_equal(*other._resource)) {
+        return *this = static_cast<VecArray const &>(other);
+    }
+
+    _deallocate(_data, _stride * components);
+
+    _data   = std::exchange(other._data, nullptr);
+    _size   = std::exchange(other._size, 0u);
+    _stride = std::exchange(other._stride, 0u);
+
+    return *this;
+}
+
+template <typename Vector>
+VecArray<Vector> & VecArray<Vector>::operator=(VecArray const &other) {
+    if(this != &other) {
+        VecArray copy(other, _resource);
+        *this = std::move(copy);
+    }
+
+    return *this;
+}
+
+// =============================================================================
+template <typename Vector>
+float * VecArray<Vector>::_allocate(std::size_t const floats) const {
+    if(floats == 0u) {
+        return nullptr;
+    }
+
+    return static_cast<float *>(
+        _resource->allocate(floats * sizeof(float), alignment)
+    );
+}
+
+template <typename Vector>
+void VecArray<Vector>::_deallocate(float *data,
+                                   std::size_t const floats) const
+{
+    if(data != nullptr) {
+        _resource->deallocate(data, floats * sizeof(float), alignment);
+    }
+}
+
+// =============================================================================
+// Bulk kernels. Each one mirrors its scalar counterpart in math.hpp, operating
+// on every element. Inputs and outputs must be the same size, and an output
+// may be the same array as one of the inputs.
+void add(Vec2Array const &a, Vec2Array const &b, Vec2Array &out);
+void add(Vec3Array const &a, Vec3Array const &b, Vec3Array &out);
+void add(Vec4Array const &a, Vec4Array const &b, Vec4Array &out);
+
+void sub(Vec2Array const &a, Vec2Array const &b, Vec2Array &out);
+void sub(Vec3Array const &a, Vec3Array const &b, Vec3Array &out);
+void sub(Vec4Array const &a, Vec4Array const &b, Vec4Array &out);
+
+void scale(Vec2Array const &a, float scalar, Vec2Array &out);
+void scale(Vec3Array const &a, float scalar, Vec3Array &out);
+void scale(Vec4Array const &a, float scalar, Vec4Array &out);
+
+void dot(Vec2Array const &a, Vec2Array const &b, std::span<float> out);
+void dot(Vec3Array const &a, Vec3Array const &b, std::span<float> out);
+void dot(Vec4Array const &a, Vec4Array const &b, std::span<float> out);
+
+void cross(Vec3Array const &a, Vec3Array const &b, Vec3Array &out);
+
+void length_squared(Vec2Array const &a, std::span<float> out);
+void length_squared(Vec3Array const &a, std::span<float> out);
+void length_squared(Vec4Array const &a, std::span<float> out);
+
+void normalize(Vec2Array const &a, Vec2Array &out);
+void normalize(Vec3Array const &a, Vec3Array &out);
+void normalize(Vec4Array const &a, Vec4Array &out);
+
+} // namespace btx::math
+
+#endif // BRASSTACKS_MATH_VECARRAY_HPP
\ No newline at end of file
@@ -0,0 +1,494 @@
+#ifndef BRASSTACKS_MATH_VECFILE_HPP
+#define BRASSTACKS_MATH_VECFILE_HPP
+
+#include "brasstacks/math/common.hpp"
+#include "brasstacks/math/Vec.hpp"
+#include "brasstacks/math/VecArray.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <ranges>
+#include <system_error>
+#include <vector>
+
+namespace btx::math {
+
+// A binary file of vectors, laid out so that a reader can map it into memory
+// and use the vectors where they lie, with nothing parsed or copied. The file
+// is a 64 byte VecFileHeader followed by the data, which starts at
+// data_offset, a multiple of the header's alignment.
+//
+// AoS files hold the vectors back to back, exactly as they sit in a
+// std::vector. SoA files hold each component in a lane of its own, every
+// lane lane_stride bytes long, starting on an alignment boundary and padded
+// with zeros, the way VecArray keeps them.
+//
+// Everything is little-endian, and the vectors are stored in their in-memory
+// representation, so files only open on little-endian machines. The checksum
+// is Fletcher-64 over the data as 32-bit words, padding included. Checking it
+// reads every page of the file, so open() leaves that to verify().
+
+enum class VecComponent : uint8_t {
+    f32 = 1u,
+    f64 = 2u,
+    i32 = 3u,
+};
+
+enum class VecLayout : uint8_t {
+    aos = 1u,
+    soa = 2u,
+};
+
+struct VecFileHeader {
+    static std::array<char, 8> constexpr expected_magic {
+        'B', 'T', 'X', 'V', 'E', 'C', 'S', '\0'
+    };
+    static uint32_t constexpr current_version = 1u;
+
+    std::array<char, 8> magic = expected_magic;
+    uint32_t     version        = current_version;
+    uint32_t     header_size    = 64u;
+    VecComponent component_type = VecComponent::f32;
+    uint8_t      components     = 0u;
+    VecLayout    layout         = VecLayout::aos;
+    uint8_t      reserved       = 0u;
+    uint32_t     alignment      = 0u;
+    uint64_t     count          = 0u;   // Vectors, not bytes
+    uint64_t     data_offset    = 0u;   // From the start of the file
+    uint64_t     data_size      = 0u;   // In bytes, padding included
+    uint64_t     lane_stride    = 0u;   // SoA only, in bytes
+    uint64_t     checksum       = 0u;
+};
+
+static_assert(sizeof(VecFileHeader) == 64u);
+static_assert(std::is_trivially_copyable_v<VecFileHeader>);
+
+// Why a file couldn't be opened, beyond what the operating system reports
+enum class VecFileError {
+    not_a_vec_file = 1,   // Too short for a header, or the wrong magic
+    unsupported_version,
+    bad_header,           // Fields that contradict each other
+    truncated,            // The data runs past the end of the file
+    wrong_byte_order,     // This machine is big-endian
+    bad_checksum,
+};
+
+[[nodiscard]] std::error_category const & vec_file_category();
+[[nodiscard]] std::error_code make_error_code(VecFileError error);
+
+namespace detail {
+
+// The vector types a file can hold, which are every Vec of float, double, or
+// 32-bit integer components
+template <typename Vector>
+struct VecFileTraits;
+
+template <std::size_t N>
+struct VecFileTraits<Vec<float, N>> {
+    static VecComponent constexpr component = VecComponent::f32;
+};
+
+template <std::size_t N>
+struct VecFileTraits<Vec<double, N>> {
+    static VecComponent constexpr component = VecComponent::f64;
+};
+
+template <std::size_t N>
+struct VecFileTraits<Vec<int32_t, N>> {
+    static VecComponent constexpr component = VecComponent::i32;
+};
+
+// Fletcher-64, fed any number of 32-bit words at a time
+class Fletcher64 {
+public:
+    void add(std::span<std::byte const> bytes);
+    [[nodiscard]] uint64_t value() const;
+
+private:
+    uint64_t _low  = 0u;
+    uint64_t _high = 0u;
+};
+
+// Writes header, then each block in turn. For SoA files every block is a
+// lane, padded out to the lane stride. Fills in the checksum and offsets.
+[[nodiscard]] std::error_code write_vec_file(
+    std::filesystem::path const &path, VecFileHeader const &header,
+    std::span<std::span<std::byte const> const> blocks
+);
+
+// The same, with block i coming from block(context, i) instead. Each block is
+// asked for twice, once for the checksum and once to write it, and only has
+// to stay valid until the next call, so blocks can share one buffer.
+using BlockSource = std::span<std::byte const> (*)(void *context,
+                                                   std::size_t index);
+
+[[nodiscard]] std::error_code write_vec_file(
+    std::filesystem::path const &path, VecFileHeader header,
+    std::size_t block_count, BlockSource block, void *context
+);
+
+} // namespace detail
+
+template <typename Vector>
+concept VecFileElement = requires {
+    detail::VecFileTraits<Vector>::component;
+};
+
+// =============================================================================
+// A read-only view of a file, mapped into memory for as long as the VecFile
+// is open. Spans it hands out are only valid until then. Like any mapping,
+// the file mustn't be truncated while it's open.
+class VecFile {
+public:
+    static uint32_t constexpr default_alignment = 64u;
+
+    // Maps path, checking its header. On failure the file is left closed.
+    [[nodiscard]] std::error_code open(std::filesystem::path const &path);
+    void close();
+
+    [[nodiscard]] bool is_open() const { return _mapping != nullptr; }
+
+    // A default header, with a count of zero, when closed
+    [[nodiscard]] VecFileHeader const & header() const { return _header; }
+    [[nodiscard]] std::size_t size() const { return _header.count; }
+
+    template <VecFileElement Vector>
+    [[nodiscard]] bool holds() const {
+        return is_open()
+            && _header.component_type
+                == detail::VecFileTraits<Vector>::component
+            && _header.components == Vector::components;
+    }
+
+    // Every vector of an AoS file, straight from the mapping. Empty unless
+    // the file holds Vectors, laid out AoS.
+    template <VecFileElement Vector>
+    [[nodiscard]] std::span<Vector const> vectors() const;
+
+    // One component of every vector of an SoA file, straight from the
+    // mapping. Empty unless the file holds Vectors, laid out SoA.
+    template <VecFileElement Vector>
+    [[nodiscard]] std::span<typename Vector::value_type const>
+    lane(std::size_t component) const;
+
+    // Copies the vectors into out, whichever the layout, resizing it to fit.
+    // False, with out left alone, unless the file holds Vectors.
+    template <typename Vector>
+    [[nodiscard]] bool read(VecArray<Vector> &out) const;
+
+    // Recomputes the checksum, which means reading every byte of the data
+    [[nodiscard]] std::error_code verify() const;
+
+// =============================================================================
+    VecFile() = default;
+    ~VecFile();
+
+    VecFile(VecFile &&other) noexcept;
+    VecFile & operator=(VecFile &&other) noexcept;
+
+    VecFile(VecFile const &) = delete;
+    VecFile & operator=(VecFile const &) = delete;
+
+private:
+    std::byte const *_mapping      = nullptr;
+    std::size_t      _mapping_size = 0u;
+    VecFileHeader    _header { };
+
+    [[nodiscard]] std::byte const * _data() const {
+        return _mapping + _header.data_offset;
+    }
+};
+
+// =============================================================================
+// Reads an AoS file front to back through stdio, as many vectors at a time as
+// the caller asks for, so files much larger than memory stream through a
+// fixed buffer. The checksum is added up along the way and checked once the
+// last vector has been read.
+class VecFileReader {
+public:
+    // Opens path and checks its header. SoA files don't stream, so they fail
+    // with std::errc::not_supported. On failure the reader is left closed.
+    [[nodiscard]] std::error_code open(std::filesystem::path const &path);
+    void close();
+
+    [[nodiscard]] bool is_open() const { return _file != nullptr; }
+
+    // A default header, with a count of zero, when closed
+    [[nodiscard]] VecFileHeader const & header() const { return _header; }
+    [[nodiscard]] std::size_t size() const { return _header.count; }
+
+    // How many vectors read() hasn't handed out yet
+    [[nodiscard]] std::size_t remaining() const {
+        return _header.count - _read;
+    }
+
+    template <VecFileElement Vector>
+    [[nodiscard]] bool holds() const {
+        return is_open()
+            && _header.component_type
+                == detail::VecFileTraits<Vector>::component
+            && _header.components == Vector::components;
+    }
+
+    // Fills out from the front with the next vectors and returns how many
+    // there were, which is fewer than out holds only at the end of the file
+    // or after an error. Reading vectors of the wrong type is an error.
+    template <VecFileElement Vector>
+    [[nodiscard]] std::size_t read(std::span<Vector> out);
+
+    // The first thing that went wrong since open(), including a checksum
+    // that doesn't match once the whole file has been read
+    [[nodiscard]] std::error_code error() const { return _error; }
+
+// =============================================================================
+    VecFileReader() = default;
+    ~VecFileReader();
+
+    VecFileReader(VecFileReader &&other) noexcept;
+    VecFileReader & operator=(VecFileReader &&other) noexcept;
+
+    VecFileReader(VecFileReader const &) = delete;
+    VecFileReader & operator=(VecFileReader const &) = delete;
+
+private:
+    std::FILE          *_file = nullptr;
+    VecFileHeader       _header { };
+    uint64_t            _read = 0u;
+    detail::Fletcher64  _checksum;
+    std::error_code     _error;
+
+    std::size_t _read_bytes(std::span<std::byte> out, std::size_t element);
+};
+
+// Writes an AoS file front to back as vectors arrive, without knowing how
+// many there will be. The header, which needs the count and checksum, is
+// written last, by close(). Until then the file has no magic, so a writer
+// that never finishes leaves nothing that opens.
+class VecFileWriter {
+public:
+    // Creates path, replacing anything already there, for Vectors. alignment
+    // is as for write_vec_file().
+    template <VecFileElement Vector>
+    [[nodiscard]] std::error_code
+    open(std::filesystem::path const &path,
+         uint32_t alignment = VecFile::default_alignment);
+
+    // Writes the header and closes the file, returning error() or whatever
+    // stopped the header going out. Closing a closed writer does nothing.
+    std::error_code close();
+
+    [[nodiscard]] bool is_open() const { return _file != nullptr; }
+
+    // The vectors written so far
+    [[nodiscard]] std::size_t size() const { return _header.count; }
+
+    // Appends vectors to the file. False if this or any earlier write
+    // failed, or the vectors aren't the type the file was opened for.
+    template <VecFileElement Vector>
+    [[nodiscard]] bool write(std::span<Vector const> vectors);
+
+    [[nodiscard]] std::error_code error() const { return _error; }
+
+// =============================================================================
+    VecFileWriter() = default;
+    ~VecFileWriter();
+
+    VecFileWriter(VecFileWriter &&other) noexcept;
+    VecFileWriter & operator=(VecFileWriter &&other) noexcept;
+
+    VecFileWriter(VecFileWriter const &) = delete;
+    VecFileWriter & operator=(VecFileWriter const &) = delete;
+
+private:
+    std::FILE          *_file = nullptr;
+    VecFileHeader       _header { };
+    detail::Fletcher64  _checksum;
+    std::error_code     _error;
+
+    std::error_code _open(std::filesystem::path const &path);
+    bool _write_bytes(std::span<std::byte const> bytes);
+};
+
+// =============================================================================
+// Writes vectors, from a std::vector or span, to path, replacing anything
+// already there. SoA files are gathered into one lane-sized buffer a lane at
+// a time, twice over, so they take one lane's worth of extra memory.
+// alignment must be a power of two from 16 to
+// 4096, the smallest page size there is.
+template <std::ranges::contiguous_range Range>
+    requires VecFileElement<std::ranges::range_value_t<Range>>
+[[nodiscard]] std::error_code write_vec_file(
+    std::filesystem::path const &path, Range const &vectors,
+    VecLayout layout = VecLayout::aos,
+    uint32_t alignment = VecFile::default_alignment
+);
+
+// Writes an array's lanes as they are, which is always SoA
+template <typename Vector>
+[[nodiscard]] std::error_code write_vec_file(
+    std::filesystem::path const &path, VecArray<Vector> const &array,
+    uint32_t alignment = VecFile::default_alignment
+);
+
+// =============================================================================
+template <VecFileElement Vector>
+std::span<Vector const> VecFile::vectors() const {
+    static_assert(sizeof(Vector) == Vector::components
+                                  * sizeof(typename Vector::value_type));
+
+    if(!holds<Vector>() || _header.layout != VecLayout::aos) {
+        return { };
+    }
+
+    // The data is aligned to at least 16 bytes, which is as much as any
+    // Vector needs, and open() has checked that it's all there
+    return { reinterpret_cast<Vector const *>(_data()), size() };
+}
+
+template <VecFileElement Vector>
+std::span<typename Vector::value_type const>
+VecFile::lane(std::size_t const component) const {
+    using T = typename Vector::value_type;
+
+    if(!holds<Vector>() || _header.layout != VecLayout::soa
+       || component >= Vector::components)
+    {
+        return { };
+    }
+
+    auto const *start = _data() + component * _header.lane_stride;
+    return { reinterpret_cast<T const *>(start), size() };
+}
+
+template <typename Vector>
+bool VecFile::read(VecArray<Vector> &out) const {
+    if(!holds<Vector>()) {
+        return false;
+    }
+
+    if(_header.layout == VecLayout::aos) {
+        out = VecArray<Vector> { vectors<Vector>() };
+        return true;
+    }
+
+    out.resize(size());
+    for(std::size_t c = 0u; c < Vector::components; ++c) {
+        auto const source = lane<Vector>(c);
+        std::memcpy(out.lane(c), source.data(), source.size_bytes());
+    }
+
+    return true;
+}
+
+// =============================================================================
+template <VecFileElement Vector>
+std::size_t VecFileReader::read(std::span<Vector> out) {
+    if(!holds<Vector>()) {
+        if(is_open() && !_error) {
+            _error = std::make_error_code(std::errc::invalid_argument);
+        }
+        return 0u;
+    }
+
+    return _read_bytes(std::as_writable_bytes(out), sizeof(Vector));
+}
+
+template <VecFileElement Vector>
+std::error_code VecFileWriter::open(std::filesystem::path const &path,
+                                    uint32_t const alignment)
+{
+    close();
+
+    _header = VecFileHeader { };
+    _header.component_type = detail::VecFileTraits<Vector>::component;
+    _header.components = static_cast<uint8_t>(Vector::components);
+    _header.layout = VecLayout::aos;
+    _header.alignment = alignment;
+    return _open(path);
+}
+
+template <VecFileElement Vector>
+bool VecFileWriter::write(std::span<Vector const> const vectors) {
+    if(_header.component_type != detail::VecFileTraits<Vector>::component
+       || _header.components != Vector::components)
+    {
+        if(is_open() && !_error) {
+            _error = std::make_error_code(std::errc::invalid_argument);
+        }
+        return false;
+    }
+
+    return _write_bytes(std::as_bytes(vectors));
+}
+
+// =============================================================================
+template <std::ranges::contiguous_range Range>
+    requires VecFileElement<std::ranges::range_value_t<Range>>
+std::error_code write_vec_file(std::filesystem::path const &path,
+                               Range const &vectors, VecLayout const layout,
+                               uint32_t const alignment)
+{
+    using Vector = std::ranges::range_value_t<Range>;
+    using T = typename Vector::value_type;
+
+    VecFileHeader header;
+    header.component_type = detail::VecFileTraits<Vector>::component;
+    header.components = static_cast<uint8_t>(Vector::components);
+    header.layout = layout;
+    header.alignment = alignment;
+    header.count = std::ranges::size(vectors);
+
+    std::span<Vector const> const all { std::ranges::data(vectors),
+                                        std::ranges::size(vectors) };
+
+    if(layout == VecLayout::aos) {
+        std::span<std::byte const> const blocks[] { std::as_bytes(all) };
+        return detail::write_vec_file(path, header, blocks);
+    }
+
+    // One lane at a time, each gathered into the same buffer
+    struct Lanes {
+        std::span<Vector const> all;
+        std::vector<T>          lane;
+    } lanes { all, std::vector<T>(all.size()) };
+
+    return detail::write_vec_file(path, header, Vector::components,
+        [](void *const context, std::size_t const c) {
+            auto &[all, lane] = *static_cast<Lanes *>(context);
+            for(std::size_t i = 0u; i < all.size(); ++i) {
+                lane[i] = all[i][static_cast<uint8_t>(c)];
+            }
+            return std::as_bytes(std::span<T const> { lane });
+        },
+        &lanes
+    );
+}
+
+template <typename Vector>
+std::error_code write_vec_file(std::filesystem::path const &path,
+                               VecArray<Vector> const &array,
+                               uint32_t const alignment)
+{
+    VecFileHeader header;
+    header.component_type = detail::VecFileTraits<Vector>::component;
+    header.components = static_cast<uint8_t>(Vector::components);
+    header.layout = VecLayout::soa;
+    header.alignment = alignment;
+    header.count = array.size();
+
+    std::array<std::span<std::byte const>, Vector::components> blocks;
+    for(std::size_t c = 0u; c < Vector::components; ++c) {
+        blocks[c] = std::as_bytes(
+            std::span<float const>(array.lane(c), array.size()));
+    }
+
+    return detail::write_vec_file(path, header, blocks);
+}
+
+} // namespace btx::math
+
+template <>
+struct std::is_error_code_enum<btx::math::VecFileError> : std::true_type { };
+
+#endif // BRASSTACKS_MATH_VECFILE_HPP
\ No newline at end of file
@@ -0,0 +1,162 @@
+#ifndef BRASSTACKS_MATH_BATCH_HPP
+#define BRASSTACKS_MATH_BATCH_HPP
+
+#include "brasstacks/math/common.hpp"
+#include "brasstacks/math/Vec.hpp"
+#include "brasstacks/math/Mat4.hpp"
+#include "brasstacks/math/Quat.hpp"
+
+namespace btx::math {
+
+// Batch versions of the functions in math.hpp, operating directly on arrays
+// of vectors. Each one produces the same result as calling its scalar
+// counterpart once per element, but processes several elements per
+// instruction. Unless noted otherwise, every span passed to a single call
+// must be the same size.
+
+// =============================================================================
+// Dot Product
+// out[i] = dot(a[i], b[i])
+void dot(std::span<Vec2 const> a, std::span<Vec2 const> b,
+         std::span<float> out);
+void dot(std::span<Vec3 const> a, std::span<Vec3 const> b,
+         std::span<float> out);
+void dot(std::span<Vec4 const> a, std::span<Vec4 const> b,
+         std::span<float> out);
+
+// One against many: out[i] = dot(a, b[i])
+void dot(Vec2 const &a, std::span<Vec2 const> b, std::span<float> out);
+void dot(Vec3 const &a, std::span<Vec3 const> b, std::span<float> out);
+void dot(Vec4 const &a, std::span<Vec4 const> b, std::span<float> out);
+
+// =============================================================================
+// Cross Product
+// out[i] = cross(a[i], b[i]). out may be the same span as a or b, but must not
+// partially overlap either of them.
+void cross(std::span<Vec3 const> a, std::span<Vec3 const> b,
+           std::span<Vec3> out);
+
+// =============================================================================
+// Normalizing
+// How much precision to trade for speed when computing 1 / length. The error
+// bounds are the maximum relative error of each output component, on top of
+// the error in the vector itself.
+enum class Accuracy : uint8_t {
+    exact,      // sqrt and divide:                  within 2 ulp (~2.4e-7)
+    fast,       // rsqrt estimate plus one Newton-Raphson step: ~4.0e-7
+    fastest,    // raw rsqrt estimate:               1.5 * 2^-12 (~3.7e-4)
+};
+
+// out[i] = normalize(v[i]). Vectors with a squared length below epsilon, or
+// within epsilon of 1, are passed through unchanged, just like the scalar
+// normalize(), but without branching. Targets without a hardware reciprocal
+// square root estimate use the exact path for every accuracy. out may be the
+// same span as v, but must not partially overlap it.
+void normalize(std::span<Vec2 const> v, std::span<Vec2> out,
+               Accuracy accuracy = Accuracy::exact);
+void normalize(std::span<Vec3 const> v, std::span<Vec3> out,
+               Accuracy accuracy = Accuracy::exact);
+void normalize(std::span<Vec4 const> v, std::span<Vec4> out,
+               Accuracy accuracy = Accuracy::exact);
+
+// =============================================================================
+// Transforming
+// out[i] = m * v[i]. out may be the same span as v, but must not partially
+// overlap it.
+void transform(Mat4 const &m, std::span<Vec4 const> v, std::span<Vec4> out);
+
+// The xyz of m * (v[i], 1), so points pick up m's translation. Same aliasing
+// rules as above.
+void transform_points(Mat4 const &m, std::span<Vec3 const> v,
+                      std::span<Vec3> out);
+
+// =============================================================================
+// Quaternions
+// out[i] = rotate(q, v[i]). out may be the same span as v, but must not
+// partially overlap it.
+void rotate(Quat const &q, std::span<Vec3 const> v, std::span<Vec3> out);
+
+// out[i] = nlerp(a[i], b[i], t). out may be the same span as a or b, but must
+// not partially overlap either of them.
+void nlerp(std::span<Quat const> a, std::span<Quat const> b, float t,
+           std::span<Quat> out);
+
+// out[i] = slerp(a[i], b[i], t), for t between 0 and 1. The sines and arc
+// cosine come from polynomial approximations rather than the standard
+// library, so results agree with slerp() to within about 1e-6 per component
+// rather than exactly. out may be the same span as a or b, but must not
+// partially overlap either of them.
+void slerp(std::span<Quat const> a, std::span<Quat const> b, float t,
+           std::span<Quat> out);
+
+// =============================================================================
+// Visibility
+// What an observer can see: every point within half_fov degrees of forward,
+// as seen from position. forward doesn't have to be unit length, but can't be
+// the zero vector. A half_fov of 90 degrees gives everything in front of the
+// observer, and 180 gives everything. A target right at position always
+// counts as inside.
+struct ViewCone {
+    Vec3  position;
+    Vec3  forward;
+    float half_fov = 90.0f;
+};
+
+// Writes the index of every target inside the cone to the front of out, in
+// increasing order, and returns how many there were. out must be at least as
+// large as targets, and past the returned count its contents are
+// unspecified. Nothing is normalized and nothing branches per target: the
+// angle test compares squared dot products, and the indices are packed with
+// SIMD shuffles.
+[[nodiscard]] std::size_t visible_indices(ViewCone const &cone,
+                                          std::span<Vec3 const> targets,
+                                          std::span<uint32_t> out);
+
+// The same test, as one bit per target: bit i % 64 of mask[i / 64] is set when
+// targets[i] is inside the cone. mask must hold (targets.size() + 63) / 64
+// words, and the bits past the last target are cleared.
+void visible_mask(ViewCone const &cone, std::span<Vec3 const> targets,
+                  std::span<uint64_t> mask);
+
+// =============================================================================
+// Approximate Equality
+// How close two components must be to count as equal
+struct Tolerance {
+    enum class Mode : uint8_t {
+        absolute,   // |a - b| < max_difference, the same test as operator==
+        ulps,       // At most max_ulps representable floats apart
+    };
+
+    Mode     mode           = Mode::absolute;
+    float    max_difference = epsilon;
+    uint32_t max_ulps       = 0u;
+
+    [[nodiscard]] static constexpr Tolerance absolute(float const max) {
+        return { Mode::absolute, max, 0u };
+    }
+
+    // ULPs scale with the magnitude of the values being compared, which
+    // makes them the better choice when those vary widely. max can be at
+    // most 2^22.
+    [[nodiscard]] static constexpr Tolerance ulps(uint32_t const max) {
+        return { Mode::ulps, 0.0f, max };
+    }
+};
+
+// Compares a[i] and b[i] for every i, and sets bit i % 64 of mask[i / 64]
+// when every component of the pair is equal within tolerance. Returns how many
+// pairs weren't. mask must hold (a.size() + 63) / 64 words, and the bits past
+// the last pair are cleared. NaN is never equal to anything, and 0 and -0 are
+// always equal.
+std::size_t approx_equal(std::span<float const> a, std::span<float const> b,
+                         std::span<uint64_t> mask, Tolerance tolerance = { });
+std::size_t approx_equal(std::span<Vec2 const> a, std::span<Vec2 const> b,
+                         std::span<uint64_t> mask, Tolerance tolerance = { });
+std::size_t approx_equal(std::span<Vec3 const> a, std::span<Vec3 const> b,
+                         std::span<uint64_t> mask, Tolerance tolerance = { });
+std::size_t approx_equal(std::span<Vec4 const> a, std::span<Vec4 const> b,
+                         std::span<uint64_t> mask, Tolerance tolerance = { });
+
+} // namespace btx::math
+
+#endif // BRASSTACKS_MATH_BATCH_HPP
\ No newline at end of file
@@ -0,0 +1,134 @@
+#ifndef BRASSTACKS_MATH_COMMON_HPP
+#define BRASSTACKS_MATH_COMMON_HPP
+
+#include "brasstacks/math/pch.hpp"
+
+// Vec and its operators are templates, so they're inline and constexpr in
+// every build mode. When BTX_MATH_HEADER_ONLY is defined (see the CMake option
+// of the same name), so are the rest: the float free functions like dot() and
+// normalize(), Mat4, Quat, AABB, and the packed formats. Otherwise those are
+// compiled once into the static library.
+#if defined(BTX_MATH_HEADER_ONLY)
+    #define BTX_MATH_INLINE    inline
+    #define BTX_MATH_CONSTEXPR constexpr
+#else
+    #define BTX_MATH_INLINE
+    #define BTX_MATH_CONSTEXPR
+#endif
+
+// Intrinsics can't be used during constant evaluation, so code paths that use
+// them check this first. Outside of header-only mode the functions that use it
+// aren't constexpr, so the check is always true. Vec's operators are constexpr
+// in every mode, and check std::is_constant_evaluated() themselves.
+#if defined(BTX_MATH_HEADER_ONLY)
+    #define BTX_MATH_IS_RUNTIME() (!std::is_constant_evaluated())
+#else
+    #define BTX_MATH_IS_RUNTIME() (true)
+#endif
+
+// When BTX_MATH_FMA is defined (see the CMake option of the same name), dot
+// products, cross products, and lengths fuse each multiply with the add that
+// follows it, rounding once instead of twice. That's more accurate, and fast
+// on hardware with FMA instructions. Without it, nothing is fused: every
+// product is rounded before it's summed. That's all it guarantees, though.
+// Under -ffast-math the compiler may still reorder the sums in the scalar
+// functions, and only the batch kernels, which are built without it, always
+// add in the order written.
+
+namespace btx::math {
+
+// For pretty-printing
+static uint8_t constexpr print_precs = 8u;
+static uint8_t constexpr print_width = 2u * print_precs + 2u;
+
+// General constants
+static float constexpr epsilon = 1.0e-4f;
+static float constexpr pi = std::numbers::pi_v<float>;
+static float constexpr pi_over_one_eighty = pi / 180.0f;
+static float constexpr one_eighty_over_pi = 180.0f / pi;
+
+namespace detail {
+
+// std::abs() and std::sqrt() aren't constexpr until C++23/26, so these stand
+// in for them when a value is computed at compile time
+[[nodiscard]] constexpr float abs(float const value) {
+    return value < 0.0f ? -value : value;
+}
+
+[[nodiscard]] constexpr double abs(double const value) {
+    return value < 0.0 ? -value : value;
+}
+
+template <std::floating_point Float>
+[[nodiscard]] constexpr Float sqrt(Float const value) {
+    if(!std::is_constant_evaluated()) {
+        return std::sqrt(value);
+    }
+
+    if(value <= Float { 0 }) {
+        return Float { 0 };
+    }
+
+    // Newton-Raphson until the estimate stops moving, with a cap in case it
+    // ends up bouncing between two neighboring floats
+    Float current = value;
+    Float previous = Float { 0 };
+    for(uint32_t i = 0u; i < 128u && current != previous; ++i) {
+        previous = current;
+        current = Float { 0.5 } * (current + value / current);
+    }
+
+    return current;
+}
+
+// a * b + c, rounded once. std::fma() isn't constexpr until C++23 either, so
+// at compile time the product is taken exactly as a double, and the sum is
+// rounded to odd before it's narrowed, which rounds the same as std::fma().
+[[nodiscard]] constexpr float fma(float const a, float const b,
+                                  float const c)
+{
+    if(!std::is_constant_evaluated()) {
+        return std::fma(a, b, c);
+    }
+
+    double const product = static_cast<double>(a) * static_cast<double>(b);
+    double const addend = static_cast<double>(c);
+    double sum = product + addend;
+
+    // Infinities and NaNs have nothing left to round
+    if(!(abs(sum) <= std::numeric_limits<double>::max())) {
+        return static_cast<float>(sum);
+    }
+
+    // The rounding error of that sum, exactly, then a nudge toward it when
+    // it's non-zero and the last bit is even
+    double const back = sum - product;
+    double const error = (product - (sum - back)) + (addend - back);
+    if(error != 0.0) {
+        auto bits = std::bit_cast<uint64_t>(sum);
+        if((bits & 1u) == 0u) {
+            bits = (error > 0.0) == (sum > 0.0) ? bits + 1u : bits - 1u;
+            sum = std::bit_cast<double>(bits);
+        }
+    }
+
+    return static_cast<float>(sum);
+}
+
+// The multiply-add used by the vector products, fused or not depending on
+// BTX_MATH_FMA
+[[nodiscard]] constexpr float mul_add(float const a, float const b,
+                                      float const c)
+{
+#if defined(BTX_MATH_FMA)
+    return fma(a, b, c);
+#else
+    return a * b + c;
+#endif
+}
+
+} // namespace detail
+
+} // namespace btx::math
+
+#endif // BRASSTACKS_MATH_COMMON_HPP
\ No newline at end of file
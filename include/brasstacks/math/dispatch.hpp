@@ -0,0 +1,42 @@
+#ifndef BRASSTACKS_MATH_DISPATCH_HPP
+#define BRASSTACKS_MATH_DISPATCH_HPP
+
+#include "brasstacks/math/common.hpp"
+
+namespace btx::math {
+
+// The library's bulk kernels (batch.hpp, VecArray.hpp, and friends) are built
+// once per instruction set level. The best level the CPU supports is picked
+// the first time a kernel runs, and every call after that goes straight to
+// the matching implementation.
+//
+// Every level produces bit-identical results, with the exception of
+// Accuracy::fast and Accuracy::fastest, which start from each instruction
+// set's own reciprocal square root estimate.
+enum class SimdLevel : uint8_t {
+    scalar, // Portable C++, used on non-x86 targets
+    sse2,   // x86-64 baseline
+    sse41,
+    avx2,   // AVX2, FMA, POPCNT, and F16C
+    avx512, // AVX-512 F, DQ, BW, and VL
+};
+
+// The best level this CPU and OS support
+[[nodiscard]] SimdLevel detected_simd_level();
+
+// The level the kernels are currently using
+[[nodiscard]] SimdLevel simd_level();
+
+// Switches the kernels to the given level, mostly for testing and
+// benchmarking. Requests above what the CPU supports are clamped to
+// detected_simd_level(). Returns the level actually selected.
+SimdLevel force_simd_level(SimdLevel level);
+
+// Goes back to the automatically detected level
+void reset_simd_level();
+
+[[nodiscard]] char const * to_string(SimdLevel level);
+
+} // namespace btx::math
+
+#endif // BRASSTACKS_MATH_DISPATCH_HPP
\ No newline at end of file
@@ -0,0 +1,458 @@
+#ifndef BRASSTACKS_MATH_EXPRESSION_HPP
+#define BRASSTACKS_MATH_EXPRESSION_HPP
+
+#include "brasstacks/math/common.hpp"
+#include "brasstacks/math/Vec.hpp"
+#include "brasstacks/math/VecArray.hpp"
+
+#include <ranges>
+
+namespace btx::math {
+
+// Lazy expressions over whole arrays. Arithmetic on VecArrays, or on spans
+// and vectors of floats or vectors wrapped in lazy(), doesn't compute
+// anything by itself. It builds a small tree describing the work, which is
+// evaluated element by element in a single loop once it's assigned to a
+// VecArray or passed to evaluate():
+//
+//     positions += velocities * dt + accelerations * (0.5f * dt * dt);
+//
+// reads velocities and accelerations once and positions once, and writes
+// positions once, where the same thing with the bulk functions in
+// VecArray.hpp would take four passes and two temporary arrays.
+//
+// Expressions support + and - between two of the same type, * between a
+// vector and a float or two floats, / by a float, unary -, dot(), cross() of
+// Vec3s, and normalize(), which behaves like its scalar namesake. Single
+// floats and vectors work as operands too, and apply to every element.
+// Every array in an expression must have the same size.
+//
+// Expressions hold pointers to the arrays they read rather than copies, so
+// they mustn't outlive them or be kept across a resize. They're compiled
+// into the calling code, which means how well the loop vectorizes depends on
+// the flags that code is built with; unlike the bulk functions there's no
+// runtime dispatch. With BTX_MATH_FMA, dot() and cross() fuse the way their
+// scalar namesakes do, and calls to std::fma() only vectorize when FMA
+// instructions are enabled, with -mfma or a -march that has them.
+
+namespace detail {
+
+template <typename T>
+struct IsFloatVec : std::false_type { };
+
+template <std::size_t N>
+struct IsFloatVec<Vec<float, N>> : std::true_type { };
+
+// What an expression element can be
+template <typename T>
+concept ExpressionValue = std::same_as<T, float> || IsFloatVec<T>::value;
+
+// =============================================================================
+// Leaves
+template <typename Vector>
+class ArrayLeaf : public ArrayExpressionBase {
+public:
+    using value_type = Vector;
+    static bool constexpr broadcast = false;
+
+    explicit ArrayLeaf(VecArray<Vector> const &array) : _size(array.size()) {
+        for(std::size_t c = 0u; c < Vector::components; ++c) {
+            _lanes[c] = array.lane(c);
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const { return _size; }
+
+    [[nodiscard]] Vector at(std::size_t const i) const {
+        Vector result;
+        for(std::size_t c = 0u; c < Vector::components; ++c) {
+            result[static_cast<uint8_t>(c)] = _lanes[c][i];
+        }
+        return result;
+    }
+
+private:
+    std::array<float const *, Vector::components> _lanes { };
+    std::size_t _size = 0u;
+};
+
+template <ExpressionValue T>
+class SpanLeaf : public ArrayExpressionBase {
+public:
+    using value_type = T;
+    static bool constexpr broadcast = false;
+
+    explicit SpanLeaf(std::span<T const> const values) : _values(values) { }
+
+    [[nodiscard]] std::size_t size() const { return _values.size(); }
+    [[nodiscard]] T at(std::size_t const i) const { return _values[i]; }
+
+private:
+    std::span<T const> _values;
+};
+
+// A single value standing in for every element
+template <ExpressionValue T>
+class ValueLeaf : public ArrayExpressionBase {
+public:
+    using value_type = T;
+    static bool constexpr broadcast = true;
+
+    explicit ValueLeaf(T const &value) : _value(value) { }
+
+    [[nodiscard]] std::size_t size() const { return 0u; }
+    [[nodiscard]] T at(std::size_t) const { return _value; }
+
+private:
+    T _value;
+};
+
+// =============================================================================
+// Inner nodes, which apply Op to their operands' elements
+template <typename Op, typename Arg>
+class Unary : public ArrayExpressionBase {
+public:
+    using value_type = decltype(Op::apply(
+        std::declval<typename Arg::value_type>()
+    ));
+    static bool constexpr broadcast = Arg::broadcast;
+
+    explicit Unary(Arg const &arg) : _arg(arg) { }
+
+    [[nodiscard]] std::size_t size() const { return _arg.size(); }
+
+    [[nodiscard]] value_type at(std::size_t const i) const {
+        return Op::apply(_arg.at(i));
+    }
+
+private:
+    Arg _arg;
+};
+
+template <typename Op, typename Left, typename Right>
+class Binary : public ArrayExpressionBase {
+public:
+    using value_type = decltype(Op::apply(
+        std::declval<typename Left::value_type>(),
+        std::declval<typename Right::value_type>()
+    ));
+    static bool constexpr broadcast = Left::broadcast && Right::broadcast;
+
+    Binary(Left const &left, Right const &right) :
+        _left(left),
+        _right(right)
+    { }
+
+    [[nodiscard]] std::size_t size() const {
+        if constexpr(Left::broadcast) {
+            return _right.size();
+        }
+        else if constexpr(Right::broadcast) {
+            return _left.size();
+        }
+        else {
+            assert(_left.size() == _right.size());
+            return _left.size();
+        }
+    }
+
+    [[nodiscard]] value_type at(std::size_t const i) const {
+        return Op::apply(_left.at(i), _right.at(i));
+    }
+
+private:
+    Left  _left;
+    Right _right;
+};
+
+// =============================================================================
+// The operations. These spell out each component rather than using Vec's
+// operators, whose SSE paths for Vec4 would get in the way of vectorizing
+// the loop across elements instead.
+template <typename T, typename Component>
+[[nodiscard]] T each_component(Component const &component) {
+    T result;
+    for(uint8_t c = 0u; c < T::components; ++c) {
+        result[c] = component(c);
+    }
+    return result;
+}
+
+struct Add {
+    static float apply(float const a, float const b) { return a + b; }
+
+    template <std::size_t N>
+    static Vec<float, N> apply(Vec<float, N> const &a,
+                               Vec<float, N> const &b)
+    {
+        return each_component<Vec<float, N>>([&](uint8_t const c) {
+            return a[c] + b[c];
+        });
+    }
+};
+
+struct Sub {
+    static float apply(float const a, float const b) { return a - b; }
+
+    template <std::size_t N>
+    static Vec<float, N> apply(Vec<float, N> const &a,
+                               Vec<float, N> const &b)
+    {
+        return each_component<Vec<float, N>>([&](uint8_t const c) {
+            return a[c] - b[c];
+        });
+    }
+};
+
+struct Mul {
+    static float apply(float const a, float const b) { return a * b; }
+
+    template <std::size_t N>
+    static Vec<float, N> apply(Vec<float, N> const &v, float const scalar) {
+        return each_component<Vec<float, N>>([&](uint8_t const c) {
+            return v[c] * scalar;
+        });
+    }
+
+    template <std::size_t N>
+    static Vec<float, N> apply(float const scalar, Vec<float, N> const &v) {
+        return apply(v, scalar);
+    }
+};
+
+struct Div {
+    static float apply(float const a, float const b) { return a / b; }
+
+    template <std::size_t N>
+    static Vec<float, N> apply(Vec<float, N> const &v, float const scalar) {
+        return each_component<Vec<float, N>>([&](uint8_t const c) {
+            return v[c] / scalar;
+        });
+    }
+};
+
+struct Negate {
+    static float apply(float const a) { return -a; }
+
+    template <std::size_t N>
+    static Vec<float, N> apply(Vec<float, N> const &v) {
+        return each_component<Vec<float, N>>([&](uint8_t const c) {
+            return -v[c];
+        });
+    }
+};
+
+struct Dot {
+    template <std::size_t N>
+    static float apply(Vec<float, N> const &a, Vec<float, N> const &b) {
+        float result = a[0] * b[0];
+        for(uint8_t c = 1u; c < N; ++c) {
+            result = detail::mul_add(a[c], b[c], result);
+        }
+        return result;
+    }
+};
+
+struct Cross {
+    static Vec3 apply(Vec3 const &a, Vec3 const &b) {
+        return Vec3 {
+            detail::mul_add(a.y, b.z, -(a.z * b.y)),
+            detail::mul_add(a.z, b.x, -(a.x * b.z)),
+            detail::mul_add(a.x, b.y, -(a.y * b.x)),
+        };
+    }
+};
+
+struct Normalize {
+    template <std::size_t N>
+    static Vec<float, N> apply(Vec<float, N> const &v) {
+        // Like normalize(), the zero vector and vectors that are already
+        // normalized come back unchanged. Choosing a scale of one for them
+        // instead of branching keeps the loop vectorizable.
+        float const length = Dot::apply(v, v);
+        bool const keep = length < epsilon
+                       || detail::abs(length - 1.0f) < epsilon;
+        float const scale = keep ? 1.0f : 1.0f / std::sqrt(length);
+
+        return Mul::apply(v, scale);
+    }
+};
+
+// =============================================================================
+// Turning operands into expressions
+template <typename T>
+struct IsVecArray : std::false_type { };
+
+template <typename Vector>
+struct IsVecArray<VecArray<Vector>> : std::true_type { };
+
+// Operands that have one element per index
+template <typename T>
+concept ArrayOperand = ArrayExpression<T> || IsVecArray<T>::value;
+
+// Operands that apply to every element
+template <typename T>
+concept ValueOperand = std::is_arithmetic_v<T> || IsFloatVec<T>::value;
+
+template <typename T>
+concept Operand = ArrayOperand<T> || ValueOperand<T>;
+
+// At least one side has to be an array, or it's not an array expression
+template <typename Left, typename Right>
+concept BinaryOperands = (ArrayOperand<Left> && Operand<Right>)
+                      || (Operand<Left> && ArrayOperand<Right>);
+
+template <ArrayExpression Expr>
+[[nodiscard]] Expr const & to_expression(Expr const &expr) {
+    return expr;
+}
+
+template <typename Vector>
+[[nodiscard]] ArrayLeaf<Vector> to_expression(VecArray<Vector> const &array) {
+    return ArrayLeaf<Vector> { array };
+}
+
+template <typename T>
+    requires std::is_arithmetic_v<T>
+[[nodiscard]] ValueLeaf<float> to_expression(T const scalar) {
+    return ValueLeaf<float> { static_cast<float>(scalar) };
+}
+
+template <std::size_t N>
+[[nodiscard]] ValueLeaf<Vec<float, N>> to_expression(Vec<float, N> const &v) {
+    return ValueLeaf<Vec<float, N>> { v };
+}
+
+template <typename T>
+using ExpressionOf = std::remove_cvref_t<
+    decltype(to_expression(std::declval<T const &>()))
+>;
+
+template <typename T>
+using ValueOf = typename ExpressionOf<T>::value_type;
+
+// Whether Op accepts elements of these types, which is how operators and
+// functions tell, say, a vector times a float from a vector plus a float
+template <typename Op, typename... Values>
+concept Applies = requires(Values const &... values) {
+    Op::apply(values...);
+};
+
+template <typename Op, typename Arg>
+[[nodiscard]] auto make_unary(Arg const &arg) {
+    return Unary<Op, ExpressionOf<Arg>> { to_expression(arg) };
+}
+
+template <typename Op, typename Left, typename Right>
+[[nodiscard]] auto make_binary(Left const &left, Right const &right) {
+    return Binary<Op, ExpressionOf<Left>, ExpressionOf<Right>> {
+        to_expression(left), to_expression(right)
+    };
+}
+
+} // namespace detail
+
+// =============================================================================
+// An expression reading a span, vector, or array of floats or vectors, one
+// element per index. The expression only refers to the elements, so the range
+// must outlive it: temporaries are rejected, other than spans and the like
+// that don't own what they point to.
+template <std::ranges::contiguous_range Range>
+    requires std::ranges::borrowed_range<Range>
+          && detail::ExpressionValue<std::ranges::range_value_t<Range>>
+[[nodiscard]] auto lazy(Range &&values) {
+    using T = std::ranges::range_value_t<Range>;
+    return detail::SpanLeaf<T> { std::span<T const> { values } };
+}
+
+// =============================================================================
+template <typename Left, typename Right>
+    requires detail::BinaryOperands<Left, Right>
+          && detail::Applies<detail::Add, detail::ValueOf<Left>,
+                             detail::ValueOf<Right>>
+[[nodiscard]] auto operator+(Left const &left, Right const &right) {
+    return detail::make_binary<detail::Add>(left, right);
+}
+
+template <typename Left, typename Right>
+    requires detail::BinaryOperands<Left, Right>
+          && detail::Applies<detail::Sub, detail::ValueOf<Left>,
+                             detail::ValueOf<Right>>
+[[nodiscard]] auto operator-(Left const &left, Right const &right) {
+    return detail::make_binary<detail::Sub>(left, right);
+}
+
+template <typename Left, typename Right>
+    requires detail::BinaryOperands<Left, Right>
+          && detail::Applies<detail::Mul, detail::ValueOf<Left>,
+                             detail::ValueOf<Right>>
+[[nodiscard]] auto operator*(Left const &left, Right const &right) {
+    return detail::make_binary<detail::Mul>(left, right);
+}
+
+template <typename Left, typename Right>
+    requires detail::BinaryOperands<Left, Right>
+          && detail::Applies<detail::Div, detail::ValueOf<Left>,
+                             detail::ValueOf<Right>>
+[[nodiscard]] auto operator/(Left const &left, Right const &right) {
+    return detail::make_binary<detail::Div>(left, right);
+}
+
+template <detail::ArrayOperand Arg>
+[[nodiscard]] auto operator-(Arg const &arg) {
+    return detail::make_unary<detail::Negate>(arg);
+}
+
+template <typename Left, typename Right>
+    requires detail::BinaryOperands<Left, Right>
+          && detail::Applies<detail::Dot, detail::ValueOf<Left>,
+                             detail::ValueOf<Right>>
+[[nodiscard]] auto dot(Left const &left, Right const &right) {
+    return detail::make_binary<detail::Dot>(left, right);
+}
+
+template <typename Left, typename Right>
+    requires detail::BinaryOperands<Left, Right>
+          && detail::Applies<detail::Cross, detail::ValueOf<Left>,
+                             detail::ValueOf<Right>>
+[[nodiscard]] auto cross(Left const &left, Right const &right) {
+    return detail::make_binary<detail::Cross>(left, right);
+}
+
+template <detail::ArrayOperand Arg>
+    requires detail::Applies<detail::Normalize, detail::ValueOf<Arg>>
+[[nodiscard]] auto normalize(Arg const &arg) {
+    return detail::make_unary<detail::Normalize>(arg);
+}
+
+// =============================================================================
+// Evaluates an expression into an array of floats or vectors of its type,
+// which must be the same size. As with VecArray, out may be one of the spans
+// the expression reads.
+template <detail::ArrayOperand Expr>
+void evaluate(Expr const &expr, std::span<detail::ValueOf<Expr>> const out) {
+    using Value = detail::ValueOf<Expr>;
+    auto const &tree = detail::to_expression(expr);
+    assert(tree.size() == out.size());
+
+    detail::evaluate_blocks(tree, [out](std::size_t const first,
+                                        std::size_t const count,
+                                        auto const &block)
+    {
+        for(std::size_t i = 0u; i < count; ++i) {
+            if constexpr(std::is_same_v<Value, float>) {
+                out[first + i] = block[0][i];
+            }
+            else {
+                Value &v = out[first + i];
+                for(uint8_t c = 0u; c < Value::components; ++c) {
+                    v[c] = block[c][i];
+                }
+            }
+        }
+    });
+}
+
+} // namespace btx::math
+
+#endif // BRASSTACKS_MATH_EXPRESSION_HPP
\ No newline at end of file
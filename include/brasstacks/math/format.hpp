@@ -0,0 +1,306 @@
+#ifndef BRASSTACKS_MATH_FORMAT_HPP
+#define BRASSTACKS_MATH_FORMAT_HPP
+
+#include "brasstacks/math/common.hpp"
+#include "brasstacks/math/Vec.hpp"
+
+#include <charconv>
+#include <cstring>
+#include <ranges>
+#include <system_error>
+#include <version>
+
+#if defined(__cpp_lib_format)
+    #include <format>
+#endif
+
+namespace btx::math {
+
+// Text input and output for vectors without iostreams: no locale, no stream
+// state, and no allocation. The text written is what operator<< writes, each
+// component in fixed notation with print_precs decimals, right-aligned in
+// print_width columns, and separated by spaces.
+//
+// Like std::to_chars(), these write into [first, last) without a terminating
+// null, and return a pointer past the last character written. If the text
+// doesn't fit, they return last and std::errc::value_too_large instead, and
+// what's left in the range is unspecified.
+
+namespace detail {
+
+template <typename T>
+struct IsVec : std::false_type { };
+
+template <typename T, std::size_t N>
+struct IsVec<Vec<T, N>> : std::true_type { };
+
+// The longest a component can get: every digit of the largest finite value,
+// plus a sign and the decimals
+template <typename T>
+inline constexpr std::size_t component_chars = std::max<std::size_t>(
+    print_width,
+    std::is_floating_point_v<T>
+        ? std::numeric_limits<T>::max_exponent10 + print_precs + 3u
+        : std::numeric_limits<T>::digits10 + 2u
+);
+
+// One component, padded on the left like std::setw() does
+template <typename T>
+std::to_chars_result component_to_chars(char *const first, char *const last,
+                                        T const value)
+{
+    std::to_chars_result result;
+    if constexpr(std::is_floating_point_v<T>) {
+        result = std::to_chars(first, last, value, std::chars_format::fixed,
+                               print_precs);
+    }
+    else {
+        result = std::to_chars(first, last, value);
+    }
+
+    auto const length = static_cast<std::size_t>(result.ptr - first);
+    if(result.ec != std::errc { } || length >= print_width) {
+        return result;
+    }
+
+    std::size_t const padding = print_width - length;
+    if(static_cast<std::size_t>(last - result.ptr) < padding) {
+        return { last, std::errc::value_too_large };
+    }
+
+    std::memmove(first + padding, first, length);
+    std::memset(first, ' ', padding);
+    return { first + print_width, std::errc { } };
+}
+
+} // namespace detail
+
+// Enough room for any one vector of this type
+template <typename Vector>
+    requires detail::IsVec<Vector>::value
+inline constexpr std::size_t max_chars =
+    Vector::components * detail::component_chars<typename Vector::value_type>
+  + Vector::components - 1u;
+
+// =============================================================================
+template <typename T, std::size_t N>
+std::to_chars_result to_chars(char *first, char *const last,
+                              Vec<T, N> const &v)
+{
+    for(uint8_t i = 0u; i < N; ++i) {
+        if(i != 0u) {
+            if(first == last) {
+                return { last, std::errc::value_too_large };
+            }
+            *first++ = ' ';
+        }
+
+        auto const result = detail::component_to_chars(first, last, v[i]);
+        if(result.ec != std::errc { }) {
+            return result;
+        }
+        first = result.ptr;
+    }
+
+    return { first, std::errc { } };
+}
+
+// Every vector in a range, like a std::vector or std::span, one per line with
+// a newline after each. A count of them needs at most
+// count * (max_chars<Vector> + 1) characters.
+template <std::ranges::input_range Range>
+    requires detail::IsVec<std::ranges::range_value_t<Range>>::value
+std::to_chars_result to_chars(char *first, char *const last,
+                              Range const &vectors)
+{
+    for(auto const &v : vectors) {
+        auto const result = to_chars(first, last, v);
+        if(result.ec != std::errc { }) {
+            return result;
+        }
+
+        first = result.ptr;
+        if(first == last) {
+            return { last, std::errc::value_too_large };
+        }
+        *first++ = '\n';
+    }
+
+    return { first, std::errc { } };
+}
+
+// =============================================================================
+// Parsing, the inverse of the above. A vector is its components in order,
+// separated by whitespace, a comma, or both, so text written by to_chars()
+// or operator<< reads back, as does "1.5, -2, 3e4". Whitespace before the
+// first component is skipped. Numbers are anything std::from_chars() takes
+// for the component type, which includes inf and nan for floats but not a
+// leading '+'.
+//
+// Like std::from_chars(), these take [first, last) and return a pointer past
+// the last character they used. On failure they return the position of the
+// problem instead: the start of a number that's missing, malformed, or too
+// large for the component type, or of any characters that run into a number
+// with no separator in between. ec says which, std::errc::invalid_argument or
+// std::errc::result_out_of_range.
+
+namespace detail {
+
+[[nodiscard]] constexpr bool is_space(char const c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v'
+        || c == '\f';
+}
+
+[[nodiscard]] constexpr char const * skip_space(char const *first,
+                                                char const *const last)
+{
+    while(first != last && is_space(*first)) {
+        ++first;
+    }
+    return first;
+}
+
+// Whitespace with at most one comma in it
+[[nodiscard]] constexpr char const * skip_separator(char const *first,
+                                                    char const *const last)
+{
+    first = skip_space(first, last);
+    if(first != last && *first == ',') {
+        first = skip_space(first + 1, last);
+    }
+    return first;
+}
+
+template <typename T>
+std::from_chars_result component_from_chars(char const *const first,
+                                            char const *const last, T &value)
+{
+    auto const result = std::from_chars(first, last, value);
+    if(result.ec != std::errc { }) {
+        return { first, result.ec };
+    }
+    return result;
+}
+
+} // namespace detail
+
+// v is only written when the whole vector parses
+template <typename T, std::size_t N>
+std::from_chars_result from_chars(char const *first, char const *const last,
+                                  Vec<T, N> &v)
+{
+    Vec<T, N> parsed;
+    first = detail::skip_space(first, last);
+
+    for(uint8_t i = 0u; i < N; ++i) {
+        if(i != 0u) {
+            char const *const next = detail::skip_separator(first, last);
+            if(next == first) {
+                return { first, std::errc::invalid_argument };
+            }
+            first = next;
+        }
+
+        auto const result =
+            detail::component_from_chars(first, last, parsed[i]);
+        if(result.ec != std::errc { }) {
+            return result;
+        }
+        first = result.ptr;
+    }
+
+    v = parsed;
+    return { first, std::errc { } };
+}
+
+// What parsing a range of vectors got through
+struct ParseResult {
+    // Past the last vector read, or where the problem is
+    char const *ptr = nullptr;
+
+    // How many vectors were written, from the front of the range
+    std::size_t count = 0u;
+
+    std::errc ec = std::errc { };
+};
+
+// Reads vectors in order into a range, like a std::vector or std::span, until
+// it's full or only whitespace is left, so count says how many there were.
+// Vectors are separated the same way their components are, which reads the
+// output of the range version of to_chars() back. A vector that's cut off
+// by the end of the text is an error, and isn't counted.
+template <std::ranges::random_access_range Range>
+    requires detail::IsVec<std::ranges::range_value_t<Range>>::value
+ParseResult from_chars(char const *first, char const *const last,
+                       Range &&out)
+{
+    ParseResult result { first };
+
+    for(auto &v : out) {
+        char const *const next = result.count == 0u
+                               ? detail::skip_space(result.ptr, last)
+                               : detail::skip_separator(result.ptr, last);
+        if(detail::skip_space(next, last) == last) {
+            break;
+        }
+        if(next == result.ptr && result.count != 0u) {
+            result.ec = std::errc::invalid_argument;
+            return result;
+        }
+
+        auto const parsed = from_chars(next, last, v);
+        result.ptr = parsed.ptr;
+        if(parsed.ec != std::errc { }) {
+            result.ec = parsed.ec;
+            return result;
+        }
+        ++result.count;
+    }
+
+    return result;
+}
+
+} // namespace btx::math
+
+#if defined(__cpp_lib_format)
+// =============================================================================
+// std::format() support. With an empty format spec, vectors come out the
+// same as to_chars() writes them. Any other spec is applied to each component
+// in turn, so std::format("{:.2f}", Vec3 { 1.0f, 2.0f, 3.0f }) gives
+// "1.00 2.00 3.00".
+template <typename T, std::size_t N>
+struct std::formatter<btx::math::Vec<T, N>, char> {
+    constexpr auto parse(std::format_parse_context &context) {
+        auto const spec = context.begin();
+        _default = spec == context.end() || *spec == '}';
+        return _component.parse(context);
+    }
+
+    template <typename Context>
+    auto format(btx::math::Vec<T, N> const &v, Context &context) const {
+        if(_default) {
+            char text[btx::math::max_chars<btx::math::Vec<T, N>>];
+            auto const result =
+                btx::math::to_chars(std::begin(text), std::end(text), v);
+            return std::copy(std::begin(text), result.ptr, context.out());
+        }
+
+        auto out = context.out();
+        for(uint8_t i = 0u; i < N; ++i) {
+            if(i != 0u) {
+                *out++ = ' ';
+            }
+            context.advance_to(out);
+            out = _component.format(v[i], context);
+        }
+
+        return out;
+    }
+
+private:
+    std::formatter<T, char> _component;
+    bool _default = true;
+};
+#endif
+
+#endif // BRASSTACKS_MATH_FORMAT_HPP
\ No newline at end of file
@@ -0,0 +1,420 @@
+#ifndef BRASSTACKS_MATH_MATH_INL_HPP
+#define BRASSTACKS_MATH_MATH_INL_HPP
+
+#include "brasstacks/math/math.hpp"
+
+namespace btx::math {
+
+// =============================================================================
+// Normalizing
+BTX_MATH_CONSTEXPR Vec2 normalize(Vec2 const &v) {
+    Vec2 result = v;
+
+    auto const length = length_squared(v);
+
+    // If we're working with the zero vector or a vector that's already
+    // normalized, just return
+    if(length < epsilon || detail::abs(length - 1.0f) < epsilon) {
+        return result;
+    }
+
+    float const length_recip = 1.0f / detail::sqrt(length);
+
+    result.x *= length_recip;
+    result.y *= length_recip;
+
+    return result;
+}
+
+BTX_MATH_CONSTEXPR Vec3 normalize(Vec3 const &v) {
+    Vec3 result = v;
+
+    auto const length = length_squared(v);
+
+    // If we're working with the zero vector or a vector that's already
+    // normalized, just return
+    if(length < epsilon || detail::abs(length - 1.0f) < epsilon) {
+        return result;
+    }
+
+    float const length_recip = 1.0f / detail::sqrt(length);
+
+    result.x *= length_recip;
+    result.y *= length_recip;
+    result.z *= length_recip;
+
+    return result;
+}
+
+BTX_MATH_CONSTEXPR Vec4 normalize(Vec4 const &v) {
+#if defined(BTX_MATH_SSE) && !defined(BTX_MATH_FMA)
+    if(BTX_MATH_IS_RUNTIME()) {
+        __m128 const vector    = simd::load(v);
+        __m128 const length_sq = simd::dot(vector, vector);
+
+        // Same early-outs as below, but computed as a lane mask and blended
+        // so the whole thing stays in one register without branching
+        __m128 const eps  = _mm_set1_ps(epsilon);
+        __m128 const skip = _mm_or_ps(
+            _mm_cmplt_ps(length_sq, eps),
+            _mm_cmplt_ps(
+                _mm_andnot_ps(simd::sign_mask(),
+                              _mm_sub_ps(length_sq, _mm_set1_ps(1.0f))),
+                eps
+            )
+        );
+
+        __m128 const scaled = _mm_div_ps(vector, _mm_sqrt_ps(length_sq));
+
+        Vec4 result;
+        simd::store(result, simd::select(skip, vector, scaled));
+        return result;
+    }
+#endif
+
+    Vec4 result = v;
+
+    auto const length = length_squared(v);
+
+    // If we're working with the zero vector or a vector that's already
+    // normalized, just return
+    if(length < epsilon || detail::abs(length - 1.0f) < epsilon) {
+        return result;
+    }
+
+    float const length_recip = 1.0f / detail::sqrt(length);
+
+    result.x *= length_recip;
+    result.y *= length_recip;
+    result.z *= length_recip;
+    result.w *= length_recip;
+
+    return result;
+}
+
+// =============================================================================
+// Dot Product
+// Each product is added to the sum of the ones before it, in order, with
+// detail::mul_add(). The batch kernels sum the same way, fused or not.
+BTX_MATH_CONSTEXPR float dot(Vec2 const &a, Vec2 const &b) {
+    return detail::mul_add(a.y, b.y, a.x * b.x);
+}
+
+BTX_MATH_CONSTEXPR float dot(Vec3 const &a, Vec3 const &b) {
+    return detail::mul_add(a.z, b.z, detail::mul_add(a.y, b.y, a.x * b.x));
+}
+
+BTX_MATH_CONSTEXPR float dot(Vec4 const &a, Vec4 const &b) {
+    // The SSE dot product instruction rounds every product, so it's only
+    // used when they aren't meant to be fused
+#if defined(BTX_MATH_SSE) && !defined(BTX_MATH_FMA)
+    if(BTX_MATH_IS_RUNTIME()) {
+        return _mm_cvtss_f32(simd::dot(simd::load(a), simd::load(b)));
+    }
+#endif
+
+    return detail::mul_add(a.w, b.w,
+           detail::mul_add(a.z, b.z,
+           detail::mul_add(a.y, b.y, a.x * b.x)));
+}
+
+// =============================================================================
+// Cross Product
+BTX_MATH_CONSTEXPR Vec3 cross(Vec3 const &a, Vec3 const &b) {
+    // Strictly, x + -y is exactly x - y, so this only changes anything when
+    // the first product of each pair is fused
+    return Vec3 {
+        detail::mul_add(a.y, b.z, -(a.z * b.y)),
+        detail::mul_add(a.z, b.x, -(a.x * b.z)),
+        detail::mul_add(a.x, b.y, -(a.y * b.x)),
+    };
+}
+
+// =============================================================================
+// Matrices
+BTX_MATH_CONSTEXPR Mat4 transpose(Mat4 const &m) {
+#if defined(BTX_MATH_SSE)
+    if(BTX_MATH_IS_RUNTIME()) {
+        __m128 x = simd::load(m.x);
+        __m128 y = simd::load(m.y);
+        __m128 z = simd::load(m.z);
+        __m128 w = simd::load(m.w);
+
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+
+        Mat4 result;
+        simd::store(result.x, x);
+        simd::store(result.y, y);
+        simd::store(result.z, z);
+        simd::store(result.w, w);
+        return result;
+    }
+#endif
+
+    return {
+        { m.x.x, m.y.x, m.z.x, m.w.x },
+        { m.x.y, m.y.y, m.z.y, m.w.y },
+        { m.x.z, m.y.z, m.z.z, m.w.z },
+        { m.x.w, m.y.w, m.z.w, m.w.w },
+    };
+}
+
+BTX_MATH_CONSTEXPR Mat4 inverse_affine(Mat4 const &m) {
+    // With a, b, and c the first three columns, the rows of the inverse of
+    // the upper 3x3 are b x c, c x a, and a x b, each divided by the
+    // determinant. The translation is then undone by the inverted 3x3.
+#if defined(BTX_MATH_SSE)
+    if(BTX_MATH_IS_RUNTIME()) {
+        auto const cross3 = [](__m128 const u, __m128 const v) {
+            __m128 const u_yzx = _mm_shuffle_ps(u, u, _MM_SHUFFLE(3, 0, 2, 1));
+            __m128 const u_zxy = _mm_shuffle_ps(u, u, _MM_SHUFFLE(3, 1, 0, 2));
+            __m128 const v_yzx = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 2, 1));
+            __m128 const v_zxy = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 1, 0, 2));
+            return _mm_sub_ps(_mm_mul_ps(u_yzx, v_zxy),
+                              _mm_mul_ps(u_zxy, v_yzx));
+        };
+
+        __m128 const a = simd::load(m.x);
+        __m128 const b = simd::load(m.y);
+        __m128 const c = simd::load(m.z);
+
+        __m128 r0 = cross3(b, c);
+        __m128 r1 = cross3(c, a);
+        __m128 r2 = cross3(a, b);
+
+        // (a.x * r0.x + a.y * r0.y) + a.z * r0.z, like the scalar dot()
+        __m128 const products = _mm_mul_ps(a, r0);
+        float const det = _mm_cvtss_f32(_mm_add_ss(
+            _mm_add_ss(products, simd::splat<1>(products)),
+            _mm_movehl_ps(products, products)
+        ));
+
+        if(det == 0.0f) {
+            return Mat4::zero;
+        }
+
+        __m128 const det_recip = _mm_set1_ps(1.0f / det);
+        r0 = _mm_mul_ps(r0, det_recip);
+        r1 = _mm_mul_ps(r1, det_recip);
+        r2 = _mm_mul_ps(r2, det_recip);
+        __m128 r3 = _mm_setzero_ps();
+
+        // Rows to columns, which also zeroes the last row of the result
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+        __m128 const t = simd::load(m.w);
+        __m128 translation = _mm_mul_ps(r0, simd::splat<0>(t));
+        translation = _mm_add_ps(translation,
+                                 _mm_mul_ps(r1, simd::splat<1>(t)));
+        translation = _mm_add_ps(translation,
+                                 _mm_mul_ps(r2, simd::splat<2>(t)));
+
+        __m128 const w_lane = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+
+        Mat4 result;
+        simd::store(result.x, r0);
+        simd::store(result.y, r1);
+        simd::store(result.z, r2);
+        simd::store(result.w, simd::select(
+            w_lane, _mm_set1_ps(1.0f),
+            _mm_xor_ps(translation, simd::sign_mask())
+        ));
+        return result;
+    }
+#endif
+
+    Vec3 const a { m.x.x, m.x.y, m.x.z };
+    Vec3 const b { m.y.x, m.y.y, m.y.z };
+    Vec3 const c { m.z.x, m.z.y, m.z.z };
+
+    Vec3 const r0 = cross(b, c);
+    Vec3 const r1 = cross(c, a);
+    Vec3 const r2 = cross(a, b);
+
+    float const det = dot(a, r0);
+    if(det == 0.0f) {
+        return Mat4::zero;
+    }
+
+    float const det_recip = 1.0f / det;
+
+    Vec4 const x { r0.x * det_recip, r1.x * det_recip, r2.x * det_recip, 0.0f };
+    Vec4 const y { r0.y * det_recip, r1.y * det_recip, r2.y * det_recip, 0.0f };
+    Vec4 const z { r0.z * det_recip, r1.z * det_recip, r2.z * det_recip, 0.0f };
+
+    Vec4 const &t = m.w;
+    return {
+        x, y, z,
+        {
+            -((x.x * t.x) + (y.x * t.y) + (z.x * t.z)),
+            -((x.y * t.x) + (y.y * t.y) + (z.y * t.z)),
+            -((x.z * t.x) + (y.z * t.y) + (z.z * t.z)),
+            1.0f
+        },
+    };
+}
+
+BTX_MATH_CONSTEXPR Mat4 inverse(Mat4 const &m) {
+    if(m.x.w == 0.0f && m.y.w == 0.0f && m.z.w == 0.0f && m.w.w == 1.0f) {
+        return inverse_affine(m);
+    }
+
+    // Laplace expansion by 2x2 minors: the s terms come from the first two
+    // columns and the c terms from the last two. Inverting the transpose and
+    // transposing the result gives the same thing, so this works on columns
+    // just as well as it does on the rows it's usually written for.
+    float const s0 = (m.x.x * m.y.y) - (m.y.x * m.x.y);
+    float const s1 = (m.x.x * m.y.z) - (m.y.x * m.x.z);
+    float const s2 = (m.x.x * m.y.w) - (m.y.x * m.x.w);
+    float const s3 = (m.x.y * m.y.z) - (m.y.y * m.x.z);
+    float const s4 = (m.x.y * m.y.w) - (m.y.y * m.x.w);
+    float const s5 = (m.x.z * m.y.w) - (m.y.z * m.x.w);
+
+    float const c5 = (m.z.z * m.w.w) - (m.w.z * m.z.w);
+    float const c4 = (m.z.y * m.w.w) - (m.w.y * m.z.w);
+    float const c3 = (m.z.y * m.w.z) - (m.w.y * m.z.z);
+    float const c2 = (m.z.x * m.w.w) - (m.w.x * m.z.w);
+    float const c1 = (m.z.x * m.w.z) - (m.w.x * m.z.z);
+    float const c0 = (m.z.x * m.w.y) - (m.w.x * m.z.y);
+
+    float const det = (s0 * c5) - (s1 * c4) + (s2 * c3)
+                    + (s3 * c2) - (s4 * c1) + (s5 * c0);
+    if(det == 0.0f) {
+        return Mat4::zero;
+    }
+
+    float const r = 1.0f / det;
+
+    return {
+        {
+            ( (m.y.y * c5) - (m.y.z * c4) + (m.y.w * c3)) * r,
+            (-(m.x.y * c5) + (m.x.z * c4) - (m.x.w * c3)) * r,
+            ( (m.w.y * s5) - (m.w.z * s4) + (m.w.w * s3)) * r,
+            (-(m.z.y * s5) + (m.z.z * s4) - (m.z.w * s3)) * r,
+        },
+        {
+            (-(m.y.x * c5) + (m.y.z * c2) - (m.y.w * c1)) * r,
+            ( (m.x.x * c5) - (m.x.z * c2) + (m.x.w * c1)) * r,
+            (-(m.w.x * s5) + (m.w.z * s2) - (m.w.w * s1)) * r,
+            ( (m.z.x * s5) - (m.z.z * s2) + (m.z.w * s1)) * r,
+        },
+        {
+            ( (m.y.x * c4) - (m.y.y * c2) + (m.y.w * c0)) * r,
+            (-(m.x.x * c4) + (m.x.y * c2) - (m.x.w * c0)) * r,
+            ( (m.w.x * s4) - (m.w.y * s2) + (m.w.w * s0)) * r,
+            (-(m.z.x * s4) + (m.z.y * s2) - (m.z.w * s0)) * r,
+        },
+        {
+            (-(m.y.x * c3) + (m.y.y * c1) - (m.y.z * c0)) * r,
+            ( (m.x.x * c3) - (m.x.y * c1) + (m.x.z * c0)) * r,
+            (-(m.w.x * s3) + (m.w.y * s1) - (m.w.z * s0)) * r,
+            ( (m.z.x * s3) - (m.z.y * s1) + (m.z.z * s0)) * r,
+        },
+    };
+}
+
+// =============================================================================
+// Quaternions
+BTX_MATH_INLINE Quat Quat::from_axis_angle(Vec3 const &axis, float const deg) {
+    float const half_angle = radians(deg) * 0.5f;
+    float const scale = std::sin(half_angle)
+                      / detail::sqrt(length_squared(axis));
+
+    return {
+        axis.x * scale,
+        axis.y * scale,
+        axis.z * scale,
+        std::cos(half_angle),
+    };
+}
+
+BTX_MATH_CONSTEXPR float dot(Quat const &a, Quat const &b) {
+    return detail::mul_add(a.w, b.w,
+           detail::mul_add(a.z, b.z,
+           detail::mul_add(a.y, b.y, a.x * b.x)));
+}
+
+BTX_MATH_CONSTEXPR Quat normalize(Quat const &q) {
+    auto const length = length_squared(q);
+
+    if(length < epsilon) {
+        return q;
+    }
+
+    float const length_recip = 1.0f / detail::sqrt(length);
+
+    return {
+        q.x * length_recip,
+        q.y * length_recip,
+        q.z * length_recip,
+        q.w * length_recip,
+    };
+}
+
+BTX_MATH_CONSTEXPR Quat conjugate(Quat const &q) {
+    return { -q.x, -q.y, -q.z, q.w };
+}
+
+BTX_MATH_CONSTEXPR Quat inverse(Quat const &q) {
+    auto const length = length_squared(q);
+
+    if(length == 0.0f) {
+        return { 0.0f, 0.0f, 0.0f, 0.0f };
+    }
+
+    return conjugate(q) * (1.0f / length);
+}
+
+BTX_MATH_CONSTEXPR Vec3 rotate(Quat const &q, Vec3 const &v) {
+    // With u the vector part, q * v * q^-1 expands to
+    // v + 2w(u x v) + 2(u x (u x v))
+    Vec3 const u { q.x, q.y, q.z };
+    Vec3 const t = 2.0f * cross(u, v);
+
+    return v + q.w * t + cross(u, t);
+}
+
+BTX_MATH_CONSTEXPR Quat nlerp(Quat const &a, Quat const &b, float const t) {
+    // Negating b when the two are more than 90 degrees apart in 4D keeps the
+    // blend on the shorter arc, since b and -b are the same rotation
+    float const weight_a = 1.0f - t;
+    float const weight_b = dot(a, b) < 0.0f ? -t : t;
+
+    return normalize(Quat {
+        (a.x * weight_a) + (b.x * weight_b),
+        (a.y * weight_a) + (b.y * weight_b),
+        (a.z * weight_a) + (b.z * weight_b),
+        (a.w * weight_a) + (b.w * weight_b),
+    });
+}
+
+BTX_MATH_INLINE Quat slerp(Quat const &a, Quat const &b, float const t) {
+    float cos_theta = dot(a, b);
+    float sign = 1.0f;
+    if(cos_theta < 0.0f) {
+        cos_theta = -cos_theta;
+        sign = -1.0f;
+    }
+
+    // sin(theta) heads to zero here, and the division below with it
+    if(cos_theta > 1.0f - epsilon) {
+        return nlerp(a, b, t);
+    }
+
+    float const theta = std::acos(cos_theta);
+    float const sin_recip = 1.0f / std::sin(theta);
+
+    float const weight_a = std::sin((1.0f - t) * theta) * sin_recip;
+    float const weight_b = std::sin(t * theta) * sin_recip * sign;
+
+    return {
+        (a.x * weight_a) + (b.x * weight_b),
+        (a.y * weight_a) + (b.y * weight_b),
+        (a.z * weight_a) + (b.z * weight_b),
+        (a.w * weight_a) + (b.w * weight_b),
+    };
+}
+
+} // namespace btx::math
+
+#endif // BRASSTACKS_MATH_MATH_INL_HPP
\ No newline at end of file
@@ -1,10 +1,10 @@
 #ifndef BRASSTACKS_MATH_MATH_HPP
 #define BRASSTACKS_MATH_MATH_HPP
 
-#include "brasstacks/math/pch.hpp"
-#include "brasstacks/math/Vec2.hpp"
-#include "brasstacks/math/Vec3.hpp"
-#include "brasstacks/math/Vec4.hpp"
+#include "brasstacks/math/common.hpp"
+#include "brasstacks/math/Vec.hpp"
+#include "brasstacks/math/Mat4.hpp"
+#include "brasstacks/math/Quat.hpp"
 
 namespace btx::math {
 
@@ -12,78 +12,196 @@ namespace btx::math {
 static_assert(sizeof(Vec2) == sizeof(float) * 2);
 static_assert(sizeof(Vec3) == sizeof(float) * 3);
 static_assert(sizeof(Vec4) == sizeof(float) * 4);
+static_assert(sizeof(DVec3) == sizeof(double) * 3);
+static_assert(sizeof(IVec3) == sizeof(int32_t) * 3);
+static_assert(sizeof(Mat4) == sizeof(float) * 16);
+static_assert(sizeof(Quat) == sizeof(float) * 4);
 
 static_assert(std::is_trivially_copyable_v<Vec2>);
 static_assert(std::is_trivially_copyable_v<Vec3>);
 static_assert(std::is_trivially_copyable_v<Vec4>);
+static_assert(std::is_trivially_copyable_v<DVec3>);
+static_assert(std::is_trivially_copyable_v<IVec3>);
+static_assert(std::is_trivially_copyable_v<Mat4>);
+static_assert(std::is_trivially_copyable_v<Quat>);
 
 static_assert(std::is_trivially_copy_constructible_v<Vec2>);
 static_assert(std::is_trivially_copy_constructible_v<Vec3>);
 static_assert(std::is_trivially_copy_constructible_v<Vec4>);
-
-// For pretty-printing
-static uint8_t constexpr print_precs = 8u;
-static uint8_t constexpr print_width = 2u * print_precs + 2u;
-
-// General constants
-static float constexpr epsilon = 1.0e-4f;
-static float constexpr pi = std::numbers::pi_v<float>;
-static float constexpr pi_over_one_eighty = pi / 180.0f;
-static float constexpr one_eighty_over_pi = 180.0f / pi;
+static_assert(std::is_trivially_copy_constructible_v<Mat4>);
+static_assert(std::is_trivially_copy_constructible_v<Quat>);
+
+// Components sit back to back from x, so vectors can be read and written as
+// arrays of their component type
+static_assert(std::is_standard_layout_v<Vec3>);
+static_assert(std::is_standard_layout_v<DVec3>);
+static_assert(std::is_standard_layout_v<IVec3>);
+
+#if defined(BTX_MATH_SIMD)
+// The SIMD backend loads and stores Vec4 with aligned instructions
+static_assert(alignof(Vec4) == 16u);
+static_assert(alignof(Mat4) == 16u);
+static_assert(alignof(Quat) == 16u);
+#endif
 
 // Conversions
-[[nodiscard]] inline float radians(float const deg) {
+[[nodiscard]] constexpr float radians(float const deg) {
     return deg * pi_over_one_eighty;
 }
-[[nodiscard]] inline float degrees(float const rad) {
+[[nodiscard]] constexpr float degrees(float const rad) {
     return rad * one_eighty_over_pi;
 }
 
 // =============================================================================
 // Vector length
-[[nodiscard]] inline float length_squared(Vec2 const &v) {
-    return (v.x * v.x) + (v.y * v.y);
+[[nodiscard]] constexpr float length_squared(Vec2 const &v) {
+    return detail::mul_add(v.y, v.y, v.x * v.x);
+}
+[[nodiscard]] constexpr float length_squared(Vec3 const &v) {
+    return detail::mul_add(v.z, v.z, detail::mul_add(v.y, v.y, v.x * v.x));
 }
-[[nodiscard]] inline float length_squared(Vec3 const &v) {
-    return (v.x * v.x) + (v.y * v.y) + (v.z * v.z);
+[[nodiscard]] constexpr float length_squared(Vec4 const &v) {
+    return detail::mul_add(v.w, v.w,
+           detail::mul_add(v.z, v.z,
+           detail::mul_add(v.y, v.y, v.x * v.x)));
 }
-[[nodiscard]] inline float length_squared(Vec4 const &v) {
-    return (v.x * v.x) + (v.y * v.y) + (v.z * v.z) + (v.w * v.w);
+[[nodiscard]] constexpr float length_squared(Quat const &q) {
+    return detail::mul_add(q.w, q.w,
+           detail::mul_add(q.z, q.z,
+           detail::mul_add(q.y, q.y, q.x * q.x)));
 }
 
+// Returns the same type as length_squared(), so double vectors keep their
+// precision
 template <typename Vector>
-[[nodiscard]] inline float length(Vector const &v) {
-    float length_sq = length_squared(v);
+[[nodiscard]] constexpr auto length(Vector const &v) {
+    auto const length_sq = length_squared(v);
+    using Scalar = std::remove_const_t<decltype(length_sq)>;
 
     // If we're dealing with the zero vector, return zero
-    if(std::abs(length_sq) < epsilon) {
-        return 0.0f;
+    if(detail::abs(length_sq) < epsilon) {
+        return Scalar { 0 };
     }
 
     // If it's a unit vector, skip the square root calculation
-    if(std::abs(length_sq - 1.0f) < epsilon) {
+    if(detail::abs(length_sq - Scalar { 1 }) < epsilon) {
         return length_sq;
     }
 
-    return std::sqrt(length_sq);
+    return detail::sqrt(length_sq);
 }
 
 // =============================================================================
 // Normalizing
-[[nodiscard]] Vec2 normalize(Vec2 const &v);
-[[nodiscard]] Vec3 normalize(Vec3 const &v);
-[[nodiscard]] Vec4 normalize(Vec4 const &v);
+[[nodiscard]] BTX_MATH_CONSTEXPR Vec2 normalize(Vec2 const &v);
+[[nodiscard]] BTX_MATH_CONSTEXPR Vec3 normalize(Vec3 const &v);
+[[nodiscard]] BTX_MATH_CONSTEXPR Vec4 normalize(Vec4 const &v);
 
 // =============================================================================
 // Dot Product
-[[nodiscard]] float dot(Vec2 const &a, Vec2 const &b);
-[[nodiscard]] float dot(Vec3 const &a, Vec3 const &b);
-[[nodiscard]] float dot(Vec4 const &a, Vec4 const &b);
+[[nodiscard]] BTX_MATH_CONSTEXPR float dot(Vec2 const &a, Vec2 const &b);
+[[nodiscard]] BTX_MATH_CONSTEXPR float dot(Vec3 const &a, Vec3 const &b);
+[[nodiscard]] BTX_MATH_CONSTEXPR float dot(Vec4 const &a, Vec4 const &b);
 
 // =============================================================================
 // Cross Product
-[[nodiscard]] Vec3 cross(Vec3 const &a, Vec3 const &b);
+[[nodiscard]] BTX_MATH_CONSTEXPR Vec3 cross(Vec3 const &a, Vec3 const &b);
+
+// =============================================================================
+// Other component types
+// The float vectors above have their own overloads, with SIMD paths where
+// they help. These cover the double and integer vectors, and like Vec itself
+// are constexpr in every build mode. normalize() and length() need floating
+// point components.
+template <typename T, std::size_t N>
+    requires (!std::is_same_v<T, float>)
+[[nodiscard]] constexpr T dot(Vec<T, N> const &a, Vec<T, N> const &b) {
+    T result = a[0] * b[0];
+    for(uint8_t i = 1u; i < N; ++i) {
+        result += a[i] * b[i];
+    }
+    return result;
+}
+
+template <typename T, std::size_t N>
+    requires (!std::is_same_v<T, float>)
+[[nodiscard]] constexpr T length_squared(Vec<T, N> const &v) {
+    return dot(v, v);
+}
+
+template <typename T>
+    requires (!std::is_same_v<T, float>)
+[[nodiscard]] constexpr Vec<T, 3u> cross(Vec<T, 3u> const &a,
+                                         Vec<T, 3u> const &b)
+{
+    return Vec<T, 3u> {
+        (a.y * b.z) - (a.z * b.y),
+        (a.z * b.x) - (a.x * b.z),
+        (a.x * b.y) - (a.y * b.x),
+    };
+}
+
+template <std::floating_point T, std::size_t N>
+    requires (!std::is_same_v<T, float>)
+[[nodiscard]] constexpr Vec<T, N> normalize(Vec<T, N> const &v) {
+    T const length = length_squared(v);
+
+    // Same as the float versions: the zero vector and vectors that are
+    // already normalized come back unchanged
+    if(length < epsilon || detail::abs(length - T { 1 }) < epsilon) {
+        return v;
+    }
+
+    return v * (T { 1 } / detail::sqrt(length));
+}
+
+// =============================================================================
+// Matrices
+[[nodiscard]] BTX_MATH_CONSTEXPR Mat4 transpose(Mat4 const &m);
+
+// The inverse of an affine transform, one whose last row is 0, 0, 0, 1: any
+// mix of rotation, scale, shear, and translation. That only takes inverting
+// the upper 3x3 and a matrix-vector multiply, so it's several times cheaper
+// than the general inverse(). Other matrices give meaningless results. A
+// singular matrix has no inverse, and gives Mat4::zero.
+[[nodiscard]] BTX_MATH_CONSTEXPR Mat4 inverse_affine(Mat4 const &m);
+
+// The general inverse, which uses inverse_affine() whenever m's last row is
+// exactly 0, 0, 0, 1. A singular matrix gives Mat4::zero.
+[[nodiscard]] BTX_MATH_CONSTEXPR Mat4 inverse(Mat4 const &m);
+
+// =============================================================================
+// Quaternions
+[[nodiscard]] BTX_MATH_CONSTEXPR float dot(Quat const &a, Quat const &b);
+
+// Unlike the vector versions, this rescales quaternions that are already
+// close to unit length too, since that's how drift from repeated products
+// gets corrected. Only the zero quaternion is returned unchanged.
+[[nodiscard]] BTX_MATH_CONSTEXPR Quat normalize(Quat const &q);
+
+// The conjugate is the inverse of a unit quaternion, and much cheaper than
+// the general inverse(). The zero quaternion has no inverse, and gives zero.
+[[nodiscard]] BTX_MATH_CONSTEXPR Quat conjugate(Quat const &q);
+[[nodiscard]] BTX_MATH_CONSTEXPR Quat inverse(Quat const &q);
+
+// v rotated by the unit quaternion q, the same as q * v * conjugate(q) but
+// with two cross products instead of two full quaternion products
+[[nodiscard]] BTX_MATH_CONSTEXPR Vec3 rotate(Quat const &q, Vec3 const &v);
+
+// Interpolation between unit quaternions, from a at t = 0 to b at t = 1,
+// always along the shorter of the two arcs between them. nlerp() blends the
+// components and renormalizes, so it's cheap but doesn't move at a constant
+// angular speed. slerp() does, and falls back to nlerp() when a and b are
+// too close together for the angle between them to be computed accurately.
+[[nodiscard]] BTX_MATH_CONSTEXPR Quat nlerp(Quat const &a, Quat const &b,
+                                            float t);
+[[nodiscard]] BTX_MATH_INLINE Quat slerp(Quat const &a, Quat const &b,
+                                         float t);
 
 } // namespace btx::math
 
+#if defined(BTX_MATH_HEADER_ONLY)
+    #include "brasstacks/math/math-inl.hpp"
+#endif
+
 #endif // BRASSTACKS_MATH_MATH_HPP
\ No newline at end of file
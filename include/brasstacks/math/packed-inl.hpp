@@ -0,0 +1,136 @@
+#ifndef BRASSTACKS_MATH_PACKED_INL_HPP
+#define BRASSTACKS_MATH_PACKED_INL_HPP
+
+#include "brasstacks/math/packed.hpp"
+
+namespace btx::math {
+
+// =============================================================================
+BTX_MATH_CONSTEXPR Half3 to_half(Vec3 const &v) {
+    return { to_half(v.x), to_half(v.y), to_half(v.z) };
+}
+
+BTX_MATH_CONSTEXPR Half4 to_half(Vec4 const &v) {
+    return { to_half(v.x), to_half(v.y), to_half(v.z), to_half(v.w) };
+}
+
+BTX_MATH_CONSTEXPR Vec3 from_half(Half3 const &h) {
+    return { from_half(h.x), from_half(h.y), from_half(h.z) };
+}
+
+BTX_MATH_CONSTEXPR Vec4 from_half(Half4 const &h) {
+    return { from_half(h.x), from_half(h.y), from_half(h.z), from_half(h.w) };
+}
+
+// =============================================================================
+BTX_MATH_CONSTEXPR Q16Vec3 quantize(Vec3 const &v, AABB const &bounds) {
+    auto const component = [](float const value, float const min,
+                              float const max)
+    {
+        float const extent = max - min;
+        if(!(extent > 0.0f)) {
+            return uint16_t { 0u };
+        }
+
+        float const steps = (value - min) * (65535.0f / extent);
+        float const clamped = steps < 0.0f      ? 0.0f
+                            : steps > 65535.0f  ? 65535.0f
+                            : steps;
+        return static_cast<uint16_t>(clamped + 0.5f);
+    };
+
+    return {
+        component(v.x, bounds.min.x, bounds.max.x),
+        component(v.y, bounds.min.y, bounds.max.y),
+        component(v.z, bounds.min.z, bounds.max.z),
+    };
+}
+
+BTX_MATH_CONSTEXPR Vec3 dequantize(Q16Vec3 const &q, AABB const &bounds) {
+    auto const component = [](uint16_t const value, float const min,
+                              float const max)
+    {
+        return min + static_cast<float>(value) * ((max - min) / 65535.0f);
+    };
+
+    return {
+        component(q.x, bounds.min.x, bounds.max.x),
+        component(q.y, bounds.min.y, bounds.max.y),
+        component(q.z, bounds.min.z, bounds.max.z),
+    };
+}
+
+// =============================================================================
+namespace detail {
+
+// The arithmetic behind the octahedral conversions, shared by both sizes.
+// The kernels repeat these steps in the same order, so every level gives
+// the same bits.
+template <typename Oct, float scale>
+BTX_MATH_CONSTEXPR Oct to_oct(Vec3 const &n) {
+    // Onto the octahedron |x| + |y| + |z| = 1, with the zero vector kept
+    // finite so it lands on (0, 0)
+    float length = abs(n.x) + abs(n.y) + abs(n.z);
+    length = length < std::numeric_limits<float>::min()
+           ? std::numeric_limits<float>::min()
+           : length;
+
+    float const inverse = 1.0f / length;
+    float x = n.x * inverse;
+    float y = n.y * inverse;
+
+    // The lower half folds out over the triangles at the corners
+    if(n.z < 0.0f) {
+        float const folded_x = (1.0f - abs(y)) * (x < 0.0f ? -1.0f : 1.0f);
+        float const folded_y = (1.0f - abs(x)) * (y < 0.0f ? -1.0f : 1.0f);
+        x = folded_x;
+        y = folded_y;
+    }
+
+    // Rounded to nearest, halfway cases away from zero
+    using Int = decltype(Oct::x);
+    return {
+        static_cast<Int>(x * scale + (x < 0.0f ? -0.5f : 0.5f)),
+        static_cast<Int>(y * scale + (y < 0.0f ? -0.5f : 0.5f)),
+    };
+}
+
+template <float scale>
+BTX_MATH_CONSTEXPR Vec3 from_oct(float const qx, float const qy) {
+    // The most negative integer is one past -1, and clamps back to it
+    float x = qx * (1.0f / scale);
+    float y = qy * (1.0f / scale);
+    x = x < -1.0f ? -1.0f : x;
+    y = y < -1.0f ? -1.0f : y;
+
+    // Unfolding the lower half again
+    float const z = 1.0f - abs(x) - abs(y);
+    float const t = z < 0.0f ? -z : 0.0f;
+    x = x < 0.0f ? x + t : x - t;
+    y = y < 0.0f ? y + t : y - t;
+
+    float const inverse = 1.0f / sqrt(x * x + y * y + z * z);
+    return { x * inverse, y * inverse, z * inverse };
+}
+
+} // namespace detail
+
+BTX_MATH_CONSTEXPR Oct16 to_oct16(Vec3 const &n) {
+    return detail::to_oct<Oct16, 32767.0f>(n);
+}
+
+BTX_MATH_CONSTEXPR Oct8 to_oct8(Vec3 const &n) {
+    return detail::to_oct<Oct8, 127.0f>(n);
+}
+
+BTX_MATH_CONSTEXPR Vec3 from_oct(Oct16 const &o) {
+    return detail::from_oct<32767.0f>(o.x, o.y);
+}
+
+BTX_MATH_CONSTEXPR Vec3 from_oct(Oct8 const &o) {
+    return detail::from_oct<127.0f>(o.x, o.y);
+}
+
+} // namespace btx::math
+
+#endif // BRASSTACKS_MATH_PACKED_INL_HPP
\ No newline at end of file
@@ -0,0 +1,205 @@
+#ifndef BRASSTACKS_MATH_PACKED_HPP
+#define BRASSTACKS_MATH_PACKED_HPP
+
+#include "brasstacks/math/common.hpp"
+#include "brasstacks/math/Vec.hpp"
+#include "brasstacks/math/AABB.hpp"
+
+#include <bit>
+
+namespace btx::math {
+
+// Compact storage formats for vectors, for when moving them through memory
+// costs more than the arithmetic done on them: vertex streams, network
+// snapshots, and the like. None of these support arithmetic directly; they
+// unpack to the regular types first.
+
+// =============================================================================
+// Half precision
+// IEEE 754 binary16 components, at half the size of floats. Converting from
+// float rounds to the nearest half, ties to even, so for magnitudes between
+// 2^-14 (about 6.1e-5) and 65504 the relative error is at most 2^-11 (about
+// 4.9e-4). Smaller magnitudes become subnormal halves with an absolute error
+// of at most 2^-25 (about 3.0e-8), and larger ones round to infinity from
+// 65520 up. Infinities convert to infinities, and NaNs to quiet NaNs.
+// Converting back to float is exact.
+struct Half3 {
+    uint16_t x = 0u;
+    uint16_t y = 0u;
+    uint16_t z = 0u;
+};
+
+struct Half4 {
+    uint16_t x = 0u;
+    uint16_t y = 0u;
+    uint16_t z = 0u;
+    uint16_t w = 0u;
+};
+
+static_assert(sizeof(Half3) == sizeof(uint16_t) * 3);
+static_assert(sizeof(Half4) == sizeof(uint16_t) * 4);
+
+// Single values never touch the vector types, so these are constexpr in
+// every build mode
+[[nodiscard]] constexpr uint16_t to_half(float f);
+[[nodiscard]] constexpr float    from_half(uint16_t h);
+
+[[nodiscard]] BTX_MATH_CONSTEXPR Half3 to_half(Vec3 const &v);
+[[nodiscard]] BTX_MATH_CONSTEXPR Half4 to_half(Vec4 const &v);
+[[nodiscard]] BTX_MATH_CONSTEXPR Vec3  from_half(Half3 const &h);
+[[nodiscard]] BTX_MATH_CONSTEXPR Vec4  from_half(Half4 const &h);
+
+// =============================================================================
+// Quantized
+// Each component as a 16-bit fraction of the way across a bounding box, 0 at
+// the box's min and 65535 at its max, rounded to the nearest step. Inside
+// the box the error per component is at most half a step, extent / 131070,
+// plus a few float ulps from the arithmetic: about 7.6e-6 of the box's size,
+// compared to half's 4.9e-4 of each value. Points outside the box are moved
+// onto it first, and a box that's flat along an axis gives 0 along it.
+struct Q16Vec3 {
+    uint16_t x = 0u;
+    uint16_t y = 0u;
+    uint16_t z = 0u;
+};
+
+static_assert(sizeof(Q16Vec3) == sizeof(uint16_t) * 3);
+
+[[nodiscard]] BTX_MATH_CONSTEXPR Q16Vec3 quantize(Vec3 const &v,
+                                                 AABB const &bounds);
+[[nodiscard]] BTX_MATH_CONSTEXPR Vec3 dequantize(Q16Vec3 const &q,
+                                                 AABB const &bounds);
+
+// =============================================================================
+// Octahedral
+// Unit vectors as two snorm components, by projecting the sphere onto an
+// octahedron and unfolding that into a square. 2x16 bits keeps every
+// direction within 0.004 degrees, and 2x8 bits within 1 degree, at a third
+// and a sixth of the size of a Vec3. Decoding always gives
+// a unit vector. Encoding expects one too, though any nonzero length gives
+// the same direction, and the zero vector comes back as +z.
+struct Oct16 {
+    int16_t x = 0;
+    int16_t y = 0;
+};
+
+struct Oct8 {
+    int8_t x = 0;
+    int8_t y = 0;
+};
+
+static_assert(sizeof(Oct16) == sizeof(int16_t) * 2);
+static_assert(sizeof(Oct8) == sizeof(int8_t) * 2);
+
+[[nodiscard]] BTX_MATH_CONSTEXPR Oct16 to_oct16(Vec3 const &n);
+[[nodiscard]] BTX_MATH_CONSTEXPR Oct8  to_oct8(Vec3 const &n);
+[[nodiscard]] BTX_MATH_CONSTEXPR Vec3  from_oct(Oct16 const &o);
+[[nodiscard]] BTX_MATH_CONSTEXPR Vec3  from_oct(Oct8 const &o);
+
+// =============================================================================
+// Bulk conversions, through the same SIMD dispatch as batch.hpp. Half
+// conversions use the F16C instructions at the AVX2 and AVX-512 levels, and
+// give exactly the same bits as the scalar functions above at every level.
+// Quantizing works out each axis's step once for the whole span, then does
+// the same arithmetic as quantize() and dequantize() for every vector. That
+// and the octahedral conversions match the scalar versions unless the
+// calling code is built to reorder or fuse float operations. Each output
+// span must be the same size as its input.
+void to_half(std::span<Vec3 const> v, std::span<Half3> out);
+void to_half(std::span<Vec4 const> v, std::span<Half4> out);
+void from_half(std::span<Half3 const> h, std::span<Vec3> out);
+void from_half(std::span<Half4 const> h, std::span<Vec4> out);
+
+void quantize(AABB const &bounds, std::span<Vec3 const> v,
+              std::span<Q16Vec3> out);
+void dequantize(AABB const &bounds, std::span<Q16Vec3 const> q,
+                std::span<Vec3> out);
+
+void to_oct16(std::span<Vec3 const> n, std::span<Oct16> out);
+void to_oct8(std::span<Vec3 const> n, std::span<Oct8> out);
+void from_oct(std::span<Oct16 const> o, std::span<Vec3> out);
+void from_oct(std::span<Oct8 const> o, std::span<Vec3> out);
+
+// =============================================================================
+constexpr uint16_t to_half(float const f) {
+    // All integer arithmetic, which -ffast-math can't reassociate and which
+    // works the same during constant evaluation
+    auto const bits = std::bit_cast<uint32_t>(f);
+    auto const sign = static_cast<uint16_t>((bits >> 16u) & 0x8000u);
+    uint32_t const magnitude = bits & 0x7FFFFFFFu;
+
+    // Infinity and NaN, keeping the top of a NaN's payload and making it
+    // quiet, as the F16C instructions do
+    if(magnitude >= 0x7F800000u) {
+        uint32_t const payload = magnitude > 0x7F800000u
+            ? 0x200u | ((magnitude >> 13u) & 0x3FFu)
+            : 0u;
+        return static_cast<uint16_t>(sign | 0x7C00u | payload);
+    }
+
+    // Normal halves, and anything too large for one. Rebias the exponent,
+    // then round off the low 13 mantissa bits to nearest even. A carry out
+    // of the mantissa bumps the exponent, which is the right answer, up to
+    // and including overflowing to infinity.
+    if(magnitude >= 0x38800000u) {                      // 2^-14
+        if(magnitude >= 0x477FF000u) {                  // Rounds to 65536
+            return static_cast<uint16_t>(sign | 0x7C00u);
+        }
+
+        uint32_t const odd = (magnitude >> 13u) & 1u;
+        uint32_t const rebiased = magnitude - 0x38000000u + 0xFFFu + odd;
+        return static_cast<uint16_t>(sign | (rebiased >> 13u));
+    }
+
+    // Subnormal halves, in units of 2^-24. Anything below 2^-25 rounds to
+    // zero, including every float subnormal.
+    uint32_t const exponent = magnitude >> 23u;
+    if(exponent < 102u) {
+        return sign;
+    }
+
+    uint32_t const mantissa = (magnitude & 0x7FFFFFu) | 0x800000u;
+    uint32_t const shift = 126u - exponent;
+    uint32_t const halfway = 1u << (shift - 1u);
+    uint32_t const remainder = mantissa & ((1u << shift) - 1u);
+
+    uint32_t result = mantissa >> shift;
+    if(remainder > halfway || (remainder == halfway && (result & 1u) != 0u))
+    {
+        ++result;
+    }
+    return static_cast<uint16_t>(sign | result);
+}
+
+constexpr float from_half(uint16_t const h) {
+    uint32_t const sign = static_cast<uint32_t>(h & 0x8000u) << 16u;
+    uint32_t const exponent = (h >> 10u) & 0x1Fu;
+    uint32_t const mantissa = h & 0x3FFu;
+
+    uint32_t bits = sign;
+    if(exponent == 0x1Fu) {
+        // Infinity, or a NaN made quiet
+        bits |= 0x7F800000u | (mantissa << 13u)
+              | (mantissa != 0u ? 0x400000u : 0u);
+    }
+    else if(exponent != 0u) {
+        bits |= ((exponent + 112u) << 23u) | (mantissa << 13u);
+    }
+    else if(mantissa != 0u) {
+        // Subnormal halves are all normal floats. Shift the leading one up
+        // to the implicit bit and adjust the exponent to match.
+        auto const width = static_cast<uint32_t>(std::bit_width(mantissa));
+        bits |= ((width + 102u) << 23u)
+              | ((mantissa << (24u - width)) & 0x7FFFFFu);
+    }
+
+    return std::bit_cast<float>(bits);
+}
+
+} // namespace btx::math
+
+#if defined(BTX_MATH_HEADER_ONLY)
+    #include "brasstacks/math/packed-inl.hpp"
+#endif
+
+#endif // BRASSTACKS_MATH_PACKED_HPP
\ No newline at end of file
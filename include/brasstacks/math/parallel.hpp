@@ -0,0 +1,150 @@
+#ifndef BRASSTACKS_MATH_PARALLEL_HPP
+#define BRASSTACKS_MATH_PARALLEL_HPP
+
+#include "brasstacks/math/common.hpp"
+#include "brasstacks/math/batch.hpp"
+#include "brasstacks/math/VecArray.hpp"
+#include "brasstacks/math/skinning.hpp"
+
+#include <memory>
+
+namespace btx::math {
+
+// A fixed set of threads for splitting one bulk call across cores. Each call
+// is cut into tasks of `grain` elements, which are dealt out to the threads in
+// contiguous runs. A thread that runs out of its own tasks steals from the
+// far end of another thread's run, so a slow core doesn't hold up the rest.
+class ThreadPool {
+public:
+    // threads counts the thread making each call, which works alongside the
+    // pool's own, so a pool of 1 runs everything on the caller. 0 picks one
+    // thread per hardware thread.
+    explicit ThreadPool(std::size_t threads = 0u);
+    ~ThreadPool();
+
+    // How many threads work on each call, including the caller
+    [[nodiscard]] std::size_t size() const;
+
+    // Calls body(begin, end) for consecutive ranges covering [0, count), each
+    // grain elements long apart from perhaps the last, and returns once every
+    // range is done. Ranges run concurrently and in no particular order, so
+    // body must only write what belongs to its own range, and must not
+    // throw. Calls from inside body, or from a second thread while the pool
+    // is busy, run on the calling thread alone rather than waiting.
+    template <typename Body>
+    void for_each_range(std::size_t count, std::size_t grain,
+                        Body const &body);
+
+    ThreadPool(ThreadPool &&) = delete;
+    ThreadPool(ThreadPool const &) = delete;
+
+    ThreadPool & operator=(ThreadPool &&) = delete;
+    ThreadPool & operator=(ThreadPool const &) = delete;
+
+private:
+    struct State;
+    std::unique_ptr<State> _state;
+
+    using Invoke = void (*)(void const *body, std::size_t begin,
+                            std::size_t end);
+
+    void _run(std::size_t count, std::size_t grain, Invoke invoke,
+              void const *body);
+};
+
+// The pool the parallel overloads below use unless given another one,
+// started on first use with one thread per hardware thread
+[[nodiscard]] ThreadPool & default_thread_pool();
+
+// =============================================================================
+// An execution policy for the bulk kernels. Passing one as the first argument
+// splits the call across a thread pool. Every element is computed exactly as
+// the single-threaded overload would, so results don't depend on the thread
+// count, the grain, or the timing. Batches shorter than one grain run on the
+// calling thread.
+struct Parallel {
+    // Elements per task. Smaller grains balance better, larger ones spend
+    // less time handing out work. VecArray calls round it up to a multiple
+    // of VecArray::lane_width so tasks never split a SIMD register. Must be
+    // at least 1.
+    std::size_t grain = 16384u;
+
+    // nullptr for default_thread_pool()
+    ThreadPool *pool = nullptr;
+};
+
+// =============================================================================
+// Parallel versions of the batch.hpp kernels, with the same requirements
+void dot(Parallel const &policy, std::span<Vec2 const> a,
+         std::span<Vec2 const> b, std::span<float> out);
+void dot(Parallel const &policy, std::span<Vec3 const> a,
+         std::span<Vec3 const> b, std::span<float> out);
+void dot(Parallel const &policy, std::span<Vec4 const> a,
+         std::span<Vec4 const> b, std::span<float> out);
+
+void normalize(Parallel const &policy, std::span<Vec2 const> v,
+               std::span<Vec2> out, Accuracy accuracy = Accuracy::exact);
+void normalize(Parallel const &policy, std::span<Vec3 const> v,
+               std::span<Vec3> out, Accuracy accuracy = Accuracy::exact);
+void normalize(Parallel const &policy, std::span<Vec4 const> v,
+               std::span<Vec4> out, Accuracy accuracy = Accuracy::exact);
+
+void transform(Parallel const &policy, Mat4 const &m,
+               std::span<Vec4 const> v, std::span<Vec4> out);
+
+// =============================================================================
+// Parallel versions of the VecArray.hpp kernels, with the same requirements
+void add(Parallel const &policy, Vec2Array const &a, Vec2Array const &b,
+         Vec2Array &out);
+void add(Parallel const &policy, Vec3Array const &a, Vec3Array const &b,
+         Vec3Array &out);
+void add(Parallel const &policy, Vec4Array const &a, Vec4Array const &b,
+         Vec4Array &out);
+
+void scale(Parallel const &policy, Vec2Array const &a, float scalar,
+           Vec2Array &out);
+void scale(Parallel const &policy, Vec3Array const &a, float scalar,
+           Vec3Array &out);
+void scale(Parallel const &policy, Vec4Array const &a, float scalar,
+           Vec4Array &out);
+
+void dot(Parallel const &policy, Vec2Array const &a, Vec2Array const &b,
+         std::span<float> out);
+void dot(Parallel const &policy, Vec3Array const &a, Vec3Array const &b,
+         std::span<float> out);
+void dot(Parallel const &policy, Vec4Array const &a, Vec4Array const &b,
+         std::span<float> out);
+
+void normalize(Parallel const &policy, Vec2Array const &a, Vec2Array &out);
+void normalize(Parallel const &policy, Vec3Array const &a, Vec3Array &out);
+void normalize(Parallel const &policy, Vec4Array const &a, Vec4Array &out);
+
+// =============================================================================
+// Parallel versions of the skinning.hpp kernels, with the same requirements
+void skin(Parallel const &policy, std::span<Mat4 const> palette,
+          std::span<BoneIndices const> bones, Vec4Array const &weights,
+          Vec3Array const &positions, Vec3Array &out_positions);
+
+void skin(Parallel const &policy, std::span<Mat4 const> palette,
+          std::span<BoneIndices const> bones, Vec4Array const &weights,
+          Vec3Array const &positions, Vec3Array const &normals,
+          Vec3Array &out_positions, Vec3Array &out_normals);
+
+// =============================================================================
+template <typename Body>
+void ThreadPool::for_each_range(std::size_t const count,
+                                std::size_t const grain, Body const &body)
+{
+    _run(count, grain,
+        [](void const *erased, std::size_t const begin,
+           std::size_t const end)
+        {
+            (*static_cast<Body const *>(erased))(begin, end);
+        },
+        &body
+    );
+}
+
+} // namespace btx::math
+
+#endif // BRASSTACKS_MATH_PARALLEL_HPP
\ No newline at end of file
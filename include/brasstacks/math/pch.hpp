@@ -1,12 +1,21 @@
 #ifndef BRASSTACKS_MATH_PCH_HPP
 #define BRASSTACKS_MATH_PCH_HPP
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <iostream>
 #include <iomanip>
 #include <limits>
 #include <type_traits>
 #include <cmath>
+#include <concepts>
 #include <numbers>
+#include <new>
+#include <span>
+#include <utility>
 
 #endif // BRASSTACKS_MATH_PCH_HPP
\ No newline at end of file
@@ -0,0 +1,99 @@
+#ifndef BRASSTACKS_MATH_SIMD_HPP
+#define BRASSTACKS_MATH_SIMD_HPP
+
+#include "brasstacks/math/common.hpp"
+
+// SSE2 is part of the x86-64 baseline, so the library's own batch kernels can
+// always rely on it there
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define BTX_MATH_HAS_SSE2
+    #include <immintrin.h>
+#endif
+
+// The Vec4 SIMD backend is opt-in via the BTX_MATH_SIMD CMake option, and only
+// kicks in when the target actually has SSE2. Everything else falls back to
+// the scalar implementation.
+#if defined(BTX_MATH_SIMD) && defined(BTX_MATH_HAS_SSE2)
+    #define BTX_MATH_SSE
+#endif
+
+// Alignment follows the option rather than the instruction set, so Vec4 has
+// the same layout on every platform a given build configuration targets
+#if defined(BTX_MATH_SIMD)
+    #define BTX_MATH_SIMD_ALIGN alignas(16)
+#else
+    #define BTX_MATH_SIMD_ALIGN
+#endif
+
+namespace btx::math {
+
+template <typename T, std::size_t N>
+struct Vec;
+using Vec4 = Vec<float, 4u>;
+struct Quat;
+
+#if defined(BTX_MATH_HAS_SSE2)
+
+namespace simd {
+
+[[nodiscard]] inline __m128 sign_mask() {
+    return _mm_set1_ps(-0.0f);
+}
+
+// The dot product of a and b, broadcast to all four lanes
+[[nodiscard]] inline __m128 dot(__m128 const a, __m128 const b) {
+#if defined(__SSE4_1__)
+    return _mm_dp_ps(a, b, 0xFF);
+#else
+    __m128 const product = _mm_mul_ps(a, b);
+    __m128 const swapped = _mm_shuffle_ps(product, product,
+                                          _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 const pairs   = _mm_add_ps(product, swapped);
+    __m128 const rotated = _mm_shuffle_ps(pairs, pairs,
+                                          _MM_SHUFFLE(1, 0, 3, 2));
+    return _mm_add_ps(pairs, rotated);
+#endif
+}
+
+// Lane i of v, broadcast to all four lanes
+template <int i>
+[[nodiscard]] inline __m128 splat(__m128 const v) {
+    return _mm_shuffle_ps(v, v, _MM_SHUFFLE(i, i, i, i));
+}
+
+// Per-lane select: mask ? a : b
+[[nodiscard]] inline __m128 select(__m128 const mask, __m128 const a,
+                                   __m128 const b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+#if defined(BTX_MATH_SSE)
+// Vec4 is aligned to 16 bytes in this mode, so these are single aligned
+// loads and stores which the optimizer folds away entirely once inlined
+[[nodiscard]] inline __m128 load(Vec4 const &v) {
+    return _mm_load_ps(reinterpret_cast<float const *>(&v));
+}
+
+inline void store(Vec4 &v, __m128 const r) {
+    _mm_store_ps(reinterpret_cast<float *>(&v), r);
+}
+
+// Quat shares Vec4's layout and alignment
+[[nodiscard]] inline __m128 load(Quat const &q) {
+    return _mm_load_ps(reinterpret_cast<float const *>(&q));
+}
+
+inline void store(Quat &q, __m128 const r) {
+    _mm_store_ps(reinterpret_cast<float *>(&q), r);
+}
+#endif // BTX_MATH_SSE
+
+} // namespace simd
+
+#endif // BTX_MATH_HAS_SSE2
+
+} // namespace btx::math
+
+#endif // BRASSTACKS_MATH_SIMD_HPP
\ No newline at end of file
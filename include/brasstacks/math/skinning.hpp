@@ -0,0 +1,51 @@
+#ifndef BRASSTACKS_MATH_SKINNING_HPP
+#define BRASSTACKS_MATH_SKINNING_HPP
+
+#include "brasstacks/math/common.hpp"
+#include "brasstacks/math/Mat4.hpp"
+#include "brasstacks/math/VecArray.hpp"
+
+namespace btx::math {
+
+// Linear blend skinning. Every vertex of a mesh is bound to up to four bones,
+// and follows the weighted sum of their matrices. Those come from a palette,
+// one matrix per bone, each the bone's current transform times the inverse of
+// its transform in the bind pose.
+
+// Which palette entries move a vertex. Unused slots can name any bone in the
+// palette, as long as their weight is zero.
+using BoneIndices = std::array<uint16_t, 4>;
+
+// The sum of weights[i] * palette[bones[i]] over all four bones. Weights
+// normally add up to one, but nothing here checks.
+[[nodiscard]] Mat4 blend_bones(std::span<Mat4 const> palette,
+                               BoneIndices const &bones, Vec4 const &weights);
+
+// =============================================================================
+// Skins a whole mesh, with vertex i bound to bones[i] by weights[i]. With m
+// that vertex's blended matrix,
+//
+//     out_positions[i] = m * (positions[i], 1)
+//     out_normals[i]   = normalize(m * (normals[i], 0))
+//
+// dropping the w of each result, and matching what those give to within
+// rounding. Normals only go through the upper 3x3, which keeps them
+// perpendicular as long as the bones don't scale non-uniformly.
+//
+// The blended matrices are never stored. Each block of vertices gathers its
+// bones into SIMD lanes, skips bones that none of them use, and prefetches the
+// bones of the block after it. Every array must be the same size, with every
+// index inside the palette. out_positions may be the same array as
+// positions, and out_normals as normals.
+void skin(std::span<Mat4 const> palette, std::span<BoneIndices const> bones,
+          Vec4Array const &weights, Vec3Array const &positions,
+          Vec3Array &out_positions);
+
+void skin(std::span<Mat4 const> palette, std::span<BoneIndices const> bones,
+          Vec4Array const &weights, Vec3Array const &positions,
+          Vec3Array const &normals, Vec3Array &out_positions,
+          Vec3Array &out_normals);
+
+} // namespace btx::math
+
+#endif // BRASSTACKS_MATH_SKINNING_HPP
\ No newline at end of file
@@ -0,0 +1,161 @@
+#ifndef BRASSTACKS_MATH_STREAM_HPP
+#define BRASSTACKS_MATH_STREAM_HPP
+
+#include "brasstacks/math/common.hpp"
+#include "brasstacks/math/AABB.hpp"
+#include "brasstacks/math/Mat4.hpp"
+#include "brasstacks/math/Vec.hpp"
+#include "brasstacks/math/batch.hpp"
+
+#include <functional>
+#include <memory_resource>
+#include <system_error>
+#include <vector>
+
+namespace btx::math {
+
+// Runs points of any number through a chain of batch operations a chunk at a
+// time, so memory stays at three chunks no matter how big the input is. While
+// one chunk is being worked on, the next is read and the one before is
+// written, each on a thread of its own, so I/O overlaps compute.
+//
+// Points come from a source and go to a sink, which are any types like the
+// ones below. VecFileReader and VecFileWriter both qualify, so files stream
+// straight through.
+
+// read() fills out from the front and returns how many points it wrote, which
+// is fewer than out holds only at the end or after an error. error() says
+// which, afterwards.
+template <typename Source>
+concept PointSource = requires(Source &source, std::span<Vec3> out) {
+    { source.read(out) } -> std::convertible_to<std::size_t>;
+    { source.error() } -> std::convertible_to<std::error_code>;
+};
+
+// write() takes every point it's given, or returns false, with the reason in
+// error().
+template <typename Sink>
+concept PointSink = requires(Sink &sink, std::span<Vec3 const> points) {
+    { sink.write(points) } -> std::convertible_to<bool>;
+    { sink.error() } -> std::convertible_to<std::error_code>;
+};
+
+// Points already in memory
+class SpanSource {
+public:
+    explicit SpanSource(std::span<Vec3 const> const points) :
+        _rest { points }
+    { }
+
+    [[nodiscard]] std::size_t read(std::span<Vec3> out);
+    [[nodiscard]] std::error_code error() const { return { }; }
+
+private:
+    std::span<Vec3 const> _rest;
+};
+
+// Appends to a std::vector, which grows with the output
+class VectorSink {
+public:
+    explicit VectorSink(std::vector<Vec3> &out) : _out { &out } { }
+
+    [[nodiscard]] bool write(std::span<Vec3 const> points);
+    [[nodiscard]] std::error_code error() const { return { }; }
+
+private:
+    std::vector<Vec3> *_out;
+};
+
+// What a run got through
+struct PipelineStats {
+    std::size_t read    = 0u;
+    std::size_t written = 0u;   // Fewer than read when a filter dropped some
+
+    // The source's error if it had one, otherwise the sink's
+    std::error_code error;
+};
+
+// =============================================================================
+// Stages run in the order they were added, on each chunk in turn, and every
+// chunk is finished before the next one starts. So stages never run
+// concurrently with one another, and bounds() and filter() see points in
+// source order.
+class Pipeline {
+public:
+    static std::size_t constexpr default_chunk_size = 1u << 16u;
+
+    // Points per chunk, at least 1
+    explicit Pipeline(std::size_t chunk_size = default_chunk_size);
+
+    // p = m * (p, 1), as transform_points()
+    Pipeline & transform(Mat4 const &m);
+
+    // As the batch normalize()
+    Pipeline & normalize(Accuracy accuracy = Accuracy::exact);
+
+    // Grows box around every point reaching this stage. box isn't reset
+    // first, so start it at AABB::empty, and it must outlive every run().
+    Pipeline & bounds(AABB &box);
+
+    // Drops the points keep() returns false for, keeping the rest in order
+    Pipeline & filter(std::function<bool(Vec3 const &)> keep);
+
+    // Anything else: stage() may change the points in place and move the
+    // ones to keep to the front, and returns how many that is
+    Pipeline & then(std::function<std::size_t(std::span<Vec3>)> stage);
+
+    [[nodiscard]] std::size_t chunk_size() const { return _chunk_size; }
+
+    // Reads source to the end, or until the source or sink fails, passing
+    // every chunk through the stages and on to sink. Source and sink are each
+    // used from one thread at a time, but not always the calling thread. If a
+    // stage throws, run() waits for any read or write in flight and then
+    // rethrows. The three chunks come from scratch, and are freed before
+    // run() returns.
+    template <PointSource Source, PointSink Sink>
+    PipelineStats run(
+        Source &source, Sink &sink,
+        std::pmr::memory_resource *scratch = std::pmr::get_default_resource()
+    ) const;
+
+private:
+    using Stage = std::function<std::size_t(std::span<Vec3>)>;
+
+    std::size_t        _chunk_size;
+    std::vector<Stage> _stages;
+
+    using Read = std::size_t (*)(void *source, std::span<Vec3> out);
+    using Write = bool (*)(void *sink, std::span<Vec3 const> points);
+
+    // Counts and I/O only. Errors come from the source and sink themselves.
+    PipelineStats _run(Read read, void *source, Write write, void *sink,
+                       std::pmr::memory_resource *scratch) const;
+};
+
+// =============================================================================
+template <PointSource Source, PointSink Sink>
+PipelineStats Pipeline::run(Source &source, Sink &sink,
+                            std::pmr::memory_resource *const scratch) const
+{
+    auto stats = _run(
+        [](void *erased, std::span<Vec3> const out) -> std::size_t {
+            return static_cast<Source *>(erased)->read(out);
+        },
+        &source,
+        [](void *erased, std::span<Vec3 const> const points) -> bool {
+            return static_cast<Sink *>(erased)->write(points);
+        },
+        &sink, scratch
+    );
+
+    stats.error = source.error();
+    if(!stats.error) {
+        stats.error = sink.error();
+    }
+
+    return stats;
+}
+
+} // namespace btx::math
+
+#endif // BRASSTACKS_MATH_STREAM_HPP
\ No newline at end of file
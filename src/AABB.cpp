@@ -0,0 +1,19 @@
+#include "brasstacks/math/AABB.hpp"
+
+#if !defined(BTX_MATH_HEADER_ONLY)
+
+#include "brasstacks/math/AABB-inl.hpp"
+
+namespace btx::math {
+
+AABB const AABB::empty {
+    { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+      std::numeric_limits<float>::max() },
+    { std::numeric_limits<float>::lowest(),
+      std::numeric_limits<float>::lowest(),
+      std::numeric_limits<float>::lowest() },
+};
+
+} // namespace btx::math
+
+#endif // !BTX_MATH_HEADER_ONLY
\ No newline at end of file
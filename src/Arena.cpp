@@ -0,0 +1,80 @@
+#include "brasstacks/math/Arena.hpp"
+
+namespace btx::math {
+
+// =============================================================================
+void Arena::rewind(Marker const marker) {
+    assert(marker.offset <= _used);
+    _used = marker.offset;
+}
+
+bool Arena::owns(void const *const p) const {
+    // Comparing addresses as integers, since pointers into different objects
+    // don't compare with < at all
+    auto const address = reinterpret_cast<std::uintptr_t>(p);
+    auto const first = reinterpret_cast<std::uintptr_t>(_data);
+    return address >= first && address - first < _capacity;
+}
+
+// =============================================================================
+Arena::~Arena() {
+    if(_owned) {
+        ::operator delete(_data, std::align_val_t { block_alignment });
+    }
+}
+
+Arena::Arena(std::size_t const capacity) :
+    _data {
+        static_cast<std::byte *>(::operator new(
+            std::max<std::size_t>(capacity, 1u),
+            std::align_val_t { block_alignment }
+        ))
+    },
+    _capacity { capacity },
+    _owned    { true }
+{ }
+
+Arena::Arena(std::span<std::byte> const buffer) :
+    _data     { buffer.data() },
+    _capacity { buffer.size() }
+{ }
+
+// =============================================================================
+ArenaResource::ArenaResource(Arena &arena,
+                             std::pmr::memory_resource *const upstream) :
+    _arena    { &arena },
+    _upstream { upstream }
+{ }
+
+// Empty allocations still take a byte, so that no pointer handed out sits at
+// the very end of the block, where owns() wouldn't claim it
+void * ArenaResource::do_allocate(std::size_t const bytes,
+                                  std::size_t const alignment)
+{
+    if(void *const p = _arena->allocate(std::max<std::size_t>(bytes, 1u),
+                                        alignment))
+    {
+        return p;
+    }
+    return _upstream->allocate(bytes, alignment);
+}
+
+// The arena's own allocations are freed by rewinding it instead
+void ArenaResource::do_deallocate(void *const p, std::size_t const bytes,
+                                  std::size_t const alignment)
+{
+    if(!_arena->owns(p)) {
+        _upstream->deallocate(p, bytes, alignment);
+    }
+}
+
+bool ArenaResource::do_is_equal(
+    std::pmr::memory_resource const &other
+) const noexcept
+{
+    auto const *const resource = dynamic_cast<ArenaResource const *>(&other);
+    return resource != nullptr && resource->_arena == _arena
+        && resource->_upstream->is_equal(*_upstream);
+}
+
+} // namespace btx::math
\ No newline at end of file
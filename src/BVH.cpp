@@ -0,0 +1,511 @@
+#include "brasstacks/math/BVH.hpp"
+
+#include <algorithm>
+
+namespace btx::math {
+
+namespace {
+
+// Candidate split planes per axis, evenly spaced across the box centers
+std::size_t constexpr bin_count = 16u;
+
+// Below this depth nodes are split by the SAH, and past it at the median, so
+// that no path through the tree is longer than max_depth whatever the boxes
+// look like. That bounds the traversal stacks below.
+uint32_t constexpr sah_depth = 32u;
+uint32_t constexpr max_depth = 64u;
+
+// Relative to the cost of testing one box. Walking into a node means testing
+// both of its children, so descending costs about as much as two leaf boxes.
+float constexpr traversal_cost = 2.0f;
+
+struct Bin {
+    AABB     bounds = AABB::empty;
+    uint32_t count  = 0u;
+};
+
+// A box as the builder sees it. Splitting a node moves these around rather
+// than an array of indices, so each pass over a node's boxes reads memory
+// in order.
+struct Primitive {
+    AABB     bounds;
+    Vec3     center;
+    uint32_t index;
+};
+
+// merge(), surface_area() and overlaps() from AABB.hpp, repeated here so
+// they inline into the builder and the queries, which call them for every
+// box and node they touch. The bounds are copied out first, since GCC
+// otherwise turns the min and max of values in memory into unpredictable
+// branches.
+inline void grow(AABB &box, AABB const &other) {
+    Vec3 min = box.min;
+    Vec3 max = box.max;
+    for(uint8_t c = 0u; c < 3u; ++c) {
+        min[c] = std::min(min[c], other.min[c]);
+        max[c] = std::max(max[c], other.max[c]);
+    }
+    box.min = min;
+    box.max = max;
+}
+
+inline void grow(AABB &box, Vec3 const &p) {
+    Vec3 min = box.min;
+    Vec3 max = box.max;
+    for(uint8_t c = 0u; c < 3u; ++c) {
+        min[c] = std::min(min[c], p[c]);
+        max[c] = std::max(max[c], p[c]);
+    }
+    box.min = min;
+    box.max = max;
+}
+
+inline bool boxes_overlap(AABB const &a, AABB const &b) {
+    return a.min.x <= b.max.x && b.min.x <= a.max.x &&
+           a.min.y <= b.max.y && b.min.y <= a.max.y &&
+           a.min.z <= b.max.z && b.min.z <= a.max.z;
+}
+
+// Half the surface area, which is all the SAH needs to compare costs. The box
+// must not be empty.
+inline float half_area(AABB const &box) {
+    float const x = box.max.x - box.min.x;
+    float const y = box.max.y - box.min.y;
+    float const z = box.max.z - box.min.z;
+    return (x * y) + (y * z) + (z * x);
+}
+
+// The ray, set up for testing against many boxes. This is the same slab test
+// as intersect() in AABB.hpp, with the division done once up front.
+struct Slabs {
+    Vec3 origin;
+    Vec3 inverse;
+    bool parallel[3] { };
+
+    explicit Slabs(Ray const &ray) : origin { ray.origin } {
+        for(uint8_t c = 0u; c < 3u; ++c) {
+            parallel[c] = ray.direction[c] == 0.0f;
+            inverse[c] = parallel[c] ? 0.0f : 1.0f / ray.direction[c];
+        }
+    }
+
+    // Where the ray enters box, if it does within limit
+    [[nodiscard]] bool enter(AABB const &box, float const limit,
+                             float &distance) const
+    {
+        float near = 0.0f;
+        float far  = limit;
+
+        for(uint8_t c = 0u; c < 3u; ++c) {
+            if(parallel[c]) {
+                if(origin[c] < box.min[c] || origin[c] > box.max[c]) {
+                    return false;
+                }
+                continue;
+            }
+
+            float const t0 = (box.min[c] - origin[c]) * inverse[c];
+            float const t1 = (box.max[c] - origin[c]) * inverse[c];
+
+            near = std::max(near, std::min(t0, t1));
+            far  = std::min(far, std::max(t0, t1));
+        }
+
+        distance = near;
+        return near <= far;
+    }
+};
+
+// A node still to visit, and how far along the ray it starts
+struct Pending {
+    uint32_t node;
+    float    distance;
+};
+
+} // namespace
+
+// =============================================================================
+BVH::BVH(std::span<AABB const> boxes, uint32_t const max_leaf_size,
+         std::pmr::memory_resource *const scratch) :
+    _boxes { boxes.begin(), boxes.end() }
+{
+    assert(boxes.size() <= std::numeric_limits<uint32_t>::max());
+    assert(max_leaf_size > 0u);
+
+    _build(max_leaf_size, scratch);
+}
+
+void BVH::_build(uint32_t const max_leaf_size,
+                 std::pmr::memory_resource *const scratch)
+{
+    auto const count = static_cast<uint32_t>(_boxes.size());
+    if(count == 0u) {
+        return;
+    }
+
+    std::pmr::vector<Primitive> primitives(count, scratch);
+    for(uint32_t i = 0u; i < count; ++i) {
+        primitives[i] = { _boxes[i], center(_boxes[i]), i };
+    }
+
+    auto const bounds_of = [&](uint32_t const first, uint32_t const n) {
+        AABB bounds = AABB::empty;
+        for(uint32_t i = first; i < first + n; ++i) {
+            grow(bounds, primitives[i].bounds);
+        }
+        return bounds;
+    };
+
+    // A binary tree with at least one box per leaf has fewer than twice as
+    // many nodes as boxes
+    _nodes.reserve(2u * count - 1u);
+    _nodes.push_back({ bounds_of(0u, count), 0u, count });
+
+    struct Subtree {
+        uint32_t node;
+        uint32_t depth;
+    };
+    std::pmr::vector<Subtree> todo({ { 0u, 0u } }, scratch);
+
+    while(!todo.empty()) {
+        auto const [node, depth] = todo.back();
+        todo.pop_back();
+
+        AABB const bounds = _nodes[node].bounds;
+        uint32_t const first = _nodes[node].first;
+        uint32_t const n = _nodes[node].count;
+
+        AABB center_bounds = AABB::empty;
+        for(uint32_t i = first; i < first + n; ++i) {
+            grow(center_bounds, primitives[i].center);
+        }
+        Vec3 const spread = extent(center_bounds);
+
+        // Boxes that share a center can't be told apart by any plane
+        if(n <= 1u || (spread.x <= 0.0f && spread.y <= 0.0f &&
+                       spread.z <= 0.0f))
+        {
+            continue;
+        }
+
+        uint32_t left_count = 0u;
+        AABB left_bounds = AABB::empty;
+        AABB right_bounds = AABB::empty;
+
+        if(depth < sah_depth) {
+            // The cheapest plane across all three axes, with costs scaled by
+            // the node's surface area to save dividing every one by it
+            float best_cost = std::numeric_limits<float>::max();
+            uint8_t best_axis = 0u;
+            std::size_t best_bin = 0u;
+
+            // Small nodes get fewer planes, since most bins would be empty
+            std::size_t const bins_used = std::min<std::size_t>(bin_count, n);
+            float const bins_float = static_cast<float>(bins_used);
+
+            // Bin along all three axes in one pass over the boxes. An axis
+            // with no spread puts everything in its first bin, which the
+            // sweeps below never split.
+            Vec3 scale;
+            for(uint8_t axis = 0u; axis < 3u; ++axis) {
+                scale[axis] = spread[axis] > 0.0f ? bins_float / spread[axis]
+                                                  : 0.0f;
+            }
+
+            std::array<std::array<Bin, bin_count>, 3> bins;
+            for(auto &axis_bins : bins) {
+                std::fill_n(axis_bins.begin(), bins_used, Bin { });
+            }
+
+            for(uint32_t i = first; i < first + n; ++i) {
+                Primitive const &primitive = primitives[i];
+                for(uint8_t axis = 0u; axis < 3u; ++axis) {
+                    auto const b = std::min(
+                        static_cast<std::size_t>(
+                            (primitive.center[axis] - center_bounds.min[axis])
+                            * scale[axis]),
+                        bins_used - 1u
+                    );
+                    grow(bins[axis][b].bounds, primitive.bounds);
+                    ++bins[axis][b].count;
+                }
+            }
+
+            for(uint8_t axis = 0u; axis < 3u; ++axis) {
+                if(spread[axis] <= 0.0f) {
+                    continue;
+                }
+
+                // Sweep from the right, then from the left, scoring the
+                // plane after each bin and skipping over empty ones
+                std::array<AABB, bin_count> rights;
+                std::array<float, bin_count> right_costs;
+                AABB right = AABB::empty;
+                uint32_t right_n = 0u;
+                for(std::size_t b = bins_used - 1u; b > 0u; --b) {
+                    if(bins[axis][b].count > 0u) {
+                        grow(right, bins[axis][b].bounds);
+                        right_n += bins[axis][b].count;
+                    }
+                    rights[b - 1u] = right;
+                    right_costs[b - 1u] = right_n == 0u
+                        ? std::numeric_limits<float>::max()
+                        : half_area(right) * static_cast<float>(right_n);
+                }
+
+                AABB left = AABB::empty;
+                uint32_t left_n = 0u;
+                for(std::size_t b = 0u; b + 1u < bins_used; ++b) {
+                    if(bins[axis][b].count == 0u) {
+                        continue;
+                    }
+                    grow(left, bins[axis][b].bounds);
+                    left_n += bins[axis][b].count;
+                    if(left_n == n) {
+                        break;
+                    }
+
+                    float const cost = right_costs[b]
+                        + half_area(left) * static_cast<float>(left_n);
+                    if(cost < best_cost) {
+                        best_cost = cost;
+                        best_axis = axis;
+                        best_bin = b;
+                        left_bounds = left;
+                        right_bounds = rights[b];
+                    }
+                }
+            }
+
+            float const area = half_area(bounds);
+            float const leaf_cost = area * static_cast<float>(n);
+            float const split_cost = area * traversal_cost + best_cost;
+            if(n <= max_leaf_size && leaf_cost <= split_cost) {
+                continue;
+            }
+
+            // The spread along at least one axis is positive, and the first
+            // and last bins along it aren't empty, so there's always a plane
+            float const start = center_bounds.min[best_axis];
+            auto const *split = std::partition(
+                primitives.data() + first, primitives.data() + first + n,
+                [&](Primitive const &primitive) {
+                    auto const b = std::min(
+                        static_cast<std::size_t>(
+                            (primitive.center[best_axis] - start)
+                            * scale[best_axis]),
+                        bins_used - 1u
+                    );
+                    return b <= best_bin;
+                }
+            );
+            left_count = static_cast<uint32_t>(
+                split - (primitives.data() + first));
+        }
+
+        // Too deep for the SAH, or rounding put every center on one side of
+        // its plane after all
+        if(left_count == 0u || left_count == n) {
+            if(n <= max_leaf_size) {
+                continue;
+            }
+
+            // Half the boxes on each side of the median center along the
+            // widest axis
+            uint8_t const axis = spread.x >= spread.y
+                ? (spread.x >= spread.z ? 0u : 2u)
+                : (spread.y >= spread.z ? 1u : 2u);
+
+            left_count = n / 2u;
+            std::nth_element(
+                primitives.begin() + first,
+                primitives.begin() + first + left_count,
+                primitives.begin() + first + n,
+                [&](Primitive const &a, Primitive const &b) {
+                    return a.center[axis] < b.center[axis];
+                }
+            );
+
+            left_bounds = bounds_of(first, left_count);
+            right_bounds = bounds_of(first + left_count, n - left_count);
+        }
+
+        assert(left_count > 0u && left_count < n);
+        assert(depth + 1u < max_depth);
+
+        auto const left = static_cast<uint32_t>(_nodes.size());
+        uint32_t const right_count = n - left_count;
+        _nodes.push_back({ left_bounds, first, left_count });
+        _nodes.push_back({ right_bounds, first + left_count, right_count });
+
+        _nodes[node].first = left;
+        _nodes[node].count = 0u;
+
+        todo.push_back({ left, depth + 1u });
+        todo.push_back({ left + 1u, depth + 1u });
+    }
+
+    // Keep the boxes in leaf order, so each leaf reads a contiguous run
+    _indices.resize(count);
+    for(uint32_t i = 0u; i < count; ++i) {
+        _boxes[i] = primitives[i].bounds;
+        _indices[i] = primitives[i].index;
+    }
+}
+
+// =============================================================================
+AABB BVH::bounds() const {
+    return _nodes.empty() ? AABB::empty : _nodes.front().bounds;
+}
+
+// =============================================================================
+void BVH::overlapping(AABB const &box, std::vector<uint32_t> &out) const {
+    if(_nodes.empty() || !boxes_overlap(_nodes.front().bounds, box)) {
+        return;
+    }
+
+    std::array<uint32_t, max_depth> stack;
+    std::size_t size = 0u;
+    uint32_t node = 0u;
+
+    for(;;) {
+        Node const &current = _nodes[node];
+
+        if(current.count > 0u) {
+            for(uint32_t i = current.first;
+                i < current.first + current.count; ++i)
+            {
+                if(boxes_overlap(_boxes[i], box)) {
+                    out.push_back(_indices[i]);
+                }
+            }
+        }
+        else {
+            Node const &left_node = _nodes[current.first];
+            Node const &right_node = _nodes[current.first + 1u];
+            bool const left = boxes_overlap(left_node.bounds, box);
+            bool const right = boxes_overlap(right_node.bounds, box);
+
+            if(left && right) {
+                stack[size++] = current.first + 1u;
+                node = current.first;
+                continue;
+            }
+            if(left || right) {
+                node = left ? current.first : current.first + 1u;
+                continue;
+            }
+        }
+
+        if(size == 0u) {
+            return;
+        }
+        node = stack[--size];
+    }
+}
+
+void BVH::overlapping(std::span<AABB const> queries,
+                      std::vector<uint32_t> &out,
+                      std::span<std::size_t> offsets) const
+{
+    assert(offsets.size() == queries.size() + 1u);
+
+    out.clear();
+    for(std::size_t i = 0u; i < queries.size(); ++i) {
+        offsets[i] = out.size();
+        overlapping(queries[i], out);
+    }
+    offsets[queries.size()] = out.size();
+}
+
+// =============================================================================
+BVH::RayHit BVH::intersect(Ray const &ray, float const max_distance) const {
+    RayHit hit;
+
+    Slabs const slabs { ray };
+    float limit = max_distance;
+
+    float distance = 0.0f;
+    if(_nodes.empty() || !slabs.enter(_nodes.front().bounds, limit, distance))
+    {
+        return hit;
+    }
+
+    // Nearer children first, so later boxes can be skipped once a hit
+    // closer than their node is known
+    std::array<Pending, max_depth> stack;
+    std::size_t size = 0u;
+    uint32_t node = 0u;
+
+    for(;;) {
+        Node const &current = _nodes[node];
+
+        if(current.count > 0u) {
+            for(uint32_t i = current.first;
+                i < current.first + current.count; ++i)
+            {
+                if(slabs.enter(_boxes[i], limit, distance) &&
+                   (hit.index == RayHit::none || distance < hit.distance))
+                {
+                    hit = { _indices[i], distance };
+                    limit = distance;
+                }
+            }
+        }
+        else {
+            float left_distance = 0.0f;
+            float right_distance = 0.0f;
+            bool const left = slabs.enter(_nodes[current.first].bounds,
+                                          limit, left_distance);
+            bool const right = slabs.enter(_nodes[current.first + 1u].bounds,
+                                           limit, right_distance);
+
+            if(left && right) {
+                bool const left_first = left_distance <= right_distance;
+                stack[size++] = left_first
+                    ? Pending { current.first + 1u, right_distance }
+                    : Pending { current.first, left_distance };
+                node = left_first ? current.first : current.first + 1u;
+                continue;
+            }
+            if(left || right) {
+                node = left ? current.first : current.first + 1u;
+                continue;
+            }
+        }
+
+        // Skip anything that starts beyond the closest hit so far
+        do {
+            if(size == 0u) {
+                return hit;
+            }
+            --size;
+        } while(stack[size].distance > limit);
+        node = stack[size].node;
+    }
+}
+
+void BVH::intersect(std::span<Ray const> rays, std::span<RayHit> hits) const
+{
+    assert(rays.size() == hits.size());
+    for(std::size_t i = 0u; i < rays.size(); ++i) {
+        hits[i] = intersect(rays[i]);
+    }
+}
+
+void BVH::intersect(Parallel const &policy, std::span<Ray const> rays,
+                    std::span<RayHit> hits) const
+{
+    assert(rays.size() == hits.size());
+
+    ThreadPool &pool = policy.pool != nullptr ? *policy.pool
+                                              : default_thread_pool();
+    pool.for_each_range(rays.size(), policy.grain,
+        [&](std::size_t const begin, std::size_t const end) {
+            intersect(rays.subspan(begin, end - begin),
+                      hits.subspan(begin, end - begin));
+        }
+    );
+}
+
+} // namespace btx::math
\ No newline at end of file
@@ -0,0 +1,5 @@
+#include "brasstacks/math/math.hpp"
+
+#if !defined(BTX_MATH_HEADER_ONLY)
+    #include "brasstacks/math/Quat-inl.hpp"
+#endif
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "brasstacks/math/VecArray.hpp"
+#include "kernels/kernels.hpp"
+
+namespace btx::math {
+
+namespace {
+
+// Lanes are contiguous and each one is padded with zeros to the stride, so
+// element-wise kernels can treat every lane of an array as one long run of
+// floats. Adding, subtracting and normalizing keep the padding zero, but
+// scaling by infinity or NaN doesn't, so scale() zeroes it again after. It's
+// less than a register per lane, and checking the scalar instead wouldn't
+// survive -ffast-math.
+
+template <typename Array>
+void add_lanes(Array const &a, Array const &b, Array &out) {
+    assert(a.size() == b.size() && a.size() == out.size());
+    kernels::table().lanes_add(a.lane(0u), b.lane(0u), out.lane(0u),
+                               a.stride() * Array::components);
+}
+
+template <typename Array>
+void sub_lanes(Array const &a, Array const &b, Array &out) {
+    assert(a.size() == b.size() && a.size() == out.size());
+    kernels::table().lanes_sub(a.lane(0u), b.lane(0u), out.lane(0u),
+                               a.stride() * Array::components);
+}
+
+template <typename Array>
+void scale_lanes(Array const &a, float const scalar, Array &out) {
+    assert(a.size() == out.size());
+    kernels::table().lanes_scale(a.lane(0u), scalar, out.lane(0u),
+                                 a.stride() * Array::components);
+
+    for(std::size_t c = 0u; c < Array::components; ++c) {
+        std::fill(out.lane(c) + out.size(), out.lane(c) + out.stride(), 0.0f);
+    }
+}
+
+template <typename Array>
+void dot_lanes(Array const &a, Array const &b, std::span<float> out) {
+    assert(a.size() == b.size() && a.size() == out.size());
+    assert(a.stride() == b.stride());
+    kernels::table().lanes_dot(a.lane(0u), b.lane(0u), a.stride(),
+                               Array::components, out.data(), out.size());
+}
+
+template <typename Array>
+void length_squared_lanes(Array const &a, std::span<float> out) {
+    dot_lanes(a, a, out);
+}
+
+template <typename Array>
+void normalize_lanes(Array const &a, Array &out) {
+    assert(a.size() == out.size());
+    kernels::table().lanes_normalize(a.lane(0u), out.lane(0u), a.stride(),
+                                     Array::components, a.stride());
+}
+
+} // namespace
+
+// =============================================================================
+void add(Vec2Array const &a, Vec2Array const &b, Vec2Array &out) {
+    add_lanes(a, b, out);
+}
+
+void add(Vec3Array const &a, Vec3Array const &b, Vec3Array &out) {
+    add_lanes(a, b, out);
+}
+
+void add(Vec4Array const &a, Vec4Array const &b, Vec4Array &out) {
+    add_lanes(a, b, out);
+}
+
+// =============================================================================
+void sub(Vec2Array const &a, Vec2Array const &b, Vec2Array &out) {
+    sub_lanes(a, b, out);
+}
+
+void sub(Vec3Array const &a, Vec3Array const &b, Vec3Array &out) {
+    sub_lanes(a, b, out);
+}
+
+void sub(Vec4Array const &a, Vec4Array const &b, Vec4Array &out) {
+    sub_lanes(a, b, out);
+}
+
+// =============================================================================
+void scale(Vec2Array const &a, float const scalar, Vec2Array &out) {
+    scale_lanes(a, scalar, out);
+}
+
+void scale(Vec3Array const &a, float const scalar, Vec3Array &out) {
+    scale_lanes(a, scalar, out);
+}
+
+void scale(Vec4Array const &a, float const scalar, Vec4Array &out) {
+    scale_lanes(a, scalar, out);
+}
+
+// =============================================================================
+void dot(Vec2Array const &a, Vec2Array const &b, std::span<float> out) {
+    dot_lanes(a, b, out);
+}
+
+void dot(Vec3Array const &a, Vec3Array const &b, std::span<float> out) {
+    dot_lanes(a, b, out);
+}
+
+void dot(Vec4Array const &a, Vec4Array const &b, std::span<float> out) {
+    dot_lanes(a, b, out);
+}
+
+// =============================================================================
+void cross(Vec3Array const &a, Vec3Array const &b, Vec3Array &out) {
+    assert(a.size() == b.size() && a.size() == out.size());
+    kernels::table().lanes_cross(a.lane(0u), b.lane(0u), out.lane(0u),
+                                 a.stride());
+}
+
+// =============================================================================
+void length_squared(Vec2Array const &a, std::span<float> out) {
+    length_squared_lanes(a, out);
+}
+
+void length_squared(Vec3Array const &a, std::span<float> out) {
+    length_squared_lanes(a, out);
+}
+
+void length_squared(Vec4Array const &a, std::span<float> out) {
+    length_squared_lanes(a, out);
+}
+
+// =============================================================================
+void normalize(Vec2Array const &a, Vec2Array &out) {
+    normalize_lanes(a, out);
+}
+
+void normalize(Vec3Array const &a, Vec3Array &out) {
+    normalize_lanes(a, out);
+}
+
+void normalize(Vec4Array const &a, Vec4Array &out) {
+    normalize_lanes(a, out);
+}
+
+} // namespace btx::math
\ No newline at end of file
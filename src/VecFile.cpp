@@ -0,0 +1,698 @@
+#include "brasstacks/math/VecFile.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <memory>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace btx::math {
+
+namespace {
+
+class VecFileCategory : public std::error_category {
+public:
+    char const * name() const noexcept override { return "vec_file"; }
+
+    std::string message(int const error) const override {
+        switch(static_cast<VecFileError>(error)) {
+            case VecFileError::not_a_vec_file:
+                return "not a vector file";
+            case VecFileError::unsupported_version:
+                return "unsupported vector file version";
+            case VecFileError::bad_header:
+                return "malformed vector file header";
+            case VecFileError::truncated:
+                return "vector file is truncated";
+            case VecFileError::wrong_byte_order:
+                return "vector files need a little-endian machine";
+            case VecFileError::bad_checksum:
+                return "vector file checksum mismatch";
+        }
+        return "unknown vector file error";
+    }
+};
+
+[[nodiscard]] std::size_t component_size(VecComponent const type) {
+    return type == VecComponent::f64 ? 8u : 4u;
+}
+
+[[nodiscard]] bool valid_component(VecComponent const type) {
+    return type == VecComponent::f32 || type == VecComponent::f64
+        || type == VecComponent::i32;
+}
+
+[[nodiscard]] bool valid_alignment(uint64_t const alignment) {
+    return alignment >= 16u && alignment <= 4096u
+        && std::has_single_bit(alignment);
+}
+
+[[nodiscard]] uint64_t round_up(uint64_t const size, uint64_t const to) {
+    return (size + to - 1u) / to * to;
+}
+
+// Where the data goes and how big it is, from the header's type, layout,
+// count, and alignment. False if those don't make sense or don't fit in
+// 64 bits.
+[[nodiscard]] bool place_data(VecFileHeader &header) {
+    if(!valid_component(header.component_type)
+       || header.components < 2u || header.components > 4u
+       || (header.layout != VecLayout::aos && header.layout != VecLayout::soa)
+       || !valid_alignment(header.alignment))
+    {
+        return false;
+    }
+
+    uint64_t constexpr max = std::numeric_limits<uint64_t>::max() / 2u;
+    uint64_t const element = component_size(header.component_type)
+                           * header.components;
+    if(header.count > max / element) {
+        return false;
+    }
+
+    header.data_offset = round_up(header.header_size, header.alignment);
+    if(header.layout == VecLayout::aos) {
+        header.lane_stride = 0u;
+        header.data_size = header.count * element;
+    }
+    else {
+        header.lane_stride = round_up(
+            header.count * component_size(header.component_type),
+            header.alignment
+        );
+        header.data_size = header.lane_stride * header.components;
+    }
+
+    return true;
+}
+
+// =============================================================================
+// Mapping files, read-only and shared, with the handles closed again as soon
+// as the view exists
+#if defined(_WIN32)
+
+std::error_code last_error() {
+    return { static_cast<int>(GetLastError()), std::system_category() };
+}
+
+std::error_code map_file(std::filesystem::path const &path,
+                         std::byte const *&mapping, std::size_t &size)
+{
+    HANDLE const file = CreateFileW(
+        path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, nullptr
+    );
+    if(file == INVALID_HANDLE_VALUE) {
+        return last_error();
+    }
+
+    LARGE_INTEGER file_size;
+    if(!GetFileSizeEx(file, &file_size)) {
+        auto const error = last_error();
+        CloseHandle(file);
+        return error;
+    }
+
+    // Windows can't map an empty file
+    if(file_size.QuadPart < static_cast<LONGLONG>(sizeof(VecFileHeader))) {
+        CloseHandle(file);
+        return VecFileError::not_a_vec_file;
+    }
+
+    HANDLE const view =
+        CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    auto error = view == nullptr ? last_error() : std::error_code { };
+    CloseHandle(file);
+    if(error) {
+        return error;
+    }
+
+    void const *data = MapViewOfFile(view, FILE_MAP_READ, 0, 0, 0);
+    error = data == nullptr ? last_error() : std::error_code { };
+    CloseHandle(view);
+    if(error) {
+        return error;
+    }
+
+    mapping = static_cast<std::byte const *>(data);
+    size = static_cast<std::size_t>(file_size.QuadPart);
+    return { };
+}
+
+void unmap_file(std::byte const *mapping, std::size_t) {
+    UnmapViewOfFile(mapping);
+}
+
+std::FILE * open_for_reading(std::filesystem::path const &path) {
+    return _wfopen(path.c_str(), L"rb");
+}
+
+std::FILE * open_for_writing(std::filesystem::path const &path) {
+    return _wfopen(path.c_str(), L"wb");
+}
+
+#else
+
+std::error_code last_error() {
+    return { errno, std::generic_category() };
+}
+
+std::error_code map_file(std::filesystem::path const &path,
+                         std::byte const *&mapping, std::size_t &size)
+{
+    int const file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if(file < 0) {
+        return last_error();
+    }
+
+    struct stat status;
+    if(::fstat(file, &status) != 0) {
+        auto const error = last_error();
+        ::close(file);
+        return error;
+    }
+
+    // mmap() can't map an empty file either
+    if(status.st_size < static_cast<off_t>(sizeof(VecFileHeader))) {
+        ::close(file);
+        return VecFileError::not_a_vec_file;
+    }
+
+    auto const file_size = static_cast<std::size_t>(status.st_size);
+    void *data = ::mmap(nullptr, file_size, PROT_READ, MAP_SHARED, file, 0);
+    auto const error = data == MAP_FAILED ? last_error() : std::error_code { };
+    ::close(file);
+    if(error) {
+        return error;
+    }
+
+    mapping = static_cast<std::byte const *>(data);
+    size = file_size;
+    return { };
+}
+
+void unmap_file(std::byte const *mapping, std::size_t const size) {
+    ::munmap(const_cast<std::byte *>(mapping), size);
+}
+
+std::FILE * open_for_reading(std::filesystem::path const &path) {
+    return std::fopen(path.c_str(), "rb");
+}
+
+std::FILE * open_for_writing(std::filesystem::path const &path) {
+    return std::fopen(path.c_str(), "wb");
+}
+
+#endif
+
+// Everything open() checks, given the whole mapped file
+std::error_code check_header(VecFileHeader const &header,
+                             std::size_t const file_size)
+{
+    if(header.magic != VecFileHeader::expected_magic) {
+        return VecFileError::not_a_vec_file;
+    }
+    if(header.version != VecFileHeader::current_version) {
+        return VecFileError::unsupported_version;
+    }
+
+    // Recomputing where the data belongs catches any field that's out of
+    // range or disagrees with the others
+    VecFileHeader expected = header;
+    if(header.header_size < sizeof(VecFileHeader) || !place_data(expected)
+       || expected.data_offset != header.data_offset
+       || expected.data_size != header.data_size
+       || expected.lane_stride != header.lane_stride)
+    {
+        return VecFileError::bad_header;
+    }
+
+    if(header.data_offset > file_size
+       || header.data_size > file_size - header.data_offset)
+    {
+        return VecFileError::truncated;
+    }
+
+    return { };
+}
+
+// The padding between the header and the data, which is never longer than
+// the largest alignment
+std::array<std::byte, 4096u> constexpr zeros { };
+
+[[nodiscard]] bool write_all(std::FILE *const file,
+                             std::span<std::byte const> const bytes)
+{
+    return std::fwrite(bytes.data(), 1u, bytes.size(), file) == bytes.size();
+}
+
+// Reads and throws away bytes, a buffer at a time, since std::fseek() only
+// takes a long, which is 32 bits on Windows
+[[nodiscard]] bool skip(std::FILE *const file, uint64_t bytes) {
+    std::array<std::byte, 4096u> discard;
+    while(bytes > 0u) {
+        auto const run = static_cast<std::size_t>(
+            std::min<uint64_t>(bytes, discard.size()));
+        if(std::fread(discard.data(), 1u, run, file) != run) {
+            return false;
+        }
+        bytes -= run;
+    }
+
+    return true;
+}
+
+// Why a read came up short, once it has
+[[nodiscard]] std::error_code read_error(std::FILE *const file) {
+    return std::ferror(file) ? std::make_error_code(std::errc::io_error)
+                             : VecFileError::truncated;
+}
+
+} // namespace
+
+// =============================================================================
+std::error_category const & vec_file_category() {
+    static VecFileCategory const category;
+    return category;
+}
+
+std::error_code make_error_code(VecFileError const error) {
+    return { static_cast<int>(error), vec_file_category() };
+}
+
+// =============================================================================
+namespace detail {
+
+// Both sums are reduced modulo 2^32 - 1 often enough that neither can
+// overflow 64 bits in between
+void Fletcher64::add(std::span<std::byte const> bytes) {
+    assert(bytes.size() % sizeof(uint32_t) == 0u);
+
+    std::size_t constexpr block = 1u << 15u;
+    uint64_t constexpr modulus = 0xFFFFFFFFu;
+
+    std::size_t words = bytes.size() / sizeof(uint32_t);
+    auto const *data = bytes.data();
+
+    while(words > 0u) {
+        std::size_t const run = std::min(words, block);
+        for(std::size_t i = 0u; i < run; ++i) {
+            uint32_t word;
+            std::memcpy(&word, data + i * sizeof(uint32_t), sizeof(word));
+            _low += word;
+            _high += _low;
+        }
+
+        _low %= modulus;
+        _high %= modulus;
+        data += run * sizeof(uint32_t);
+        words -= run;
+    }
+}
+
+uint64_t Fletcher64::value() const {
+    return (_high << 32u) | _low;
+}
+
+std::error_code write_vec_file(std::filesystem::path const &path,
+                               VecFileHeader header,
+                               std::size_t const block_count,
+                               BlockSource const block, void *const context)
+{
+    if constexpr(std::endian::native != std::endian::little) {
+        return VecFileError::wrong_byte_order;
+    }
+
+    header.header_size = sizeof(VecFileHeader);
+    if(!place_data(header)) {
+        return std::make_error_code(std::errc::invalid_argument);
+    }
+
+    auto const padding = [](uint64_t const bytes) {
+        return std::span<std::byte const>(zeros).first(bytes);
+    };
+
+    // Calls visit() on each block in file order, and on the padding after it
+    auto const for_each_span = [&](auto const &visit) {
+        for(std::size_t i = 0u; i < block_count; ++i) {
+            auto const bytes = block(context, i);
+            if(!visit(bytes)) {
+                return false;
+            }
+            if(header.layout == VecLayout::soa
+               && !visit(padding(header.lane_stride - bytes.size())))
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    Fletcher64 checksum;
+    for_each_span([&checksum](std::span<std::byte const> const bytes) {
+        checksum.add(bytes);
+        return true;
+    });
+    header.checksum = checksum.value();
+
+    std::unique_ptr<std::FILE, int (*)(std::FILE *)> file {
+        open_for_writing(path), &std::fclose
+    };
+    if(!file) {
+        return last_error();
+    }
+
+    bool const written =
+        write_all(file.get(), std::as_bytes(std::span { &header, 1u }))
+     && write_all(file.get(), padding(header.data_offset - sizeof(header)))
+     && for_each_span([&file](std::span<std::byte const> const bytes) {
+            return write_all(file.get(), bytes);
+        });
+
+    if(!written || std::fclose(file.release()) != 0) {
+        return last_error();
+    }
+    return { };
+}
+
+std::error_code write_vec_file(std::filesystem::path const &path,
+                               VecFileHeader const &header,
+                               std::span<std::span<std::byte const> const>
+                                   blocks)
+{
+    return write_vec_file(path, header, blocks.size(),
+        [](void *const context, std::size_t const i) {
+            using Blocks = std::span<std::span<std::byte const> const>;
+            return (*static_cast<Blocks const *>(context))[i];
+        },
+        &blocks
+    );
+}
+
+} // namespace detail
+
+// =============================================================================
+std::error_code VecFile::open(std::filesystem::path const &path) {
+    close();
+
+    if constexpr(std::endian::native != std::endian::little) {
+        return VecFileError::wrong_byte_order;
+    }
+
+    std::byte const *mapping = nullptr;
+    std::size_t size = 0u;
+    if(auto const error = map_file(path, mapping, size)) {
+        return error;
+    }
+
+    VecFileHeader header;
+    std::memcpy(&header, mapping, sizeof(header));
+    if(auto const error = check_header(header, size)) {
+        unmap_file(mapping, size);
+        return error;
+    }
+
+    _mapping = mapping;
+    _mapping_size = size;
+    _header = header;
+    return { };
+}
+
+void VecFile::close() {
+    if(_mapping != nullptr) {
+        unmap_file(_mapping, _mapping_size);
+    }
+
+    _mapping = nullptr;
+    _mapping_size = 0u;
+    _header = VecFileHeader { };
+}
+
+std::error_code VecFile::verify() const {
+    if(!is_open()) {
+        return std::make_error_code(std::errc::bad_file_descriptor);
+    }
+
+    detail::Fletcher64 checksum;
+    checksum.add({ _data(), _header.data_size });
+    if(checksum.value() != _header.checksum) {
+        return VecFileError::bad_checksum;
+    }
+    return { };
+}
+
+// =============================================================================
+VecFile::~VecFile() {
+    close();
+}
+
+VecFile::VecFile(VecFile &&other) noexcept :
+    _mapping      { std::exchange(other._mapping, nullptr) },
+    _mapping_size { std::exchange(other._mapping_size, 0u) },
+    _header       { other._header }
+{
+    other.close();
+}
+
+VecFile & VecFile::operator=(VecFile &&other) noexcept {
+    if(this != &other) {
+        close();
+        _mapping = std::exchange(other._mapping, nullptr);
+        _mapping_size = std::exchange(other._mapping_size, 0u);
+        _header = other._header;
+        other.close();
+    }
+
+    return *this;
+}
+
+// =============================================================================
+std::error_code VecFileReader::open(std::filesystem::path const &path) {
+    close();
+
+    if constexpr(std::endian::native != std::endian::little) {
+        return VecFileError::wrong_byte_order;
+    }
+
+    std::error_code error;
+    auto const file_size = std::filesystem::file_size(path, error);
+    if(error) {
+        return error;
+    }
+
+    std::unique_ptr<std::FILE, int (*)(std::FILE *)> file {
+        open_for_reading(path), &std::fclose
+    };
+    if(!file) {
+        return last_error();
+    }
+
+    VecFileHeader header;
+    if(file_size < sizeof(header)
+       || std::fread(&header, sizeof(header), 1u, file.get()) != 1u)
+    {
+        return VecFileError::not_a_vec_file;
+    }
+
+    if(auto const error = check_header(header, file_size)) {
+        return error;
+    }
+    if(header.layout != VecLayout::aos) {
+        return std::make_error_code(std::errc::not_supported);
+    }
+    if(!skip(file.get(), header.data_offset - sizeof(header))) {
+        return read_error(file.get());
+    }
+
+    _file = file.release();
+    _header = header;
+    return { };
+}
+
+void VecFileReader::close() {
+    if(_file != nullptr) {
+        std::fclose(_file);
+    }
+
+    _file = nullptr;
+    _header = VecFileHeader { };
+    _read = 0u;
+    _checksum = detail::Fletcher64 { };
+    _error = std::error_code { };
+}
+
+std::size_t VecFileReader::_read_bytes(std::span<std::byte> const out,
+                                       std::size_t const element)
+{
+    if(_error) {
+        return 0u;
+    }
+
+    auto const count = static_cast<std::size_t>(
+        std::min<uint64_t>(out.size() / element, remaining()));
+    auto const bytes = out.first(count * element);
+    if(std::fread(bytes.data(), 1u, bytes.size(), _file) != bytes.size()) {
+        _error = read_error(_file);
+        return 0u;
+    }
+
+    _checksum.add(bytes);
+    _read += count;
+    if(count != 0u && remaining() == 0u
+       && _checksum.value() != _header.checksum)
+    {
+        _error = VecFileError::bad_checksum;
+    }
+
+    return count;
+}
+
+VecFileReader::~VecFileReader() {
+    close();
+}
+
+VecFileReader::VecFileReader(VecFileReader &&other) noexcept :
+    _file     { std::exchange(other._file, nullptr) },
+    _header   { other._header },
+    _read     { other._read },
+    _checksum { other._checksum },
+    _error    { other._error }
+{
+    other.close();
+}
+
+VecFileReader & VecFileReader::operator=(VecFileReader &&other) noexcept {
+    if(this != &other) {
+        close();
+        _file = std::exchange(other._file, nullptr);
+        _header = other._header;
+        _read = other._read;
+        _checksum = other._checksum;
+        _error = other._error;
+        other.close();
+    }
+
+    return *this;
+}
+
+// =============================================================================
+std::error_code VecFileWriter::_open(std::filesystem::path const &path) {
+    if constexpr(std::endian::native != std::endian::little) {
+        return VecFileError::wrong_byte_order;
+    }
+
+    _header.header_size = sizeof(VecFileHeader);
+    if(!place_data(_header)) {
+        _header = VecFileHeader { };
+        return std::make_error_code(std::errc::invalid_argument);
+    }
+
+    std::unique_ptr<std::FILE, int (*)(std::FILE *)> file {
+        open_for_writing(path), &std::fclose
+    };
+    if(!file) {
+        _header = VecFileHeader { };
+        return last_error();
+    }
+
+    // Everything but the magic, which close() fills in along with the rest
+    VecFileHeader placeholder = _header;
+    placeholder.magic = { };
+
+    auto const padding = std::span<std::byte const>(zeros).first(
+        _header.data_offset - sizeof(placeholder));
+    if(!write_all(file.get(), std::as_bytes(std::span { &placeholder, 1u }))
+       || !write_all(file.get(), padding))
+    {
+        _header = VecFileHeader { };
+        return last_error();
+    }
+
+    _file = file.release();
+    return { };
+}
+
+std::error_code VecFileWriter::close() {
+    if(_file == nullptr) {
+        return { };
+    }
+
+    auto error = _error;
+    if(!error) {
+        _header.checksum = _checksum.value();
+        if(!place_data(_header)) {
+            error = std::make_error_code(std::errc::file_too_large);
+        }
+        else if(std::fseek(_file, 0, SEEK_SET) != 0
+                || !write_all(_file,
+                              std::as_bytes(std::span { &_header, 1u })))
+        {
+            error = last_error();
+        }
+    }
+
+    if(std::fclose(_file) != 0 && !error) {
+        error = last_error();
+    }
+
+    _file = nullptr;
+    _header = VecFileHeader { };
+    _checksum = detail::Fletcher64 { };
+    _error = std::error_code { };
+    return error;
+}
+
+bool VecFileWriter::_write_bytes(std::span<std::byte const> const bytes) {
+    if(_file == nullptr || _error) {
+        return false;
+    }
+
+    if(!write_all(_file, bytes)) {
+        _error = last_error();
+        return false;
+    }
+
+    _checksum.add(bytes);
+    _header.count += bytes.size()
+                   / (component_size(_header.component_type)
+                      * _header.components);
+    return true;
+}
+
+VecFileWriter::~VecFileWriter() {
+    close();
+}
+
+VecFileWriter::VecFileWriter(VecFileWriter &&other) noexcept :
+    _file     { std::exchange(other._file, nullptr) },
+    _header   { other._header },
+    _checksum { other._checksum },
+    _error    { other._error }
+{
+    other._header = VecFileHeader { };
+    other._checksum = detail::Fletcher64 { };
+    other._error = std::error_code { };
+}
+
+VecFileWriter & VecFileWriter::operator=(VecFileWriter &&other) noexcept {
+    if(this != &other) {
+        close();
+        _file = std::exchange(other._file, nullptr);
+        _header = std::exchange(other._header, VecFileHeader { });
+        _checksum = std::exchange(other._checksum, detail::Fletcher64 { });
+        _error = std::exchange(other._error, std::error_code { });
+    }
+
+    return *this;
+}
+
+} // namespace btx::math
\ No newline at end of file
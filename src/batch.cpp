@@ -0,0 +1,196 @@
+#include "brasstacks/math/batch.hpp"
+#include "kernels/kernels.hpp"
+
+namespace btx::math {
+
+// The kernels themselves live in src/kernels, built once per instruction set
+// level. These just check the spans and forward to the selected level.
+
+// =============================================================================
+// Dot Product
+void dot(std::span<Vec2 const> a, std::span<Vec2 const> b,
+         std::span<float> out)
+{
+    assert(a.size() == b.size() && a.size() == out.size());
+    kernels::table().dot2(a.data(), b.data(), out.data(), out.size());
+}
+
+void dot(std::span<Vec3 const> a, std::span<Vec3 const> b,
+         std::span<float> out)
+{
+    assert(a.size() == b.size() && a.size() == out.size());
+    kernels::table().dot3(a.data(), b.data(), out.data(), out.size());
+}
+
+void dot(std::span<Vec4 const> a, std::span<Vec4 const> b,
+         std::span<float> out)
+{
+    assert(a.size() == b.size() && a.size() == out.size());
+    kernels::table().dot4(a.data(), b.data(), out.data(), out.size());
+}
+
+void dot(Vec2 const &a, std::span<Vec2 const> b, std::span<float> out) {
+    assert(b.size() == out.size());
+    kernels::table().dot2_one(a, b.data(), out.data(), out.size());
+}
+
+void dot(Vec3 const &a, std::span<Vec3 const> b, std::span<float> out) {
+    assert(b.size() == out.size());
+    kernels::table().dot3_one(a, b.data(), out.data(), out.size());
+}
+
+void dot(Vec4 const &a, std::span<Vec4 const> b, std::span<float> out) {
+    assert(b.size() == out.size());
+    kernels::table().dot4_one(a, b.data(), out.data(), out.size());
+}
+
+// =============================================================================
+// Cross Product
+void cross(std::span<Vec3 const> a, std::span<Vec3 const> b,
+           std::span<Vec3> out)
+{
+    assert(a.size() == b.size() && a.size() == out.size());
+    kernels::table().cross3(a.data(), b.data(), out.data(), out.size());
+}
+
+// =============================================================================
+// Normalizing
+void normalize(std::span<Vec2 const> v, std::span<Vec2> out,
+               Accuracy const accuracy)
+{
+    assert(v.size() == out.size());
+    kernels::table().normalize2(v.data(), out.data(), out.size(), accuracy);
+}
+
+void normalize(std::span<Vec3 const> v, std::span<Vec3> out,
+               Accuracy const accuracy)
+{
+    assert(v.size() == out.size());
+    kernels::table().normalize3(v.data(), out.data(), out.size(), accuracy);
+}
+
+void normalize(std::span<Vec4 const> v, std::span<Vec4> out,
+               Accuracy const accuracy)
+{
+    assert(v.size() == out.size());
+    kernels::table().normalize4(v.data(), out.data(), out.size(), accuracy);
+}
+
+// =============================================================================
+// Transforming
+void transform(Mat4 const &m, std::span<Vec4 const> v, std::span<Vec4> out) {
+    assert(v.size() == out.size());
+    kernels::table().transform4(m, v.data(), out.data(), out.size());
+}
+
+void transform_points(Mat4 const &m, std::span<Vec3 const> v,
+                      std::span<Vec3> out)
+{
+    assert(v.size() == out.size());
+    kernels::table().transform_points(m, v.data(), out.data(), out.size());
+}
+
+// =============================================================================
+// Quaternions
+void rotate(Quat const &q, std::span<Vec3 const> v, std::span<Vec3> out) {
+    assert(v.size() == out.size());
+    kernels::table().rotate3(q, v.data(), out.data(), out.size());
+}
+
+void nlerp(std::span<Quat const> a, std::span<Quat const> b, float const t,
+           std::span<Quat> out)
+{
+    assert(a.size() == b.size() && a.size() == out.size());
+    kernels::table().nlerp(a.data(), b.data(), t, out.data(), out.size());
+}
+
+void slerp(std::span<Quat const> a, std::span<Quat const> b, float const t,
+           std::span<Quat> out)
+{
+    assert(a.size() == b.size() && a.size() == out.size());
+    kernels::table().slerp(a.data(), b.data(), t, out.data(), out.size());
+}
+
+// =============================================================================
+// Visibility
+std::size_t visible_indices(ViewCone const &cone,
+                            std::span<Vec3 const> targets,
+                            std::span<uint32_t> out)
+{
+    assert(out.size() >= targets.size());
+    assert(targets.size() <= std::numeric_limits<uint32_t>::max());
+
+    return kernels::table().cone_indices(
+        cone.position, cone.forward, std::cos(radians(cone.half_fov)),
+        targets.data(), out.data(), targets.size()
+    );
+}
+
+void visible_mask(ViewCone const &cone, std::span<Vec3 const> targets,
+                  std::span<uint64_t> mask)
+{
+    assert(mask.size() == (targets.size() + 63u) / 64u);
+
+    kernels::table().cone_mask(
+        cone.position, cone.forward, std::cos(radians(cone.half_fov)),
+        targets.data(), mask.data(), targets.size()
+    );
+}
+
+// =============================================================================
+// Approximate Equality
+namespace {
+
+// Pairs that didn't match, from the mask the kernels filled in
+std::size_t mismatches(std::span<uint64_t const> mask,
+                       std::size_t const count)
+{
+    std::size_t matches = 0u;
+    for(auto const word : mask) {
+        matches += static_cast<std::size_t>(std::popcount(word));
+    }
+
+    return count - matches;
+}
+
+template <typename T>
+std::size_t compare(auto const kernel, std::span<T const> a,
+                    std::span<T const> b, std::span<uint64_t> mask,
+                    Tolerance const &tolerance)
+{
+    assert(a.size() == b.size());
+    assert(mask.size() == (a.size() + 63u) / 64u);
+    assert(tolerance.mode != Tolerance::Mode::ulps ||
+           tolerance.max_ulps <= (1u << 22u));
+
+    kernel(a.data(), b.data(), tolerance, mask.data(), a.size());
+    return mismatches(mask, a.size());
+}
+
+} // namespace
+
+std::size_t approx_equal(std::span<float const> a, std::span<float const> b,
+                         std::span<uint64_t> mask, Tolerance const tolerance)
+{
+    return compare(kernels::table().equal1, a, b, mask, tolerance);
+}
+
+std::size_t approx_equal(std::span<Vec2 const> a, std::span<Vec2 const> b,
+                         std::span<uint64_t> mask, Tolerance const tolerance)
+{
+    return compare(kernels::table().equal2, a, b, mask, tolerance);
+}
+
+std::size_t approx_equal(std::span<Vec3 const> a, std::span<Vec3 const> b,
+                         std::span<uint64_t> mask, Tolerance const tolerance)
+{
+    return compare(kernels::table().equal3, a, b, mask, tolerance);
+}
+
+std::size_t approx_equal(std::span<Vec4 const> a, std::span<Vec4 const> b,
+                         std::span<uint64_t> mask, Tolerance const tolerance)
+{
+    return compare(kernels::table().equal4, a, b, mask, tolerance);
+}
+
+} // namespace btx::math
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include "brasstacks/math/dispatch.hpp"
+#include "kernels/kernels.hpp"
+
+#if defined(BTX_MATH_HAS_SSE2)
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#endif
+
+#include <atomic>
+
+namespace btx::math {
+
+namespace {
+
+#if defined(BTX_MATH_HAS_SSE2)
+
+struct CpuidRegisters {
+    uint32_t eax = 0u;
+    uint32_t ebx = 0u;
+    uint32_t ecx = 0u;
+    uint32_t edx = 0u;
+};
+
+CpuidRegisters cpuid(uint32_t const leaf, uint32_t const subleaf) {
+    CpuidRegisters regs;
+
+#if defined(_MSC_VER)
+    int info[4] { };
+    __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+    regs = {
+        static_cast<uint32_t>(info[0]), static_cast<uint32_t>(info[1]),
+        static_cast<uint32_t>(info[2]), static_cast<uint32_t>(info[3]),
+    };
+#else
+    __cpuid_count(leaf, subleaf, regs.eax, regs.ebx, regs.ecx, regs.edx);
+#endif
+
+    return regs;
+}
+
+// Which register states the OS saves on a context switch. Only valid when
+// CPUID reports OSXSAVE.
+uint64_t xgetbv() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t eax = 0u;
+    uint32_t edx = 0u;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32u) | eax;
+#endif
+}
+
+bool has_bit(uint32_t const reg, uint32_t const bit) {
+    return ((reg >> bit) & 1u) != 0u;
+}
+
+SimdLevel detect() {
+    uint32_t const max_leaf = cpuid(0u, 0u).eax;
+    CpuidRegisters const leaf1 = cpuid(1u, 0u);
+
+    if(!has_bit(leaf1.ecx, 19u)) {          // SSE4.1
+        return SimdLevel::sse2;
+    }
+
+    // The wider registers are only usable if the OS saves them, which
+    // XCR0 reports: bits 1 and 2 for XMM and YMM, 5 through 7 for the
+    // AVX-512 mask and ZMM registers
+    bool const os_avx = has_bit(leaf1.ecx, 27u)     // OSXSAVE
+                     && has_bit(leaf1.ecx, 28u)     // AVX
+                     && (xgetbv() & 0x06u) == 0x06u;
+
+    if(!os_avx || max_leaf < 7u) {
+        return SimdLevel::sse41;
+    }
+
+    CpuidRegisters const leaf7 = cpuid(7u, 0u);
+
+    bool const avx2 = has_bit(leaf7.ebx, 5u)        // AVX2
+                   && has_bit(leaf1.ecx, 12u)       // FMA
+                   && has_bit(leaf1.ecx, 23u)       // POPCNT
+                   && has_bit(leaf1.ecx, 29u);      // F16C
+    if(!avx2) {
+        return SimdLevel::sse41;
+    }
+
+    bool const avx512 = has_bit(leaf7.ebx, 16u)     // AVX512F
+                     && has_bit(leaf7.ebx, 17u)     // AVX512DQ
+                     && has_bit(leaf7.ebx, 30u)     // AVX512BW
+                     && has_bit(leaf7.ebx, 31u)     // AVX512VL
+                     && (xgetbv() & 0xE6u) == 0xE6u;
+
+    return avx512 ? SimdLevel::avx512 : SimdLevel::avx2;
+}
+
+#else
+
+SimdLevel detect() {
+    return SimdLevel::scalar;
+}
+
+#endif // BTX_MATH_HAS_SSE2
+
+kernels::Table const * table_for(SimdLevel const level) {
+    switch(level) {
+        case SimdLevel::scalar: return kernels::scalar_table();
+        case SimdLevel::sse2:   return kernels::sse2_table();
+        case SimdLevel::sse41:  return kernels::sse41_table();
+        case SimdLevel::avx2:   return kernels::avx2_table();
+        case SimdLevel::avx512: return kernels::avx512_table();
+    }
+
+    return kernels::scalar_table();
+}
+
+// Null until the first kernel call or an explicit force_simd_level(). Two
+// threads racing to make that first selection both store the same pointer.
+std::atomic<SimdLevel> selected_level { SimdLevel::scalar };
+std::atomic<kernels::Table const *> selected_table { nullptr };
+
+SimdLevel select(SimdLevel const level) {
+    selected_level.store(level, std::memory_order_relaxed);
+    selected_table.store(table_for(level), std::memory_order_release);
+    return level;
+}
+
+} // namespace
+
+// =============================================================================
+SimdLevel detected_simd_level() {
+    static SimdLevel const level = detect();
+    return level;
+}
+
+SimdLevel simd_level() {
+    if(selected_table.load(std::memory_order_acquire) == nullptr) {
+        select(detected_simd_level());
+    }
+
+    return selected_level.load(std::memory_order_relaxed);
+}
+
+SimdLevel force_simd_level(SimdLevel const level) {
+    return select(std::min(level, detected_simd_level()));
+}
+
+void reset_simd_level() {
+    select(detected_simd_level());
+}
+
+char const * to_string(SimdLevel const level) {
+    switch(level) {
+        case SimdLevel::scalar: return "scalar";
+        case SimdLevel::sse2:   return "SSE2";
+        case SimdLevel::sse41:  return "SSE4.1";
+        case SimdLevel::avx2:   return "AVX2";
+        case SimdLevel::avx512: return "AVX-512";
+    }
+
+    return "unknown";
+}
+
+// =============================================================================
+kernels::Table const & kernels::table() {
+    Table const *current = selected_table.load(std::memory_order_acquire);
+
+    if(current == nullptr) [[unlikely]] {
+        select(detected_simd_level());
+        current = selected_table.load(std::memory_order_acquire);
+    }
+
+    return *current;
+}
+
+} // namespace btx::math
\ No newline at end of file
@@ -0,0 +1,40 @@
+// Kernels built for AVX2, FMA, POPCNT, and F16C
+#include "kernels.hpp"
+
+#if defined(BTX_MATH_HAS_SSE2)
+
+#if defined(__clang__)
+    #pragma clang attribute push(                                        \
+        __attribute__((target("avx2,fma,popcnt,f16c"))),                     \
+        apply_to = function                                             \
+    )
+#elif defined(__GNUC__)
+    #pragma GCC push_options
+    #pragma GCC target("avx2,fma,popcnt,f16c")
+#endif
+
+#define BTX_KERNEL_LEVEL     BTX_KERNEL_LEVEL_AVX2
+#define BTX_KERNEL_NAMESPACE avx2
+
+#include "pack.hpp"
+#include "kernels-inl.hpp"
+
+#if defined(__clang__)
+    #pragma clang attribute pop
+#elif defined(__GNUC__)
+    #pragma GCC pop_options
+#endif
+
+#endif // BTX_MATH_HAS_SSE2
+
+namespace btx::math::kernels {
+
+Table const * avx2_table() {
+#if defined(BTX_MATH_HAS_SSE2)
+    return &avx2::level_table;
+#else
+    return nullptr;
+#endif
+}
+
+} // namespace btx::math::kernels
\ No newline at end of file
@@ -0,0 +1,48 @@
+// Kernels built for AVX-512 F, DQ, BW, and VL
+#include "kernels.hpp"
+
+#if defined(BTX_MATH_HAS_SSE2)
+
+#if defined(__clang__)
+    #pragma clang attribute push(                                        \
+        __attribute__((target("avx512f,avx512dq,avx512bw,avx512vl,"     \
+                              "avx2,fma,popcnt,f16c"))),                \
+        apply_to = function                                             \
+    )
+#elif defined(__GNUC__)
+    #pragma GCC push_options
+    #pragma GCC target("avx512f,avx512dq,avx512bw,avx512vl", \
+                       "avx2,fma,popcnt,f16c")
+
+    // GCC 12 trips over the _mm512_undefined_ps() inside its own intrinsics
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+    #pragma GCC diagnostic ignored "-Wuninitialized"
+#endif
+
+#define BTX_KERNEL_LEVEL     BTX_KERNEL_LEVEL_AVX512
+#define BTX_KERNEL_NAMESPACE avx512
+
+#include "pack.hpp"
+#include "kernels-inl.hpp"
+
+#if defined(__clang__)
+    #pragma clang attribute pop
+#elif defined(__GNUC__)
+    #pragma GCC diagnostic pop
+    #pragma GCC pop_options
+#endif
+
+#endif // BTX_MATH_HAS_SSE2
+
+namespace btx::math::kernels {
+
+Table const * avx512_table() {
+#if defined(BTX_MATH_HAS_SSE2)
+    return &avx512::level_table;
+#else
+    return nullptr;
+#endif
+}
+
+} // namespace btx::math::kernels
\ No newline at end of file
@@ -0,0 +1,1242 @@
+// The bulk kernels themselves, written once against the Pack interface from
+// pack.hpp. Like pack.hpp, this is included once per instruction set level,
+// inside that level's namespace and target region.
+
+namespace btx::math::kernels::BTX_KERNEL_NAMESPACE {
+
+namespace {
+
+std::size_t constexpr width = Pack::width;
+
+// The same encoding as _MM_SHUFFLE(), which isn't available without SSE
+consteval int order(int const a, int const b, int const c, int const d) {
+    return (a << 6) | (b << 4) | (c << 2) | d;
+}
+
+// One register per component, lane i holding element i of the block. A plain
+// array rather than std::array, which would drop the registers' alignment.
+template <std::size_t N>
+struct Lanes {
+    Reg regs[N];
+
+    [[nodiscard]] Reg & operator[](std::size_t const c) { return regs[c]; }
+    [[nodiscard]] Reg const & operator[](std::size_t const c) const {
+        return regs[c];
+    }
+};
+
+// =============================================================================
+// Deinterleaving loads. Each 128-bit chunk of the result covers four
+// consecutive vectors, and chunk i starts i * 4 vectors into the block, so
+// lane i of every component register always belongs to vector i.
+
+Lanes<2> load_lanes(Vec2 const *v) {
+    auto const *data = reinterpret_cast<float const *>(v);
+
+    Reg const r0 = Pack::load_chunks(data,      8u); // x0 y0 x1 y1
+    Reg const r1 = Pack::load_chunks(data + 4u, 8u); // x2 y2 x3 y3
+
+    return { {
+        Pack::shuffle<order(2, 0, 2, 0)>(r0, r1),
+        Pack::shuffle<order(3, 1, 3, 1)>(r0, r1),
+    } };
+}
+
+Lanes<3> load_lanes(Vec3 const *v) {
+    auto const *data = reinterpret_cast<float const *>(v);
+
+    Reg const r0 = Pack::load_chunks(data,      12u); // x0 y0 z0 x1
+    Reg const r1 = Pack::load_chunks(data + 4u, 12u); // y1 z1 x2 y2
+    Reg const r2 = Pack::load_chunks(data + 8u, 12u); // z2 x3 y3 z3
+
+    Reg const x0x1y1z1 = Pack::shuffle<order(1, 0, 3, 0)>(r0, r1);
+    Reg const x2y2x3y3 = Pack::shuffle<order(2, 1, 3, 2)>(r1, r2);
+    Reg const y0__y1__ = Pack::shuffle<order(0, 2, 0, 1)>(r0, x0x1y1z1);
+    Reg const z0z0z1z1 = Pack::shuffle<order(1, 1, 2, 2)>(r0, r1);
+    Reg const z2z2z3z3 = Pack::shuffle<order(3, 3, 0, 0)>(r2, r2);
+
+    return { {
+        Pack::shuffle<order(2, 0, 1, 0)>(x0x1y1z1, x2y2x3y3),
+        Pack::shuffle<order(3, 1, 2, 0)>(y0__y1__, x2y2x3y3),
+        Pack::shuffle<order(2, 0, 2, 0)>(z0z0z1z1, z2z2z3z3),
+    } };
+}
+
+// A 4x4 transpose within each chunk, which is its own inverse
+void transpose(Reg &r0, Reg &r1, Reg &r2, Reg &r3) {
+    Reg const t0 = Pack::unpacklo(r0, r1); // x0 x1 y0 y1
+    Reg const t1 = Pack::unpacklo(r2, r3); // x2 x3 y2 y3
+    Reg const t2 = Pack::unpackhi(r0, r1); // z0 z1 w0 w1
+    Reg const t3 = Pack::unpackhi(r2, r3); // z2 z3 w2 w3
+
+    r0 = Pack::shuffle<order(1, 0, 1, 0)>(t0, t1);
+    r1 = Pack::shuffle<order(3, 2, 3, 2)>(t0, t1);
+    r2 = Pack::shuffle<order(1, 0, 1, 0)>(t2, t3);
+    r3 = Pack::shuffle<order(3, 2, 3, 2)>(t2, t3);
+}
+
+Lanes<4> load_lanes(Vec4 const *v) {
+    auto const *data = reinterpret_cast<float const *>(v);
+
+    Lanes<4> lanes { {
+        Pack::load_chunks(data,       16u),
+        Pack::load_chunks(data + 4u,  16u),
+        Pack::load_chunks(data + 8u,  16u),
+        Pack::load_chunks(data + 12u, 16u),
+    } };
+
+    transpose(lanes[0], lanes[1], lanes[2], lanes[3]);
+    return lanes;
+}
+
+// =============================================================================
+// Interleaving stores, the inverse of the loads above
+void store_lanes(Lanes<2> const &lanes, Vec2 *v) {
+    auto *data = reinterpret_cast<float *>(v);
+
+    Pack::store_chunks(data,      8u, Pack::unpacklo(lanes[0], lanes[1]));
+    Pack::store_chunks(data + 4u, 8u, Pack::unpackhi(lanes[0], lanes[1]));
+}
+
+void store_lanes(Lanes<3> const &lanes, Vec3 *v) {
+    auto *data = reinterpret_cast<float *>(v);
+
+    Reg const x0y0x1y1 = Pack::unpacklo(lanes[0], lanes[1]);
+    Reg const x2y2x3y3 = Pack::unpackhi(lanes[0], lanes[1]);
+    Reg const z0z1x1y1 = Pack::shuffle<order(3, 2, 1, 0)>(lanes[2], x0y0x1y1);
+    Reg const z2z3x3y3 = Pack::shuffle<order(3, 2, 3, 2)>(lanes[2], x2y2x3y3);
+
+    Pack::store_chunks(data,      12u,
+        Pack::shuffle<order(2, 0, 1, 0)>(x0y0x1y1, z0z1x1y1));
+    Pack::store_chunks(data + 4u, 12u,
+        Pack::shuffle<order(1, 0, 1, 3)>(z0z1x1y1, x2y2x3y3));
+    Pack::store_chunks(data + 8u, 12u,
+        Pack::shuffle<order(1, 3, 2, 0)>(z2z3x3y3, z2z3x3y3));
+}
+
+void store_lanes(Lanes<4> lanes, Vec4 *v) {
+    auto *data = reinterpret_cast<float *>(v);
+
+    transpose(lanes[0], lanes[1], lanes[2], lanes[3]);
+
+    Pack::store_chunks(data,       16u, lanes[0]);
+    Pack::store_chunks(data + 4u,  16u, lanes[1]);
+    Pack::store_chunks(data + 8u,  16u, lanes[2]);
+    Pack::store_chunks(data + 12u, 16u, lanes[3]);
+}
+
+// =============================================================================
+// detail::mul_add() for every lane, fused only with BTX_MATH_FMA
+Reg mul_add(Reg const &a, Reg const &b, Reg const &c) {
+#if defined(BTX_MATH_FMA)
+    return Pack::fma(a, b, c);
+#else
+    return Pack::add(Pack::mul(a, b), c);
+#endif
+}
+
+// a * b - c the same way. Subtracting from -0 negates exactly, zeros
+// included, so this matches the scalar a * b + -c.
+Reg mul_sub(Reg const &a, Reg const &b, Reg const &c) {
+#if defined(BTX_MATH_FMA)
+    return Pack::fma(a, b, Pack::sub(Pack::set1(-0.0f), c));
+#else
+    return Pack::sub(Pack::mul(a, b), c);
+#endif
+}
+
+// The same component sums, in the same order, as the scalar dot()
+template <std::size_t N>
+Reg dot_lanes(Lanes<N> const &a, Lanes<N> const &b) {
+    Reg sum = Pack::mul(a[0], b[0]);
+    for(std::size_t c = 1u; c < N; ++c) {
+        sum = mul_add(a[c], b[c], sum);
+    }
+
+    return sum;
+}
+
+// A single vector splatted across every lane, for one-against-many
+template <typename Vector>
+auto splat_lanes(Vector const &v) {
+    std::size_t constexpr components = sizeof(Vector) / sizeof(float);
+
+    Lanes<components> lanes;
+    for(std::size_t c = 0u; c < components; ++c) {
+        lanes[c] = Pack::set1(v[static_cast<uint8_t>(c)]);
+    }
+
+    return lanes;
+}
+
+// And the scalar cross()
+Lanes<3> cross_lanes(Lanes<3> const &a, Lanes<3> const &b) {
+    return { {
+        mul_sub(a[1], b[2], Pack::mul(a[2], b[1])),
+        mul_sub(a[2], b[0], Pack::mul(a[0], b[2])),
+        mul_sub(a[0], b[1], Pack::mul(a[1], b[0])),
+    } };
+}
+
+// =============================================================================
+// 1 / sqrt(length_sq) at the requested accuracy
+template <Accuracy accuracy>
+Reg inverse_sqrt(Reg const length_sq) {
+    if constexpr(accuracy == Accuracy::exact) {
+        return Pack::div(Pack::set1(1.0f), Pack::sqrt(length_sq));
+    }
+
+    Reg const estimate = Pack::rsqrt(length_sq);
+
+    if constexpr(accuracy == Accuracy::fastest) {
+        return estimate;
+    }
+
+    // One Newton-Raphson step: y' = y * (1.5 - 0.5 * x * y * y)
+    Reg const half_x = Pack::mul(Pack::set1(0.5f), length_sq);
+    Reg const y_sq   = Pack::mul(estimate, estimate);
+    return Pack::mul(
+        estimate,
+        Pack::sub(Pack::set1(1.5f), Pack::mul(half_x, y_sq))
+    );
+}
+
+// Scales every lane by the inverse length. Lanes where skip is set get a
+// scale of one instead, which also masks off the inf/NaN that the inverse of
+// a zero length produces.
+template <Accuracy accuracy, std::size_t N>
+Lanes<N> scale_lanes(Lanes<N> lanes, Reg const length_sq, Mask const skip) {
+    Reg const scale = Pack::select(skip, Pack::set1(1.0f),
+                                   inverse_sqrt<accuracy>(length_sq));
+
+    for(auto &lane : lanes.regs) {
+        lane = Pack::mul(lane, scale);
+    }
+
+    return lanes;
+}
+
+// =============================================================================
+// A copy of the first `count` elements at p, zero-padded to a whole block
+template <typename T>
+std::array<T, width> padded(T const *p, std::size_t const count) {
+    std::array<T, width> block { };
+    std::copy_n(p, count, block.begin());
+    return block;
+}
+
+// Calls block() for each whole block of `width` elements, then once more on
+// zero-padded copies of whatever's left. The leftovers go through exactly the
+// same instructions as everything else, so an element's result never depends
+// on where it falls in the array.
+template <typename Out, typename Block, typename... In>
+void for_each_block(std::size_t const count, Out *out, Block block,
+                    In const *...in)
+{
+    std::size_t i = 0u;
+    for(; i + width <= count; i += width) {
+        block(out + i, (in + i)...);
+    }
+
+    if(i == count) {
+        return;
+    }
+
+    std::array<Out, width> tail { };
+    block(tail.data(), padded(in + i, count - i).data()...);
+    std::copy_n(tail.begin(), count - i, out + i);
+}
+
+// =============================================================================
+template <typename Vector>
+void dot_each(Vector const *a, Vector const *b, float *out,
+              std::size_t const count)
+{
+    for_each_block(count, out,
+        [](float *o, Vector const *a_block, Vector const *b_block) {
+            Pack::store(o, dot_lanes(load_lanes(a_block),
+                                     load_lanes(b_block)));
+        },
+        a, b
+    );
+}
+
+template <typename Vector>
+void dot_one(Vector const &a, Vector const *b, float *out,
+             std::size_t const count)
+{
+    auto const a_lanes = splat_lanes(a);
+
+    for_each_block(count, out,
+        [&a_lanes](float *o, Vector const *b_block) {
+            Pack::store(o, dot_lanes(a_lanes, load_lanes(b_block)));
+        },
+        b
+    );
+}
+
+void cross_each(Vec3 const *a, Vec3 const *b, Vec3 *out,
+                std::size_t const count)
+{
+    for_each_block(count, out,
+        [](Vec3 *o, Vec3 const *a_block, Vec3 const *b_block) {
+            store_lanes(cross_lanes(load_lanes(a_block),
+                                    load_lanes(b_block)), o);
+        },
+        a, b
+    );
+}
+
+// Mirrors the scalar normalize(): the zero vector and vectors that are
+// already unit length pass through untouched
+template <Accuracy accuracy, typename Vector>
+void normalize_each(Vector const *v, Vector *out, std::size_t const count) {
+    for_each_block(count, out,
+        [](Vector *o, Vector const *v_block) {
+            Reg const one = Pack::set1(1.0f);
+            Reg const eps = Pack::set1(epsilon);
+
+            auto const lanes = load_lanes(v_block);
+            Reg const length_sq = dot_lanes(lanes, lanes);
+            Mask const skip = Pack::mask_or(
+                Pack::lt(length_sq, eps),
+                Pack::lt(Pack::abs(Pack::sub(length_sq, one)), eps)
+            );
+
+            store_lanes(scale_lanes<accuracy>(lanes, length_sq, skip), o);
+        },
+        v
+    );
+}
+
+template <typename Vector>
+void normalize_each(Vector const *v, Vector *out, std::size_t const count,
+                    Accuracy const accuracy)
+{
+    switch(accuracy) {
+        case Accuracy::exact:
+            normalize_each<Accuracy::exact>(v, out, count);
+            break;
+        case Accuracy::fast:
+            normalize_each<Accuracy::fast>(v, out, count);
+            break;
+        case Accuracy::fastest:
+            normalize_each<Accuracy::fastest>(v, out, count);
+            break;
+    }
+}
+
+// Every element of m splatted across a register, column by column
+struct MatLanes {
+    Lanes<4> columns[4];
+};
+
+MatLanes splat_lanes(Mat4 const &m) {
+    MatLanes lanes;
+    for(uint8_t c = 0u; c < 4u; ++c) {
+        lanes.columns[c] = splat_lanes(m[c]);
+    }
+
+    return lanes;
+}
+
+// The same sums in the same order as Mat4::operator*(Vec4)
+Lanes<4> transform_lanes(MatLanes const &m, Lanes<4> const &v) {
+    Lanes<4> result;
+    for(std::size_t row = 0u; row < 4u; ++row) {
+        Reg sum = Pack::mul(m.columns[0][row], v[0]);
+        for(std::size_t c = 1u; c < 4u; ++c) {
+            sum = Pack::add(sum, Pack::mul(m.columns[c][row], v[c]));
+        }
+        result[row] = sum;
+    }
+
+    return result;
+}
+
+// The top three rows of m * (v, w), summed like Mat4::operator*(Vec4). A w
+// of zero leaves the translation out.
+Lanes<3> transform_lanes(MatLanes const &m, Lanes<3> const &v, bool const w) {
+    Lanes<3> result;
+    for(std::size_t row = 0u; row < 3u; ++row) {
+        Reg sum = Pack::mul(m.columns[0][row], v[0]);
+        sum = Pack::add(sum, Pack::mul(m.columns[1][row], v[1]));
+        sum = Pack::add(sum, Pack::mul(m.columns[2][row], v[2]));
+        result[row] = w ? Pack::add(sum, m.columns[3][row]) : sum;
+    }
+
+    return result;
+}
+
+void transform_each(Mat4 const &m, Vec4 const *v, Vec4 *out,
+                    std::size_t const count)
+{
+    MatLanes const m_lanes = splat_lanes(m);
+
+    for_each_block(count, out,
+        [&m_lanes](Vec4 *o, Vec4 const *v_block) {
+            store_lanes(transform_lanes(m_lanes, load_lanes(v_block)), o);
+        },
+        v
+    );
+}
+
+void transform_points_each(Mat4 const &m, Vec3 const *v, Vec3 *out,
+                           std::size_t const count)
+{
+    MatLanes const m_lanes = splat_lanes(m);
+
+    for_each_block(count, out,
+        [&m_lanes](Vec3 *o, Vec3 const *v_block) {
+            store_lanes(transform_lanes(m_lanes, load_lanes(v_block), true),
+                        o);
+        },
+        v
+    );
+}
+
+// =============================================================================
+// Quaternions share Vec4's layout, so they load and store the same way
+Lanes<4> load_lanes(Quat const *q) {
+    return load_lanes(reinterpret_cast<Vec4 const *>(q));
+}
+
+void store_lanes(Lanes<4> const &lanes, Quat *q) {
+    store_lanes(lanes, reinterpret_cast<Vec4 *>(q));
+}
+
+// The same steps in the same order as the scalar rotate()
+Lanes<3> rotate_lanes(Lanes<4> const &q, Lanes<3> const &v) {
+    Lanes<3> const u { { q[0], q[1], q[2] } };
+    Reg const two = Pack::set1(2.0f);
+
+    Lanes<3> t = cross_lanes(u, v);
+    for(auto &lane : t.regs) {
+        lane = Pack::mul(lane, two);
+    }
+
+    Lanes<3> const u_cross_t = cross_lanes(u, t);
+
+    Lanes<3> result;
+    for(std::size_t c = 0u; c < 3u; ++c) {
+        result[c] = Pack::add(Pack::add(v[c], Pack::mul(t[c], q[3])),
+                              u_cross_t[c]);
+    }
+
+    return result;
+}
+
+// a * weight_a + b * weight_b, component by component
+Lanes<4> blend_lanes(Lanes<4> const &a, Lanes<4> const &b,
+                     Reg const weight_a, Reg const weight_b)
+{
+    Lanes<4> result;
+    for(std::size_t c = 0u; c < 4u; ++c) {
+        result[c] = Pack::add(Pack::mul(a[c], weight_a),
+                              Pack::mul(b[c], weight_b));
+    }
+
+    return result;
+}
+
+// Mirrors the scalar nlerp(), including normalize(Quat) leaving the zero
+// quaternion alone
+Lanes<4> nlerp_lanes(Lanes<4> const &a, Lanes<4> const &b, float const t) {
+    Mask const flip = Pack::lt(dot_lanes(a, b), Pack::set1(0.0f));
+    Lanes<4> const blend = blend_lanes(
+        a, b,
+        Pack::set1(1.0f - t),
+        Pack::select(flip, Pack::set1(-t), Pack::set1(t))
+    );
+
+    Reg const length_sq = dot_lanes(blend, blend);
+    Mask const skip = Pack::lt(length_sq, Pack::set1(epsilon));
+
+    return scale_lanes<Accuracy::exact>(blend, length_sq, skip);
+}
+
+// =============================================================================
+// Polynomial approximations for slerp, after Cephes' single precision
+// asinf() and sinf(). Each is within a few ulp over the range it's used on,
+// and uses only adds and multiplies, so every level gets identical results.
+
+// asin(x) for |x| <= 0.5
+Reg asin_poly(Reg const x) {
+    Reg const z = Pack::mul(x, x);
+
+    Reg p = Pack::set1(4.2163199048e-2f);
+    p = Pack::add(Pack::mul(p, z), Pack::set1(2.4181311049e-2f));
+    p = Pack::add(Pack::mul(p, z), Pack::set1(4.5470025998e-2f));
+    p = Pack::add(Pack::mul(p, z), Pack::set1(7.4953002686e-2f));
+    p = Pack::add(Pack::mul(p, z), Pack::set1(1.6666752422e-1f));
+
+    return Pack::add(Pack::mul(Pack::mul(p, z), x), x);
+}
+
+// acos(x) for x in [0, 1]. Above one half, acos(x) = 2 asin(sqrt((1 - x) / 2))
+// keeps the polynomial's argument small.
+Reg acos_lanes(Reg const x) {
+    Reg const half = Pack::set1(0.5f);
+    Mask const large = Pack::lt(half, x);
+
+    Reg const arg = Pack::select(
+        large, Pack::sqrt(Pack::mul(half, Pack::sub(Pack::set1(1.0f), x))), x
+    );
+    Reg const asin = asin_poly(arg);
+
+    return Pack::select(large, Pack::add(asin, asin),
+                        Pack::sub(Pack::set1(pi * 0.5f), asin));
+}
+
+// sin(x) for x in [0, pi / 2]. Above pi / 4, that's cos(pi / 2 - x), which
+// converges faster there.
+Reg sin_lanes(Reg const x) {
+    Mask const upper = Pack::lt(Pack::set1(pi * 0.25f), x);
+    Reg const y = Pack::select(upper, Pack::sub(Pack::set1(pi * 0.5f), x), x);
+    Reg const z = Pack::mul(y, y);
+
+    Reg s = Pack::set1(-1.9515295891e-4f);
+    s = Pack::add(Pack::mul(s, z), Pack::set1(8.3321608736e-3f));
+    s = Pack::add(Pack::mul(s, z), Pack::set1(-1.6666654611e-1f));
+    s = Pack::add(Pack::mul(Pack::mul(s, z), y), y);
+
+    Reg c = Pack::set1(2.443315711809948e-5f);
+    c = Pack::add(Pack::mul(c, z), Pack::set1(-1.388731625493765e-3f));
+    c = Pack::add(Pack::mul(c, z), Pack::set1(4.166664568298827e-2f));
+    c = Pack::sub(Pack::mul(Pack::mul(c, z), z),
+                  Pack::mul(Pack::set1(0.5f), z));
+    c = Pack::add(c, Pack::set1(1.0f));
+
+    return Pack::select(upper, c, s);
+}
+
+// Mirrors the scalar slerp(), with the approximations above standing in for
+// std::acos() and std::sin()
+Lanes<4> slerp_lanes(Lanes<4> const &a, Lanes<4> const &b, float const t) {
+    Reg const one = Pack::set1(1.0f);
+
+    Reg const dot = dot_lanes(a, b);
+    Mask const flip = Pack::lt(dot, Pack::set1(0.0f));
+    Reg const cos_theta = Pack::abs(dot);
+    Reg const sign = Pack::select(flip, Pack::set1(-1.0f), one);
+
+    Reg const theta = acos_lanes(cos_theta);
+    Reg const sin_recip = Pack::div(one, sin_lanes(theta));
+
+    Reg const weight_a = Pack::mul(
+        sin_lanes(Pack::mul(Pack::set1(1.0f - t), theta)), sin_recip
+    );
+    Reg const weight_b = Pack::mul(
+        Pack::mul(sin_lanes(Pack::mul(Pack::set1(t), theta)), sin_recip),
+        sign
+    );
+
+    Lanes<4> result = blend_lanes(a, b, weight_a, weight_b);
+
+    // Pairs too close together for the angle to mean much take nlerp()
+    // instead, which also replaces the inf and NaN they produced above
+    Mask const close = Pack::lt(Pack::set1(1.0f - epsilon), cos_theta);
+    if(Pack::bits(close) != 0u) {
+        Lanes<4> const fallback = nlerp_lanes(a, b, t);
+        for(std::size_t c = 0u; c < 4u; ++c) {
+            result[c] = Pack::select(close, fallback[c], result[c]);
+        }
+    }
+
+    return result;
+}
+
+void rotate_each(Quat const &q, Vec3 const *v, Vec3 *out,
+                 std::size_t const count)
+{
+    auto const q_lanes = splat_lanes(q);
+
+    for_each_block(count, out,
+        [&q_lanes](Vec3 *o, Vec3 const *v_block) {
+            store_lanes(rotate_lanes(q_lanes, load_lanes(v_block)), o);
+        },
+        v
+    );
+}
+
+void nlerp_each(Quat const *a, Quat const *b, float const t, Quat *out,
+                std::size_t const count)
+{
+    for_each_block(count, out,
+        [t](Quat *o, Quat const *a_block, Quat const *b_block) {
+            store_lanes(nlerp_lanes(load_lanes(a_block),
+                                    load_lanes(b_block), t), o);
+        },
+        a, b
+    );
+}
+
+void slerp_each(Quat const *a, Quat const *b, float const t, Quat *out,
+                std::size_t const count)
+{
+    for_each_block(count, out,
+        [t](Quat *o, Quat const *a_block, Quat const *b_block) {
+            store_lanes(slerp_lanes(load_lanes(a_block),
+                                    load_lanes(b_block), t), o);
+        },
+        a, b
+    );
+}
+
+// =============================================================================
+// Vision cones. A target at offset d from the apex is inside when
+// dot(f, d) >= cos(half_fov) * |f| * |d|. Rather than normalizing every d,
+// the kernels square both sides, which only works when both sides have the
+// same sign, so the signs are checked separately.
+
+struct Cone {
+    Lanes<3> apex;
+    Lanes<3> forward;
+    Reg      bound;     // cos^2(half_fov) * |f|^2
+    bool     wide;      // Half angle over 90 degrees, where cos is negative
+};
+
+Cone splat_cone(Vec3 const &position, Vec3 const &forward,
+                float const cos_half_fov)
+{
+    return {
+        splat_lanes(position),
+        splat_lanes(forward),
+        Pack::set1(cos_half_fov * cos_half_fov * dot(forward, forward)),
+        cos_half_fov < 0.0f,
+    };
+}
+
+uint32_t constexpr all_lanes = (1u << width) - 1u;
+
+// One bit per target in the block, set when it's inside the cone
+uint32_t cone_lanes(Cone const &cone, Vec3 const *block) {
+    Lanes<3> d = load_lanes(block);
+    for(std::size_t c = 0u; c < 3u; ++c) {
+        d[c] = Pack::sub(d[c], cone.apex[c]);
+    }
+
+    Reg const along = dot_lanes(cone.forward, d);
+    Reg const along_sq = Pack::mul(along, along);
+    Reg const bound = Pack::mul(cone.bound, dot_lanes(d, d));
+
+    uint32_t const behind = Pack::bits(Pack::lt(along, Pack::set1(0.0f)));
+
+    // The same every block, so this branch always predicts correctly
+    if(cone.wide) {
+        // Everything in front, plus anything behind that's within the bound
+        return ~(behind & Pack::bits(Pack::lt(bound, along_sq))) & all_lanes;
+    }
+
+    return ~(behind | Pack::bits(Pack::lt(along_sq, bound))) & all_lanes;
+}
+
+// The lanes of the last, partial block that hold real targets
+uint32_t tail_lanes(std::size_t const remaining) {
+    return (1u << remaining) - 1u;
+}
+
+std::size_t cone_indices(Vec3 const &position, Vec3 const &forward,
+                         float const cos_half_fov, Vec3 const *targets,
+                         uint32_t *out, std::size_t const count)
+{
+    Cone const cone = splat_cone(position, forward, cos_half_fov);
+
+    // A whole block's worth of indices always fits, since the count so far
+    // can't be more than the index of the block's first target
+    std::size_t visible = 0u;
+    std::size_t i = 0u;
+    for(; i + width <= count; i += width) {
+        visible += Pack::left_pack(out + visible, static_cast<uint32_t>(i),
+                                   cone_lanes(cone, targets + i));
+    }
+
+    if(i < count) {
+        uint32_t const lanes = cone_lanes(cone, padded(targets + i,
+                                                       count - i).data())
+                             & tail_lanes(count - i);
+
+        std::array<uint32_t, width> packed;
+        std::size_t const tail = Pack::left_pack(
+            packed.data(), static_cast<uint32_t>(i), lanes
+        );
+        std::copy_n(packed.begin(), tail, out + visible);
+        visible += tail;
+    }
+
+    return visible;
+}
+
+// Like for_each_block(), but for kernels that produce one bit per element:
+// block() returns the bits for its elements, which are gathered into mask,
+// 64 to a word. Bits past count are cleared.
+template <typename Block, typename... In>
+void for_each_mask_block(std::size_t const count, uint64_t *mask,
+                         Block block, In const *...in)
+{
+    std::fill_n(mask, (count + 63u) / 64u, uint64_t { 0u });
+
+    // width divides 64, so a block's bits never straddle two words
+    std::size_t i = 0u;
+    for(; i + width <= count; i += width) {
+        mask[i / 64u] |= uint64_t { block((in + i)...) } << (i % 64u);
+    }
+
+    if(i < count) {
+        uint32_t const lanes = block(padded(in + i, count - i).data()...)
+                             & tail_lanes(count - i);
+        mask[i / 64u] |= uint64_t { lanes } << (i % 64u);
+    }
+}
+
+void cone_mask(Vec3 const &position, Vec3 const &forward,
+               float const cos_half_fov, Vec3 const *targets,
+               uint64_t *mask, std::size_t const count)
+{
+    Cone const cone = splat_cone(position, forward, cos_half_fov);
+
+    for_each_mask_block(count, mask,
+        [&cone](Vec3 const *block) { return cone_lanes(cone, block); },
+        targets
+    );
+}
+
+// =============================================================================
+// Approximate equality
+
+Lanes<1> load_lanes(float const *f) {
+    return { { Pack::load(f) } };
+}
+
+// Every component of a and b within tolerance, one bit per element
+template <std::size_t N>
+uint32_t equal_lanes(Lanes<N> const &a, Lanes<N> const &b,
+                     Tolerance const &tolerance)
+{
+    if(tolerance.mode == Tolerance::Mode::absolute) {
+        Reg const max = Pack::set1(tolerance.max_difference);
+
+        Mask equal = Pack::lt(Pack::abs(Pack::sub(a[0], b[0])), max);
+        for(std::size_t c = 1u; c < N; ++c) {
+            equal = Pack::mask_and(equal,
+                Pack::lt(Pack::abs(Pack::sub(a[c], b[c])), max));
+        }
+        return Pack::bits(equal);
+    }
+
+    Mask equal = Pack::within_ulps(a[0], b[0], tolerance.max_ulps);
+    for(std::size_t c = 1u; c < N; ++c) {
+        equal = Pack::mask_and(equal,
+            Pack::within_ulps(a[c], b[c], tolerance.max_ulps));
+    }
+    return Pack::bits(equal);
+}
+
+template <typename T>
+void equal_each(T const *a, T const *b, Tolerance const &tolerance,
+                uint64_t *mask, std::size_t const count)
+{
+    for_each_mask_block(count, mask,
+        [&tolerance](T const *a_block, T const *b_block) {
+            return equal_lanes(load_lanes(a_block), load_lanes(b_block),
+                               tolerance);
+        },
+        a, b
+    );
+}
+
+// =============================================================================
+// Packed storage
+
+void to_half_each(float const *f, uint16_t *out, std::size_t const count) {
+    for_each_block(count, out,
+        [](uint16_t *o, float const *block) {
+            Pack::to_half(o, Pack::load(block));
+        },
+        f
+    );
+}
+
+void from_half_each(uint16_t const *h, float *out, std::size_t const count) {
+    for_each_block(count, out,
+        [](float *o, uint16_t const *block) {
+            Pack::store(o, Pack::from_half(block));
+        },
+        h
+    );
+}
+
+// A block of Vec3s is three registers' worth of floats, x y z x y z and so on,
+// and quantizing never mixes components, so there's no need to deinterleave
+// them. Instead, the per-axis constants are laid out in that same pattern.
+Lanes<3> repeat_lanes(Vec3 const &v) {
+    std::array<float, width * 3u> pattern;
+    for(std::size_t i = 0u; i < pattern.size(); ++i) {
+        pattern[i] = v[static_cast<uint8_t>(i % 3u)];
+    }
+
+    return { {
+        Pack::load(pattern.data()),
+        Pack::load(pattern.data() + width),
+        Pack::load(pattern.data() + width * 2u),
+    } };
+}
+
+// The same steps as the scalar quantize(), with scale = 65535 / extent
+void quantize_each(Vec3 const *v, Vec3 const &min, Vec3 const &scale,
+                   Q16Vec3 *out, std::size_t const count)
+{
+    Lanes<3> const mins = repeat_lanes(min);
+    Lanes<3> const scales = repeat_lanes(scale);
+
+    for_each_block(count, out,
+        [&mins, &scales](Q16Vec3 *o, Vec3 const *block) {
+            Reg const zero = Pack::set1(0.0f);
+            Reg const top  = Pack::set1(65535.0f);
+
+            auto const *data = reinterpret_cast<float const *>(block);
+            auto *q = reinterpret_cast<uint16_t *>(o);
+
+            for(std::size_t r = 0u; r < 3u; ++r) {
+                Reg steps = Pack::mul(
+                    Pack::sub(Pack::load(data + r * width), mins[r]),
+                    scales[r]
+                );
+                steps = Pack::select(Pack::lt(steps, zero), zero, steps);
+                steps = Pack::select(Pack::lt(top, steps), top, steps);
+
+                Pack::to_ints(q + r * width,
+                             Pack::add(steps, Pack::set1(0.5f)));
+            }
+        },
+        v
+    );
+}
+
+// And the scalar dequantize(), with step = extent / 65535
+void dequantize_each(Q16Vec3 const *q, Vec3 const &min, Vec3 const &step,
+                     Vec3 *out, std::size_t const count)
+{
+    Lanes<3> const mins = repeat_lanes(min);
+    Lanes<3> const steps = repeat_lanes(step);
+
+    for_each_block(count, out,
+        [&mins, &steps](Vec3 *o, Q16Vec3 const *block) {
+            auto const *data = reinterpret_cast<uint16_t const *>(block);
+            auto *v = reinterpret_cast<float *>(o);
+
+            for(std::size_t r = 0u; r < 3u; ++r) {
+                Pack::store(v + r * width, Pack::add(mins[r], Pack::mul(
+                    Pack::from_ints(data + r * width), steps[r])));
+            }
+        },
+        q
+    );
+}
+
+// Octahedral normals, in the same steps as to_oct() and from_oct() in
+// packed-inl.hpp
+template <typename Oct>
+void to_oct_each(Vec3 const *n, Oct *out, std::size_t const count) {
+    using Int = decltype(Oct::x);
+    float constexpr scale = std::numeric_limits<Int>::max();
+
+    for_each_block(count, out,
+        [](Oct *o, Vec3 const *block) {
+            Reg const zero = Pack::set1(0.0f);
+            Reg const one  = Pack::set1(1.0f);
+            Reg const smallest = Pack::set1(std::numeric_limits<float>::min());
+
+            auto const lanes = load_lanes(block);
+            Reg length = Pack::add(
+                Pack::add(Pack::abs(lanes[0]), Pack::abs(lanes[1])),
+                Pack::abs(lanes[2])
+            );
+            length = Pack::select(Pack::lt(length, smallest), smallest,
+                                  length);
+
+            Reg const inverse = Pack::div(one, length);
+            Reg x = Pack::mul(lanes[0], inverse);
+            Reg y = Pack::mul(lanes[1], inverse);
+
+            auto const sign = [&](Reg const r) {
+                return Pack::select(Pack::lt(r, zero), Pack::set1(-1.0f),
+                                    one);
+            };
+            Reg const folded_x = Pack::mul(Pack::sub(one, Pack::abs(y)),
+                                           sign(x));
+            Reg const folded_y = Pack::mul(Pack::sub(one, Pack::abs(x)),
+                                           sign(y));
+
+            Mask const lower = Pack::lt(lanes[2], zero);
+            x = Pack::select(lower, folded_x, x);
+            y = Pack::select(lower, folded_y, y);
+
+            auto const round = [&](Reg const r) {
+                return Pack::add(Pack::mul(r, Pack::set1(scale)),
+                    Pack::select(Pack::lt(r, zero), Pack::set1(-0.5f),
+                                 Pack::set1(0.5f)));
+            };
+
+            x = round(x);
+            y = round(y);
+
+            auto *ints = reinterpret_cast<Int *>(o);
+            Pack::to_ints(ints,         Pack::zip_first(x, y));
+            Pack::to_ints(ints + width, Pack::zip_second(x, y));
+        },
+        n
+    );
+}
+
+template <typename Oct>
+void from_oct_each(Oct const *o, Vec3 *out, std::size_t const count) {
+    using Int = decltype(Oct::x);
+    float constexpr scale = std::numeric_limits<Int>::max();
+
+    for_each_block(count, out,
+        [](Vec3 *v, Oct const *block) {
+            Reg const zero = Pack::set1(0.0f);
+            Reg const one  = Pack::set1(1.0f);
+            Reg const minus_one = Pack::set1(-1.0f);
+
+            auto const *ints = reinterpret_cast<Int const *>(block);
+            Reg const p = Pack::from_ints(ints);
+            Reg const q = Pack::from_ints(ints + width);
+
+            Reg x = Pack::mul(Pack::unzip_even(p, q), Pack::set1(1.0f / scale));
+            Reg y = Pack::mul(Pack::unzip_odd(p, q),  Pack::set1(1.0f / scale));
+            x = Pack::select(Pack::lt(x, minus_one), minus_one, x);
+            y = Pack::select(Pack::lt(y, minus_one), minus_one, y);
+
+            Reg const z = Pack::sub(Pack::sub(one, Pack::abs(x)),
+                                    Pack::abs(y));
+            Reg const t = Pack::select(Pack::lt(z, zero), Pack::sub(zero, z),
+                                       zero);
+            x = Pack::select(Pack::lt(x, zero), Pack::add(x, t),
+                             Pack::sub(x, t));
+            y = Pack::select(Pack::lt(y, zero), Pack::add(y, t),
+                             Pack::sub(y, t));
+
+            Lanes<3> lanes { { x, y, z } };
+            Reg const inverse = Pack::div(one,
+                                          Pack::sqrt(dot_lanes(lanes, lanes)));
+            for(auto &lane : lanes.regs) {
+                lane = Pack::mul(lane, inverse);
+            }
+
+            store_lanes(lanes, v);
+        },
+        o
+    );
+}
+
+// =============================================================================
+// Component lanes. Counts here are always a multiple of 16, and so of width.
+
+void lanes_add(float const *a, float const *b, float *out,
+               std::size_t const count)
+{
+    for(std::size_t i = 0u; i < count; i += width) {
+        Pack::store(out + i, Pack::add(Pack::load(a + i), Pack::load(b + i)));
+    }
+}
+
+void lanes_sub(float const *a, float const *b, float *out,
+               std::size_t const count)
+{
+    for(std::size_t i = 0u; i < count; i += width) {
+        Pack::store(out + i, Pack::sub(Pack::load(a + i), Pack::load(b + i)));
+    }
+}
+
+void lanes_scale(float const *a, float const scalar, float *out,
+                 std::size_t const count)
+{
+    Reg const s = Pack::set1(scalar);
+    for(std::size_t i = 0u; i < count; i += width) {
+        Pack::store(out + i, Pack::mul(Pack::load(a + i), s));
+    }
+}
+
+// The one lane kernel with an arbitrary count, since out only has room for
+// the vectors themselves. The lanes are still padded, so reading a whole
+// register past count is fine, and only the writes need trimming.
+void lanes_dot(float const *a, float const *b, std::size_t const stride,
+               std::size_t const components, float *out,
+               std::size_t const count)
+{
+    auto const dot_at = [=](std::size_t const i) {
+        Reg sum = Pack::mul(Pack::load(a + i), Pack::load(b + i));
+        for(std::size_t c = 1u; c < components; ++c) {
+            std::size_t const j = c * stride + i;
+            sum = mul_add(Pack::load(a + j), Pack::load(b + j), sum);
+        }
+        return sum;
+    };
+
+    std::size_t i = 0u;
+    for(; i + width <= count; i += width) {
+        Pack::store(out + i, dot_at(i));
+    }
+
+    if(i < count) {
+        std::array<float, width> tail;
+        Pack::store(tail.data(), dot_at(i));
+        std::copy_n(tail.begin(), count - i, out + i);
+    }
+}
+
+// Every load for a block happens before any of its stores, so out may be the
+// same array as a or b
+void lanes_cross(float const *a, float const *b, float *out,
+                 std::size_t const stride)
+{
+    for(std::size_t i = 0u; i < stride; i += width) {
+        Lanes<3> a_lanes;
+        Lanes<3> b_lanes;
+        for(std::size_t c = 0u; c < 3u; ++c) {
+            a_lanes[c] = Pack::load(a + c * stride + i);
+            b_lanes[c] = Pack::load(b + c * stride + i);
+        }
+
+        auto const result = cross_lanes(a_lanes, b_lanes);
+        for(std::size_t c = 0u; c < 3u; ++c) {
+            Pack::store(out + c * stride + i, result[c]);
+        }
+    }
+}
+
+// Mirrors the scalar normalize(): the zero vector and vectors that are
+// already unit length pass through untouched
+template <std::size_t N>
+void lanes_normalize(float const *a, float *out, std::size_t const stride,
+                     std::size_t const count)
+{
+    Reg const one = Pack::set1(1.0f);
+    Reg const eps = Pack::set1(epsilon);
+
+    for(std::size_t i = 0u; i < count; i += width) {
+        Lanes<N> lanes;
+        for(std::size_t c = 0u; c < N; ++c) {
+            lanes[c] = Pack::load(a + c * stride + i);
+        }
+
+        Reg const length_sq = dot_lanes(lanes, lanes);
+        Mask const skip = Pack::mask_or(
+            Pack::lt(length_sq, eps),
+            Pack::lt(Pack::abs(Pack::sub(length_sq, one)), eps)
+        );
+
+        lanes = scale_lanes<Accuracy::exact>(lanes, length_sq, skip);
+        for(std::size_t c = 0u; c < N; ++c) {
+            Pack::store(out + c * stride + i, lanes[c]);
+        }
+    }
+}
+
+void lanes_normalize(float const *a, float *out, std::size_t const stride,
+                     std::size_t const components, std::size_t const count)
+{
+    switch(components) {
+        case 2u: lanes_normalize<2u>(a, out, stride, count); break;
+        case 3u: lanes_normalize<3u>(a, out, stride, count); break;
+        case 4u: lanes_normalize<4u>(a, out, stride, count); break;
+        default: assert(false); break;
+    }
+}
+
+// =============================================================================
+// Skinning, over component lanes
+
+// Hints that p will be read soon. Only a hint, so it's fine for it to do
+// nothing where there's no way to give it.
+void prefetch(void const *p) {
+#if defined(__GNUC__)
+    __builtin_prefetch(p);
+#else
+    static_cast<void>(p);
+#endif
+}
+
+// The palette entry for influence k of vertex i, or the first one for the
+// padding past the last vertex, where the weights are all zero anyway
+Mat4 const & bone_matrix(SkinLanes const &skin, std::size_t const i,
+                         std::size_t const k)
+{
+    return skin.palette[i < skin.count ? skin.bones[i][k] : 0u];
+}
+
+// Starts pulling in every bone a block of vertices uses, first to last line
+void prefetch_bones(SkinLanes const &skin, std::size_t const first) {
+    std::size_t const last = std::min(first + width, skin.count);
+    for(std::size_t i = first; i < last; ++i) {
+        for(std::size_t k = 0u; k < 4u; ++k) {
+            Mat4 const &bone = skin.palette[skin.bones[i][k]];
+            prefetch(&bone.x);
+            prefetch(&bone.w);
+        }
+    }
+}
+
+// The weighted sum of each vertex's bone matrices, the same sums in the same
+// order as blend_bones(). Only the top three rows, since that's all the
+// vertices need. Each bone's columns are loaded straight from the palette a
+// chunk at a time, and transposed into lanes the way load_lanes() does for
+// an array of Vec4s.
+MatLanes blend_lanes(SkinLanes const &skin, std::size_t const i) {
+    Reg const zero = Pack::set1(0.0f);
+
+    MatLanes blended;
+    for(auto &column : blended.columns) {
+        for(auto &row : column.regs) {
+            row = zero;
+        }
+    }
+
+    for(std::size_t k = 0u; k < 4u; ++k) {
+        Reg const weight = Pack::load(skin.weights + k * skin.stride + i);
+
+        // Most vertices only need one or two bones, so whole blocks can
+        // often skip the last few
+        Mask const used = Pack::mask_or(Pack::lt(weight, zero),
+                                        Pack::lt(zero, weight));
+        if(Pack::bits(used) == 0u) {
+            continue;
+        }
+
+        Mat4 const *bones[width];
+        for(std::size_t j = 0u; j < width; ++j) {
+            bones[j] = &bone_matrix(skin, i + j, k);
+        }
+
+        for(uint8_t c = 0u; c < 4u; ++c) {
+            // Register r holds vertex r of each chunk, like load_lanes()
+            Lanes<4> column;
+            for(std::size_t r = 0u; r < 4u; ++r) {
+                float const *chunks[width / 4u];
+                for(std::size_t chunk = 0u; chunk < width / 4u; ++chunk) {
+                    chunks[chunk] = &(*bones[chunk * 4u + r])[c].x;
+                }
+                column[r] = Pack::gather_chunks(chunks);
+            }
+            transpose(column[0], column[1], column[2], column[3]);
+
+            for(std::size_t row = 0u; row < 3u; ++row) {
+                blended.columns[c][row] = Pack::add(
+                    blended.columns[c][row], Pack::mul(column[row], weight)
+                );
+            }
+        }
+    }
+
+    return blended;
+}
+
+// Each output is stored after the input it replaces is loaded, so they may
+// be the same arrays
+void lanes_skin(SkinLanes const &skin, std::size_t const begin,
+                std::size_t const end)
+{
+    Reg const one = Pack::set1(1.0f);
+    Reg const eps = Pack::set1(epsilon);
+
+    auto const load3 = [&skin](float const *lanes, std::size_t const i) {
+        Lanes<3> result;
+        for(std::size_t c = 0u; c < 3u; ++c) {
+            result[c] = Pack::load(lanes + c * skin.stride + i);
+        }
+        return result;
+    };
+
+    auto const store3 = [&skin](Lanes<3> const &lanes, float *out,
+                                std::size_t const i)
+    {
+        for(std::size_t c = 0u; c < 3u; ++c) {
+            Pack::store(out + c * skin.stride + i, lanes[c]);
+        }
+    };
+
+    if(begin < skin.count) {
+        prefetch_bones(skin, begin);
+    }
+
+    for(std::size_t i = begin; i < end; i += width) {
+        if(i + width < skin.count) {
+            prefetch_bones(skin, i + width);
+        }
+
+        MatLanes const m = blend_lanes(skin, i);
+
+        store3(transform_lanes(m, load3(skin.positions, i), true),
+               skin.out_positions, i);
+
+        if(skin.normals == nullptr) {
+            continue;
+        }
+
+        // Then normalized just like the scalar normalize()
+        Lanes<3> const normals =
+            transform_lanes(m, load3(skin.normals, i), false);
+        Reg const length_sq = dot_lanes(normals, normals);
+        Mask const skip = Pack::mask_or(
+            Pack::lt(length_sq, eps),
+            Pack::lt(Pack::abs(Pack::sub(length_sq, one)), eps)
+        );
+
+        store3(scale_lanes<Accuracy::exact>(normals, length_sq, skip),
+               skin.out_normals, i);
+    }
+}
+
+} // namespace
+
+Table const level_table {
+    .dot2 = dot_each<Vec2>,
+    .dot3 = dot_each<Vec3>,
+    .dot4 = dot_each<Vec4>,
+
+    .dot2_one = dot_one<Vec2>,
+    .dot3_one = dot_one<Vec3>,
+    .dot4_one = dot_one<Vec4>,
+
+    .cross3 = cross_each,
+
+    .normalize2 = normalize_each<Vec2>,
+    .normalize3 = normalize_each<Vec3>,
+    .normalize4 = normalize_each<Vec4>,
+
+    .transform4       = transform_each,
+    .transform_points = transform_points_each,
+
+    .rotate3 = rotate_each,
+    .nlerp   = nlerp_each,
+    .slerp   = slerp_each,
+
+    .cone_indices = cone_indices,
+    .cone_mask    = cone_mask,
+
+    .equal1 = equal_each<float>,
+    .equal2 = equal_each<Vec2>,
+    .equal3 = equal_each<Vec3>,
+    .equal4 = equal_each<Vec4>,
+
+    .to_half     = to_half_each,
+    .from_half   = from_half_each,
+    .quantize3   = quantize_each,
+    .dequantize3 = dequantize_each,
+    .to_oct16    = to_oct_each<Oct16>,
+    .to_oct8     = to_oct_each<Oct8>,
+    .from_oct16  = from_oct_each<Oct16>,
+    .from_oct8   = from_oct_each<Oct8>,
+
+    .lanes_add       = lanes_add,
+    .lanes_sub       = lanes_sub,
+    .lanes_scale     = lanes_scale,
+    .lanes_dot       = lanes_dot,
+    .lanes_cross     = lanes_cross,
+    .lanes_normalize = lanes_normalize,
+    .lanes_skin      = lanes_skin,
+};
+
+} // namespace btx::math::kernels::BTX_KERNEL_NAMESPACE
\ No newline at end of file
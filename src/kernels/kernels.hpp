@@ -0,0 +1,189 @@
+#ifndef BRASSTACKS_MATH_SRC_KERNELS_KERNELS_HPP
+#define BRASSTACKS_MATH_SRC_KERNELS_KERNELS_HPP
+
+#include "brasstacks/math/math.hpp"
+#include "brasstacks/math/batch.hpp"
+#include "brasstacks/math/dispatch.hpp"
+#include "brasstacks/math/packed.hpp"
+#include "brasstacks/math/simd.hpp"
+#include "brasstacks/math/skinning.hpp"
+
+#include <bit>
+#include <cstring>
+#include <functional>
+
+// The kernels are written once, in kernels-inl.hpp, and compiled once per
+// instruction set level by the .cpp files in this directory. Rather than
+// per-file compiler flags, each of those wraps its includes in a target
+// pragma. That way only the kernels themselves use the wider instructions,
+// and any inline function from another header keeps the baseline encoding,
+// so the linker can't pick an AVX copy of it for code running on a CPU that
+// doesn't have AVX.
+//
+// Values for BTX_KERNEL_LEVEL, which each per-level translation unit defines
+// before including pack.hpp and kernels-inl.hpp
+#define BTX_KERNEL_LEVEL_SCALAR 0
+#define BTX_KERNEL_LEVEL_SSE2   1
+#define BTX_KERNEL_LEVEL_SSE41  2
+#define BTX_KERNEL_LEVEL_AVX2   3
+#define BTX_KERNEL_LEVEL_AVX512 4
+
+namespace btx::math::kernels {
+
+// The arrays behind one skin() call, see skinning.hpp. The float arrays are
+// VecArray lanes, all `stride` floats apart. bones only has `count` entries,
+// and normals and out_normals are null when only skinning positions.
+struct SkinLanes {
+    Mat4 const        *palette;
+    BoneIndices const *bones;
+    std::size_t        count;
+
+    float const *weights;
+    float const *positions;
+    float const *normals;
+    float       *out_positions;
+    float       *out_normals;
+    std::size_t  stride;
+};
+
+// Checks that the arrays for a skin() call line up and that every bone is in
+// the palette, and collects them
+inline SkinLanes skin_lanes(std::span<Mat4 const> const palette,
+                            std::span<BoneIndices const> const bones,
+                            Vec4Array const &weights,
+                            Vec3Array const &positions,
+                            Vec3Array const *normals,
+                            Vec3Array &out_positions,
+                            Vec3Array *out_normals)
+{
+    assert(bones.size() == weights.size());
+    assert(bones.size() == positions.size());
+    assert(bones.size() == out_positions.size());
+    assert((normals == nullptr) == (out_normals == nullptr));
+    assert(normals == nullptr || bones.size() == normals->size());
+    assert(normals == nullptr || bones.size() == out_normals->size());
+
+    // The kernels gather from the palette without checking, so every index
+    // has to be inside it, as blend_bones() asserts for its four
+    assert(std::ranges::all_of(bones, [palette](BoneIndices const &indices) {
+        return std::ranges::all_of(indices, [palette](uint16_t const bone) {
+            return bone < palette.size();
+        });
+    }));
+
+    return {
+        .palette       = palette.data(),
+        .bones         = bones.data(),
+        .count         = bones.size(),
+        .weights       = weights.lane(0u),
+        .positions     = positions.lane(0u),
+        .normals       = normals ? normals->lane(0u) : nullptr,
+        .out_positions = out_positions.lane(0u),
+        .out_normals   = out_normals ? out_normals->lane(0u) : nullptr,
+        .stride        = positions.stride(),
+    };
+}
+
+// One entry per bulk operation. Every instruction set level fills in its own
+// copy of this table, and the public functions call through whichever one
+// dispatch.cpp selected.
+struct Table {
+    // Arrays of vectors, see batch.hpp
+    void (*dot2)(Vec2 const *a, Vec2 const *b, float *out, std::size_t count);
+    void (*dot3)(Vec3 const *a, Vec3 const *b, float *out, std::size_t count);
+    void (*dot4)(Vec4 const *a, Vec4 const *b, float *out, std::size_t count);
+
+    void (*dot2_one)(Vec2 const &a, Vec2 const *b, float *out,
+                     std::size_t count);
+    void (*dot3_one)(Vec3 const &a, Vec3 const *b, float *out,
+                     std::size_t count);
+    void (*dot4_one)(Vec4 const &a, Vec4 const *b, float *out,
+                     std::size_t count);
+
+    void (*cross3)(Vec3 const *a, Vec3 const *b, Vec3 *out, std::size_t count);
+
+    void (*normalize2)(Vec2 const *v, Vec2 *out, std::size_t count,
+                       Accuracy accuracy);
+    void (*normalize3)(Vec3 const *v, Vec3 *out, std::size_t count,
+                       Accuracy accuracy);
+    void (*normalize4)(Vec4 const *v, Vec4 *out, std::size_t count,
+                       Accuracy accuracy);
+
+    void (*transform4)(Mat4 const &m, Vec4 const *v, Vec4 *out,
+                       std::size_t count);
+    void (*transform_points)(Mat4 const &m, Vec3 const *v, Vec3 *out,
+                             std::size_t count);
+
+    void (*rotate3)(Quat const &q, Vec3 const *v, Vec3 *out,
+                    std::size_t count);
+    void (*nlerp)(Quat const *a, Quat const *b, float t, Quat *out,
+                  std::size_t count);
+    void (*slerp)(Quat const *a, Quat const *b, float t, Quat *out,
+                  std::size_t count);
+
+    // Vision cones, see batch.hpp
+    std::size_t (*cone_indices)(Vec3 const &position, Vec3 const &forward,
+                                float cos_half_fov, Vec3 const *targets,
+                                uint32_t *out, std::size_t count);
+    void (*cone_mask)(Vec3 const &position, Vec3 const &forward,
+                      float cos_half_fov, Vec3 const *targets,
+                      uint64_t *mask, std::size_t count);
+
+    // Approximate equality, see batch.hpp
+    void (*equal1)(float const *a, float const *b, Tolerance const &tolerance,
+                   uint64_t *mask, std::size_t count);
+    void (*equal2)(Vec2 const *a, Vec2 const *b, Tolerance const &tolerance,
+                   uint64_t *mask, std::size_t count);
+    void (*equal3)(Vec3 const *a, Vec3 const *b, Tolerance const &tolerance,
+                   uint64_t *mask, std::size_t count);
+    void (*equal4)(Vec4 const *a, Vec4 const *b, Tolerance const &tolerance,
+                   uint64_t *mask, std::size_t count);
+
+    // Packed storage, see packed.hpp. The half conversions work on runs of
+    // floats, whatever vectors they came from.
+    void (*to_half)(float const *f, uint16_t *out, std::size_t count);
+    void (*from_half)(uint16_t const *h, float *out, std::size_t count);
+    void (*quantize3)(Vec3 const *v, Vec3 const &min, Vec3 const &scale,
+                      Q16Vec3 *out, std::size_t count);
+    void (*dequantize3)(Q16Vec3 const *q, Vec3 const &min, Vec3 const &step,
+                        Vec3 *out, std::size_t count);
+    void (*to_oct16)(Vec3 const *n, Oct16 *out, std::size_t count);
+    void (*to_oct8)(Vec3 const *n, Oct8 *out, std::size_t count);
+    void (*from_oct16)(Oct16 const *o, Vec3 *out, std::size_t count);
+    void (*from_oct8)(Oct8 const *o, Vec3 *out, std::size_t count);
+
+    // Component lanes, see VecArray.hpp. Lanes are `stride` floats apart, and
+    // stride is always a multiple of 16, so these never need a scalar tail.
+    void (*lanes_add)(float const *a, float const *b, float *out,
+                      std::size_t count);
+    void (*lanes_sub)(float const *a, float const *b, float *out,
+                      std::size_t count);
+    void (*lanes_scale)(float const *a, float scalar, float *out,
+                        std::size_t count);
+    void (*lanes_dot)(float const *a, float const *b, std::size_t stride,
+                      std::size_t components, float *out, std::size_t count);
+    void (*lanes_cross)(float const *a, float const *b, float *out,
+                        std::size_t stride);
+    // Only the first count elements of each lane, a multiple of 16
+    void (*lanes_normalize)(float const *a, float *out, std::size_t stride,
+                            std::size_t components, std::size_t count);
+
+    // Vertices begin to end of the lanes, both multiples of 16
+    void (*lanes_skin)(SkinLanes const &skin, std::size_t begin,
+                       std::size_t end);
+};
+
+// The table for the currently selected level
+[[nodiscard]] Table const & table();
+
+// The tables for each level. On non-x86 targets only the scalar one exists,
+// and the others return nullptr.
+[[nodiscard]] Table const * scalar_table();
+[[nodiscard]] Table const * sse2_table();
+[[nodiscard]] Table const * sse41_table();
+[[nodiscard]] Table const * avx2_table();
+[[nodiscard]] Table const * avx512_table();
+
+} // namespace btx::math::kernels
+
+#endif // BRASSTACKS_MATH_SRC_KERNELS_KERNELS_HPP
\ No newline at end of file
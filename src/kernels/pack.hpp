@@ -0,0 +1,816 @@
+// Included once by each of the per-level kernel translation units, after they
+// define BTX_KERNEL_LEVEL and BTX_KERNEL_NAMESPACE. There's no include guard
+// on purpose: every level gets its own Pack in its own namespace, so the
+// differently compiled copies never collide at link time.
+//
+// A Pack is a SIMD register of `width` floats, treated as `width / 4`
+// independent 128-bit chunks. Shuffles act on each chunk separately, just
+// like the AVX and AVX-512 instructions do, which lets one set of kernels
+// work at every register width.
+//
+// Every Pack also has left_pack(), which takes one bit per lane, and writes
+// `first + i` for each lane i whose bit is set to the front of out, in order.
+// It returns how many it wrote, but may store up to `width` indices, so out
+// always needs room for a whole register's worth.
+//
+// within_ulps() sets the lanes where a and b are at most max_ulps
+// representable floats apart, counting 0 and -0 as the same float and NaN as
+// never within anything. Each float's bits are first mapped to an integer
+// that orders the same way the floats do, so the distance is a subtraction.
+// max_ulps must be well short of 2^31 for that not to wrap.
+//
+// zip_first() and zip_second() interleave a and b across a whole register,
+// a0 b0 a1 b1 and so on, rather than within each chunk the way unpacklo()
+// and unpackhi() do. unzip_even() and unzip_odd() take the result apart
+// again.
+//
+// gather_chunks() is load_chunks() with a pointer per chunk rather than a
+// stride, for chunks scattered through memory.
+//
+// fma() is a * b + c in every lane, rounded once. Levels without the
+// instruction fall back to std::fma() a lane at a time, which is slow but
+// gives the same bits.
+//
+// to_half() and from_half() convert a register to and from `width` IEEE half
+// floats, rounding to nearest even exactly like the scalar functions in
+// packed.hpp. to_ints() and from_ints() do the same for 16-bit unsigned and
+// 16- and 8-bit signed integers. to_ints() truncates, and is only defined
+// for lanes already in range for the integer type.
+
+namespace btx::math::kernels::BTX_KERNEL_NAMESPACE {
+
+#if BTX_KERNEL_LEVEL == BTX_KERNEL_LEVEL_SCALAR
+
+// Portable stand-in for a 128-bit register, for targets without SSE
+struct Pack {
+    struct Reg { std::array<float, 4> f; };
+    using Mask = uint32_t;
+
+    static std::size_t constexpr width = 4u;
+
+    static Reg load(float const *p) {
+        Reg r;
+        std::copy_n(p, width, r.f.begin());
+        return r;
+    }
+    static void store(float *p, Reg const &r) {
+        std::copy_n(r.f.begin(), width, p);
+    }
+
+    static Reg load_chunks(float const *p, std::size_t) { return load(p); }
+    static Reg gather_chunks(float const *const *p) { return load(p[0]); }
+    static void store_chunks(float *p, std::size_t, Reg const &r) {
+        store(p, r);
+    }
+
+    static Reg set1(float const v) { return { { v, v, v, v } }; }
+
+    template <typename Op>
+    static Reg map(Reg const &a, Reg const &b, Op op) {
+        return { { op(a.f[0], b.f[0]), op(a.f[1], b.f[1]),
+                   op(a.f[2], b.f[2]), op(a.f[3], b.f[3]) } };
+    }
+
+    static Reg add(Reg const &a, Reg const &b) {
+        return map(a, b, std::plus { });
+    }
+    static Reg sub(Reg const &a, Reg const &b) {
+        return map(a, b, std::minus { });
+    }
+    static Reg mul(Reg const &a, Reg const &b) {
+        return map(a, b, std::multiplies { });
+    }
+    static Reg div(Reg const &a, Reg const &b) {
+        return map(a, b, std::divides { });
+    }
+
+    static Reg fma(Reg const &a, Reg const &b, Reg const &c) {
+        return { { std::fma(a.f[0], b.f[0], c.f[0]),
+                   std::fma(a.f[1], b.f[1], c.f[1]),
+                   std::fma(a.f[2], b.f[2], c.f[2]),
+                   std::fma(a.f[3], b.f[3], c.f[3]) } };
+    }
+
+    static Reg sqrt(Reg const &a) {
+        return { { std::sqrt(a.f[0]), std::sqrt(a.f[1]),
+                   std::sqrt(a.f[2]), std::sqrt(a.f[3]) } };
+    }
+    static Reg rsqrt(Reg const &a) { return div(set1(1.0f), sqrt(a)); }
+    static Reg abs(Reg const &a) {
+        return { { std::abs(a.f[0]), std::abs(a.f[1]),
+                   std::abs(a.f[2]), std::abs(a.f[3]) } };
+    }
+
+    static Mask lt(Reg const &a, Reg const &b) {
+        Mask m = 0u;
+        for(std::size_t i = 0u; i < width; ++i) {
+            m |= (a.f[i] < b.f[i] ? 1u : 0u) << i;
+        }
+        return m;
+    }
+    static Mask mask_or(Mask const a, Mask const b) { return a | b; }
+    static Mask mask_and(Mask const a, Mask const b) { return a & b; }
+    static uint32_t bits(Mask const m) { return m; }
+
+    static Reg select(Mask const m, Reg const &a, Reg const &b) {
+        Reg r;
+        for(std::size_t i = 0u; i < width; ++i) {
+            r.f[i] = ((m >> i) & 1u) != 0u ? a.f[i] : b.f[i];
+        }
+        return r;
+    }
+
+    template <int imm>
+    static Reg shuffle(Reg const &a, Reg const &b) {
+        return { { a.f[imm & 3], a.f[(imm >> 2) & 3],
+                   b.f[(imm >> 4) & 3], b.f[(imm >> 6) & 3] } };
+    }
+    static Reg unpacklo(Reg const &a, Reg const &b) {
+        return { { a.f[0], b.f[0], a.f[1], b.f[1] } };
+    }
+    static Reg unpackhi(Reg const &a, Reg const &b) {
+        return { { a.f[2], b.f[2], a.f[3], b.f[3] } };
+    }
+
+    static Reg zip_first(Reg const &a, Reg const &b) {
+        return unpacklo(a, b);
+    }
+    static Reg zip_second(Reg const &a, Reg const &b) {
+        return unpackhi(a, b);
+    }
+    static Reg unzip_even(Reg const &p, Reg const &q) {
+        return { { p.f[0], p.f[2], q.f[0], q.f[2] } };
+    }
+    static Reg unzip_odd(Reg const &p, Reg const &q) {
+        return { { p.f[1], p.f[3], q.f[1], q.f[3] } };
+    }
+
+    // Every lane is written, but only set lanes move the output along, so
+    // there's no branch to mispredict
+    static std::size_t left_pack(uint32_t *out, uint32_t const first,
+                                 uint32_t const lanes)
+    {
+        std::size_t count = 0u;
+        for(uint32_t i = 0u; i < width; ++i) {
+            out[count] = first + i;
+            count += (lanes >> i) & 1u;
+        }
+        return count;
+    }
+
+    static Mask within_ulps(Reg const &a, Reg const &b,
+                            uint32_t const max_ulps)
+    {
+        // Checking for NaN through the bits, which -ffast-math leaves alone
+        auto const is_nan = [](float const f) {
+            return (std::bit_cast<uint32_t>(f) & 0x7FFFFFFFu) > 0x7F800000u;
+        };
+
+        auto const ordered = [](float const f) {
+            auto const bits = std::bit_cast<int32_t>(f);
+            int32_t const magnitude = bits & 0x7FFFFFFF;
+            return bits < 0 ? -magnitude : magnitude;
+        };
+
+        Mask m = 0u;
+        for(std::size_t i = 0u; i < width; ++i) {
+            int64_t const distance = int64_t { ordered(a.f[i]) }
+                                   - int64_t { ordered(b.f[i]) };
+            bool const within = !is_nan(a.f[i]) && !is_nan(b.f[i])
+                && (distance < 0 ? -distance : distance) <= max_ulps;
+            m |= (within ? 1u : 0u) << i;
+        }
+        return m;
+    }
+
+    static void to_half(uint16_t *p, Reg const &r) {
+        for(std::size_t i = 0u; i < width; ++i) {
+            p[i] = math::to_half(r.f[i]);
+        }
+    }
+    static Reg from_half(uint16_t const *p) {
+        return { { math::from_half(p[0]), math::from_half(p[1]),
+                   math::from_half(p[2]), math::from_half(p[3]) } };
+    }
+
+    template <typename Int>
+    static void to_ints(Int *p, Reg const &r) {
+        for(std::size_t i = 0u; i < width; ++i) {
+            p[i] = static_cast<Int>(r.f[i]);
+        }
+    }
+    template <typename Int>
+    static Reg from_ints(Int const *p) {
+        return { { static_cast<float>(p[0]), static_cast<float>(p[1]),
+                   static_cast<float>(p[2]), static_cast<float>(p[3]) } };
+    }
+};
+
+#elif BTX_KERNEL_LEVEL <= BTX_KERNEL_LEVEL_SSE41
+
+struct Pack {
+    using Reg  = __m128;
+    using Mask = __m128;
+
+    static std::size_t constexpr width = 4u;
+
+    static Reg load(float const *p) { return _mm_loadu_ps(p); }
+    static void store(float *p, Reg const r) { _mm_storeu_ps(p, r); }
+
+    static Reg load_chunks(float const *p, std::size_t) { return load(p); }
+    static Reg gather_chunks(float const *const *p) { return load(p[0]); }
+    static void store_chunks(float *p, std::size_t, Reg const r) {
+        store(p, r);
+    }
+
+    static Reg set1(float const v) { return _mm_set1_ps(v); }
+
+    static Reg add(Reg const a, Reg const b) { return _mm_add_ps(a, b); }
+    static Reg sub(Reg const a, Reg const b) { return _mm_sub_ps(a, b); }
+    static Reg mul(Reg const a, Reg const b) { return _mm_mul_ps(a, b); }
+    static Reg div(Reg const a, Reg const b) { return _mm_div_ps(a, b); }
+
+    // No FMA instructions at this level, so one lane at a time
+    static Reg fma(Reg const a, Reg const b, Reg const c) {
+        alignas(16) float x[4], y[4], z[4];
+        _mm_store_ps(x, a);
+        _mm_store_ps(y, b);
+        _mm_store_ps(z, c);
+        for(std::size_t i = 0u; i < width; ++i) {
+            x[i] = std::fma(x[i], y[i], z[i]);
+        }
+        return _mm_load_ps(x);
+    }
+
+    static Reg sqrt(Reg const a)  { return _mm_sqrt_ps(a); }
+    static Reg rsqrt(Reg const a) { return _mm_rsqrt_ps(a); }
+    static Reg abs(Reg const a) {
+        return _mm_andnot_ps(_mm_set1_ps(-0.0f), a);
+    }
+
+    static Mask lt(Reg const a, Reg const b) { return _mm_cmplt_ps(a, b); }
+    static Mask mask_or(Mask const a, Mask const b) {
+        return _mm_or_ps(a, b);
+    }
+    static Mask mask_and(Mask const a, Mask const b) {
+        return _mm_and_ps(a, b);
+    }
+    static uint32_t bits(Mask const m) {
+        return static_cast<uint32_t>(_mm_movemask_ps(m));
+    }
+
+    static Reg select(Mask const m, Reg const a, Reg const b) {
+#if BTX_KERNEL_LEVEL == BTX_KERNEL_LEVEL_SSE41
+        return _mm_blendv_ps(b, a, m);
+#else
+        return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+#endif
+    }
+
+    template <int imm>
+    static Reg shuffle(Reg const a, Reg const b) {
+        return _mm_shuffle_ps(a, b, imm);
+    }
+    static Reg unpacklo(Reg const a, Reg const b) {
+        return _mm_unpacklo_ps(a, b);
+    }
+    static Reg unpackhi(Reg const a, Reg const b) {
+        return _mm_unpackhi_ps(a, b);
+    }
+
+    static Reg zip_first(Reg const a, Reg const b) {
+        return _mm_unpacklo_ps(a, b);
+    }
+    static Reg zip_second(Reg const a, Reg const b) {
+        return _mm_unpackhi_ps(a, b);
+    }
+    static Reg unzip_even(Reg const p, Reg const q) {
+        return _mm_shuffle_ps(p, q, _MM_SHUFFLE(2, 0, 2, 0));
+    }
+    static Reg unzip_odd(Reg const p, Reg const q) {
+        return _mm_shuffle_ps(p, q, _MM_SHUFFLE(3, 1, 3, 1));
+    }
+
+#if BTX_KERNEL_LEVEL == BTX_KERNEL_LEVEL_SSE41
+    // For each 4-bit mask, the byte shuffle that moves the set lanes to the
+    // front. SSE4.1 implies SSSE3 and its pshufb.
+    static auto constexpr shuffles = [] {
+        std::array<std::array<uint8_t, 16>, 16> table { };
+        for(uint32_t lanes = 0u; lanes < 16u; ++lanes) {
+            table[lanes].fill(0x80u);
+
+            uint32_t next = 0u;
+            for(uint32_t i = 0u; i < 4u; ++i) {
+                if(((lanes >> i) & 1u) == 0u) {
+                    continue;
+                }
+                for(uint32_t byte = 0u; byte < 4u; ++byte) {
+                    table[lanes][next * 4u + byte] =
+                        static_cast<uint8_t>(i * 4u + byte);
+                }
+                ++next;
+            }
+        }
+        return table;
+    }();
+
+    static std::size_t left_pack(uint32_t *out, uint32_t const first,
+                                 uint32_t const lanes)
+    {
+        __m128i const indices = _mm_add_epi32(_mm_set1_epi32(
+            static_cast<int>(first)), _mm_setr_epi32(0, 1, 2, 3));
+        __m128i const shuffle = _mm_loadu_si128(
+            reinterpret_cast<__m128i const *>(shuffles[lanes].data()));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out),
+                         _mm_shuffle_epi8(indices, shuffle));
+
+        // Some SSE4.1 CPUs predate POPCNT, so count the bits with a table of
+        // the answers for each 4-bit mask instead
+        return (0x4332322132212110u >> (lanes * 4u)) & 0xFu;
+    }
+#else
+    // SSE2 has no variable shuffle, so this is the same branchless loop as
+    // the scalar level
+    static std::size_t left_pack(uint32_t *out, uint32_t const first,
+                                 uint32_t const lanes)
+    {
+        std::size_t count = 0u;
+        for(uint32_t i = 0u; i < width; ++i) {
+            out[count] = first + i;
+            count += (lanes >> i) & 1u;
+        }
+        return count;
+    }
+#endif
+
+    // The bits of f as an integer that orders the same way f does
+    static __m128i ordered(Reg const f) {
+        __m128i const bits = _mm_castps_si128(f);
+        __m128i const sign = _mm_srai_epi32(bits, 31);
+        __m128i const magnitude = _mm_and_si128(
+            bits, _mm_set1_epi32(0x7FFFFFFF));
+        return _mm_sub_epi32(_mm_xor_si128(magnitude, sign), sign);
+    }
+
+    static Mask within_ulps(Reg const a, Reg const b,
+                            uint32_t const max_ulps)
+    {
+        // SSE2 has neither an absolute value nor an unsigned compare
+        __m128i const distance = _mm_sub_epi32(ordered(a), ordered(b));
+        __m128i const sign = _mm_srai_epi32(distance, 31);
+        __m128i const abs_distance = _mm_sub_epi32(
+            _mm_xor_si128(distance, sign), sign);
+
+        __m128i const within = _mm_cmplt_epi32(
+            abs_distance, _mm_set1_epi32(static_cast<int>(max_ulps + 1u)));
+        return _mm_and_ps(_mm_castsi128_ps(within), _mm_cmpord_ps(a, b));
+    }
+
+    // F16C arrived alongside AVX, so below that it's one lane at a time
+    static void to_half(uint16_t *p, Reg const r) {
+        alignas(16) std::array<float, width> lanes;
+        _mm_store_ps(lanes.data(), r);
+        for(std::size_t i = 0u; i < width; ++i) {
+            p[i] = math::to_half(lanes[i]);
+        }
+    }
+    static Reg from_half(uint16_t const *p) {
+        return _mm_setr_ps(math::from_half(p[0]), math::from_half(p[1]),
+                           math::from_half(p[2]), math::from_half(p[3]));
+    }
+
+    static void to_ints(uint16_t *p, Reg const r) {
+        __m128i const ints = _mm_cvttps_epi32(r);
+#if BTX_KERNEL_LEVEL == BTX_KERNEL_LEVEL_SSE41
+        __m128i const packed = _mm_packus_epi32(ints, ints);
+#else
+        // SSE2 can only pack with signed saturation, so shift the range down
+        // to fit and flip the top bit back afterwards
+        __m128i const offset = _mm_sub_epi32(ints, _mm_set1_epi32(0x8000));
+        __m128i const packed = _mm_xor_si128(
+            _mm_packs_epi32(offset, offset), _mm_set1_epi16(-0x8000));
+#endif
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(p), packed);
+    }
+    static void to_ints(int16_t *p, Reg const r) {
+        __m128i const ints = _mm_cvttps_epi32(r);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(p),
+                         _mm_packs_epi32(ints, ints));
+    }
+    static void to_ints(int8_t *p, Reg const r) {
+        __m128i const ints = _mm_cvttps_epi32(r);
+        __m128i const shorts = _mm_packs_epi32(ints, ints);
+        auto const bytes = _mm_cvtsi128_si32(_mm_packs_epi16(shorts, shorts));
+        std::memcpy(p, &bytes, sizeof(bytes));
+    }
+
+    static Reg from_ints(uint16_t const *p) {
+        __m128i const shorts = _mm_loadl_epi64(
+            reinterpret_cast<__m128i const *>(p));
+        return _mm_cvtepi32_ps(
+            _mm_unpacklo_epi16(shorts, _mm_setzero_si128()));
+    }
+    static Reg from_ints(int16_t const *p) {
+        __m128i const shorts = _mm_loadl_epi64(
+            reinterpret_cast<__m128i const *>(p));
+#if BTX_KERNEL_LEVEL == BTX_KERNEL_LEVEL_SSE41
+        return _mm_cvtepi32_ps(_mm_cvtepi16_epi32(shorts));
+#else
+        // Sign extend by moving each one to the top of its lane and shifting
+        // it back down
+        return _mm_cvtepi32_ps(
+            _mm_srai_epi32(_mm_unpacklo_epi16(shorts, shorts), 16));
+#endif
+    }
+    static Reg from_ints(int8_t const *p) {
+        int32_t bytes = 0;
+        std::memcpy(&bytes, p, sizeof(bytes));
+        __m128i const packed = _mm_cvtsi32_si128(bytes);
+#if BTX_KERNEL_LEVEL == BTX_KERNEL_LEVEL_SSE41
+        return _mm_cvtepi32_ps(_mm_cvtepi8_epi32(packed));
+#else
+        __m128i const shorts = _mm_unpacklo_epi8(packed, packed);
+        return _mm_cvtepi32_ps(
+            _mm_srai_epi32(_mm_unpacklo_epi16(shorts, shorts), 24));
+#endif
+    }
+};
+
+#elif BTX_KERNEL_LEVEL == BTX_KERNEL_LEVEL_AVX2
+
+struct Pack {
+    using Reg  = __m256;
+    using Mask = __m256;
+
+    static std::size_t constexpr width = 8u;
+
+    static Reg load(float const *p) { return _mm256_loadu_ps(p); }
+    static void store(float *p, Reg const r) { _mm256_storeu_ps(p, r); }
+
+    // Chunk i comes from p + i * stride
+    static Reg load_chunks(float const *p, std::size_t const stride) {
+        return _mm256_insertf128_ps(
+            _mm256_castps128_ps256(_mm_loadu_ps(p)),
+            _mm_loadu_ps(p + stride), 1
+        );
+    }
+    static Reg gather_chunks(float const *const *p) {
+        return _mm256_insertf128_ps(
+            _mm256_castps128_ps256(_mm_loadu_ps(p[0])), _mm_loadu_ps(p[1]), 1
+        );
+    }
+    static void store_chunks(float *p, std::size_t const stride,
+                             Reg const r)
+    {
+        _mm_storeu_ps(p,          _mm256_castps256_ps128(r));
+        _mm_storeu_ps(p + stride, _mm256_extractf128_ps(r, 1));
+    }
+
+    static Reg set1(float const v) { return _mm256_set1_ps(v); }
+
+    static Reg add(Reg const a, Reg const b) { return _mm256_add_ps(a, b); }
+    static Reg sub(Reg const a, Reg const b) { return _mm256_sub_ps(a, b); }
+    static Reg mul(Reg const a, Reg const b) { return _mm256_mul_ps(a, b); }
+    static Reg div(Reg const a, Reg const b) { return _mm256_div_ps(a, b); }
+    static Reg fma(Reg const a, Reg const b, Reg const c) {
+        return _mm256_fmadd_ps(a, b, c);
+    }
+
+    static Reg sqrt(Reg const a)  { return _mm256_sqrt_ps(a); }
+    static Reg rsqrt(Reg const a) { return _mm256_rsqrt_ps(a); }
+    static Reg abs(Reg const a) {
+        return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a);
+    }
+
+    static Mask lt(Reg const a, Reg const b) {
+        return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+    }
+    static Mask mask_or(Mask const a, Mask const b) {
+        return _mm256_or_ps(a, b);
+    }
+    static Mask mask_and(Mask const a, Mask const b) {
+        return _mm256_and_ps(a, b);
+    }
+    static uint32_t bits(Mask const m) {
+        return static_cast<uint32_t>(_mm256_movemask_ps(m));
+    }
+
+    static Reg select(Mask const m, Reg const a, Reg const b) {
+        return _mm256_blendv_ps(b, a, m);
+    }
+
+    template <int imm>
+    static Reg shuffle(Reg const a, Reg const b) {
+        return _mm256_shuffle_ps(a, b, imm);
+    }
+    static Reg unpacklo(Reg const a, Reg const b) {
+        return _mm256_unpacklo_ps(a, b);
+    }
+    static Reg unpackhi(Reg const a, Reg const b) {
+        return _mm256_unpackhi_ps(a, b);
+    }
+
+    // The unpacks leave the pairs in the right chunks but the wrong halves,
+    // and the unzips need each chunk's pairs next to each other, so both
+    // swap 128-bit halves around too
+    static Reg zip_first(Reg const a, Reg const b) {
+        return _mm256_permute2f128_ps(_mm256_unpacklo_ps(a, b),
+                                      _mm256_unpackhi_ps(a, b), 0x20);
+    }
+    static Reg zip_second(Reg const a, Reg const b) {
+        return _mm256_permute2f128_ps(_mm256_unpacklo_ps(a, b),
+                                      _mm256_unpackhi_ps(a, b), 0x31);
+    }
+    static Reg unzip_even(Reg const p, Reg const q) {
+        return _mm256_shuffle_ps(_mm256_permute2f128_ps(p, q, 0x20),
+                                 _mm256_permute2f128_ps(p, q, 0x31),
+                                 _MM_SHUFFLE(2, 0, 2, 0));
+    }
+    static Reg unzip_odd(Reg const p, Reg const q) {
+        return _mm256_shuffle_ps(_mm256_permute2f128_ps(p, q, 0x20),
+                                 _mm256_permute2f128_ps(p, q, 0x31),
+                                 _MM_SHUFFLE(3, 1, 3, 1));
+    }
+
+    // For each 8-bit mask, the lane permutation that moves the set lanes to
+    // the front, as eight 4-bit lane numbers
+    static auto constexpr permutations = [] {
+        std::array<uint32_t, 256> table { };
+        for(uint32_t lanes = 0u; lanes < 256u; ++lanes) {
+            uint32_t next = 0u;
+            for(uint32_t i = 0u; i < 8u; ++i) {
+                if(((lanes >> i) & 1u) != 0u) {
+                    table[lanes] |= i << (next * 4u);
+                    ++next;
+                }
+            }
+        }
+        return table;
+    }();
+
+    static std::size_t left_pack(uint32_t *out, uint32_t const first,
+                                 uint32_t const lanes)
+    {
+        __m256i const indices = _mm256_add_epi32(
+            _mm256_set1_epi32(static_cast<int>(first)),
+            _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)
+        );
+
+        // Spread the lane numbers out, one per 32-bit lane
+        __m256i const permutation = _mm256_and_si256(
+            _mm256_srlv_epi32(
+                _mm256_set1_epi32(static_cast<int>(permutations[lanes])),
+                _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28)
+            ),
+            _mm256_set1_epi32(0x7)
+        );
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out),
+            _mm256_permutevar8x32_epi32(indices, permutation));
+        return static_cast<std::size_t>(std::popcount(lanes));
+    }
+
+    // The bits of f as an integer that orders the same way f does
+    static __m256i ordered(Reg const f) {
+        __m256i const bits = _mm256_castps_si256(f);
+        __m256i const magnitude = _mm256_and_si256(
+            bits, _mm256_set1_epi32(0x7FFFFFFF));
+        return _mm256_sign_epi32(magnitude, bits);
+    }
+
+    static Mask within_ulps(Reg const a, Reg const b,
+                            uint32_t const max_ulps)
+    {
+        __m256i const distance = _mm256_abs_epi32(
+            _mm256_sub_epi32(ordered(a), ordered(b)));
+        __m256i const within = _mm256_cmpgt_epi32(
+            _mm256_set1_epi32(static_cast<int>(max_ulps + 1u)), distance);
+
+        return _mm256_and_ps(_mm256_castsi256_ps(within),
+                             _mm256_cmp_ps(a, b, _CMP_ORD_Q));
+    }
+
+    static void to_half(uint16_t *p, Reg const r) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p),
+                         _mm256_cvtps_ph(r, _MM_FROUND_TO_NEAREST_INT));
+    }
+    static Reg from_half(uint16_t const *p) {
+        return _mm256_cvtph_ps(
+            _mm_loadu_si128(reinterpret_cast<__m128i const *>(p)));
+    }
+
+    static void to_ints(uint16_t *p, Reg const r) {
+        __m256i const ints = _mm256_cvttps_epi32(r);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p), _mm_packus_epi32(
+            _mm256_castsi256_si128(ints), _mm256_extracti128_si256(ints, 1)));
+    }
+    static void to_ints(int16_t *p, Reg const r) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p), to_shorts(r));
+    }
+    static void to_ints(int8_t *p, Reg const r) {
+        __m128i const shorts = to_shorts(r);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(p),
+                         _mm_packs_epi16(shorts, shorts));
+    }
+
+    // Truncated and packed to signed 16 bits, in order
+    static __m128i to_shorts(Reg const r) {
+        __m256i const ints = _mm256_cvttps_epi32(r);
+        return _mm_packs_epi32(_mm256_castsi256_si128(ints),
+                               _mm256_extracti128_si256(ints, 1));
+    }
+
+    static Reg from_ints(uint16_t const *p) {
+        return _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(
+            _mm_loadu_si128(reinterpret_cast<__m128i const *>(p))));
+    }
+    static Reg from_ints(int16_t const *p) {
+        return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(
+            _mm_loadu_si128(reinterpret_cast<__m128i const *>(p))));
+    }
+    static Reg from_ints(int8_t const *p) {
+        return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(
+            _mm_loadl_epi64(reinterpret_cast<__m128i const *>(p))));
+    }
+};
+
+#elif BTX_KERNEL_LEVEL == BTX_KERNEL_LEVEL_AVX512
+
+struct Pack {
+    using Reg  = __m512;
+    using Mask = __mmask16;
+
+    static std::size_t constexpr width = 16u;
+
+    static Reg load(float const *p) { return _mm512_loadu_ps(p); }
+    static void store(float *p, Reg const r) { _mm512_storeu_ps(p, r); }
+
+    // Chunk i comes from p + i * stride
+    static Reg load_chunks(float const *p, std::size_t const stride) {
+        Reg r = _mm512_castps128_ps512(_mm_loadu_ps(p));
+        r = _mm512_insertf32x4(r, _mm_loadu_ps(p + stride),      1);
+        r = _mm512_insertf32x4(r, _mm_loadu_ps(p + stride * 2u), 2);
+        r = _mm512_insertf32x4(r, _mm_loadu_ps(p + stride * 3u), 3);
+        return r;
+    }
+    static Reg gather_chunks(float const *const *p) {
+        Reg r = _mm512_castps128_ps512(_mm_loadu_ps(p[0]));
+        r = _mm512_insertf32x4(r, _mm_loadu_ps(p[1]), 1);
+        r = _mm512_insertf32x4(r, _mm_loadu_ps(p[2]), 2);
+        r = _mm512_insertf32x4(r, _mm_loadu_ps(p[3]), 3);
+        return r;
+    }
+    static void store_chunks(float *p, std::size_t const stride,
+                             Reg const r)
+    {
+        _mm_storeu_ps(p,               _mm512_castps512_ps128(r));
+        _mm_storeu_ps(p + stride,      _mm512_extractf32x4_ps(r, 1));
+        _mm_storeu_ps(p + stride * 2u, _mm512_extractf32x4_ps(r, 2));
+        _mm_storeu_ps(p + stride * 3u, _mm512_extractf32x4_ps(r, 3));
+    }
+
+    static Reg set1(float const v) { return _mm512_set1_ps(v); }
+
+    static Reg add(Reg const a, Reg const b) { return _mm512_add_ps(a, b); }
+    static Reg sub(Reg const a, Reg const b) { return _mm512_sub_ps(a, b); }
+    static Reg mul(Reg const a, Reg const b) { return _mm512_mul_ps(a, b); }
+    static Reg div(Reg const a, Reg const b) { return _mm512_div_ps(a, b); }
+    static Reg fma(Reg const a, Reg const b, Reg const c) {
+        return _mm512_fmadd_ps(a, b, c);
+    }
+
+    static Reg sqrt(Reg const a)  { return _mm512_sqrt_ps(a); }
+    static Reg rsqrt(Reg const a) { return _mm512_rsqrt14_ps(a); }
+    static Reg abs(Reg const a)   { return _mm512_abs_ps(a); }
+
+    static Mask lt(Reg const a, Reg const b) {
+        return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ);
+    }
+    static Mask mask_or(Mask const a, Mask const b) {
+        return static_cast<Mask>(a | b);
+    }
+    static Mask mask_and(Mask const a, Mask const b) {
+        return static_cast<Mask>(a & b);
+    }
+    static uint32_t bits(Mask const m) { return m; }
+
+    static Reg select(Mask const m, Reg const a, Reg const b) {
+        return _mm512_mask_blend_ps(m, b, a);
+    }
+
+    template <int imm>
+    static Reg shuffle(Reg const a, Reg const b) {
+        return _mm512_shuffle_ps(a, b, imm);
+    }
+    static Reg unpacklo(Reg const a, Reg const b) {
+        return _mm512_unpacklo_ps(a, b);
+    }
+    static Reg unpackhi(Reg const a, Reg const b) {
+        return _mm512_unpackhi_ps(a, b);
+    }
+
+    // One two-register permute each, with indices 16 and up picking from
+    // the second register
+    static Reg zip_first(Reg const a, Reg const b) {
+        return _mm512_permutex2var_ps(a, _mm512_setr_epi32(
+            0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23), b);
+    }
+    static Reg zip_second(Reg const a, Reg const b) {
+        return _mm512_permutex2var_ps(a, _mm512_setr_epi32(
+            8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31), b);
+    }
+    static Reg unzip_even(Reg const p, Reg const q) {
+        return _mm512_permutex2var_ps(p, _mm512_setr_epi32(
+            0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30), q);
+    }
+    static Reg unzip_odd(Reg const p, Reg const q) {
+        return _mm512_permutex2var_ps(p, _mm512_setr_epi32(
+            1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31), q);
+    }
+
+    // AVX-512 does this in one instruction. A full store after a register
+    // compress is faster than the compressing store on some CPUs.
+    static std::size_t left_pack(uint32_t *out, uint32_t const first,
+                                 uint32_t const lanes)
+    {
+        __m512i const indices = _mm512_add_epi32(
+            _mm512_set1_epi32(static_cast<int>(first)),
+            _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7,
+                              8, 9, 10, 11, 12, 13, 14, 15)
+        );
+
+        _mm512_storeu_si512(out, _mm512_maskz_compress_epi32(
+            static_cast<__mmask16>(lanes), indices));
+        return static_cast<std::size_t>(std::popcount(lanes));
+    }
+
+    // The bits of f as an integer that orders the same way f does, by
+    // negating the magnitude of the lanes whose sign bit is set
+    static __m512i ordered(Reg const f) {
+        __m512i const bits = _mm512_castps_si512(f);
+        __m512i const magnitude = _mm512_and_si512(
+            bits, _mm512_set1_epi32(0x7FFFFFFF));
+
+        return _mm512_mask_sub_epi32(
+            magnitude, _mm512_movepi32_mask(bits),
+            _mm512_setzero_si512(), magnitude
+        );
+    }
+
+    static Mask within_ulps(Reg const a, Reg const b,
+                            uint32_t const max_ulps)
+    {
+        __m512i const distance = _mm512_abs_epi32(
+            _mm512_sub_epi32(ordered(a), ordered(b)));
+
+        return _mm512_mask_cmple_epu32_mask(
+            _mm512_cmp_ps_mask(a, b, _CMP_ORD_Q),
+            distance, _mm512_set1_epi32(static_cast<int>(max_ulps))
+        );
+    }
+
+    static void to_half(uint16_t *p, Reg const r) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(p),
+                            _mm512_cvtps_ph(r, _MM_FROUND_TO_NEAREST_INT));
+    }
+    static Reg from_half(uint16_t const *p) {
+        return _mm512_cvtph_ps(
+            _mm256_loadu_si256(reinterpret_cast<__m256i const *>(p)));
+    }
+
+    // Every lane is already in range, so plain truncating narrows work for
+    // signed and unsigned alike
+    static void to_ints(uint16_t *p, Reg const r) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(p),
+                            _mm512_cvtepi32_epi16(_mm512_cvttps_epi32(r)));
+    }
+    static void to_ints(int16_t *p, Reg const r) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(p),
+                            _mm512_cvtepi32_epi16(_mm512_cvttps_epi32(r)));
+    }
+    static void to_ints(int8_t *p, Reg const r) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p),
+                         _mm512_cvtepi32_epi8(_mm512_cvttps_epi32(r)));
+    }
+
+    static Reg from_ints(uint16_t const *p) {
+        return _mm512_cvtepi32_ps(_mm512_cvtepu16_epi32(
+            _mm256_loadu_si256(reinterpret_cast<__m256i const *>(p))));
+    }
+    static Reg from_ints(int16_t const *p) {
+        return _mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(
+            _mm256_loadu_si256(reinterpret_cast<__m256i const *>(p))));
+    }
+    static Reg from_ints(int8_t const *p) {
+        return _mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(
+            _mm_loadu_si128(reinterpret_cast<__m128i const *>(p))));
+    }
+};
+
+#endif
+
+using Reg  = Pack::Reg;
+using Mask = Pack::Mask;
+
+} // namespace btx::math::kernels::BTX_KERNEL_NAMESPACE
\ No newline at end of file
@@ -0,0 +1,17 @@
+// Portable kernels, for targets without SSE. They're built everywhere, which
+// also gives the tests a reference to compare the other levels against.
+#include "kernels.hpp"
+
+#define BTX_KERNEL_LEVEL     BTX_KERNEL_LEVEL_SCALAR
+#define BTX_KERNEL_NAMESPACE scalar
+
+#include "pack.hpp"
+#include "kernels-inl.hpp"
+
+namespace btx::math::kernels {
+
+Table const * scalar_table() {
+    return &scalar::level_table;
+}
+
+} // namespace btx::math::kernels
\ No newline at end of file
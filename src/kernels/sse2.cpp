@@ -0,0 +1,24 @@
+// Kernels built for SSE2, the x86-64 baseline
+#include "kernels.hpp"
+
+#if defined(BTX_MATH_HAS_SSE2)
+
+#define BTX_KERNEL_LEVEL     BTX_KERNEL_LEVEL_SSE2
+#define BTX_KERNEL_NAMESPACE sse2
+
+#include "pack.hpp"
+#include "kernels-inl.hpp"
+
+#endif // BTX_MATH_HAS_SSE2
+
+namespace btx::math::kernels {
+
+Table const * sse2_table() {
+#if defined(BTX_MATH_HAS_SSE2)
+    return &sse2::level_table;
+#else
+    return nullptr;
+#endif
+}
+
+} // namespace btx::math::kernels
\ No newline at end of file
@@ -0,0 +1,38 @@
+// Kernels built for SSE4.1
+#include "kernels.hpp"
+
+#if defined(BTX_MATH_HAS_SSE2)
+
+#if defined(__clang__)
+    #pragma clang attribute push(__attribute__((target("sse4.1"))), \
+                                 apply_to = function)
+#elif defined(__GNUC__)
+    #pragma GCC push_options
+    #pragma GCC target("sse4.1")
+#endif
+
+#define BTX_KERNEL_LEVEL     BTX_KERNEL_LEVEL_SSE41
+#define BTX_KERNEL_NAMESPACE sse41
+
+#include "pack.hpp"
+#include "kernels-inl.hpp"
+
+#if defined(__clang__)
+    #pragma clang attribute pop
+#elif defined(__GNUC__)
+    #pragma GCC pop_options
+#endif
+
+#endif // BTX_MATH_HAS_SSE2
+
+namespace btx::math::kernels {
+
+Table const * sse41_table() {
+#if defined(BTX_MATH_HAS_SSE2)
+    return &sse41::level_table;
+#else
+    return nullptr;
+#endif
+}
+
+} // namespace btx::math::kernels
\ No newline at end of file
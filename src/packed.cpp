@@ -0,0 +1,101 @@
+#include "brasstacks/math/packed.hpp"
+#include "kernels/kernels.hpp"
+
+#if !defined(BTX_MATH_HEADER_ONLY)
+    #include "brasstacks/math/packed-inl.hpp"
+#endif
+
+namespace btx::math {
+
+// =============================================================================
+// Half precision. Vec3 and Vec4 are nothing but floats, and Half3 and Half4
+// nothing but halves, so both convert as one long run of components.
+void to_half(std::span<Vec3 const> v, std::span<Half3> out) {
+    assert(v.size() == out.size());
+    kernels::table().to_half(reinterpret_cast<float const *>(v.data()),
+                             reinterpret_cast<uint16_t *>(out.data()),
+                             out.size() * 3u);
+}
+
+void to_half(std::span<Vec4 const> v, std::span<Half4> out) {
+    assert(v.size() == out.size());
+    kernels::table().to_half(reinterpret_cast<float const *>(v.data()),
+                             reinterpret_cast<uint16_t *>(out.data()),
+                             out.size() * 4u);
+}
+
+void from_half(std::span<Half3 const> h, std::span<Vec3> out) {
+    assert(h.size() == out.size());
+    kernels::table().from_half(reinterpret_cast<uint16_t const *>(h.data()),
+                               reinterpret_cast<float *>(out.data()),
+                               out.size() * 3u);
+}
+
+void from_half(std::span<Half4 const> h, std::span<Vec4> out) {
+    assert(h.size() == out.size());
+    kernels::table().from_half(reinterpret_cast<uint16_t const *>(h.data()),
+                               reinterpret_cast<float *>(out.data()),
+                               out.size() * 4u);
+}
+
+// =============================================================================
+// Quantized
+void quantize(AABB const &bounds, std::span<Vec3 const> v,
+              std::span<Q16Vec3> out)
+{
+    assert(v.size() == out.size());
+
+    // A flat or empty axis scales everything to 0, as in quantize()
+    auto const scale = [](float const min, float const max) {
+        float const extent = max - min;
+        return extent > 0.0f ? 65535.0f / extent : 0.0f;
+    };
+
+    Vec3 const scales {
+        scale(bounds.min.x, bounds.max.x),
+        scale(bounds.min.y, bounds.max.y),
+        scale(bounds.min.z, bounds.max.z),
+    };
+
+    kernels::table().quantize3(v.data(), bounds.min, scales, out.data(),
+                               out.size());
+}
+
+void dequantize(AABB const &bounds, std::span<Q16Vec3 const> q,
+                std::span<Vec3> out)
+{
+    assert(q.size() == out.size());
+
+    Vec3 const steps {
+        (bounds.max.x - bounds.min.x) / 65535.0f,
+        (bounds.max.y - bounds.min.y) / 65535.0f,
+        (bounds.max.z - bounds.min.z) / 65535.0f,
+    };
+
+    kernels::table().dequantize3(q.data(), bounds.min, steps, out.data(),
+                                 out.size());
+}
+
+// =============================================================================
+// Octahedral
+void to_oct16(std::span<Vec3 const> n, std::span<Oct16> out) {
+    assert(n.size() == out.size());
+    kernels::table().to_oct16(n.data(), out.data(), out.size());
+}
+
+void to_oct8(std::span<Vec3 const> n, std::span<Oct8> out) {
+    assert(n.size() == out.size());
+    kernels::table().to_oct8(n.data(), out.data(), out.size());
+}
+
+void from_oct(std::span<Oct16 const> o, std::span<Vec3> out) {
+    assert(o.size() == out.size());
+    kernels::table().from_oct16(o.data(), out.data(), out.size());
+}
+
+void from_oct(std::span<Oct8 const> o, std::span<Vec3> out) {
+    assert(o.size() == out.size());
+    kernels::table().from_oct8(o.data(), out.data(), out.size());
+}
+
+} // namespace btx::math
\ No newline at end of file
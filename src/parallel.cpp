@@ -0,0 +1,455 @@
+#include "brasstacks/math/parallel.hpp"
+#include "kernels/kernels.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace btx::math {
+
+// =============================================================================
+// Thread Pool
+// Each call numbers its tasks 0 through n - 1 and gives every thread a
+// contiguous run of them. Owners take tasks from the front of their run and
+// thieves from the back, so the two only meet over the last task or two, and
+// a thread's own tasks stay next to each other in memory.
+struct ThreadPool::State {
+    struct alignas(64) Run {
+        std::mutex  mutex;
+        std::size_t begin = 0u;
+        std::size_t end   = 0u;
+    };
+
+    std::vector<std::thread> threads;
+    std::unique_ptr<Run[]>   runs; // One per thread, the caller's last
+    std::size_t              size = 1u;
+
+    // The call in progress. These are written before any tasks are handed
+    // out, and read after taking one, so the run mutexes order them.
+    Invoke      invoke = nullptr;
+    void const *body   = nullptr;
+    std::size_t count  = 0u;
+    std::size_t grain  = 0u;
+
+    std::atomic<std::size_t> remaining { 0u };
+
+    std::mutex              mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    uint64_t                generation = 0u;
+    bool                    stopping   = false;
+
+    // Held for the length of a call
+    std::mutex busy;
+
+    bool take(std::size_t const thread, std::size_t &task);
+    void work(std::size_t thread);
+    void worker(std::size_t thread);
+};
+
+namespace {
+
+// The state of the pool the current thread is working for, if any
+thread_local void const *current_pool = nullptr;
+
+} // namespace
+
+bool ThreadPool::State::take(std::size_t const thread, std::size_t &task) {
+    {
+        Run &own = runs[thread];
+        std::scoped_lock const lock(own.mutex);
+        if(own.begin < own.end) {
+            task = own.begin++;
+            return true;
+        }
+    }
+
+    for(std::size_t offset = 1u; offset < size; ++offset) {
+        Run &victim = runs[(thread + offset) % size];
+        std::scoped_lock const lock(victim.mutex);
+        if(victim.begin < victim.end) {
+            task = --victim.end;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::State::work(std::size_t const thread) {
+    std::size_t task = 0u;
+    while(take(thread, task)) {
+        std::size_t const begin = task * grain;
+        invoke(body, begin, std::min(begin + grain, count));
+
+        if(remaining.fetch_sub(1u, std::memory_order_acq_rel) == 1u) {
+            std::scoped_lock const lock(mutex);
+            done.notify_one();
+        }
+    }
+}
+
+void ThreadPool::State::worker(std::size_t const thread) {
+    current_pool = this;
+
+    uint64_t seen = 0u;
+    for(;;) {
+        {
+            std::unique_lock lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if(stopping) {
+                return;
+            }
+            seen = generation;
+        }
+
+        work(thread);
+    }
+}
+
+// =============================================================================
+ThreadPool::ThreadPool(std::size_t threads) :
+    _state { std::make_unique<State>() }
+{
+    if(threads == 0u) {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    _state->size = threads;
+    _state->runs = std::make_unique<State::Run[]>(threads);
+
+    _state->threads.reserve(threads - 1u);
+    for(std::size_t i = 0u; i + 1u < threads; ++i) {
+        _state->threads.emplace_back(&State::worker, _state.get(), i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::scoped_lock const lock(_state->mutex);
+        _state->stopping = true;
+    }
+    _state->wake.notify_all();
+
+    for(auto &thread : _state->threads) {
+        thread.join();
+    }
+}
+
+std::size_t ThreadPool::size() const {
+    return _state->size;
+}
+
+void ThreadPool::_run(std::size_t const count, std::size_t const grain,
+                      Invoke const invoke, void const *body)
+{
+    assert(grain > 0u);
+
+    std::size_t const tasks = (count + grain - 1u) / grain;
+
+    // Nothing worth splitting, a call from inside a task, or the pool is
+    // already busy with another thread's call
+    std::unique_lock busy(_state->busy, std::defer_lock);
+    if(tasks <= 1u || _state->size == 1u || current_pool == _state.get() ||
+       !busy.try_lock())
+    {
+        for(std::size_t begin = 0u; begin < count; begin += grain) {
+            invoke(body, begin, std::min(begin + grain, count));
+        }
+        return;
+    }
+
+    State &state = *_state;
+    state.invoke = invoke;
+    state.body   = body;
+    state.count  = count;
+    state.grain  = grain;
+    state.remaining.store(tasks, std::memory_order_relaxed);
+
+    for(std::size_t i = 0u; i < state.size; ++i) {
+        std::scoped_lock const lock(state.runs[i].mutex);
+        state.runs[i].begin = tasks * i / state.size;
+        state.runs[i].end   = tasks * (i + 1u) / state.size;
+    }
+
+    {
+        std::scoped_lock const lock(state.mutex);
+        ++state.generation;
+    }
+    state.wake.notify_all();
+
+    current_pool = &state;
+    state.work(state.size - 1u);
+    current_pool = nullptr;
+
+    std::unique_lock lock(state.mutex);
+    state.done.wait(lock, [&] {
+        return state.remaining.load(std::memory_order_acquire) == 0u;
+    });
+}
+
+ThreadPool & default_thread_pool() {
+    static ThreadPool pool;
+    return pool;
+}
+
+// =============================================================================
+// Parallel Kernels
+namespace {
+
+ThreadPool & pool_for(Parallel const &policy) {
+    return policy.pool != nullptr ? *policy.pool : default_thread_pool();
+}
+
+// VecArray lanes are padded to a multiple of lane_width, and so are these
+// tasks, so every one of them covers whole registers
+std::size_t lane_grain(Parallel const &policy) {
+    std::size_t constexpr width = Vec4Array::lane_width;
+    return std::max((policy.grain + width - 1u) / width * width, width);
+}
+
+template <typename T>
+void dot_spans(Parallel const &policy, auto const kernel,
+               std::span<T const> a, std::span<T const> b,
+               std::span<float> out)
+{
+    assert(a.size() == b.size() && a.size() == out.size());
+    pool_for(policy).for_each_range(out.size(), policy.grain,
+        [&](std::size_t const begin, std::size_t const end) {
+            kernel(a.data() + begin, b.data() + begin, out.data() + begin,
+                   end - begin);
+        }
+    );
+}
+
+template <typename T>
+void normalize_spans(Parallel const &policy, auto const kernel,
+                     std::span<T const> v, std::span<T> out,
+                     Accuracy const accuracy)
+{
+    assert(v.size() == out.size());
+    pool_for(policy).for_each_range(out.size(), policy.grain,
+        [&](std::size_t const begin, std::size_t const end) {
+            kernel(v.data() + begin, out.data() + begin, end - begin,
+                   accuracy);
+        }
+    );
+}
+
+// add() and scale() treat every lane as one long run of floats, the same as
+// in VecArray.cpp
+template <typename Array>
+void add_lanes(Parallel const &policy, Array const &a, Array const &b,
+               Array &out)
+{
+    assert(a.size() == b.size() && a.size() == out.size());
+    auto const kernel = kernels::table().lanes_add;
+    pool_for(policy).for_each_range(a.stride() * Array::components,
+                                    lane_grain(policy),
+        [&](std::size_t const begin, std::size_t const end) {
+            kernel(a.lane(0u) + begin, b.lane(0u) + begin,
+                   out.lane(0u) + begin, end - begin);
+        }
+    );
+}
+
+template <typename Array>
+void scale_lanes(Parallel const &policy, Array const &a, float const scalar,
+                 Array &out)
+{
+    assert(a.size() == out.size());
+    auto const kernel = kernels::table().lanes_scale;
+    pool_for(policy).for_each_range(a.stride() * Array::components,
+                                    lane_grain(policy),
+        [&](std::size_t const begin, std::size_t const end) {
+            kernel(a.lane(0u) + begin, scalar, out.lane(0u) + begin,
+                   end - begin);
+        }
+    );
+
+    // Zeroing the padding again, as the serial scale() does
+    for(std::size_t c = 0u; c < Array::components; ++c) {
+        std::fill(out.lane(c) + out.size(), out.lane(c) + out.stride(), 0.0f);
+    }
+}
+
+// dot() and normalize() split the elements instead, offsetting every lane
+// by the same amount
+template <typename Array>
+void dot_lanes(Parallel const &policy, Array const &a, Array const &b,
+               std::span<float> out)
+{
+    assert(a.size() == b.size() && a.size() == out.size());
+    assert(a.stride() == b.stride());
+    auto const kernel = kernels::table().lanes_dot;
+    pool_for(policy).for_each_range(out.size(), lane_grain(policy),
+        [&](std::size_t const begin, std::size_t const end) {
+            kernel(a.lane(0u) + begin, b.lane(0u) + begin, a.stride(),
+                   Array::components, out.data() + begin, end - begin);
+        }
+    );
+}
+
+template <typename Array>
+void normalize_lanes(Parallel const &policy, Array const &a, Array &out) {
+    assert(a.size() == out.size());
+    auto const kernel = kernels::table().lanes_normalize;
+    pool_for(policy).for_each_range(a.stride(), lane_grain(policy),
+        [&](std::size_t const begin, std::size_t const end) {
+            kernel(a.lane(0u) + begin, out.lane(0u) + begin, a.stride(),
+                   Array::components, end - begin);
+        }
+    );
+}
+
+// skin() splits the vertices the same way
+void skin_ranges(Parallel const &policy, kernels::SkinLanes const &lanes) {
+    auto const kernel = kernels::table().lanes_skin;
+    pool_for(policy).for_each_range(lanes.stride, lane_grain(policy),
+        [&](std::size_t const begin, std::size_t const end) {
+            kernel(lanes, begin, end);
+        }
+    );
+}
+
+} // namespace
+
+// =============================================================================
+void dot(Parallel const &policy, std::span<Vec2 const> a,
+         std::span<Vec2 const> b, std::span<float> out)
+{
+    dot_spans(policy, kernels::table().dot2, a, b, out);
+}
+
+void dot(Parallel const &policy, std::span<Vec3 const> a,
+         std::span<Vec3 const> b, std::span<float> out)
+{
+    dot_spans(policy, kernels::table().dot3, a, b, out);
+}
+
+void dot(Parallel const &policy, std::span<Vec4 const> a,
+         std::span<Vec4 const> b, std::span<float> out)
+{
+    dot_spans(policy, kernels::table().dot4, a, b, out);
+}
+
+void normalize(Parallel const &policy, std::span<Vec2 const> v,
+               std::span<Vec2> out, Accuracy const accuracy)
+{
+    normalize_spans(policy, kernels::table().normalize2, v, out, accuracy);
+}
+
+void normalize(Parallel const &policy, std::span<Vec3 const> v,
+               std::span<Vec3> out, Accuracy const accuracy)
+{
+    normalize_spans(policy, kernels::table().normalize3, v, out, accuracy);
+}
+
+void normalize(Parallel const &policy, std::span<Vec4 const> v,
+               std::span<Vec4> out, Accuracy const accuracy)
+{
+    normalize_spans(policy, kernels::table().normalize4, v, out, accuracy);
+}
+
+void transform(Parallel const &policy, Mat4 const &m,
+               std::span<Vec4 const> v, std::span<Vec4> out)
+{
+    assert(v.size() == out.size());
+    auto const kernel = kernels::table().transform4;
+    pool_for(policy).for_each_range(out.size(), policy.grain,
+        [&](std::size_t const begin, std::size_t const end) {
+            kernel(m, v.data() + begin, out.data() + begin, end - begin);
+        }
+    );
+}
+
+// =============================================================================
+void add(Parallel const &policy, Vec2Array const &a, Vec2Array const &b,
+         Vec2Array &out)
+{
+    add_lanes(policy, a, b, out);
+}
+
+void add(Parallel const &policy, Vec3Array const &a, Vec3Array const &b,
+         Vec3Array &out)
+{
+    add_lanes(policy, a, b, out);
+}
+
+void add(Parallel const &policy, Vec4Array const &a, Vec4Array const &b,
+         Vec4Array &out)
+{
+    add_lanes(policy, a, b, out);
+}
+
+void scale(Parallel const &policy, Vec2Array const &a, float const scalar,
+           Vec2Array &out)
+{
+    scale_lanes(policy, a, scalar, out);
+}
+
+void scale(Parallel const &policy, Vec3Array const &a, float const scalar,
+           Vec3Array &out)
+{
+    scale_lanes(policy, a, scalar, out);
+}
+
+void scale(Parallel const &policy, Vec4Array const &a, float const scalar,
+           Vec4Array &out)
+{
+    scale_lanes(policy, a, scalar, out);
+}
+
+void dot(Parallel const &policy, Vec2Array const &a, Vec2Array const &b,
+         std::span<float> out)
+{
+    dot_lanes(policy, a, b, out);
+}
+
+void dot(Parallel const &policy, Vec3Array const &a, Vec3Array const &b,
+         std::span<float> out)
+{
+    dot_lanes(policy, a, b, out);
+}
+
+void dot(Parallel const &policy, Vec4Array const &a, Vec4Array const &b,
+         std::span<float> out)
+{
+    dot_lanes(policy, a, b, out);
+}
+
+void normalize(Parallel const &policy, Vec2Array const &a, Vec2Array &out) {
+    normalize_lanes(policy, a, out);
+}
+
+void normalize(Parallel const &policy, Vec3Array const &a, Vec3Array &out) {
+    normalize_lanes(policy, a, out);
+}
+
+void normalize(Parallel const &policy, Vec4Array const &a, Vec4Array &out) {
+    normalize_lanes(policy, a, out);
+}
+
+// =============================================================================
+void skin(Parallel const &policy, std::span<Mat4 const> palette,
+          std::span<BoneIndices const> bones, Vec4Array const &weights,
+          Vec3Array const &positions, Vec3Array &out_positions)
+{
+    skin_ranges(policy, kernels::skin_lanes(palette, bones, weights,
+                                            positions, nullptr,
+                                            out_positions, nullptr));
+}
+
+void skin(Parallel const &policy, std::span<Mat4 const> palette,
+          std::span<BoneIndices const> bones, Vec4Array const &weights,
+          Vec3Array const &positions, Vec3Array const &normals,
+          Vec3Array &out_positions, Vec3Array &out_normals)
+{
+    skin_ranges(policy, kernels::skin_lanes(palette, bones, weights,
+                                            positions, &normals,
+                                            out_positions, &out_normals));
+}
+
+} // namespace btx::math
\ No newline at end of file
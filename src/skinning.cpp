@@ -0,0 +1,44 @@
+#include "brasstacks/math/skinning.hpp"
+#include "kernels/kernels.hpp"
+
+namespace btx::math {
+
+// =============================================================================
+Mat4 blend_bones(std::span<Mat4 const> palette, BoneIndices const &bones,
+                 Vec4 const &weights)
+{
+    Mat4 result = Mat4::zero;
+    for(uint8_t k = 0u; k < 4u; ++k) {
+        assert(bones[k] < palette.size());
+        Mat4 const &bone = palette[bones[k]];
+
+        for(uint8_t c = 0u; c < 4u; ++c) {
+            result[c] += bone[c] * weights[k];
+        }
+    }
+
+    return result;
+}
+
+// =============================================================================
+void skin(std::span<Mat4 const> palette, std::span<BoneIndices const> bones,
+          Vec4Array const &weights, Vec3Array const &positions,
+          Vec3Array &out_positions)
+{
+    auto const lanes = kernels::skin_lanes(palette, bones, weights, positions,
+                                           nullptr, out_positions, nullptr);
+    kernels::table().lanes_skin(lanes, 0u, lanes.stride);
+}
+
+void skin(std::span<Mat4 const> palette, std::span<BoneIndices const> bones,
+          Vec4Array const &weights, Vec3Array const &positions,
+          Vec3Array const &normals, Vec3Array &out_positions,
+          Vec3Array &out_normals)
+{
+    auto const lanes = kernels::skin_lanes(palette, bones, weights, positions,
+                                           &normals, out_positions,
+                                           &out_normals);
+    kernels::table().lanes_skin(lanes, 0u, lanes.stride);
+}
+
+} // namespace btx::math
\ No newline at end of file
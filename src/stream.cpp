@@ -0,0 +1,158 @@
+#include "brasstacks/math/stream.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <future>
+
+namespace btx::math {
+
+// =============================================================================
+std::size_t SpanSource::read(std::span<Vec3> const out) {
+    std::size_t const count = std::min(out.size(), _rest.size());
+    std::copy_n(_rest.begin(), count, out.begin());
+    _rest = _rest.subspan(count);
+    return count;
+}
+
+bool VectorSink::write(std::span<Vec3 const> const points) {
+    _out->insert(_out->end(), points.begin(), points.end());
+    return true;
+}
+
+// =============================================================================
+Pipeline::Pipeline(std::size_t const chunk_size) :
+    _chunk_size { chunk_size }
+{
+    assert(chunk_size > 0u);
+}
+
+Pipeline & Pipeline::transform(Mat4 const &m) {
+    return then([m](std::span<Vec3> const points) {
+        transform_points(m, points, points);
+        return points.size();
+    });
+}
+
+Pipeline & Pipeline::normalize(Accuracy const accuracy) {
+    return then([accuracy](std::span<Vec3> const points) {
+        btx::math::normalize(points, points, accuracy);
+        return points.size();
+    });
+}
+
+Pipeline & Pipeline::bounds(AABB &box) {
+    return then([&box](std::span<Vec3> const points) {
+        AABB grown = box;
+        for(auto const &p : points) {
+            grown = merge(grown, p);
+        }
+
+        box = grown;
+        return points.size();
+    });
+}
+
+Pipeline & Pipeline::filter(std::function<bool(Vec3 const &)> keep) {
+    return then([keep = std::move(keep)](std::span<Vec3> const points) {
+        std::size_t kept = 0u;
+        for(auto const &p : points) {
+            if(keep(p)) {
+                points[kept++] = p;
+            }
+        }
+
+        return kept;
+    });
+}
+
+Pipeline & Pipeline::then(Stage stage) {
+    _stages.push_back(std::move(stage));
+    return *this;
+}
+
+// =============================================================================
+// Three chunks take turns: while chunk i is computed on this thread, chunk
+// i + 1 is being read into the next buffer and chunk i - 1 written from the
+// one before. Each buffer is only touched again once the future using it has
+// been waited on.
+PipelineStats Pipeline::_run(Read const read, void *const source,
+                             Write const write, void *const sink,
+                             std::pmr::memory_resource *const scratch) const
+{
+    // Declared before the futures, so that if a stage throws, the futures'
+    // destructors wait for any I/O in flight while the buffers still exist
+    std::pmr::vector<Vec3> storage(3u * _chunk_size, scratch);
+    std::array<std::span<Vec3>, 3u> buffers;
+    for(std::size_t i = 0u; i < buffers.size(); ++i) {
+        buffers[i] = std::span { storage }.subspan(i * _chunk_size,
+                                                   _chunk_size);
+    }
+
+    std::future<std::size_t> reading;
+    std::future<bool> writing;
+
+    auto const start_read = [&](std::size_t const buffer) {
+        reading = std::async(std::launch::async, [read, source, &buffers,
+                                                  buffer]
+        {
+            return read(source, buffers[buffer]);
+        });
+    };
+
+    PipelineStats stats;
+
+    // Points in the write in flight, which only count once it succeeds
+    std::size_t pending = 0u;
+    auto const finish_write = [&] {
+        bool const written = !writing.valid() || writing.get();
+        if(written) {
+            stats.written += pending;
+        }
+        pending = 0u;
+        return written;
+    };
+
+    start_read(0u);
+    for(std::size_t chunk = 0u; ; ++chunk) {
+        std::size_t const count = reading.get();
+        stats.read += count;
+
+        // A short read means there's nothing after this chunk
+        bool const last = count < _chunk_size;
+        if(!last) {
+            start_read((chunk + 1u) % buffers.size());
+        }
+
+        std::span<Vec3> points { buffers[chunk % buffers.size()].data(),
+                                 count };
+        for(auto const &stage : _stages) {
+            if(points.empty()) {
+                break;
+            }
+            points = points.first(stage(points));
+        }
+
+        // A failed write stops the run, leaving any read in flight for the
+        // future's destructor to wait on
+        if(!finish_write()) {
+            break;
+        }
+
+        if(!points.empty()) {
+            pending = points.size();
+            writing = std::async(std::launch::async, [write, sink, points] {
+                return write(sink, points);
+            });
+        }
+
+        if(last) {
+            finish_write();
+            break;
+        }
+    }
+
+    return stats;
+}
+
+} // namespace btx::math
\ No newline at end of file
@@ -0,0 +1,210 @@
+#include "tests/helpers.hpp"
+
+#include "brasstacks/math/Arena.hpp"
+#include "brasstacks/math/VecArray.hpp"
+
+#include <vector>
+
+using namespace btx::math;
+using namespace Catch::Matchers;
+
+static std::size_t constexpr ARENA_SIZE = 4096u;
+
+namespace {
+
+[[nodiscard]] bool aligned(void const *p, std::size_t const alignment) {
+    return reinterpret_cast<std::uintptr_t>(p) % alignment == 0u;
+}
+
+// Counts what reaches it, to show which allocations missed the arena
+class CountingResource : public std::pmr::memory_resource {
+public:
+    std::size_t allocations   = 0u;
+    std::size_t deallocations = 0u;
+
+private:
+    void * do_allocate(std::size_t const bytes,
+                       std::size_t const alignment) override
+    {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *const p, std::size_t const bytes,
+                       std::size_t const alignment) override
+    {
+        ++deallocations;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(
+        std::pmr::memory_resource const &other
+    ) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+} // namespace
+
+TEST_CASE("Arena allocation", "[arrays][arena]") {
+    Arena arena { ARENA_SIZE };
+    REQUIRE(arena.capacity() == ARENA_SIZE);
+    REQUIRE(arena.used() == 0u);
+
+    // Every alignment asked for, however the allocations before it ended
+    void *const one = arena.allocate(1u, 1u);
+    REQUIRE(one != nullptr);
+    for(std::size_t alignment = 1u; alignment <= 256u; alignment *= 2u) {
+        void *const p = arena.allocate(3u, alignment);
+        REQUIRE(p != nullptr);
+        REQUIRE(aligned(p, alignment));
+        REQUIRE(arena.owns(p));
+    }
+
+    auto const points = arena.allocate<Vec3>(10u);
+    REQUIRE(points.size() == 10u);
+    REQUIRE(aligned(points.data(), alignof(Vec3)));
+    for(auto &p : points) {
+        p = random_vec3();
+    }
+
+    // Running out returns nothing, and leaves the arena as it was
+    std::size_t const used = arena.used();
+    REQUIRE(arena.allocate(ARENA_SIZE, 1u) == nullptr);
+    REQUIRE(arena.allocate<Vec4>(ARENA_SIZE).empty());
+    REQUIRE(arena.allocate<float>(std::numeric_limits<std::size_t>::max())
+            .empty());
+    REQUIRE(arena.used() == used);
+
+    // Filling it exactly still fits
+    REQUIRE(arena.allocate(arena.capacity() - arena.used(), 1u) != nullptr);
+    REQUIRE(arena.used() == arena.capacity());
+    REQUIRE(arena.allocate(1u, 1u) == nullptr);
+
+    REQUIRE_FALSE(arena.owns(&arena));
+    REQUIRE(arena.peak() == ARENA_SIZE);
+
+    arena.reset();
+    REQUIRE(arena.used() == 0u);
+    REQUIRE(arena.peak() == ARENA_SIZE);
+    REQUIRE(arena.allocate(1u, 1u) == one);
+}
+
+TEST_CASE("Arena markers", "[arrays][arena]") {
+    // The caller's memory this time
+    alignas(64) std::array<std::byte, ARENA_SIZE> buffer;
+    Arena arena { buffer };
+    REQUIRE(arena.owns(buffer.data()));
+
+    auto const kept = arena.allocate<float>(5u);
+    auto const marker = arena.mark();
+
+    auto const first = arena.allocate<Vec4>(8u);
+    REQUIRE(first.data() != nullptr);
+    arena.rewind(marker);
+    REQUIRE(arena.used() == marker.offset);
+
+    // The same memory again, after the rewind
+    REQUIRE(arena.allocate<Vec4>(8u).data() == first.data());
+    arena.rewind(marker);
+
+    {
+        Arena::Scope const scope { arena };
+        static_cast<void>(arena.allocate<Vec3>(100u));
+        REQUIRE(arena.used() > marker.offset);
+
+        {
+            Arena::Scope const inner { arena };
+            static_cast<void>(arena.allocate<Vec3>(100u));
+        }
+        REQUIRE(arena.used() < marker.offset + 101u * sizeof(Vec3));
+    }
+    REQUIRE(arena.used() == marker.offset);
+    REQUIRE(arena.owns(kept.data()));
+}
+
+TEST_CASE("Arena memory resources", "[arrays][arena]") {
+    Arena arena { ARENA_SIZE };
+    CountingResource upstream;
+    ArenaResource resource { arena, &upstream };
+    REQUIRE(&resource.arena() == &arena);
+    REQUIRE(resource.upstream() == &upstream);
+
+    REQUIRE(resource.is_equal(resource));
+    REQUIRE_FALSE(resource.is_equal(upstream));
+    REQUIRE_FALSE(resource.is_equal(*std::pmr::get_default_resource()));
+
+    {
+        Arena::Scope const scope { arena };
+
+        // Small enough for the arena, so nothing goes upstream
+        std::pmr::vector<Vec3> points(100u, &resource);
+        REQUIRE(arena.owns(points.data()));
+        REQUIRE(upstream.allocations == 0u);
+
+        // Too big, so it goes upstream, and back there when it's freed
+        std::pmr::vector<Vec4> large(ARENA_SIZE, &resource);
+        REQUIRE_FALSE(arena.owns(large.data()));
+        REQUIRE(upstream.allocations == 1u);
+
+        large = { };
+        large.shrink_to_fit();
+        REQUIRE(upstream.deallocations == 1u);
+    }
+    REQUIRE(arena.used() == 0u);
+
+    // Empty allocations still land inside the block
+    Arena full { 64u };
+    ArenaResource full_resource { full, std::pmr::null_memory_resource() };
+    static_cast<void>(full_resource.allocate(63u, 1u));
+    void *const empty = full_resource.allocate(0u, 1u);
+    REQUIRE(full.owns(empty));
+    full_resource.deallocate(empty, 0u, 1u);
+
+    // Nowhere left to go
+    REQUIRE_THROWS_AS(full_resource.allocate(1u, 1u), std::bad_alloc);
+}
+
+TEST_CASE("Arrays in an arena", "[arrays][arena]") {
+    Arena arena { 64u * ARENA_SIZE };
+    ArenaResource resource { arena };
+
+    auto const points = random_vectors<Vec3>(37u);
+
+    Arena::Scope const scope { arena };
+
+    Vec3Array array { points, &resource };
+    REQUIRE(array.resource() == &resource);
+    REQUIRE(arena.owns(array.lane(0u)));
+    REQUIRE(reinterpret_cast<std::uintptr_t>(array.lane(0u))
+            % Vec3Array::alignment == 0u);
+
+    array.resize(100u);
+    REQUIRE(arena.owns(array.lane(2u)));
+
+    // Copies go on the heap unless given a resource
+    Vec3Array const copy { array };
+    REQUIRE(copy.resource() == std::pmr::get_default_resource());
+    REQUIRE_FALSE(arena.owns(copy.lane(0u)));
+
+    Vec3Array const arena_copy { array, &resource };
+    REQUIRE(arena.owns(arena_copy.lane(0u)));
+
+    // Assigning between resources copies into the destination's
+    Vec3Array heap;
+    heap = std::move(array);
+    REQUIRE(heap.resource() == std::pmr::get_default_resource());
+    REQUIRE_FALSE(arena.owns(heap.lane(0u)));
+    for(std::size_t i = 0u; i < points.size(); ++i) {
+        REQUIRE(heap[i] == points[i]);
+    }
+
+    // And between arrays in the same arena, moves the lanes
+    Vec3Array moved { 0u, &resource };
+    Vec3Array source { arena_copy, &resource };
+    float const *const lanes = source.lane(0u);
+    moved = std::move(source);
+    REQUIRE(moved.lane(0u) == lanes);
+    REQUIRE(source.empty());
+}
\ No newline at end of file
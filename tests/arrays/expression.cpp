@@ -0,0 +1,151 @@
+#include "tests/helpers.hpp"
+
+#include "brasstacks/math/expression.hpp"
+
+#include <vector>
+
+using namespace btx::math;
+using namespace Catch::Matchers;
+
+// More than one evaluation block, and not a multiple of one
+static std::size_t constexpr EXPRESSION_SIZE = 150u;
+
+namespace {
+
+template <typename A, typename B>
+concept Addable = requires(A const &a, B const &b) { a + b; };
+
+template <typename A, typename B>
+concept Multipliable = requires(A const &a, B const &b) { a * b; };
+
+template <typename Range>
+concept Lazy = requires(Range &&range) { lazy(std::forward<Range>(range)); };
+
+template <typename A, typename B>
+concept Divisible = requires(A const &a, B const &b) { a / b; };
+
+template <typename A>
+concept Crossable = requires(A const &a) { cross(a, a); };
+
+} // namespace
+
+TEST_CASE("Expressions match element-wise math", "[arrays][expression]") {
+    auto const a3 = random_vectors<Vec3>(EXPRESSION_SIZE);
+    auto const b3 = random_vectors<Vec3>(EXPRESSION_SIZE);
+    auto const a4 = random_vectors<Vec4>(EXPRESSION_SIZE);
+
+    Vec3Array const a { a3 };
+    Vec3Array const b { b3 };
+    Vec4Array const c { a4 };
+
+    Vec3Array const sum { a + b * 2.0f - Vec3::unit_x };
+    Vec3Array const scaled { -(0.5f * a) / 4.0f };
+    Vec3Array const normals { normalize(cross(a, b)) };
+    Vec4Array const unit { normalize(c) };
+
+    REQUIRE(sum.size() == EXPRESSION_SIZE);
+    for(std::size_t i = 0u; i < EXPRESSION_SIZE; ++i) {
+        REQUIRE(sum[i] == a3[i] + b3[i] * 2.0f - Vec3::unit_x);
+        REQUIRE(scaled[i] == -(0.5f * a3[i]) / 4.0f);
+        REQUIRE(normals[i] == normalize(cross(a3[i], b3[i])));
+        REQUIRE(unit[i] == normalize(a4[i]));
+    }
+
+    // Dot products give floats
+    std::vector<float> dots(EXPRESSION_SIZE);
+    evaluate(dot(a, b) * 0.5f + 1.0f, dots);
+    for(std::size_t i = 0u; i < EXPRESSION_SIZE; ++i) {
+        REQUIRE_THAT(dots[i],
+                     WithinRel(dot(a3[i], b3[i]) * 0.5f + 1.0f, 1.0e-5f));
+    }
+}
+
+TEST_CASE("Updating arrays in place", "[arrays][expression]") {
+    auto const p = random_vectors<Vec3>(EXPRESSION_SIZE);
+    auto const v = random_vectors<Vec3>(EXPRESSION_SIZE);
+    auto const g = random_vectors<Vec3>(EXPRESSION_SIZE);
+
+    Vec3Array positions { p };
+    Vec3Array const velocities { v };
+    Vec3Array const accelerations { g };
+
+    float const dt = 0.1f;
+    positions += velocities * dt + accelerations * (0.5f * dt * dt);
+    for(std::size_t i = 0u; i < EXPRESSION_SIZE; ++i) {
+        REQUIRE(positions[i] == p[i] + v[i] * dt + g[i] * (0.5f * dt * dt));
+    }
+
+    positions -= velocities * dt;
+    positions = positions * 2.0f;
+    for(std::size_t i = 0u; i < EXPRESSION_SIZE; ++i) {
+        Vec3 const expected = (p[i] + v[i] * dt + g[i] * (0.5f * dt * dt)
+                            - v[i] * dt) * 2.0f;
+        REQUIRE(positions[i] == expected);
+    }
+
+    // Assigning resizes to fit, and padding past the end stays zeroed
+    Vec3Array out;
+    out = normalize(velocities);
+    REQUIRE(out.size() == EXPRESSION_SIZE);
+    for(std::size_t i = out.size(); i < out.stride(); ++i) {
+        REQUIRE(out.x().data()[i] == 0.0f);
+    }
+}
+
+TEST_CASE("Expressions over spans", "[arrays][expression]") {
+    auto const a3 = random_vectors<Vec3>(EXPRESSION_SIZE);
+    std::vector<float> weights(EXPRESSION_SIZE);
+    for(auto &w : weights) {
+        w = Catch::Generators::random(0.0f, 1.0f).get();
+    }
+
+    Vec3Array const a { a3 };
+
+    // Arrays, spans, and single values mix freely
+    std::vector<Vec3> out(EXPRESSION_SIZE);
+    evaluate(a * lazy(weights) + lazy(a3), out);
+    for(std::size_t i = 0u; i < EXPRESSION_SIZE; ++i) {
+        REQUIRE(out[i] == a3[i] * weights[i] + a3[i]);
+    }
+
+    // Including writing back into a span the expression reads
+    evaluate(lazy(out) * 2.0f, out);
+    for(std::size_t i = 0u; i < EXPRESSION_SIZE; ++i) {
+        REQUIRE(out[i] == (a3[i] * weights[i] + a3[i]) * 2.0f);
+    }
+
+    // Nothing at all
+    std::vector<Vec3> const none;
+    std::vector<Vec3> none_out;
+    evaluate(lazy(none) * 2.0f, none_out);
+    REQUIRE(none_out.empty());
+}
+
+TEST_CASE("Expression types", "[arrays][expression]") {
+    // Only combinations that make sense for the element types are allowed
+    STATIC_REQUIRE(Addable<Vec3Array, Vec3Array>);
+    STATIC_REQUIRE(Multipliable<Vec3Array, float>);
+    STATIC_REQUIRE(Divisible<Vec3Array, float>);
+    STATIC_REQUIRE(Crossable<Vec3Array>);
+    STATIC_REQUIRE_FALSE(Multipliable<Vec3Array, Vec3Array>);
+    STATIC_REQUIRE_FALSE(Addable<Vec3Array, float>);
+    STATIC_REQUIRE_FALSE(Divisible<float, Vec3Array>);
+    STATIC_REQUIRE_FALSE(Crossable<Vec4Array>);
+    STATIC_REQUIRE_FALSE(Addable<Vec3Array, Vec4Array>);
+
+    // Ranges that own their elements have to outlive the expression, so
+    // temporaries can't be wrapped
+    STATIC_REQUIRE(Lazy<std::vector<Vec3> &>);
+    STATIC_REQUIRE(Lazy<std::vector<float> const &>);
+    STATIC_REQUIRE(Lazy<std::span<Vec3 const>>);
+    STATIC_REQUIRE_FALSE(Lazy<std::vector<Vec3>>);
+    STATIC_REQUIRE_FALSE(Lazy<std::array<float, 4> &&>);
+
+    // Plain vectors are left to their own operators
+    STATIC_REQUIRE(std::is_same_v<decltype(Vec3 { } + Vec3 { }), Vec3>);
+
+    STATIC_REQUIRE(std::is_same_v<
+        decltype(dot(std::declval<Vec3Array>(), Vec3::unit_x))::value_type,
+        float
+    >);
+}
\ No newline at end of file
@@ -0,0 +1,159 @@
+#include "tests/helpers.hpp"
+
+#include "brasstacks/math/skinning.hpp"
+
+#include <vector>
+
+using namespace btx::math;
+using namespace Catch::Matchers;
+
+// More than one block of lanes at every SIMD level, and not a multiple of one
+static std::size_t constexpr SKINNING_SIZE = 150u;
+static uint16_t constexpr SKINNING_BONES = 12u;
+
+namespace {
+
+// Bones that stay close to rigid, so that results stay small enough to
+// compare with Vec's tolerance
+std::vector<Mat4> random_palette() {
+    std::vector<Mat4> palette(SKINNING_BONES);
+    for(auto &bone : palette) {
+        bone = { random_vec4(-1.0f, 1.0f), random_vec4(-1.0f, 1.0f),
+                 random_vec4(-1.0f, 1.0f), random_vec4(-1.0f, 1.0f) };
+    }
+
+    return palette;
+}
+
+struct Bindings {
+    std::vector<BoneIndices> bones;
+    std::vector<Vec4> weights;
+};
+
+// Up to four bones per vertex, adding up to one. Some vertices only use the
+// first one or two, and those past the halfway point never use the last.
+Bindings random_bindings() {
+    Bindings b { std::vector<BoneIndices>(SKINNING_SIZE),
+                 std::vector<Vec4>(SKINNING_SIZE) };
+
+    for(std::size_t i = 0u; i < SKINNING_SIZE; ++i) {
+        for(auto &bone : b.bones[i]) {
+            bone = static_cast<uint16_t>(
+                Catch::Generators::random(0, SKINNING_BONES - 1).get());
+        }
+
+        Vec4 w = random_vec4(0.1f, 1.0f);
+        if(i % 3u == 0u) {
+            w.y = w.z = w.w = 0.0f;
+        }
+        else if(i % 3u == 1u) {
+            w.z = w.w = 0.0f;
+        }
+        if(i >= SKINNING_SIZE / 2u) {
+            w.w = 0.0f;
+        }
+
+        b.weights[i] = w / (w.x + w.y + w.z + w.w);
+    }
+
+    return b;
+}
+
+Vec3 xyz(Vec4 const &v) {
+    return { v.x, v.y, v.z };
+}
+
+} // namespace
+
+TEST_CASE("Blending bones", "[arrays][skinning]") {
+    auto const palette = random_palette();
+
+    // All of one bone
+    REQUIRE(blend_bones(palette, { 3u, 0u, 0u, 0u }, Vec4::unit_x)
+            == palette[3]);
+    REQUIRE(blend_bones(palette, { 0u, 0u, 5u, 0u }, Vec4::unit_z)
+            == palette[5]);
+
+    // Halfway between two
+    Mat4 const halfway =
+        blend_bones(palette, { 1u, 2u, 0u, 0u }, Vec4(0.5f, 0.5f, 0.0f, 0.0f));
+    for(uint8_t c = 0u; c < 4u; ++c) {
+        REQUIRE(halfway[c] == (palette[1][c] + palette[2][c]) * 0.5f);
+    }
+
+    // The same bone twice adds up
+    REQUIRE(blend_bones(palette, { 4u, 4u, 0u, 0u },
+                        Vec4(0.25f, 0.75f, 0.0f, 0.0f)) == palette[4]);
+}
+
+TEST_CASE("Skinning matches blended matrices", "[arrays][skinning]") {
+    auto const palette = random_palette();
+    auto const bindings = random_bindings();
+    auto const p = random_vectors<Vec3>(SKINNING_SIZE, -2.0f, 2.0f);
+    auto const n = random_vectors<Vec3>(SKINNING_SIZE, -1.0f, 1.0f);
+
+    Vec4Array const weights { bindings.weights };
+    Vec3Array const positions { p };
+    Vec3Array const normals { n };
+
+    Vec3Array out_positions { SKINNING_SIZE };
+    Vec3Array out_normals { SKINNING_SIZE };
+    skin(palette, bindings.bones, weights, positions, normals, out_positions,
+         out_normals);
+
+    for(std::size_t i = 0u; i < SKINNING_SIZE; ++i) {
+        Mat4 const m =
+            blend_bones(palette, bindings.bones[i], bindings.weights[i]);
+
+        REQUIRE(out_positions[i] == xyz(m * Vec4(p[i].x, p[i].y, p[i].z,
+                                                 1.0f)));
+        REQUIRE(out_normals[i] == normalize(xyz(m * Vec4(n[i].x, n[i].y,
+                                                         n[i].z, 0.0f))));
+    }
+
+    // Positions alone come out the same
+    Vec3Array only_positions { SKINNING_SIZE };
+    skin(palette, bindings.bones, weights, positions, only_positions);
+    for(std::size_t i = 0u; i < SKINNING_SIZE; ++i) {
+        REQUIRE(only_positions[i] == out_positions[i]);
+    }
+}
+
+TEST_CASE("Skinning in place", "[arrays][skinning]") {
+    auto const palette = random_palette();
+    auto const bindings = random_bindings();
+
+    Vec4Array const weights { bindings.weights };
+    Vec3Array const positions {
+        random_vectors<Vec3>(SKINNING_SIZE, -2.0f, 2.0f)
+    };
+    Vec3Array const normals {
+        random_vectors<Vec3>(SKINNING_SIZE, -1.0f, 1.0f)
+    };
+
+    Vec3Array expected_positions { SKINNING_SIZE };
+    Vec3Array expected_normals { SKINNING_SIZE };
+    skin(palette, bindings.bones, weights, positions, normals,
+         expected_positions, expected_normals);
+
+    Vec3Array in_place_positions { positions };
+    Vec3Array in_place_normals { normals };
+    skin(palette, bindings.bones, weights, in_place_positions,
+         in_place_normals, in_place_positions, in_place_normals);
+
+    for(std::size_t i = 0u; i < SKINNING_SIZE; ++i) {
+        REQUIRE(in_place_positions[i] == expected_positions[i]);
+        REQUIRE(in_place_normals[i] == expected_normals[i]);
+    }
+
+    // Padding past the end stays zeroed
+    for(std::size_t i = SKINNING_SIZE; i < in_place_positions.stride(); ++i) {
+        REQUIRE(in_place_positions.x().data()[i] == 0.0f);
+        REQUIRE(in_place_normals.x().data()[i] == 0.0f);
+    }
+
+    // Nothing at all
+    Vec3Array none;
+    skin(palette, { }, Vec4Array { }, none, none);
+    REQUIRE(none.size() == 0u);
+}
\ No newline at end of file
@@ -0,0 +1,187 @@
+#include "tests/helpers.hpp"
+
+#include "brasstacks/math/Arena.hpp"
+#include "brasstacks/math/stream.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+using namespace btx::math;
+using namespace Catch::Matchers;
+
+// Empty, shorter than a chunk, exactly some chunks, and a partial last chunk
+static std::size_t constexpr CHUNK_SIZE = 64u;
+static std::size_t constexpr STREAM_SIZES[] = { 0u, 5u, 64u, 192u, 1000u };
+
+namespace {
+
+// Takes a set number of points, then fails
+class FailingSink {
+public:
+    explicit FailingSink(std::size_t const capacity) :
+        _capacity { capacity }
+    { }
+
+    [[nodiscard]] bool write(std::span<Vec3 const> const points) {
+        if(points.size() > _capacity) {
+            _error = std::make_error_code(std::errc::no_space_on_device);
+            return false;
+        }
+
+        _capacity -= points.size();
+        return true;
+    }
+
+    [[nodiscard]] std::error_code error() const { return _error; }
+
+private:
+    std::size_t     _capacity;
+    std::error_code _error;
+};
+
+// Hands out points, then stops short with an error partway through
+class FailingSource {
+public:
+    explicit FailingSource(std::size_t const available) :
+        _available { available }
+    { }
+
+    [[nodiscard]] std::size_t read(std::span<Vec3> const out) {
+        std::size_t const count = std::min(out.size(), _available);
+        std::fill_n(out.begin(), count, Vec3(1.0f, 2.0f, 3.0f));
+        _available -= count;
+        if(count < out.size()) {
+            _error = std::make_error_code(std::errc::io_error);
+        }
+
+        return count;
+    }
+
+    [[nodiscard]] std::error_code error() const { return _error; }
+
+private:
+    std::size_t     _available;
+    std::error_code _error;
+};
+
+} // namespace
+
+TEST_CASE("Streaming pipelines", "[arrays][stream]") {
+    Mat4 const m {
+        random_vec4(), random_vec4(), random_vec4(), random_vec4(),
+    };
+
+    for(auto const size : STREAM_SIZES) {
+        auto const points = random_vectors<Vec3>(size);
+
+        // The same batch calls, on everything at once
+        std::vector<Vec3> expected(size);
+        transform_points(m, points, expected);
+        AABB expected_box = AABB::empty;
+        for(auto const &p : expected) {
+            expected_box = merge(expected_box, p);
+        }
+        normalize(expected, expected);
+
+        AABB box = AABB::empty;
+        Pipeline pipeline { CHUNK_SIZE };
+        pipeline.transform(m).bounds(box).normalize();
+        REQUIRE(pipeline.chunk_size() == CHUNK_SIZE);
+
+        SpanSource source { points };
+        std::vector<Vec3> out;
+        VectorSink sink { out };
+        auto const stats = pipeline.run(source, sink);
+
+        REQUIRE_FALSE(stats.error);
+        REQUIRE(stats.read == size);
+        REQUIRE(stats.written == size);
+        REQUIRE(out == expected);
+        REQUIRE(box.min == expected_box.min);
+        REQUIRE(box.max == expected_box.max);
+    }
+}
+
+TEST_CASE("Filtering pipelines", "[arrays][stream]") {
+    auto const points = random_vectors<Vec3>(1000u);
+    auto const above = [](Vec3 const &p) { return p.y > 0.0f; };
+
+    std::vector<Vec3> expected;
+    std::copy_if(points.begin(), points.end(), std::back_inserter(expected),
+                 above);
+
+    // Kept in order, with a custom stage after the filter seeing only what
+    // passed it
+    std::size_t seen = 0u;
+    Pipeline pipeline { CHUNK_SIZE };
+    pipeline.filter(above).then([&seen](std::span<Vec3> const chunk) {
+        seen += chunk.size();
+        return chunk.size();
+    });
+
+    SpanSource source { points };
+    std::vector<Vec3> out;
+    VectorSink sink { out };
+    auto const stats = pipeline.run(source, sink);
+
+    REQUIRE(stats.read == points.size());
+    REQUIRE(stats.written == expected.size());
+    REQUIRE(seen == expected.size());
+    REQUIRE(out == expected);
+
+    // Dropping everything writes nothing
+    SpanSource again { points };
+    out.clear();
+    auto const none = Pipeline { CHUNK_SIZE }
+        .filter([](Vec3 const &) { return false; })
+        .run(again, sink);
+    REQUIRE(none.read == points.size());
+    REQUIRE(none.written == 0u);
+    REQUIRE(out.empty());
+}
+
+TEST_CASE("Pipeline errors", "[arrays][stream]") {
+    auto const points = random_vectors<Vec3>(1000u);
+
+    // A sink that fails stops the run, counting only what it took
+    SpanSource source { points };
+    FailingSink full { 3u * CHUNK_SIZE };
+    auto const stats = Pipeline { CHUNK_SIZE }.run(source, full);
+    REQUIRE(stats.error == std::errc::no_space_on_device);
+    REQUIRE(stats.written == 3u * CHUNK_SIZE);
+    REQUIRE(stats.read < points.size());
+
+    // A source that fails still has what it read passed on
+    FailingSource broken { 100u };
+    std::vector<Vec3> out;
+    VectorSink sink { out };
+    auto const partial = Pipeline { CHUNK_SIZE }.run(broken, sink);
+    REQUIRE(partial.error == std::errc::io_error);
+    REQUIRE(partial.read == 100u);
+    REQUIRE(out.size() == 100u);
+
+    // A stage that throws comes back out of run()
+    SpanSource again { points };
+    Pipeline throwing { CHUNK_SIZE };
+    throwing.then([](std::span<Vec3> const) -> std::size_t {
+        throw std::runtime_error { "stage failed" };
+    });
+    REQUIRE_THROWS_AS(throwing.run(again, sink), std::runtime_error);
+}
+
+TEST_CASE("Pipeline scratch memory", "[arrays][stream][arena]") {
+    auto const points = random_vectors<Vec3>(1000u);
+
+    // Exactly room for the three chunks, with nowhere else to go
+    Arena arena { 3u * CHUNK_SIZE * sizeof(Vec3) };
+    ArenaResource scratch { arena, std::pmr::null_memory_resource() };
+
+    SpanSource source { points };
+    std::vector<Vec3> out;
+    VectorSink sink { out };
+    auto const stats = Pipeline { CHUNK_SIZE }.run(source, sink, &scratch);
+
+    REQUIRE_FALSE(stats.error);
+    REQUIRE(out == points);
+    REQUIRE(arena.peak() == arena.capacity());
+}
\ No newline at end of file
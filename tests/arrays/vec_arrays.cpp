@@ -0,0 +1,192 @@
+#include "tests/helpers.hpp"
+
+#include "brasstacks/math/VecArray.hpp"
+
+#include <vector>
+
+using namespace btx::math;
+using namespace Catch::Matchers;
+
+// Deliberately not a multiple of the lane width, so the padding gets used
+static std::size_t constexpr ARRAY_SIZE = 37u;
+
+TEST_CASE("Array structure", "[arrays][Vec3Array]") {
+    Vec3Array a(ARRAY_SIZE);
+
+    REQUIRE(a.size() == ARRAY_SIZE);
+    REQUIRE(a.stride() % Vec3Array::lane_width == 0u);
+
+    // Every lane starts on the alignment boundary
+    for(std::size_t c = 0u; c < Vec3Array::components; ++c) {
+        auto const address = reinterpret_cast<std::uintptr_t>(a.lane(c));
+        REQUIRE(address % Vec3Array::alignment == 0u);
+    }
+
+    // New elements are zeroed
+    for(std::size_t i = 0u; i < a.size(); ++i) {
+        REQUIRE(a[i] == Vec3::zero);
+    }
+
+    // Element access scatters to and gathers from the lanes
+    a.set(5u, Vec3(1.0f, 2.0f, 3.0f));
+    REQUIRE(a[5u] == Vec3(1.0f, 2.0f, 3.0f));
+    REQUIRE_THAT(a.x()[5u], WithinAbs(1.0f, epsilon));
+    REQUIRE_THAT(a.y()[5u], WithinAbs(2.0f, epsilon));
+    REQUIRE_THAT(a.z()[5u], WithinAbs(3.0f, epsilon));
+
+    // Growing keeps existing elements
+    a.resize(ARRAY_SIZE * 3u);
+    REQUIRE(a.size() == ARRAY_SIZE * 3u);
+    REQUIRE(a[5u] == Vec3(1.0f, 2.0f, 3.0f));
+    REQUIRE(a[ARRAY_SIZE * 2u] == Vec3::zero);
+
+    // As do copies and moves
+    Vec3Array b = a;
+    REQUIRE(b[5u] == Vec3(1.0f, 2.0f, 3.0f));
+
+    Vec3Array c = std::move(b);
+    REQUIRE(c[5u] == Vec3(1.0f, 2.0f, 3.0f));
+    REQUIRE(b.empty()); // NOLINT(bugprone-use-after-move)
+}
+
+TEST_CASE("Array conversion", "[arrays][Vec4Array]") {
+    auto const vectors = random_vectors<Vec4>(ARRAY_SIZE);
+
+    Vec4Array const a { std::span<Vec4 const>(vectors) };
+    REQUIRE(a.size() == vectors.size());
+
+    std::vector<Vec4> round_trip(a.size());
+    a.store(round_trip);
+
+    for(std::size_t i = 0u; i < vectors.size(); ++i) {
+        REQUIRE(a[i] == vectors[i]);
+        REQUIRE(round_trip[i] == vectors[i]);
+    }
+}
+
+TEST_CASE("Array arithmetic", "[arrays][Vec2Array]") {
+    auto const a_vectors = random_vectors<Vec2>(ARRAY_SIZE);
+    auto const b_vectors = random_vectors<Vec2>(ARRAY_SIZE);
+
+    Vec2Array const a { std::span<Vec2 const>(a_vectors) };
+    Vec2Array const b { std::span<Vec2 const>(b_vectors) };
+    Vec2Array out(ARRAY_SIZE);
+
+    add(a, b, out);
+    for(std::size_t i = 0u; i < ARRAY_SIZE; ++i) {
+        REQUIRE(out[i] == a_vectors[i] + b_vectors[i]);
+    }
+
+    sub(a, b, out);
+    for(std::size_t i = 0u; i < ARRAY_SIZE; ++i) {
+        REQUIRE(out[i] == a_vectors[i] - b_vectors[i]);
+    }
+
+    scale(a, -2.5f, out);
+    for(std::size_t i = 0u; i < ARRAY_SIZE; ++i) {
+        REQUIRE(out[i] == a_vectors[i] * -2.5f);
+    }
+
+    // Operating in place
+    Vec2Array c = a;
+    add(c, b, c);
+    for(std::size_t i = 0u; i < ARRAY_SIZE; ++i) {
+        REQUIRE(c[i] == a_vectors[i] + b_vectors[i]);
+    }
+}
+
+TEST_CASE("Array products", "[arrays][Vec3Array]") {
+    auto const a_vectors = random_vectors<Vec3>(ARRAY_SIZE);
+    auto const b_vectors = random_vectors<Vec3>(ARRAY_SIZE);
+
+    Vec3Array const a { std::span<Vec3 const>(a_vectors) };
+    Vec3Array const b { std::span<Vec3 const>(b_vectors) };
+
+    std::vector<float> dots(ARRAY_SIZE);
+    dot(a, b, dots);
+    for(std::size_t i = 0u; i < ARRAY_SIZE; ++i) {
+        REQUIRE_THAT(dots[i], WithinAbs(dot(a_vectors[i], b_vectors[i]),
+                                        epsilon));
+    }
+
+    length_squared(a, dots);
+    for(std::size_t i = 0u; i < ARRAY_SIZE; ++i) {
+        REQUIRE_THAT(dots[i], WithinAbs(length_squared(a_vectors[i]),
+                                        epsilon));
+    }
+
+    Vec3Array out(ARRAY_SIZE);
+    cross(a, b, out);
+    for(std::size_t i = 0u; i < ARRAY_SIZE; ++i) {
+        REQUIRE(out[i] == cross(a_vectors[i], b_vectors[i]));
+    }
+
+    // Crossing in place
+    Vec3Array c = a;
+    cross(c, b, c);
+    for(std::size_t i = 0u; i < ARRAY_SIZE; ++i) {
+        REQUIRE(c[i] == cross(a_vectors[i], b_vectors[i]));
+    }
+}
+
+TEST_CASE("Array normalization", "[arrays][Vec4Array]") {
+    auto vectors = random_vectors<Vec4>(ARRAY_SIZE);
+
+    // Sneak in the special cases the scalar version handles
+    vectors[0] = Vec4::zero;
+    vectors[1] = Vec4::unit_w;
+
+    Vec4Array const a { std::span<Vec4 const>(vectors) };
+    Vec4Array out(ARRAY_SIZE);
+    normalize(a, out);
+
+    REQUIRE(out[0] == Vec4::zero);
+    REQUIRE(out[1] == Vec4::unit_w);
+
+    for(std::size_t i = 0u; i < ARRAY_SIZE; ++i) {
+        REQUIRE(out[i] == normalize(vectors[i]));
+    }
+}
+
+TEST_CASE("Array padding", "[arrays][Vec3Array]") {
+    auto const padding_is_zero = [](Vec3Array const &array) {
+        for(std::size_t c = 0u; c < Vec3Array::components; ++c) {
+            for(std::size_t i = array.size(); i < array.stride(); ++i) {
+                if(std::bit_cast<uint32_t>(array.lane(c)[i]) != 0u) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+
+    // Scaling by infinity or NaN would make the padding NaN
+    for(float const scalar : { std::numeric_limits<float>::infinity(),
+                               std::numeric_limits<float>::quiet_NaN() })
+    {
+        Vec3Array a { random_vectors<Vec3>(5u) };
+        scale(a, scalar, a);
+        REQUIRE(padding_is_zero(a));
+
+        a.resize(10u);
+        for(std::size_t i = 5u; i < 10u; ++i) {
+            REQUIRE(a[i] == Vec3::zero);
+        }
+    }
+
+    // Growing within the stride zeroes new elements whatever the padding
+    // held
+    Vec3Array b(5u);
+    for(std::size_t c = 0u; c < Vec3Array::components; ++c) {
+        std::fill(b.lane(c) + b.size(), b.lane(c) + b.stride(), 1.0f);
+    }
+    b.resize(b.stride());
+    for(std::size_t i = 5u; i < b.size(); ++i) {
+        REQUIRE(b[i] == Vec3::zero);
+    }
+
+    // Shrinking zeroes what's left behind
+    b.set(3u, Vec3(1.0f, 2.0f, 3.0f));
+    b.resize(2u);
+    REQUIRE(padding_is_zero(b));
+}
\ No newline at end of file
@@ -0,0 +1,387 @@
+#include "tests/helpers.hpp"
+
+#include "brasstacks/math/VecFile.hpp"
+#include "brasstacks/math/stream.hpp"
+
+#include <fstream>
+#include <vector>
+
+using namespace btx::math;
+using namespace Catch::Matchers;
+
+// Not a multiple of any alignment, so SoA lanes always need padding
+static std::size_t constexpr FILE_SIZE = 1001u;
+
+namespace {
+
+// A file of its own in the temporary directory, removed again afterwards
+class TempFile {
+public:
+    explicit TempFile(std::string const &name) :
+        _path { std::filesystem::temp_directory_path()
+                / ("btx_math_" + name + ".vecs") }
+    { }
+
+    ~TempFile() {
+        std::error_code ignored;
+        std::filesystem::remove(_path, ignored);
+    }
+
+    TempFile(TempFile const &) = delete;
+    TempFile & operator=(TempFile const &) = delete;
+
+    [[nodiscard]] std::filesystem::path const & path() const { return _path; }
+
+private:
+    std::filesystem::path _path;
+};
+
+// Overwrites part of a file in place
+void patch(std::filesystem::path const &path, std::size_t const offset,
+           void const *data, std::size_t const size)
+{
+    std::fstream file { path, std::ios::in | std::ios::out
+                                | std::ios::binary };
+    file.seekp(static_cast<std::streamoff>(offset));
+    file.write(static_cast<char const *>(data),
+               static_cast<std::streamsize>(size));
+}
+
+} // namespace
+
+TEST_CASE("AoS vector files", "[arrays][vec_file]") {
+    TempFile const temp { "aos" };
+    auto const points = random_vectors<Vec3>(FILE_SIZE);
+    REQUIRE_FALSE(write_vec_file(temp.path(), points));
+
+    VecFile file;
+    REQUIRE_FALSE(file.open(temp.path()));
+    REQUIRE(file.is_open());
+    REQUIRE(file.size() == FILE_SIZE);
+    REQUIRE(file.header().layout == VecLayout::aos);
+    REQUIRE(file.header().data_offset % VecFile::default_alignment == 0u);
+    REQUIRE_FALSE(file.verify());
+
+    REQUIRE(file.holds<Vec3>());
+    REQUIRE_FALSE(file.holds<Vec4>());
+    REQUIRE_FALSE(file.holds<DVec3>());
+
+    // The vectors as they were, straight out of the mapping
+    auto const view = file.vectors<Vec3>();
+    REQUIRE(view.size() == FILE_SIZE);
+    REQUIRE(std::memcmp(view.data(), points.data(), view.size_bytes()) == 0);
+
+    // Nothing for the wrong type or layout
+    REQUIRE(file.vectors<Vec4>().empty());
+    REQUIRE(file.lane<Vec3>(0u).empty());
+
+    Vec3Array array;
+    REQUIRE(file.read(array));
+    REQUIRE(array.size() == FILE_SIZE);
+    for(std::size_t i = 0u; i < FILE_SIZE; ++i) {
+        REQUIRE(array[i] == points[i]);
+    }
+
+    Vec4Array wrong;
+    REQUIRE_FALSE(file.read(wrong));
+
+    file.close();
+    REQUIRE_FALSE(file.is_open());
+    REQUIRE(file.size() == 0u);
+    REQUIRE(file.vectors<Vec3>().empty());
+}
+
+TEST_CASE("SoA vector files", "[arrays][vec_file]") {
+    TempFile const temp { "soa" };
+
+    auto const vectors = random_vectors<Vec4>(FILE_SIZE);
+    REQUIRE_FALSE(
+        write_vec_file(temp.path(), vectors, VecLayout::soa, 256u));
+
+    VecFile file;
+    REQUIRE_FALSE(file.open(temp.path()));
+    REQUIRE_FALSE(file.verify());
+    REQUIRE(file.header().layout == VecLayout::soa);
+    REQUIRE(file.header().alignment == 256u);
+    REQUIRE(file.vectors<Vec4>().empty());
+
+    for(std::size_t c = 0u; c < 4u; ++c) {
+        auto const lane = file.lane<Vec4>(c);
+        REQUIRE(lane.size() == FILE_SIZE);
+        REQUIRE(reinterpret_cast<uintptr_t>(lane.data()) % 256u == 0u);
+        for(std::size_t i = 0u; i < FILE_SIZE; ++i) {
+            REQUIRE(lane[i] == vectors[i][static_cast<uint8_t>(c)]);
+        }
+    }
+    REQUIRE(file.lane<Vec4>(4u).empty());
+
+    Vec4Array array;
+    REQUIRE(file.read(array));
+    for(std::size_t i = 0u; i < FILE_SIZE; ++i) {
+        REQUIRE(array[i] == vectors[i]);
+    }
+
+    // Arrays write their lanes as they are, and read back the same
+    TempFile const from_array { "soa_array" };
+    REQUIRE_FALSE(write_vec_file(from_array.path(), array, 256u));
+
+    VecFile again;
+    REQUIRE_FALSE(again.open(from_array.path()));
+    REQUIRE(again.header().checksum == file.header().checksum);
+
+    Vec4Array read_again;
+    REQUIRE(again.read(read_again));
+    for(std::size_t c = 0u; c < 4u; ++c) {
+        REQUIRE(std::memcmp(read_again.lane(c), array.lane(c),
+                            FILE_SIZE * sizeof(float)) == 0);
+    }
+}
+
+TEST_CASE("Other vector types in files", "[arrays][vec_file]") {
+    TempFile const temp { "types" };
+
+    std::vector<DVec2> doubles { { 1.0e300, -2.5 }, { 0.125, 3.0 } };
+    REQUIRE_FALSE(write_vec_file(temp.path(), doubles, VecLayout::soa));
+
+    VecFile file;
+    REQUIRE_FALSE(file.open(temp.path()));
+    REQUIRE(file.holds<DVec2>());
+    REQUIRE(file.lane<DVec2>(0u)[0] == 1.0e300);
+    REQUIRE(file.lane<DVec2>(1u)[1] == 3.0);
+
+    std::vector<IVec3> cells { { 1, -2, 3 } };
+    REQUIRE_FALSE(write_vec_file(temp.path(), cells));
+    REQUIRE_FALSE(file.open(temp.path()));
+    REQUIRE(file.vectors<IVec3>()[0] == IVec3(1, -2, 3));
+
+    // Nothing at all
+    REQUIRE_FALSE(write_vec_file(temp.path(), std::vector<Vec2> { }));
+    REQUIRE_FALSE(file.open(temp.path()));
+    REQUIRE(file.vectors<Vec2>().empty());
+    REQUIRE_FALSE(file.verify());
+
+    // Moving hands the mapping over
+    REQUIRE_FALSE(write_vec_file(temp.path(), cells));
+    REQUIRE_FALSE(file.open(temp.path()));
+    VecFile moved { std::move(file) };
+    REQUIRE(moved.is_open());
+    REQUIRE_FALSE(file.is_open());
+    REQUIRE(moved.vectors<IVec3>().size() == 1u);
+}
+
+TEST_CASE("Broken vector files", "[arrays][vec_file]") {
+    TempFile const temp { "broken" };
+    auto const points = random_vectors<Vec3>(FILE_SIZE);
+
+    VecFile file;
+    auto const reopen = [&] {
+        return file.open(temp.path());
+    };
+
+    REQUIRE(reopen() == std::errc::no_such_file_or_directory);
+    REQUIRE_FALSE(file.is_open());
+
+    // Too short for a header
+    std::ofstream { temp.path() } << "BTXVECS";
+    REQUIRE(reopen() == VecFileError::not_a_vec_file);
+
+    REQUIRE_FALSE(write_vec_file(temp.path(), points));
+    patch(temp.path(), 0u, "NOTVECS", 7u);
+    REQUIRE(reopen() == VecFileError::not_a_vec_file);
+
+    REQUIRE_FALSE(write_vec_file(temp.path(), points));
+    uint32_t const version = 2u;
+    patch(temp.path(), offsetof(VecFileHeader, version), &version,
+          sizeof(version));
+    REQUIRE(reopen() == VecFileError::unsupported_version);
+
+    // A count that disagrees with the data size
+    REQUIRE_FALSE(write_vec_file(temp.path(), points));
+    uint64_t const count = FILE_SIZE + 1u;
+    patch(temp.path(), offsetof(VecFileHeader, count), &count,
+          sizeof(count));
+    REQUIRE(reopen() == VecFileError::bad_header);
+
+    uint8_t const components = 5u;
+    REQUIRE_FALSE(write_vec_file(temp.path(), points));
+    patch(temp.path(), offsetof(VecFileHeader, components), &components,
+          sizeof(components));
+    REQUIRE(reopen() == VecFileError::bad_header);
+
+    // Cut off before the end of the data
+    REQUIRE_FALSE(write_vec_file(temp.path(), points));
+    std::filesystem::resize_file(temp.path(),
+                                 std::filesystem::file_size(temp.path()) - 4u);
+    REQUIRE(reopen() == VecFileError::truncated);
+
+    // A flipped bit in the data opens, but doesn't verify
+    REQUIRE_FALSE(write_vec_file(temp.path(), points));
+    REQUIRE_FALSE(reopen());
+    auto const offset = file.header().data_offset + 100u;
+    file.close();
+
+    char const flipped = 0x40;
+    patch(temp.path(), offset, &flipped, 1u);
+    REQUIRE_FALSE(reopen());
+    REQUIRE(file.verify() == VecFileError::bad_checksum);
+    REQUIRE(make_error_code(VecFileError::bad_checksum).message()
+            == "vector file checksum mismatch");
+
+    // Alignments that aren't allowed
+    REQUIRE(write_vec_file(temp.path(), points, VecLayout::aos, 48u)
+            == std::errc::invalid_argument);
+    REQUIRE(write_vec_file(temp.path(), points, VecLayout::aos, 8u)
+            == std::errc::invalid_argument);
+}
+
+TEST_CASE("Streaming vector files", "[arrays][vec_file]") {
+    TempFile const temp { "streaming" };
+    auto const points = random_vectors<Vec3>(FILE_SIZE);
+    std::span<Vec3 const> const all { points };
+
+    // Written in uneven pieces, it matches the file written all at once
+    VecFileWriter writer;
+    REQUIRE_FALSE(writer.open<Vec3>(temp.path()));
+    REQUIRE(writer.is_open());
+    REQUIRE(writer.write(all.first(10u)));
+    REQUIRE(writer.write(all.subspan(10u, 0u)));
+    REQUIRE(writer.write(all.subspan(10u)));
+    REQUIRE(writer.size() == FILE_SIZE);
+
+    // Until close(), there's no header to open
+    REQUIRE(VecFile { }.open(temp.path()) == VecFileError::not_a_vec_file);
+
+    REQUIRE_FALSE(writer.close());
+    REQUIRE_FALSE(writer.is_open());
+
+    VecFile file;
+    REQUIRE_FALSE(file.open(temp.path()));
+    REQUIRE_FALSE(file.verify());
+    REQUIRE(file.size() == FILE_SIZE);
+    auto const view = file.vectors<Vec3>();
+    REQUIRE(std::memcmp(view.data(), points.data(), view.size_bytes()) == 0);
+    file.close();
+
+    // Read back in pieces
+    VecFileReader reader;
+    REQUIRE_FALSE(reader.open(temp.path()));
+    REQUIRE(reader.holds<Vec3>());
+    REQUIRE(reader.size() == FILE_SIZE);
+
+    std::vector<Vec3> chunk(256u);
+    std::vector<Vec3> read;
+    while(std::size_t const count = reader.read(std::span { chunk })) {
+        read.insert(read.end(), chunk.begin(), chunk.begin() + count);
+    }
+    REQUIRE_FALSE(reader.error());
+    REQUIRE(reader.remaining() == 0u);
+    REQUIRE(read == points);
+
+    // The wrong type is an error, for reading and writing
+    REQUIRE_FALSE(reader.open(temp.path()));
+    std::vector<Vec4> wrong(4u);
+    REQUIRE(reader.read(std::span { wrong }) == 0u);
+    REQUIRE(reader.error() == std::errc::invalid_argument);
+
+    REQUIRE_FALSE(writer.open<Vec3>(temp.path()));
+    REQUIRE_FALSE(writer.write(std::span<Vec4 const> { wrong }));
+    REQUIRE(writer.close() == std::errc::invalid_argument);
+
+    // SoA files don't stream
+    REQUIRE_FALSE(
+        write_vec_file(temp.path(), points, VecLayout::soa));
+    REQUIRE(reader.open(temp.path()) == std::errc::not_supported);
+    REQUIRE_FALSE(reader.is_open());
+
+    // A flipped bit shows up once the last vector has been read
+    REQUIRE_FALSE(write_vec_file(temp.path(), points));
+    REQUIRE_FALSE(file.open(temp.path()));
+    auto const offset = file.header().data_offset + 100u;
+    file.close();
+
+    char const flipped = 0x40;
+    patch(temp.path(), offset, &flipped, 1u);
+    REQUIRE_FALSE(reader.open(temp.path()));
+    REQUIRE(reader.read(std::span { chunk }) == chunk.size());
+    REQUIRE_FALSE(reader.error());
+    read.resize(FILE_SIZE);
+    REQUIRE(reader.read(std::span { read }) == FILE_SIZE - chunk.size());
+    REQUIRE(reader.error() == VecFileError::bad_checksum);
+
+    // So does a file cut short after its header was read
+    REQUIRE_FALSE(write_vec_file(temp.path(), points));
+    REQUIRE_FALSE(reader.open(temp.path()));
+    std::filesystem::resize_file(temp.path(),
+                                 std::filesystem::file_size(temp.path()) - 4u);
+    REQUIRE(reader.read(std::span { read }) == 0u);
+    REQUIRE(reader.error() == VecFileError::truncated);
+    reader.close();
+}
+
+TEST_CASE("Vector files through a pipeline", "[arrays][vec_file][stream]") {
+    TempFile const in_temp { "pipeline_in" };
+    TempFile const out_temp { "pipeline_out" };
+    auto const points = random_vectors<Vec3>(FILE_SIZE);
+    REQUIRE_FALSE(write_vec_file(in_temp.path(), points));
+
+    Mat4 const m {
+        random_vec4(), random_vec4(), random_vec4(), random_vec4(),
+    };
+
+    VecFileReader reader;
+    VecFileWriter writer;
+    REQUIRE_FALSE(reader.open(in_temp.path()));
+    REQUIRE_FALSE(writer.open<Vec3>(out_temp.path()));
+
+    // A chunk size that doesn't divide the file
+    auto const stats = Pipeline { 100u }.transform(m).run(reader, writer);
+    REQUIRE_FALSE(stats.error);
+    REQUIRE(stats.read == FILE_SIZE);
+    REQUIRE(stats.written == FILE_SIZE);
+    REQUIRE_FALSE(writer.close());
+
+    std::vector<Vec3> expected(FILE_SIZE);
+    transform_points(m, points, expected);
+
+    VecFile file;
+    REQUIRE_FALSE(file.open(out_temp.path()));
+    REQUIRE_FALSE(file.verify());
+    auto const view = file.vectors<Vec3>();
+    REQUIRE(std::equal(view.begin(), view.end(), expected.begin(),
+                       expected.end()));
+}
+
+TEST_CASE("Fletcher-64", "[arrays][vec_file]") {
+    // Fletcher-64 of "abcde" and "abcdef", zero-padded to whole words
+    auto const checksum = [](std::string_view const text) {
+        std::vector<std::byte> padded((text.size() + 3u) / 4u * 4u);
+        std::memcpy(padded.data(), text.data(), text.size());
+
+        detail::Fletcher64 fletcher;
+        fletcher.add(padded);
+        return fletcher.value();
+    };
+
+    REQUIRE(checksum("abcde") == 0xC8C6C527646362C6u);
+    REQUIRE(checksum("abcdef") == 0xC8C72B276463C8C6u);
+
+    // Fed in pieces or all at once, and across the point where the sums
+    // are reduced
+    std::vector<std::byte> data(1u << 20u);
+    for(std::size_t i = 0u; i < data.size(); ++i) {
+        data[i] = static_cast<std::byte>(i * 2654435761u >> 13u);
+    }
+
+    detail::Fletcher64 whole;
+    whole.add(data);
+
+    detail::Fletcher64 pieces;
+    std::span<std::byte const> rest { data };
+    for(std::size_t const size : { 4u, 12u, 131072u, 4000u }) {
+        pieces.add(rest.first(size));
+        rest = rest.subspan(size);
+    }
+    pieces.add(rest);
+
+    REQUIRE(pieces.value() == whole.value());
+}
\ No newline at end of file
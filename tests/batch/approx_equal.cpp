@@ -0,0 +1,148 @@
+#include "tests/helpers.hpp"
+
+#include "brasstacks/math/batch.hpp"
+
+#include <bit>
+#include <vector>
+
+using namespace btx::math;
+using namespace Catch::Matchers;
+
+namespace {
+
+std::vector<uint64_t> mask_for(std::size_t const size) {
+    // Filled with ones, to check that approx_equal() clears what it should
+    return std::vector<uint64_t>((size + 63u) / 64u, ~uint64_t { 0u });
+}
+
+// The float n representable values above f, or below for negative n
+float step(float const f, int32_t const n) {
+    float result = f;
+    for(int32_t i = 0; i < std::abs(n); ++i) {
+        result = std::nextafter(result, n > 0 ? INFINITY : -INFINITY);
+    }
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("Batched absolute equality", "[batch][equality]") {
+    for(auto const size : LONG_BATCH_SIZES) {
+        std::vector<Vec3> a(size);
+        std::vector<Vec3> b(size);
+        for(std::size_t i = 0u; i < size; ++i) {
+            a[i] = random_vec3();
+            b[i] = a[i];
+
+            // Nudge every third pair far enough apart to differ, in one
+            // component, and every fifth by less than epsilon
+            if(i % 3u == 0u) {
+                b[i][static_cast<uint8_t>(i % 2u)] += 2.0f * epsilon;
+            }
+            else if(i % 5u == 0u) {
+                b[i].z += 0.5f * epsilon;
+            }
+        }
+
+        auto mask = mask_for(size);
+        std::size_t const different = approx_equal(a, b, mask);
+
+        std::size_t expected_different = 0u;
+        for(std::size_t i = 0u; i < size; ++i) {
+            bool const equal = a[i] == b[i];
+            REQUIRE(mask_bit(mask, i) == equal);
+            expected_different += equal ? 0u : 1u;
+        }
+        REQUIRE(different == expected_different);
+
+        if(size % 64u != 0u) {
+            REQUIRE((mask.back() >> (size % 64u)) == 0u);
+        }
+
+        // A looser tolerance lets the nudged pairs through too
+        mask = mask_for(size);
+        REQUIRE(approx_equal(a, b, mask, Tolerance::absolute(1.0f)) == 0u);
+    }
+}
+
+TEST_CASE("Batched equality for every vector size", "[batch][equality]") {
+    std::vector<float> const f { 1.0f, 2.0f, 3.0f, 4.0f, 5.0f };
+    std::vector<float> g = f;
+    g[3] = -4.0f;
+
+    std::vector<uint64_t> mask(1u);
+    REQUIRE(approx_equal(f, g, mask) == 1u);
+    REQUIRE(mask[0] == 0b10111u);
+
+    std::vector<Vec2> const a2 { Vec2(1.0f, 2.0f), Vec2(3.0f, 4.0f) };
+    std::vector<Vec2> const b2 { Vec2(1.0f, 2.0f), Vec2(3.0f, 4.5f) };
+    REQUIRE(approx_equal(a2, b2, mask) == 1u);
+    REQUIRE(mask[0] == 0b01u);
+
+    std::vector<Vec4> const a4 { Vec4::unit_x, Vec4::unit_w, Vec4::zero };
+    std::vector<Vec4> const b4 { Vec4::unit_x, Vec4::unit_z, Vec4::zero };
+    REQUIRE(approx_equal(a4, b4, mask) == 1u);
+    REQUIRE(mask[0] == 0b101u);
+}
+
+TEST_CASE("Batched ULP equality", "[batch][equality]") {
+    float const one_tenth = 0.1f;
+    float const big = 1.0e6f;
+
+    std::vector<float> const a {
+        one_tenth, one_tenth, big, big, 0.0f, -0.0f, 1.0e-45f, -1.0e-45f,
+        NAN, INFINITY, -2.0f,
+    };
+    std::vector<float> const b {
+        step(one_tenth, 2), step(one_tenth, 3), step(big, -2),
+        big + 1.0f, -0.0f, step(0.0f, 1), -1.0e-45f, 1.0e-45f,
+        NAN, INFINITY, step(-2.0f, -1),
+    };
+
+    std::vector<uint64_t> mask(1u);
+    std::size_t const different =
+        approx_equal(a, b, mask, Tolerance::ulps(2u));
+
+    // 1e6 + 1 is 16 ULPs away, the denormals straddling zero are two ULPs
+    // apart, and NaN never matches
+    REQUIRE(mask[0] == 0b11011110101u);
+    REQUIRE(different == 3u);
+
+    // Zero ULPs is exact equality, apart from NaN and the two zeroes
+    REQUIRE(approx_equal(a, a, mask, Tolerance::ulps(0u)) == 1u);
+    REQUIRE(mask[0] == 0b11011111111u);
+
+    // Absolute tolerances fall apart for large values, where ULPs don't
+    std::vector<float> const huge { 1.0e9f };
+    std::vector<float> const next { step(1.0e9f, 1) };
+    REQUIRE(approx_equal(huge, next, mask) == 1u);
+    REQUIRE(approx_equal(huge, next, mask, Tolerance::ulps(1u)) == 0u);
+}
+
+TEST_CASE("Detecting changed state", "[batch][equality][examples]") {
+    // Positions from last tick and this one, where only a few moved
+    auto const previous = random_vectors<Vec3>(100u);
+
+    std::vector<Vec3> current = previous;
+    current[7].x += 1.0f;
+    current[63].y -= 0.5f;
+    current[64].z += 0.25f;
+
+    std::vector<uint64_t> unchanged((current.size() + 63u) / 64u);
+    REQUIRE(approx_equal(previous, current, unchanged) == 3u);
+
+    std::vector<std::size_t> moved;
+    for(std::size_t word = 0u; word < unchanged.size(); ++word) {
+        uint64_t bits = ~unchanged[word];
+        while(bits != 0u) {
+            std::size_t const i = word * 64u
+                + static_cast<std::size_t>(std::countr_zero(bits));
+            if(i < current.size()) {
+                moved.push_back(i);
+            }
+            bits &= bits - 1u;
+        }
+    }
+
+    REQUIRE(moved == std::vector<std::size_t> { 7u, 63u, 64u });
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "tests/helpers.hpp"
+
+#include "brasstacks/math/batch.hpp"
+
+#include <vector>
+
+using namespace btx::math;
+
+TEST_CASE("Batched cross products", "[batch][cross product]") {
+    for(auto const size : BATCH_SIZES) {
+        auto const a = random_vectors<Vec3>(size);
+        auto const b = random_vectors<Vec3>(size);
+
+        std::vector<Vec3> out(size);
+        cross(a, b, out);
+
+        for(std::size_t i = 0u; i < size; ++i) {
+            REQUIRE(out[i] == cross(a[i], b[i]));
+        }
+
+        // Crossing in place
+        std::vector<Vec3> c = a;
+        cross(c, b, c);
+        REQUIRE(c == out);
+    }
+}
+
+TEST_CASE("Batched surface normals", "[batch][cross product][examples]") {
+    // The three planes from the scalar example, all at once
+    std::vector<Vec3> const edges_a {
+        Vec3(-4.0f, 5.0f, 0.0f),
+        Vec3(-1.0f, 0.0f, -3.0f),
+        Vec3(0.0f, -4.0f, 5.0f),
+    };
+    std::vector<Vec3> const edges_b {
+        Vec3(-1.0f, -3.0f, 0.0f),
+        Vec3(-4.0f, 0.0f, 5.0f),
+        Vec3(0.0f, -1.0f, -3.0f),
+    };
+
+    std::vector<Vec3> normals(edges_a.size());
+    cross(edges_a, edges_b, normals);
+    normalize(normals, normals);
+
+    REQUIRE(normals[0] == Vec3::unit_z);
+    REQUIRE(normals[1] == Vec3::unit_y);
+    REQUIRE(normals[2] == Vec3::unit_x);
+}
\ No newline at end of file
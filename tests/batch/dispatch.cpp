@@ -0,0 +1,310 @@
+#include "tests/helpers.hpp"
+
+#include "brasstacks/math/batch.hpp"
+#include "brasstacks/math/dispatch.hpp"
+#include "brasstacks/math/packed.hpp"
+#include "brasstacks/math/skinning.hpp"
+#include "brasstacks/math/VecArray.hpp"
+
+#include <vector>
+
+using namespace btx::math;
+using namespace Catch::Matchers;
+
+// Long enough for a whole AVX-512 block plus a tail
+static std::size_t constexpr DISPATCH_SIZE = 37u;
+
+namespace {
+
+SimdLevel const ALL_LEVELS[] = {
+    SimdLevel::scalar, SimdLevel::sse2, SimdLevel::sse41,
+    SimdLevel::avx2,   SimdLevel::avx512,
+};
+
+struct Results {
+    std::vector<float> dot3;
+    std::vector<float> dot4_one;
+    std::vector<Vec3>  cross;
+    std::vector<Vec2>  normalize2;
+    std::vector<Vec4>  normalize4;
+    std::vector<Vec4>  normalize4_fast;
+    std::vector<Vec4>  transform;
+    std::vector<Vec3>  transform_points;
+    std::vector<Vec3>  rotate;
+    std::vector<Quat>  nlerp;
+    std::vector<Quat>  slerp;
+    std::vector<uint32_t> visible;
+    std::vector<uint64_t> visible_mask;
+    std::vector<uint64_t> equal_absolute;
+    std::vector<uint64_t> equal_ulps;
+    std::vector<Half3>    half;
+    std::vector<Vec3>     from_half;
+    std::vector<Q16Vec3>  quantized;
+    std::vector<Vec3>     dequantized;
+    std::vector<Oct16>    oct16;
+    std::vector<Oct8>     oct8;
+    std::vector<Vec3>     from_oct16;
+    std::vector<Vec3>     from_oct8;
+
+    std::vector<Vec3>  array_sum;
+    std::vector<Vec3>  array_cross;
+    std::vector<Vec4>  array_normalize;
+    std::vector<float> array_dot;
+
+    std::vector<Vec3>  skinned;
+    std::vector<Vec3>  skinned_normals;
+};
+
+struct Inputs {
+    std::vector<Vec2> a2;
+    std::vector<Vec3> a3;
+    std::vector<Vec3> b3;
+    std::vector<Vec4> a4;
+    std::vector<Vec4> b4;
+    std::vector<Quat> qa;
+    std::vector<Quat> qb;
+
+    Inputs() :
+        a2(DISPATCH_SIZE), a3(DISPATCH_SIZE), b3(DISPATCH_SIZE),
+        a4(DISPATCH_SIZE), b4(DISPATCH_SIZE), qa(DISPATCH_SIZE),
+        qb(DISPATCH_SIZE)
+    {
+        for(std::size_t i = 0u; i < DISPATCH_SIZE; ++i) {
+            a2[i] = random_vec2();
+            a3[i] = random_vec3();
+            b3[i] = random_vec3();
+            a4[i] = random_vec4();
+            b4[i] = random_vec4();
+            qa[i] = random_quat();
+            qb[i] = random_quat();
+        }
+
+        // A zero vector and a unit vector, which normalizing leaves alone
+        a4[3] = Vec4 { };
+        a4[4] = Vec4::unit_y;
+
+        // A pair close enough for slerp to fall back to nlerp
+        qb[5] = qa[5];
+    }
+};
+
+Results run_all(Inputs const &in) {
+    Results r;
+
+    r.dot3.resize(DISPATCH_SIZE);
+    dot(std::span<Vec3 const> { in.a3 }, in.b3, r.dot3);
+
+    r.dot4_one.resize(DISPATCH_SIZE);
+    dot(in.a4[0], std::span<Vec4 const> { in.b4 }, r.dot4_one);
+
+    r.cross.resize(DISPATCH_SIZE);
+    cross(in.a3, in.b3, r.cross);
+
+    r.normalize2.resize(DISPATCH_SIZE);
+    normalize(in.a2, r.normalize2);
+
+    r.normalize4.resize(DISPATCH_SIZE);
+    normalize(in.a4, r.normalize4);
+
+    r.normalize4_fast.resize(DISPATCH_SIZE);
+    normalize(in.a4, r.normalize4_fast, Accuracy::fast);
+
+    Mat4 const m { in.a4[5], in.a4[6], in.a4[7], in.a4[8] };
+    r.transform.resize(DISPATCH_SIZE);
+    transform(m, in.b4, r.transform);
+
+    r.transform_points.resize(DISPATCH_SIZE);
+    transform_points(m, in.b3, r.transform_points);
+
+    r.rotate.resize(DISPATCH_SIZE);
+    rotate(in.qa[0], in.b3, r.rotate);
+
+    r.nlerp.resize(DISPATCH_SIZE);
+    nlerp(in.qa, in.qb, 0.3f, r.nlerp);
+
+    r.slerp.resize(DISPATCH_SIZE);
+    slerp(in.qa, in.qb, 0.3f, r.slerp);
+
+    ViewCone const cone { in.a3[0], in.b3[0], 60.0f };
+    r.visible.resize(DISPATCH_SIZE);
+    r.visible.resize(visible_indices(cone, in.b3, r.visible));
+
+    r.visible_mask.resize((DISPATCH_SIZE + 63u) / 64u);
+    visible_mask(cone, in.b3, r.visible_mask);
+
+    // Rounded copies, so some pairs match and some don't
+    std::vector<Vec4> rounded = in.a4;
+    for(auto &v : rounded) {
+        v.x = std::round(v.x * 100.0f) / 100.0f;
+    }
+
+    r.equal_absolute.resize((DISPATCH_SIZE + 63u) / 64u);
+    approx_equal(in.a4, rounded, r.equal_absolute,
+                 Tolerance::absolute(0.003f));
+
+    r.equal_ulps.resize((DISPATCH_SIZE + 63u) / 64u);
+    approx_equal(in.a4, rounded, r.equal_ulps, Tolerance::ulps(20000u));
+
+    // Scaled up past what a half can hold, and with some of it outside the
+    // quantizing box
+    std::vector<Vec3> scaled = in.a3;
+    for(auto &v : scaled) {
+        v *= 8000.0f;
+    }
+
+    r.half.resize(DISPATCH_SIZE);
+    to_half(scaled, r.half);
+
+    r.from_half.resize(DISPATCH_SIZE);
+    from_half(r.half, r.from_half);
+
+    AABB const box { Vec3(-50000.0f, -50000.0f, -50000.0f),
+                     Vec3(50000.0f, 50000.0f, 1000.0f) };
+    r.quantized.resize(DISPATCH_SIZE);
+    quantize(box, scaled, r.quantized);
+
+    r.dequantized.resize(DISPATCH_SIZE);
+    dequantize(box, r.quantized, r.dequantized);
+
+    // Normals pointing every which way, so about half of them fold over
+    std::vector<Vec3> normals = in.a3;
+    for(auto &n : normals) {
+        n = normalize(n);
+    }
+
+    r.oct16.resize(DISPATCH_SIZE);
+    to_oct16(normals, r.oct16);
+    r.oct8.resize(DISPATCH_SIZE);
+    to_oct8(normals, r.oct8);
+
+    r.from_oct16.resize(DISPATCH_SIZE);
+    from_oct(r.oct16, r.from_oct16);
+    r.from_oct8.resize(DISPATCH_SIZE);
+    from_oct(r.oct8, r.from_oct8);
+
+    Vec3Array const a3 { in.a3 };
+    Vec3Array const b3 { in.b3 };
+    Vec3Array out3 { DISPATCH_SIZE };
+
+    add(a3, b3, out3);
+    r.array_sum.resize(DISPATCH_SIZE);
+    out3.store(r.array_sum);
+
+    cross(a3, b3, out3);
+    r.array_cross.resize(DISPATCH_SIZE);
+    out3.store(r.array_cross);
+
+    r.array_dot.resize(DISPATCH_SIZE);
+    dot(a3, b3, r.array_dot);
+
+    Vec4Array const a4 { in.a4 };
+    Vec4Array out4 { DISPATCH_SIZE };
+    normalize(a4, out4);
+    r.array_normalize.resize(DISPATCH_SIZE);
+    out4.store(r.array_normalize);
+
+    // Five bones shared between every vertex, with the last influence never
+    // used, so every level skips it
+    std::vector<Mat4> palette;
+    for(std::size_t b = 0u; b < 5u; ++b) {
+        palette.push_back({ in.a4[b], in.b4[b], in.a4[b + 5u], in.b4[b + 5u] });
+    }
+
+    std::vector<BoneIndices> bones(DISPATCH_SIZE);
+    std::vector<Vec4> weights(DISPATCH_SIZE);
+    for(std::size_t i = 0u; i < DISPATCH_SIZE; ++i) {
+        bones[i] = { static_cast<uint16_t>(i % 5u),
+                     static_cast<uint16_t>((i + 2u) % 5u),
+                     static_cast<uint16_t>((i * 3u) % 5u), 0u };
+        weights[i] = Vec4(std::abs(in.a4[i].x), std::abs(in.a4[i].y),
+                          std::abs(in.a4[i].z), 0.0f);
+    }
+
+    Vec3Array skinned { DISPATCH_SIZE };
+    Vec3Array skinned_normals { DISPATCH_SIZE };
+    skin(palette, bones, Vec4Array { weights }, a3, b3, skinned,
+         skinned_normals);
+
+    r.skinned.resize(DISPATCH_SIZE);
+    skinned.store(r.skinned);
+    r.skinned_normals.resize(DISPATCH_SIZE);
+    skinned_normals.store(r.skinned_normals);
+
+    return r;
+}
+
+} // namespace
+
+TEST_CASE("SIMD level selection", "[batch]") {
+    SimdLevel const detected = detected_simd_level();
+    REQUIRE(simd_level() == detected);
+
+    // Scalar is always available, and anything past the CPU is clamped
+    REQUIRE(force_simd_level(SimdLevel::scalar) == SimdLevel::scalar);
+    REQUIRE(simd_level() == SimdLevel::scalar);
+
+    REQUIRE(force_simd_level(SimdLevel::avx512) == detected);
+    REQUIRE(simd_level() == detected);
+
+    reset_simd_level();
+    REQUIRE(simd_level() == detected);
+
+    for(auto const level : ALL_LEVELS) {
+        REQUIRE(std::string_view { to_string(level) }.size() > 0u);
+    }
+}
+
+TEST_CASE("Every SIMD level gives the same results", "[batch]") {
+    Inputs const in;
+
+    force_simd_level(SimdLevel::scalar);
+    Results const expected = run_all(in);
+
+    for(auto const level : ALL_LEVELS) {
+        if(force_simd_level(level) != level) {
+            continue;
+        }
+
+        INFO(to_string(level));
+        Results const actual = run_all(in);
+
+        REQUIRE(same_bits(actual.dot3, expected.dot3));
+        REQUIRE(same_bits(actual.dot4_one, expected.dot4_one));
+        REQUIRE(same_bits(actual.cross, expected.cross));
+        REQUIRE(same_bits(actual.normalize2, expected.normalize2));
+        REQUIRE(same_bits(actual.normalize4, expected.normalize4));
+        REQUIRE(same_bits(actual.transform, expected.transform));
+        REQUIRE(same_bits(actual.transform_points,
+                          expected.transform_points));
+        REQUIRE(same_bits(actual.rotate, expected.rotate));
+        REQUIRE(same_bits(actual.nlerp, expected.nlerp));
+        REQUIRE(same_bits(actual.slerp, expected.slerp));
+        REQUIRE(actual.visible == expected.visible);
+        REQUIRE(actual.visible_mask == expected.visible_mask);
+        REQUIRE(actual.equal_absolute == expected.equal_absolute);
+        REQUIRE(actual.equal_ulps == expected.equal_ulps);
+        REQUIRE(same_bits(actual.half, expected.half));
+        REQUIRE(same_bits(actual.from_half, expected.from_half));
+        REQUIRE(same_bits(actual.quantized, expected.quantized));
+        REQUIRE(same_bits(actual.dequantized, expected.dequantized));
+        REQUIRE(same_bits(actual.oct16, expected.oct16));
+        REQUIRE(same_bits(actual.oct8, expected.oct8));
+        REQUIRE(same_bits(actual.from_oct16, expected.from_oct16));
+        REQUIRE(same_bits(actual.from_oct8, expected.from_oct8));
+        REQUIRE(same_bits(actual.array_sum, expected.array_sum));
+        REQUIRE(same_bits(actual.array_cross, expected.array_cross));
+        REQUIRE(same_bits(actual.array_dot, expected.array_dot));
+        REQUIRE(same_bits(actual.array_normalize, expected.array_normalize));
+        REQUIRE(same_bits(actual.skinned, expected.skinned));
+        REQUIRE(same_bits(actual.skinned_normals, expected.skinned_normals));
+
+        // Each instruction set has its own rsqrt estimate
+        for(std::size_t i = 0u; i < DISPATCH_SIZE; ++i) {
+            REQUIRE_THAT(length_squared(actual.normalize4_fast[i]),
+                         WithinAbs(length_squared(expected.normalize4[i]),
+                                   2.0e-6f));
+        }
+    }
+
+    reset_simd_level();
+}
\ No newline at end of file
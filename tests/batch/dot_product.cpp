@@ -0,0 +1,88 @@
+#include "tests/helpers.hpp"
+
+#include "brasstacks/math/batch.hpp"
+
+#include <vector>
+
+using namespace btx::math;
+using namespace Catch::Matchers;
+
+TEST_CASE("Batched dot products", "[batch][dot product]") {
+    for(auto const size : BATCH_SIZES) {
+        auto const a2 = random_vectors<Vec2>(size);
+        auto const b2 = random_vectors<Vec2>(size);
+        auto const a3 = random_vectors<Vec3>(size);
+        auto const b3 = random_vectors<Vec3>(size);
+        auto const a4 = random_vectors<Vec4>(size);
+        auto const b4 = random_vectors<Vec4>(size);
+
+        std::vector<float> out(size);
+
+        dot(a2, b2, out);
+        for(std::size_t i = 0u; i < size; ++i) {
+            REQUIRE_THAT(out[i], WithinAbs(dot(a2[i], b2[i]), epsilon));
+        }
+
+        dot(a3, b3, out);
+        for(std::size_t i = 0u; i < size; ++i) {
+            REQUIRE_THAT(out[i], WithinAbs(dot(a3[i], b3[i]), epsilon));
+        }
+
+        dot(a4, b4, out);
+        for(std::size_t i = 0u; i < size; ++i) {
+            REQUIRE_THAT(out[i], WithinAbs(dot(a4[i], b4[i]), epsilon));
+        }
+    }
+}
+
+TEST_CASE("One against many dot products", "[batch][dot product]") {
+    Vec2 const a2 = random_vec2();
+    Vec3 const a3 = random_vec3();
+    Vec4 const a4 = random_vec4();
+
+    for(auto const size : BATCH_SIZES) {
+        auto const b2 = random_vectors<Vec2>(size);
+        auto const b3 = random_vectors<Vec3>(size);
+        auto const b4 = random_vectors<Vec4>(size);
+
+        std::vector<float> out(size);
+
+        dot(a2, b2, out);
+        for(std::size_t i = 0u; i < size; ++i) {
+            REQUIRE_THAT(out[i], WithinAbs(dot(a2, b2[i]), epsilon));
+        }
+
+        dot(a3, b3, out);
+        for(std::size_t i = 0u; i < size; ++i) {
+            REQUIRE_THAT(out[i], WithinAbs(dot(a3, b3[i]), epsilon));
+        }
+
+        dot(a4, b4, out);
+        for(std::size_t i = 0u; i < size; ++i) {
+            REQUIRE_THAT(out[i], WithinAbs(dot(a4, b4[i]), epsilon));
+        }
+    }
+}
+
+TEST_CASE("Batched vision cone", "[batch][dot product][examples]") {
+    // The NPC example, but for a crowd of players at once
+    Vec3 const npc_fwd = Vec3::unit_y;
+    float const cos_half_fov = std::cos(radians(150.0f / 2.0f));
+
+    std::vector<Vec3> const npc_to_players {
+        normalize(Vec3(1, 1, 0)),
+        normalize(Vec3(-1, 1, 0)),
+        Vec3::unit_x,
+        -Vec3::unit_x,
+        -Vec3::unit_y,
+    };
+
+    std::vector<float> dots(npc_to_players.size());
+    dot(npc_fwd, npc_to_players, dots);
+
+    REQUIRE(dots[0] >= cos_half_fov);
+    REQUIRE(dots[1] >= cos_half_fov);
+    REQUIRE(dots[2] < cos_half_fov);
+    REQUIRE(dots[3] < cos_half_fov);
+    REQUIRE(dots[4] < cos_half_fov);
+}
\ No newline at end of file
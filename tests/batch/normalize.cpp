@@ -0,0 +1,100 @@
+#include "tests/helpers.hpp"
+
+#include "brasstacks/math/batch.hpp"
+
+#include <catch2/generators/catch_generators.hpp>
+
+#include <cstring>
+#include <vector>
+
+using namespace btx::math;
+using namespace Catch::Matchers;
+
+namespace {
+
+// Bounds from the documentation on Accuracy, with a little headroom for the
+// error already present in each random input
+float max_error(Accuracy const accuracy) {
+    switch(accuracy) {
+        case Accuracy::exact:   return 1.0e-6f;
+        case Accuracy::fast:    return 1.0e-6f;
+        case Accuracy::fastest: return 4.0e-4f;
+    }
+
+    return 0.0f;
+}
+
+template <typename Vector>
+void check_normalize(Accuracy const accuracy) {
+    for(auto const size : BATCH_SIZES) {
+        auto v = random_vectors<Vector>(size);
+
+        // Zero vectors pass straight through
+        if(size > 2u) {
+            v[2] = Vector { };
+        }
+
+        std::vector<Vector> out(size);
+        normalize(v, out, accuracy);
+
+        for(std::size_t i = 0u; i < size; ++i) {
+            if(length_squared(v[i]) < epsilon) {
+                REQUIRE(out[i] == v[i]);
+                continue;
+            }
+
+            REQUIRE_THAT(length_squared(out[i]),
+                         WithinAbs(1.0f, 2.0f * max_error(accuracy)));
+            if(accuracy != Accuracy::fastest) {
+                REQUIRE(out[i] == normalize(v[i]));
+            }
+        }
+    }
+}
+
+} // namespace
+
+TEST_CASE("Batched normalization", "[batch][normalize]") {
+    auto const accuracy = GENERATE(Accuracy::exact,
+                                   Accuracy::fast,
+                                   Accuracy::fastest);
+
+    check_normalize<Vec2>(accuracy);
+    check_normalize<Vec3>(accuracy);
+    check_normalize<Vec4>(accuracy);
+}
+
+TEST_CASE("Batched normalization in place", "[batch][normalize]") {
+    auto v = random_vectors<Vec3>(17u);
+
+    std::vector<Vec3> expected(v.size());
+    normalize(v, expected);
+
+    normalize(v, v);
+    REQUIRE(v == expected);
+}
+
+TEST_CASE("Batched normalization of unit vectors", "[batch][normalize]") {
+    auto const accuracy = GENERATE(Accuracy::exact,
+                                   Accuracy::fast,
+                                   Accuracy::fastest);
+
+    // Squared lengths within epsilon of 1 but not exactly 1, which the scalar
+    // normalize() hands back as they are
+    std::vector<Vec3> const v {
+        Vec3(0.6000001f, 0.8000001f, 0.0f),
+        Vec3(1.0000001f, 0.0f, 0.0f),
+        Vec3(0.0f, 0.9999999f, 0.0f),
+        Vec3(0.0f, 0.0f, -1.0000002f),
+        Vec3(0.48f, 0.6f, 0.64000005f),
+    };
+
+    std::vector<Vec3> out(v.size());
+    normalize(v, out, accuracy);
+
+    for(std::size_t i = 0u; i < v.size(); ++i) {
+        Vec3 const expected = normalize(v[i]);
+        REQUIRE(std::memcmp(&out[i], &expected, sizeof(Vec3)) == 0);
+        REQUIRE(std::memcmp(&out[i], &v[i], sizeof(Vec3)) == 0);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,349 @@
+#include "tests/helpers.hpp"
+
+#include "brasstacks/math/packed.hpp"
+
+#include <bit>
+#include <vector>
+
+using namespace btx::math;
+using namespace Catch::Matchers;
+
+namespace {
+
+bool is_nan_half(uint16_t const h) {
+    return (h & 0x7FFFu) > 0x7C00u;
+}
+
+float from_bits(uint32_t const bits) {
+    return std::bit_cast<float>(bits);
+}
+
+} // namespace
+
+TEST_CASE("Half precision special values", "[packed][half]") {
+    REQUIRE(to_half(0.0f) == 0x0000u);
+    REQUIRE(to_half(-0.0f) == 0x8000u);
+    REQUIRE(to_half(1.0f) == 0x3C00u);
+    REQUIRE(to_half(-2.0f) == 0xC000u);
+    REQUIRE(to_half(0.5f) == 0x3800u);
+
+    // The largest half, and the point past which everything rounds to
+    // infinity
+    REQUIRE(to_half(65504.0f) == 0x7BFFu);
+    REQUIRE(to_half(65519.0f) == 0x7BFFu);
+    REQUIRE(to_half(65520.0f) == 0x7C00u);
+    REQUIRE(to_half(-1.0e6f) == 0xFC00u);
+    REQUIRE(to_half(INFINITY) == 0x7C00u);
+    REQUIRE(to_half(-INFINITY) == 0xFC00u);
+    REQUIRE(is_nan_half(to_half(std::numeric_limits<float>::quiet_NaN())));
+
+    // The smallest normal and subnormal halves, and half of the smallest
+    // subnormal, which is a tie and rounds to the even zero
+    REQUIRE(to_half(std::ldexp(1.0f, -14)) == 0x0400u);
+    REQUIRE(to_half(std::ldexp(1.0f, -24)) == 0x0001u);
+    REQUIRE(to_half(std::ldexp(1.0f, -25)) == 0x0000u);
+    REQUIRE(to_half(std::ldexp(1.5f, -25)) == 0x0001u);
+    REQUIRE(to_half(std::ldexp(3.0f, -25)) == 0x0002u);
+
+    // Ties between normal halves go to the even one
+    REQUIRE(to_half(1.0f + std::ldexp(1.0f, -11)) == 0x3C00u);
+    REQUIRE(to_half(1.0f + std::ldexp(3.0f, -11)) == 0x3C02u);
+
+    REQUIRE(from_half(0x3C00u) == 1.0f);
+    REQUIRE(from_half(0x7BFFu) == 65504.0f);
+    REQUIRE(from_half(0x0001u) == std::ldexp(1.0f, -24));
+    REQUIRE(from_half(0x03FFu) == std::ldexp(1023.0f, -24));
+    REQUIRE(std::bit_cast<uint32_t>(from_half(0x8000u)) == 0x80000000u);
+    REQUIRE(std::bit_cast<uint32_t>(from_half(0xFC00u)) == 0xFF800000u);
+}
+
+TEST_CASE("Every half survives a round trip", "[packed][half]") {
+    for(uint32_t h = 0u; h <= 0xFFFFu; ++h) {
+        auto const half = static_cast<uint16_t>(h);
+        if(is_nan_half(half)) {
+            REQUIRE(is_nan_half(to_half(from_half(half))));
+            continue;
+        }
+
+        REQUIRE(to_half(from_half(half)) == half);
+    }
+}
+
+TEST_CASE("Half precision error bounds", "[packed][half]") {
+    for(uint32_t i = 0u; i < TEST_REPEATS * 1000u; ++i) {
+        // Normal range, relative error
+        float const big = Catch::Generators::random(-65504.0f, 65504.0f).get();
+        if(std::abs(big) >= std::ldexp(1.0f, -14)) {
+            float const back = from_half(to_half(big));
+            REQUIRE(std::abs(back - big)
+                    <= std::abs(big) * std::ldexp(1.0f, -11));
+        }
+
+        // Subnormal range, absolute error
+        float const small = Catch::Generators::random(
+            -std::ldexp(1.0f, -14), std::ldexp(1.0f, -14)).get();
+        REQUIRE(std::abs(from_half(to_half(small)) - small)
+                <= std::ldexp(1.0f, -25));
+    }
+}
+
+TEST_CASE("Half precision vectors", "[packed][half]") {
+    for(uint32_t i = 0u; i < TEST_REPEATS; ++i) {
+        Vec3 const v3 = random_vec3(-100.0f, 100.0f);
+        Half3 const h3 = to_half(v3);
+        REQUIRE(h3.x == to_half(v3.x));
+        REQUIRE(h3.z == to_half(v3.z));
+
+        Vec3 const back3 = from_half(h3);
+        REQUIRE_THAT(back3.x, WithinRel(v3.x, 4.9e-4f));
+        REQUIRE_THAT(back3.y, WithinRel(v3.y, 4.9e-4f));
+        REQUIRE_THAT(back3.z, WithinRel(v3.z, 4.9e-4f));
+
+        Vec4 const v4 = random_vec4(-100.0f, 100.0f);
+        Vec4 const back4 = from_half(to_half(v4));
+        REQUIRE_THAT(back4.w, WithinRel(v4.w, 4.9e-4f));
+    }
+}
+
+TEST_CASE("Batched half conversion matches the scalar one",
+          "[packed][half][batch]")
+{
+    // Every tie between neighboring halves, and the floats either side of
+    // it, which is where a rounding mistake would show
+    std::vector<float> floats;
+    for(uint32_t h = 0u; h < 0x7C00u; ++h) {
+        float const low = from_half(static_cast<uint16_t>(h));
+        float const high = from_half(static_cast<uint16_t>(h + 1u));
+        uint32_t const tie = std::bit_cast<uint32_t>(low + (high - low) / 2);
+
+        for(uint32_t const bits : { tie - 1u, tie, tie + 1u }) {
+            floats.push_back(from_bits(bits));
+            floats.push_back(-from_bits(bits));
+        }
+    }
+    floats.push_back(INFINITY);
+    floats.push_back(std::numeric_limits<float>::quiet_NaN());
+    floats.push_back(from_bits(0x7F800001u));   // Signaling NaN
+    floats.push_back(from_bits(0x00000001u));   // Float subnormal
+    while(floats.size() % 4u != 0u) {
+        floats.push_back(0.0f);
+    }
+
+    std::span<Vec4 const> const v {
+        reinterpret_cast<Vec4 const *>(floats.data()), floats.size() / 4u
+    };
+
+    std::vector<Half4> halves(v.size());
+    to_half(v, halves);
+
+    auto const *bits = reinterpret_cast<uint16_t const *>(halves.data());
+    for(std::size_t i = 0u; i < floats.size(); ++i) {
+        INFO(std::bit_cast<uint32_t>(floats[i]));
+        REQUIRE(bits[i] == to_half(floats[i]));
+    }
+
+    // And back, which is exact
+    std::vector<Vec4> back(v.size());
+    from_half(halves, back);
+
+    auto const *back_floats = reinterpret_cast<float const *>(back.data());
+    for(std::size_t i = 0u; i < floats.size(); ++i) {
+        REQUIRE(std::bit_cast<uint32_t>(back_floats[i])
+                == std::bit_cast<uint32_t>(from_half(bits[i])));
+    }
+}
+
+TEST_CASE("Batched half precision", "[packed][half][batch]") {
+    for(auto const size : LONG_BATCH_SIZES) {
+        auto const v = random_vectors<Vec3>(size);
+
+        std::vector<Half3> h(size);
+        to_half(v, h);
+
+        std::vector<Vec3> back(size);
+        from_half(h, back);
+
+        for(std::size_t i = 0u; i < size; ++i) {
+            REQUIRE(h[i].x == to_half(v[i].x));
+            REQUIRE(h[i].y == to_half(v[i].y));
+            REQUIRE(h[i].z == to_half(v[i].z));
+            REQUIRE(back[i].y == from_half(h[i].y));
+        }
+    }
+}
+
+TEST_CASE("Quantizing against a box", "[packed][quantized]") {
+    AABB const box { Vec3(-10.0f, 0.0f, 5.0f), Vec3(10.0f, 100.0f, 5.0f) };
+
+    Q16Vec3 const low = quantize(box.min, box);
+    REQUIRE(low.x == 0u);
+    REQUIRE(low.y == 0u);
+
+    Q16Vec3 const high = quantize(Vec3(10.0f, 100.0f, 5.0f), box);
+    REQUIRE(high.x == 65535u);
+    REQUIRE(high.y == 65535u);
+
+    // Outside the box is clamped onto it, and the flat z axis is always 0
+    Q16Vec3 const outside = quantize(Vec3(-50.0f, 500.0f, 7.0f), box);
+    REQUIRE(outside.x == 0u);
+    REQUIRE(outside.y == 65535u);
+    REQUIRE(outside.z == 0u);
+
+    Vec3 const step = extent(box) / 65535.0f;
+    for(uint32_t i = 0u; i < TEST_REPEATS * 100u; ++i) {
+        Vec3 const v {
+            Catch::Generators::random(-10.0f, 10.0f).get(),
+            Catch::Generators::random(0.0f, 100.0f).get(),
+            5.0f,
+        };
+
+        Vec3 const back = dequantize(quantize(v, box), box);
+        REQUIRE_THAT(back.x, WithinAbs(v.x, step.x * 0.5f + 2.0e-6f));
+        REQUIRE_THAT(back.y, WithinAbs(v.y, step.y * 0.5f + 1.0e-5f));
+        REQUIRE(back.z == 5.0f);
+    }
+}
+
+TEST_CASE("Batched quantizing", "[packed][quantized][batch]") {
+    AABB const box { Vec3(-10.0f, -10.0f, -10.0f), Vec3(10.0f, 10.0f, 0.0f) };
+    Vec3 const step = extent(box) / 65535.0f;
+
+    for(auto const size : LONG_BATCH_SIZES) {
+        auto const v = random_vectors<Vec3>(size);
+
+        std::vector<Q16Vec3> q(size);
+        quantize(box, v, q);
+
+        std::vector<Vec3> back(size);
+        dequantize(box, q, back);
+
+        for(std::size_t i = 0u; i < size; ++i) {
+            // The steps are worked out separately, so the two can land on
+            // either side of a rounding boundary
+            Q16Vec3 const expected = quantize(v[i], box);
+            REQUIRE(std::abs(q[i].x - expected.x) <= 1);
+            REQUIRE(std::abs(q[i].y - expected.y) <= 1);
+            REQUIRE(std::abs(q[i].z - expected.z) <= 1);
+
+            Vec3 const clamped { v[i].x, v[i].y, std::min(v[i].z, 0.0f) };
+            for(uint8_t c = 0u; c < 3u; ++c) {
+                REQUIRE_THAT(back[i][c],
+                             WithinAbs(clamped[c], step[c] * 0.5f + 2.0e-6f));
+            }
+        }
+    }
+}
+
+namespace {
+
+// A random direction, evenly spread over the sphere
+Vec3 random_unit() {
+    Vec3 v = random_vec3(-1.0f, 1.0f);
+    while(length_squared(v) < 0.01f || length_squared(v) > 1.0f) {
+        v = random_vec3(-1.0f, 1.0f);
+    }
+    return normalize(v);
+}
+
+float angle_between(Vec3 const &a, Vec3 const &b) {
+    // atan2 of the cross and dot products stays accurate for tiny angles,
+    // where acos of the dot product doesn't
+    return std::atan2(std::sqrt(length_squared(cross(a, b))), dot(a, b))
+         * one_eighty_over_pi;
+}
+
+} // namespace
+
+TEST_CASE("Octahedral normals", "[packed][octahedral]") {
+    // The axes land on the corners and edge midpoints of the square
+    Oct16 const up = to_oct16(Vec3::unit_z);
+    REQUIRE(up.x == 0);
+    REQUIRE(up.y == 0);
+
+    Oct16 const right = to_oct16(Vec3::unit_x);
+    REQUIRE(right.x == 32767);
+    REQUIRE(right.y == 0);
+
+    Oct16 const down = to_oct16(Vec3(0.0f, 0.0f, -1.0f));
+    REQUIRE(std::abs(down.x) == 32767);
+    REQUIRE(std::abs(down.y) == 32767);
+
+    Vec3 const axes[] = {
+        Vec3::unit_x, Vec3::unit_y, Vec3::unit_z,
+        Vec3(-1.0f, 0.0f, 0.0f), Vec3(0.0f, -1.0f, 0.0f),
+        Vec3(0.0f, 0.0f, -1.0f),
+    };
+    for(auto const &axis : axes) {
+        REQUIRE(from_oct(to_oct16(axis)) == axis);
+        REQUIRE(from_oct(to_oct8(axis)) == axis);
+    }
+
+    // Zero comes back as +z, and the most negative integers as -1
+    REQUIRE(from_oct(to_oct16(Vec3::zero)) == Vec3::unit_z);
+    REQUIRE(from_oct(Oct8 { -128, 0 }) == from_oct(Oct8 { -127, 0 }));
+
+    for(uint32_t i = 0u; i < TEST_REPEATS * 1000u; ++i) {
+        Vec3 const n = random_unit();
+
+        Vec3 const wide = from_oct(to_oct16(n));
+        REQUIRE_THAT(length_squared(wide), WithinAbs(1.0f, 2.0e-6f));
+        REQUIRE(angle_between(n, wide) <= 0.004f);
+
+        Vec3 const narrow = from_oct(to_oct8(n));
+        REQUIRE_THAT(length_squared(narrow), WithinAbs(1.0f, 2.0e-6f));
+        REQUIRE(angle_between(n, narrow) <= 1.0f);
+    }
+}
+
+TEST_CASE("Batched octahedral normals", "[packed][octahedral][batch]") {
+    for(auto const size : LONG_BATCH_SIZES) {
+        std::vector<Vec3> n(size);
+        for(auto &each : n) {
+            each = random_unit();
+        }
+
+        std::vector<Oct16> wide(size);
+        to_oct16(n, wide);
+        std::vector<Oct8> narrow(size);
+        to_oct8(n, narrow);
+
+        std::vector<Vec3> wide_back(size);
+        from_oct(wide, wide_back);
+        std::vector<Vec3> narrow_back(size);
+        from_oct(narrow, narrow_back);
+
+        for(std::size_t i = 0u; i < size; ++i) {
+            // Rounding can go either way where a value is right on a
+            // boundary and the two are compiled differently
+            Oct16 const expected = to_oct16(n[i]);
+            REQUIRE(std::abs(wide[i].x - expected.x) <= 1);
+            REQUIRE(std::abs(wide[i].y - expected.y) <= 1);
+
+            REQUIRE(from_oct(wide[i]) == wide_back[i]);
+            REQUIRE(from_oct(narrow[i]) == narrow_back[i]);
+            REQUIRE(angle_between(n[i], narrow_back[i]) <= 1.0f);
+        }
+    }
+}
+
+#if defined(BTX_MATH_HEADER_ONLY)
+TEST_CASE("Packed formats at compile time", "[packed][constexpr]") {
+    STATIC_REQUIRE(to_half(1.0f) == 0x3C00u);
+    STATIC_REQUIRE(from_half(0xC000u) == -2.0f);
+
+    constexpr Half3 h = to_half(Vec3(1.0f, 2.0f, 3.0f));
+    STATIC_REQUIRE(from_half(h).z == 3.0f);
+
+    constexpr AABB box { Vec3::zero, Vec3(1.0f, 1.0f, 1.0f) };
+    STATIC_REQUIRE(quantize(Vec3(1.0f, 0.0f, 0.5f), box).x == 65535u);
+    STATIC_REQUIRE(quantize(Vec3(1.0f, 0.0f, 0.5f), box).z == 32768u);
+
+    STATIC_REQUIRE(to_oct16(Vec3::unit_x).x == 32767);
+    STATIC_REQUIRE(from_oct(to_oct8(Vec3::unit_y)).y == 1.0f);
+}
+#else
+TEST_CASE("Half conversion at compile time", "[packed][constexpr]") {
+    STATIC_REQUIRE(to_half(1.0f) == 0x3C00u);
+    STATIC_REQUIRE(from_half(0xC000u) == -2.0f);
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include "tests/helpers.hpp"
+
+#include "brasstacks/math/batch.hpp"
+
+#include <vector>
+
+using namespace btx::math;
+using namespace Catch::Matchers;
+
+TEST_CASE("Batched quaternion rotation", "[batch][quaternions]") {
+    Quat const q = random_quat();
+
+    for(auto const size : BATCH_SIZES) {
+        auto v = random_vectors<Vec3>(size);
+
+        std::vector<Vec3> out(size);
+        rotate(q, v, out);
+
+        for(std::size_t i = 0u; i < size; ++i) {
+            REQUIRE(out[i] == rotate(q, v[i]));
+        }
+
+        // Rotating in place
+        rotate(q, v, v);
+        REQUIRE(v == out);
+    }
+}
+
+TEST_CASE("Batched quaternion interpolation", "[batch][quaternions]") {
+    for(auto const size : BATCH_SIZES) {
+        std::vector<Quat> a(size);
+        std::vector<Quat> b(size);
+        for(std::size_t i = 0u; i < size; ++i) {
+            a[i] = random_quat();
+            b[i] = random_quat();
+        }
+
+        // Cover the shorter arc flip, and the nlerp fallback for nearly
+        // identical pairs
+        if(size > 3u) {
+            b[1] = -a[1];
+            b[2] = a[2];
+            b[3] = a[3] * Quat::from_axis_angle(Vec3::unit_x, 0.5f);
+        }
+
+        for(float const t : { 0.0f, 0.3f, 0.5f, 1.0f }) {
+            std::vector<Quat> nlerped(size);
+            nlerp(a, b, t, nlerped);
+
+            std::vector<Quat> slerped(size);
+            slerp(a, b, t, slerped);
+
+            for(std::size_t i = 0u; i < size; ++i) {
+                REQUIRE(nlerped[i] == nlerp(a[i], b[i], t));
+
+                Quat const expected = slerp(a[i], b[i], t);
+                for(uint8_t c = 0u; c < 4u; ++c) {
+                    REQUIRE_THAT(slerped[i][c],
+                                 WithinAbs(expected[c], 1.0e-6f));
+                }
+            }
+        }
+
+        // Blending in place
+        std::vector<Quat> expected(size);
+        slerp(a, b, 0.75f, expected);
+        slerp(a, b, 0.75f, a);
+        REQUIRE(a == expected);
+    }
+}
+
+TEST_CASE("Batched animation blending", "[batch][quaternions][examples]") {
+    // Halfway between two poses, joint by joint
+    std::vector<Quat> const from {
+        Quat::identity,
+        Quat::from_axis_angle(Vec3::unit_x, 30.0f),
+    };
+    std::vector<Quat> const to {
+        Quat::from_axis_angle(Vec3::unit_z, 90.0f),
+        Quat::from_axis_angle(Vec3::unit_x, 90.0f),
+    };
+
+    std::vector<Quat> pose(from.size());
+    slerp(from, to, 0.5f, pose);
+
+    REQUIRE(pose[0] == Quat::from_axis_angle(Vec3::unit_z, 45.0f));
+    REQUIRE(pose[1] == Quat::from_axis_angle(Vec3::unit_x, 60.0f));
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "tests/helpers.hpp"
+
+#include "brasstacks/math/batch.hpp"
+
+#include <vector>
+
+using namespace btx::math;
+
+TEST_CASE("Batched transforms", "[batch][matrices]") {
+    Mat4 const m {
+        random_vec4(), random_vec4(), random_vec4(), random_vec4(),
+    };
+
+    for(auto const size : BATCH_SIZES) {
+        auto v = random_vectors<Vec4>(size);
+
+        std::vector<Vec4> out(size);
+        transform(m, v, out);
+
+        for(std::size_t i = 0u; i < size; ++i) {
+            REQUIRE(out[i] == m * v[i]);
+        }
+
+        // Transforming in place
+        transform(m, v, v);
+        REQUIRE(v == out);
+    }
+}
+
+TEST_CASE("Batched point transforms", "[batch][matrices]") {
+    Mat4 const m {
+        random_vec4(), random_vec4(), random_vec4(), random_vec4(),
+    };
+
+    for(auto const size : BATCH_SIZES) {
+        auto v = random_vectors<Vec3>(size);
+
+        std::vector<Vec3> out(size);
+        transform_points(m, v, out);
+
+        for(std::size_t i = 0u; i < size; ++i) {
+            Vec4 const expected = m * Vec4(v[i].x, v[i].y, v[i].z, 1.0f);
+            REQUIRE(out[i] == Vec3(expected.x, expected.y, expected.z));
+        }
+
+        transform_points(m, v, v);
+        REQUIRE(v == out);
+    }
+}
+
+TEST_CASE("Batched vertex transforms", "[batch][matrices][examples]") {
+    // Move a triangle's points over by 2 along x
+    Mat4 translate = Mat4::identity;
+    translate.w = Vec4(2.0f, 0.0f, 0.0f, 1.0f);
+
+    std::vector<Vec4> const points {
+        Vec4(0.0f, 0.0f, 0.0f, 1.0f),
+        Vec4(1.0f, 0.0f, 0.0f, 1.0f),
+        Vec4(0.0f, 1.0f, 0.0f, 1.0f),
+    };
+
+    std::vector<Vec4> moved(points.size());
+    transform(translate, points, moved);
+
+    REQUIRE(moved[0] == Vec4(2.0f, 0.0f, 0.0f, 1.0f));
+    REQUIRE(moved[1] == Vec4(3.0f, 0.0f, 0.0f, 1.0f));
+    REQUIRE(moved[2] == Vec4(2.0f, 1.0f, 0.0f, 1.0f));
+}
\ No newline at end of file
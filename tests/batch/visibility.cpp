@@ -0,0 +1,98 @@
+#include "tests/helpers.hpp"
+
+#include "brasstacks/math/batch.hpp"
+
+#include <optional>
+#include <vector>
+
+using namespace btx::math;
+using namespace Catch::Matchers;
+
+namespace {
+
+// The test from the vision cone example, with the cosine of the angle
+// between forward and the target, or nothing when the target is too close to
+// the edge of the cone for rounding to settle which side it's on
+std::optional<bool> reference_visible(ViewCone const &cone,
+                                      Vec3 const &target)
+{
+    Vec3 const to_target = target - cone.position;
+    if(length_squared(to_target) < epsilon) {
+        return true;
+    }
+
+    float const cos_angle = dot(normalize(cone.forward),
+                                normalize(to_target));
+    float const cos_half_fov = std::cos(radians(cone.half_fov));
+
+    if(std::abs(cos_angle - cos_half_fov) < 1.0e-3f) {
+        return std::nullopt;
+    }
+
+    return cos_angle >= cos_half_fov;
+}
+
+} // namespace
+
+TEST_CASE("Batched vision cone queries", "[batch][visibility]") {
+    for(float const half_fov : { 5.0f, 45.0f, 75.0f, 90.0f, 120.0f, 179.0f }) {
+        ViewCone const cone {
+            random_vec3(), random_vec3(-1.0f, 1.0f) * 3.0f, half_fov
+        };
+
+        for(auto const size : LONG_BATCH_SIZES) {
+            auto const targets = random_vectors<Vec3>(size);
+
+            std::vector<uint32_t> indices(size);
+            std::size_t const visible =
+                visible_indices(cone, targets, indices);
+            indices.resize(visible);
+
+            std::vector<uint64_t> mask((size + 63u) / 64u, ~uint64_t { 0u });
+            visible_mask(cone, targets, mask);
+
+            // Indices come out in order, and match the mask
+            std::size_t next = 0u;
+            for(std::size_t i = 0u; i < size; ++i) {
+                bool const listed = next < visible && indices[next] == i;
+                REQUIRE(listed == mask_bit(mask, i));
+                next += listed ? 1u : 0u;
+
+                auto const expected = reference_visible(cone, targets[i]);
+                if(expected.has_value()) {
+                    REQUIRE(listed == *expected);
+                }
+            }
+            REQUIRE(next == visible);
+
+            // Bits past the end are cleared
+            if(size % 64u != 0u) {
+                REQUIRE((mask.back() >> (size % 64u)) == 0u);
+            }
+        }
+    }
+}
+
+TEST_CASE("Batched NPC vision cone", "[batch][visibility][examples]") {
+    // The same NPC as the vision cone example, at the origin looking up the
+    // Y axis with a 150-degree field of view
+    ViewCone const npc { Vec3::zero, Vec3::unit_y, 150.0f / 2.0f };
+
+    std::vector<Vec3> const players {
+        Vec3(1.0f, 1.0f, 0.0f),     // Up and to the right
+        Vec3::unit_x,               // Directly right
+        Vec3(-1.0f, 1.0f, 0.0f),    // Up and to the left
+        -Vec3::unit_y,              // Directly behind
+        Vec3(0.0f, 10.0f, 0.0f),    // Far ahead
+    };
+
+    std::vector<uint32_t> seen(players.size());
+    seen.resize(visible_indices(npc, players, seen));
+    REQUIRE(seen == std::vector<uint32_t> { 0u, 2u, 4u });
+
+    // Everything in front, including what's exactly level with the NPC
+    ViewCone const facing { Vec3::zero, Vec3::unit_y, 90.0f };
+    std::vector<uint64_t> in_front(1u);
+    visible_mask(facing, players, in_front);
+    REQUIRE(in_front[0] == 0b10111u);
+}
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include "tests/helpers.hpp"
+
+#include "brasstacks/math/AABB.hpp"
+
+#include <sstream>
+
+using namespace btx::math;
+using namespace Catch::Matchers;
+
+namespace {
+
+AABB const unit_box { Vec3::zero, Vec3(1.0f, 1.0f, 1.0f) };
+
+} // namespace
+
+TEST_CASE("Box structure", "[geometry][AABB]") {
+    REQUIRE(is_empty(AABB::empty));
+    REQUIRE_FALSE(is_empty(unit_box));
+    REQUIRE_THAT(surface_area(AABB::empty), WithinAbs(0.0f, epsilon));
+
+    // A single point is a box too
+    AABB const point { Vec3::unit_x, Vec3::unit_x };
+    REQUIRE_FALSE(is_empty(point));
+    REQUIRE(contains(point, Vec3::unit_x));
+
+    AABB const box { Vec3(-1.0f, 0.0f, 2.0f), Vec3(3.0f, 2.0f, 3.0f) };
+    REQUIRE(center(box) == Vec3(1.0f, 1.0f, 2.5f));
+    REQUIRE(extent(box) == Vec3(4.0f, 2.0f, 1.0f));
+    REQUIRE_THAT(surface_area(box), WithinAbs(28.0f, epsilon));
+
+    std::ostringstream out;
+    out << box;
+    REQUIRE(out.str().find(" to ") != std::string::npos);
+}
+
+TEST_CASE("Box union and intersection", "[geometry][AABB]") {
+    AABB const a { Vec3::zero, Vec3(2.0f, 2.0f, 2.0f) };
+    AABB const b { Vec3(1.0f, -1.0f, 1.0f), Vec3(3.0f, 1.0f, 4.0f) };
+
+    AABB const both = merge(a, b);
+    REQUIRE(both.min == Vec3(0.0f, -1.0f, 0.0f));
+    REQUIRE(both.max == Vec3(3.0f, 2.0f, 4.0f));
+    REQUIRE(contains(both, a));
+    REQUIRE(contains(both, b));
+
+    AABB const shared = intersection(a, b);
+    REQUIRE(shared.min == Vec3(1.0f, 0.0f, 1.0f));
+    REQUIRE(shared.max == Vec3(2.0f, 1.0f, 2.0f));
+
+    // Merging into the empty box gives back what was merged
+    AABB grown = AABB::empty;
+    for(uint32_t i = 0u; i < TEST_REPEATS; ++i) {
+        Vec3 const p = random_vec3();
+        AABB const before = grown;
+        grown = merge(grown, p);
+        REQUIRE(contains(grown, p));
+        REQUIRE(contains(grown, before));
+    }
+    REQUIRE(merge(AABB::empty, unit_box).min == unit_box.min);
+    REQUIRE(merge(AABB::empty, unit_box).max == unit_box.max);
+
+    // Disjoint boxes don't intersect
+    AABB const far { Vec3(5.0f, 5.0f, 5.0f), Vec3(6.0f, 6.0f, 6.0f) };
+    REQUIRE(is_empty(intersection(a, far)));
+}
+
+TEST_CASE("Box tests", "[geometry][AABB]") {
+    // Boxes are closed, so touching counts
+    AABB const touching { Vec3::unit_x, Vec3(2.0f, 1.0f, 1.0f) };
+    AABB const apart { Vec3(1.5f, 0.0f, 0.0f), Vec3(2.0f, 1.0f, 1.0f) };
+    REQUIRE(overlaps(unit_box, touching));
+    REQUIRE(overlaps(touching, unit_box));
+    REQUIRE_FALSE(overlaps(unit_box, apart));
+    REQUIRE(overlaps(unit_box, unit_box));
+    REQUIRE_FALSE(overlaps(unit_box, AABB::empty));
+
+    REQUIRE(contains(unit_box, Vec3(0.5f, 0.5f, 0.5f)));
+    REQUIRE(contains(unit_box, Vec3(1.0f, 0.0f, 1.0f)));
+    REQUIRE_FALSE(contains(unit_box, Vec3(0.5f, 1.5f, 0.5f)));
+
+    AABB const inner { Vec3(0.25f, 0.25f, 0.25f), Vec3(0.5f, 1.0f, 0.5f) };
+    REQUIRE(contains(unit_box, inner));
+    REQUIRE_FALSE(contains(inner, unit_box));
+}
+
+TEST_CASE("Ray and box intersection", "[geometry][AABB]") {
+    // Straight down the x axis, toward the box from outside
+    Ray const along_x { Vec3(-2.0f, 0.5f, 0.5f), Vec3::unit_x };
+    auto hit = intersect(along_x, unit_box);
+    REQUIRE(hit.has_value());
+    REQUIRE_THAT(*hit, WithinAbs(2.0f, epsilon));
+
+    // Too short to reach it
+    REQUIRE_FALSE(intersect(along_x, unit_box, 1.5f).has_value());
+
+    // Pointing away
+    Ray const away { along_x.origin, -Vec3::unit_x };
+    REQUIRE_FALSE(intersect(away, unit_box).has_value());
+
+    // Starting inside
+    Ray const inside { Vec3(0.5f, 0.5f, 0.5f), Vec3(1.0f, -2.0f, 0.5f) };
+    hit = intersect(inside, unit_box);
+    REQUIRE(hit.has_value());
+    REQUIRE_THAT(*hit, WithinAbs(0.0f, epsilon));
+
+    // Parallel to the y faces, but outside them
+    Ray const parallel { Vec3(-2.0f, 1.5f, 0.5f), Vec3::unit_x };
+    REQUIRE_FALSE(intersect(parallel, unit_box).has_value());
+
+    // Distances are in multiples of the direction
+    Ray const diagonal { Vec3(-1.0f, -1.0f, -1.0f), Vec3(2.0f, 2.0f, 2.0f) };
+    hit = intersect(diagonal, unit_box);
+    REQUIRE(hit.has_value());
+    REQUIRE_THAT(*hit, WithinAbs(0.5f, epsilon));
+
+    // Grazing an edge still counts
+    Ray const grazing { Vec3(-1.0f, 1.0f, 1.0f), Vec3::unit_x };
+    REQUIRE(intersect(grazing, unit_box).has_value());
+}
+
+#if defined(BTX_MATH_HEADER_ONLY)
+TEST_CASE("Boxes at compile time", "[geometry][AABB][constexpr]") {
+    constexpr AABB box { Vec3::zero, Vec3(2.0f, 2.0f, 2.0f) };
+    constexpr AABB other { Vec3::unit_x, Vec3(3.0f, 3.0f, 3.0f) };
+    constexpr Ray ray { Vec3(-1.0f, 1.0f, 1.0f), Vec3::unit_x };
+
+    STATIC_REQUIRE(contains(box, Vec3(1.0f, 1.0f, 1.0f)));
+    STATIC_REQUIRE(overlaps(box, other));
+    STATIC_REQUIRE(surface_area(box) == 24.0f);
+    STATIC_REQUIRE(*intersect(ray, box) == 1.0f);
+}
+#endif
\ No newline at end of file
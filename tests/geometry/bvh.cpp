@@ -0,0 +1,232 @@
+#include "tests/helpers.hpp"
+
+#include "brasstacks/math/Arena.hpp"
+#include "brasstacks/math/BVH.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace btx::math;
+using namespace Catch::Matchers;
+
+static std::size_t constexpr BVH_SIZES[] = { 0u, 1u, 2u, 5u, 17u, 300u };
+
+namespace {
+
+std::vector<AABB> random_boxes(std::size_t const count) {
+    std::vector<AABB> boxes(count);
+    for(auto &box : boxes) {
+        Vec3 const corner = random_vec3(-20.0f, 20.0f);
+        box = { corner, corner + random_vec3(0.0f, 3.0f) };
+    }
+    return boxes;
+}
+
+Ray random_ray() {
+    Vec3 direction = random_vec3(-1.0f, 1.0f);
+    while(length_squared(direction) < epsilon) {
+        direction = random_vec3(-1.0f, 1.0f);
+    }
+    return { random_vec3(-30.0f, 30.0f), normalize(direction) };
+}
+
+// The nearest hit by testing every box
+BVH::RayHit brute_force(std::vector<AABB> const &boxes, Ray const &ray) {
+    BVH::RayHit hit;
+    for(std::size_t i = 0u; i < boxes.size(); ++i) {
+        auto const distance = intersect(ray, boxes[i]);
+        if(distance.has_value() && *distance < hit.distance) {
+            hit = { static_cast<uint32_t>(i), *distance };
+        }
+    }
+    return hit;
+}
+
+std::vector<uint32_t> brute_force(std::vector<AABB> const &boxes,
+                                  AABB const &query)
+{
+    std::vector<uint32_t> found;
+    for(std::size_t i = 0u; i < boxes.size(); ++i) {
+        if(overlaps(boxes[i], query)) {
+            found.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    return found;
+}
+
+} // namespace
+
+TEST_CASE("BVH structure", "[geometry][BVH]") {
+    for(auto const size : BVH_SIZES) {
+        auto const boxes = random_boxes(size);
+        BVH const bvh { boxes };
+
+        REQUIRE(bvh.size() == size);
+        REQUIRE(bvh.indices().size() == size);
+
+        if(size == 0u) {
+            REQUIRE(bvh.empty());
+            REQUIRE(is_empty(bvh.bounds()));
+            continue;
+        }
+
+        // Every box appears in exactly one leaf, and every node holds
+        // whatever is below it
+        std::vector<uint32_t> seen(size, 0u);
+        auto const nodes = bvh.nodes();
+        for(auto const &node : nodes) {
+            if(node.count > 0u) {
+                for(uint32_t i = node.first; i < node.first + node.count; ++i)
+                {
+                    uint32_t const index = bvh.indices()[i];
+                    ++seen[index];
+                    REQUIRE(contains(node.bounds, boxes[index]));
+                }
+            }
+            else {
+                REQUIRE(node.first + 1u < nodes.size());
+                REQUIRE(contains(node.bounds, nodes[node.first].bounds));
+                REQUIRE(contains(node.bounds, nodes[node.first + 1u].bounds));
+            }
+        }
+
+        REQUIRE(std::all_of(seen.begin(), seen.end(),
+                            [](uint32_t const n) { return n == 1u; }));
+        REQUIRE(nodes.size() < 2u * size);
+    }
+
+    // Boxes sharing a center can't be split, however many there are
+    std::vector<AABB> const stacked(10u, AABB { Vec3::zero, Vec3::unit_x });
+    BVH const bvh { stacked };
+    REQUIRE(bvh.nodes().size() == 1u);
+    REQUIRE(bvh.nodes()[0].count == 10u);
+}
+
+TEST_CASE("BVH scratch memory", "[geometry][BVH][arena]") {
+    auto const boxes = random_boxes(300u);
+    BVH const heap { boxes };
+
+    // The build's working arrays in an arena, and nothing of it left in the
+    // result
+    Arena arena { 1u << 16u };
+    ArenaResource scratch { arena, std::pmr::null_memory_resource() };
+    BVH built { boxes, BVH::default_max_leaf_size, &scratch };
+    REQUIRE(arena.peak() > 0u);
+    arena.reset();
+
+    REQUIRE(built.nodes().size() == heap.nodes().size());
+    REQUIRE(std::equal(built.indices().begin(), built.indices().end(),
+                       heap.indices().begin(), heap.indices().end()));
+    for(std::size_t i = 0u; i < heap.nodes().size(); ++i) {
+        REQUIRE(built.nodes()[i].first == heap.nodes()[i].first);
+        REQUIRE(built.nodes()[i].count == heap.nodes()[i].count);
+    }
+}
+
+TEST_CASE("BVH ray queries", "[geometry][BVH]") {
+    for(auto const size : BVH_SIZES) {
+        auto const boxes = random_boxes(size);
+
+        for(uint32_t const leaf_size : { 1u, 4u, 16u }) {
+            BVH const bvh { boxes, leaf_size };
+
+            std::vector<Ray> rays(64u);
+            for(auto &ray : rays) {
+                ray = random_ray();
+            }
+            // Straight down an axis, so one direction component is zero
+            rays[0] = { Vec3(-30.0f, 1.0f, 1.0f), Vec3::unit_x };
+
+            std::vector<BVH::RayHit> hits(rays.size());
+            bvh.intersect(rays, hits);
+
+            for(std::size_t i = 0u; i < rays.size(); ++i) {
+                auto const expected = brute_force(boxes, rays[i]);
+                REQUIRE(hits[i].index == bvh.intersect(rays[i]).index);
+
+                if(expected.index == BVH::RayHit::none) {
+                    REQUIRE(hits[i].index == BVH::RayHit::none);
+                    continue;
+                }
+
+                // Ties between boxes may go either way, but the distance
+                // can't
+                REQUIRE(hits[i].index != BVH::RayHit::none);
+                REQUIRE_THAT(hits[i].distance,
+                             WithinAbs(expected.distance, 1.0e-5f));
+                REQUIRE_THAT(*intersect(rays[i], boxes[hits[i].index]),
+                             WithinAbs(expected.distance, 1.0e-5f));
+            }
+
+            // Nothing past max_distance
+            for(auto const &ray : rays) {
+                auto const hit = bvh.intersect(ray, 5.0f);
+                if(hit.index != BVH::RayHit::none) {
+                    REQUIRE(hit.distance <= 5.0f);
+                }
+            }
+
+            // Split across threads
+            ThreadPool pool(3u);
+            std::vector<BVH::RayHit> parallel_hits(rays.size());
+            bvh.intersect(Parallel { 5u, &pool }, rays, parallel_hits);
+            for(std::size_t i = 0u; i < rays.size(); ++i) {
+                REQUIRE(parallel_hits[i].index == hits[i].index);
+            }
+        }
+    }
+}
+
+TEST_CASE("BVH box queries", "[geometry][BVH]") {
+    for(auto const size : BVH_SIZES) {
+        auto const boxes = random_boxes(size);
+        BVH const bvh { boxes };
+
+        std::vector<AABB> queries(20u);
+        for(auto &query : queries) {
+            Vec3 const corner = random_vec3(-25.0f, 25.0f);
+            query = { corner, corner + random_vec3(0.0f, 10.0f) };
+        }
+
+        std::vector<uint32_t> found;
+        std::vector<std::size_t> offsets(queries.size() + 1u);
+        bvh.overlapping(queries, found, offsets);
+
+        for(std::size_t i = 0u; i < queries.size(); ++i) {
+            std::vector<uint32_t> single;
+            bvh.overlapping(queries[i], single);
+            std::sort(single.begin(), single.end());
+            REQUIRE(single == brute_force(boxes, queries[i]));
+
+            std::vector<uint32_t> batched(found.begin() + offsets[i],
+                                          found.begin() + offsets[i + 1u]);
+            std::sort(batched.begin(), batched.end());
+            REQUIRE(batched == single);
+        }
+    }
+}
+
+TEST_CASE("Picking with a BVH", "[geometry][BVH][examples]") {
+    // A row of crates along x, and a click that fires a ray down the row
+    std::vector<AABB> crates;
+    for(uint32_t i = 0u; i < 10u; ++i) {
+        Vec3 const corner(static_cast<float>(i) * 2.0f, 0.0f, 0.0f);
+        crates.push_back({ corner, corner + Vec3(1.0f, 1.0f, 1.0f) });
+    }
+    BVH const scene { crates };
+
+    Ray const from_left { Vec3(-5.0f, 0.5f, 0.5f), Vec3::unit_x };
+    BVH::RayHit const hit = scene.intersect(from_left);
+    REQUIRE(hit.index == 0u);
+    REQUIRE_THAT(hit.distance, WithinAbs(5.0f, epsilon));
+
+    Ray const from_right { Vec3(30.0f, 0.5f, 0.5f), -Vec3::unit_x };
+    REQUIRE(scene.intersect(from_right).index == 9u);
+
+    // Everything under a selection rectangle
+    std::vector<uint32_t> selected;
+    scene.overlapping({ Vec3(3.5f, 0.0f, 0.0f), Vec3(8.5f, 1.0f, 1.0f) },
+                      selected);
+    std::sort(selected.begin(), selected.end());
+    REQUIRE(selected == std::vector<uint32_t> { 2u, 3u, 4u });
+}
\ No newline at end of file
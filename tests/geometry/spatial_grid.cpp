@@ -0,0 +1,180 @@
+#include "tests/helpers.hpp"
+
+#include "brasstacks/math/SpatialGrid.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace btx::math;
+using namespace Catch::Matchers;
+
+static std::size_t constexpr GRID_SIZES[] = { 0u, 1u, 7u, 100u, 1000u };
+
+namespace {
+
+template <typename Vector>
+std::vector<uint32_t> brute_force_within(std::vector<Vector> const &positions,
+                                         Vector const &p, float const radius)
+{
+    std::vector<uint32_t> found;
+    for(std::size_t i = 0u; i < positions.size(); ++i) {
+        if(length_squared(positions[i] - p) <= radius * radius) {
+            found.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    return found;
+}
+
+// Every distance to p, sorted
+template <typename Vector>
+std::vector<float> brute_force_distances(std::vector<Vector> const &positions,
+                                         Vector const &p)
+{
+    std::vector<float> distances;
+    for(auto const &position : positions) {
+        distances.push_back(length_squared(position - p));
+    }
+    std::sort(distances.begin(), distances.end());
+    return distances;
+}
+
+template <typename Vector, typename Generator>
+void check_queries(Generator generate) {
+    for(auto const count : GRID_SIZES) {
+        auto const positions = random_vectors<Vector>(count, -20.0f, 20.0f);
+
+        for(float const cell_size : { 0.5f, 3.0f, 50.0f }) {
+            SpatialGrid<Vector> grid { cell_size };
+            grid.build(positions);
+            REQUIRE(grid.size() == count);
+
+            for(uint32_t i = 0u; i < 20u; ++i) {
+                // Some queries from well outside the positions
+                Vector const p = generate(-30.0f, 30.0f);
+
+                for(float const radius : { 0.0f, 1.0f, 4.0f, 100.0f }) {
+                    std::vector<uint32_t> found;
+                    grid.within(p, radius, found);
+                    std::sort(found.begin(), found.end());
+                    REQUIRE(found == brute_force_within(positions, p, radius));
+                }
+
+                auto const distances = brute_force_distances(positions, p);
+                std::vector<typename SpatialGrid<Vector>::Neighbor>
+                    nearest(5u);
+
+                std::size_t const n = grid.nearest(p, nearest);
+                REQUIRE(n == std::min<std::size_t>(5u, count));
+                for(std::size_t j = 0u; j < n; ++j) {
+                    REQUIRE(nearest[j].distance_squared == distances[j]);
+                    REQUIRE(length_squared(positions[nearest[j].index] - p)
+                            == distances[j]);
+                }
+
+                // Limited to a distance
+                std::size_t const expected = static_cast<std::size_t>(
+                    std::upper_bound(distances.begin(), distances.end(),
+                                     4.0f * 4.0f) - distances.begin());
+                REQUIRE(grid.nearest(p, nearest, 4.0f)
+                        == std::min<std::size_t>(5u, expected));
+            }
+        }
+    }
+}
+
+} // namespace
+
+TEST_CASE("Spatial grid queries in 2D", "[geometry][SpatialGrid]") {
+    check_queries<Vec2>(random_vec2);
+}
+
+TEST_CASE("Spatial grid queries in 3D", "[geometry][SpatialGrid]") {
+    check_queries<Vec3>(random_vec3);
+}
+
+TEST_CASE("Spatial grid rebuilds", "[geometry][SpatialGrid]") {
+    // A few buckets for many cells, so every bucket mixes cells
+    SpatialGrid3 grid { 1.0f, 4u };
+    REQUIRE(grid.empty());
+
+    auto positions = random_vectors<Vec3>(500u, -20.0f, 20.0f);
+    grid.build(positions);
+    REQUIRE(grid.bucket_count() == 4u);
+
+    // Move everything and rebuild in place, as a simulation would each frame
+    for(auto &p : positions) {
+        p += Vec3(0.5f, -0.25f, 0.125f);
+    }
+    grid.build(positions);
+
+    Vec3 const p = positions[0];
+    std::vector<uint32_t> found;
+    grid.within(p, 2.0f, found);
+    std::sort(found.begin(), found.end());
+    REQUIRE(found == brute_force_within(positions, p, 2.0f));
+
+    // Coinciding positions are all found
+    std::vector<Vec3> const stacked(10u, Vec3::unit_x);
+    grid.build(stacked);
+    found.clear();
+    grid.within(Vec3::zero, 1.0f, found);
+    REQUIRE(found.size() == 10u);
+
+    grid.build({ });
+    REQUIRE(grid.empty());
+    found.clear();
+    grid.within(Vec3::zero, 100.0f, found);
+    REQUIRE(found.empty());
+}
+
+TEST_CASE("Spatial grid with a distant outlier", "[geometry][SpatialGrid]") {
+    // Every ring out to the outlier would be searched, one cell wider each
+    // time, without the fallback to testing every position
+    auto positions = random_vectors<Vec3>(100u, -2.0f, 2.0f);
+    positions.push_back(Vec3(800.0f, 800.0f, 800.0f));
+
+    SpatialGrid3 grid { 1.0f };
+    grid.build(positions);
+
+    Vec3 const p = random_vec3(-1.0f, 1.0f);
+    auto const distances = brute_force_distances(positions, p);
+    std::vector<SpatialGrid3::Neighbor> nearest(positions.size());
+
+    REQUIRE(grid.nearest(p, nearest) == positions.size());
+    for(std::size_t i = 0u; i < nearest.size(); ++i) {
+        REQUIRE(nearest[i].distance_squared == distances[i]);
+    }
+    REQUIRE(nearest.back().index == 100u);
+
+    // And from beside the outlier, back across the gap
+    Vec3 const far { 799.0f, 799.0f, 799.0f };
+    auto const far_distances = brute_force_distances(positions, far);
+    std::array<SpatialGrid3::Neighbor, 2> closest;
+
+    REQUIRE(grid.nearest(far, closest) == 2u);
+    REQUIRE(closest[0].index == 100u);
+    REQUIRE(closest[1].distance_squared == far_distances[1]);
+}
+
+TEST_CASE("Agent neighbors with a spatial grid",
+          "[geometry][SpatialGrid][examples]")
+{
+    // Agents on a plane, each steering away from anyone within 2 units
+    std::vector<Vec2> const agents {
+        { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 10.0f, 10.0f }, { 0.0f, 1.5f },
+    };
+
+    SpatialGrid2 grid { 2.0f };
+    grid.build(agents);
+
+    std::vector<uint32_t> neighbors;
+    grid.within(agents[0], 2.0f, neighbors);
+    std::sort(neighbors.begin(), neighbors.end());
+    REQUIRE(neighbors == std::vector<uint32_t> { 0u, 1u, 3u });
+
+    // The closest other agent to the one off on its own
+    std::array<SpatialGrid2::Neighbor, 2> closest;
+    REQUIRE(grid.nearest(agents[2], closest) == 2u);
+    REQUIRE(closest[0].index == 2u);
+    REQUIRE(closest[1].index == 3u);
+}
\ No newline at end of file
@@ -7,8 +7,44 @@
 
 #include "brasstacks/math/math.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
+
 static uint32_t constexpr TEST_REPEATS = 10u;
 
+// Sizes on either side of the SIMD width, so both the vector loop and the
+// scalar tail get exercised
+static std::array<std::size_t, 7u> constexpr BATCH_SIZES = {
+    0u, 1u, 3u, 4u, 5u, 8u, 31u
+};
+
+// BATCH_SIZES followed by extra, for tests that need longer batches as well
+template <std::size_t N>
+consteval auto batch_sizes_and(std::size_t const (&extra)[N]) {
+    std::array<std::size_t, BATCH_SIZES.size() + N> sizes { };
+    std::copy(BATCH_SIZES.begin(), BATCH_SIZES.end(), sizes.begin());
+    std::copy_n(extra, N, sizes.begin() + BATCH_SIZES.size());
+    return sizes;
+}
+
+// BATCH_SIZES plus batches that span many blocks, one just past a whole 64
+static auto constexpr LONG_BATCH_SIZES = batch_sizes_and({ 64u, 65u, 200u });
+
+// Bit i of a mask with 64 vectors to each word, as the batch queries fill in
+inline bool mask_bit(std::vector<uint64_t> const &mask, std::size_t const i) {
+    return ((mask[i / 64u] >> (i % 64u)) & 1u) != 0u;
+}
+
+// Vector's operator== allows for rounding error, but results that should be
+// identical have to agree down to the last bit
+template <typename T>
+bool same_bits(std::vector<T> const &a, std::vector<T> const &b) {
+    return a.size() == b.size()
+        && std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+}
+
 inline auto random_vec2(float const min = -10.0f, float const max = 10.0f) {
     return btx::math::Vec2(
         Catch::Generators::random(min, max).get(),
@@ -33,4 +69,39 @@ inline auto random_vec4(float const min = -10.0f, float const max = 10.0f) {
     );
 }
 
+// count random vectors of the given type, each component in [min, max]
+template <typename Vector>
+std::vector<Vector> random_vectors(std::size_t const count,
+                                   float const min = -10.0f,
+                                   float const max = 10.0f)
+{
+    std::vector<Vector> result(count);
+    for(auto &v : result) {
+        if constexpr(std::is_same_v<Vector, btx::math::Vec2>) {
+            v = random_vec2(min, max);
+        }
+        else if constexpr(std::is_same_v<Vector, btx::math::Vec3>) {
+            v = random_vec3(min, max);
+        }
+        else {
+            static_assert(std::is_same_v<Vector, btx::math::Vec4>);
+            v = random_vec4(min, max);
+        }
+    }
+
+    return result;
+}
+
+// A random unit quaternion, from a random axis and angle
+inline auto random_quat() {
+    btx::math::Vec3 axis = random_vec3(-1.0f, 1.0f);
+    while(btx::math::length_squared(axis) < btx::math::epsilon) {
+        axis = random_vec3(-1.0f, 1.0f);
+    }
+
+    return btx::math::Quat::from_axis_angle(
+        axis, Catch::Generators::random(-180.0f, 180.0f).get()
+    );
+}
+
 #endif // BRASSTACKS_MATH_TESTS_HELPERS_HPP
\ No newline at end of file
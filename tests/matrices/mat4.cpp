@@ -0,0 +1,181 @@
+#include "tests/helpers.hpp"
+
+#include <sstream>
+
+using namespace btx::math;
+using namespace Catch::Matchers;
+
+namespace {
+
+// Random entries with a heavy diagonal, which keeps the matrix comfortably
+// invertible
+Mat4 random_mat4() {
+    Mat4 m {
+        random_vec4(-1.0f, 1.0f), random_vec4(-1.0f, 1.0f),
+        random_vec4(-1.0f, 1.0f), random_vec4(-1.0f, 1.0f),
+    };
+
+    for(uint8_t i = 0u; i < 4u; ++i) {
+        m[i][i] += 4.0f;
+    }
+
+    return m;
+}
+
+// Rotation, scale, and shear in the upper 3x3, plus a translation
+Mat4 random_affine() {
+    Mat4 m = random_mat4();
+    m.x.w = 0.0f;
+    m.y.w = 0.0f;
+    m.z.w = 0.0f;
+    m.w = Vec4(random_vec3().x, random_vec3().y, random_vec3().z, 1.0f);
+    return m;
+}
+
+} // namespace
+
+TEST_CASE("Matrix structure", "[matrices][Mat4]") {
+    Mat4 m; // Default constructor
+    for(uint8_t c = 0u; c < 4u; ++c) {
+        REQUIRE(m[c] == Vec4::zero);
+    }
+
+    // Columns by name and by index are the same thing
+    m.y = Vec4(1.0f, 2.0f, 3.0f, 4.0f);
+    REQUIRE(m[1] == m.y);
+
+    m[3][0] = 5.0f;
+    REQUIRE_THAT(m.w.x, WithinAbs(5.0f, epsilon));
+
+    REQUIRE(Mat4::identity.x == Vec4::unit_x);
+    REQUIRE(Mat4::identity.y == Vec4::unit_y);
+    REQUIRE(Mat4::identity.z == Vec4::unit_z);
+    REQUIRE(Mat4::identity.w == Vec4::unit_w);
+    REQUIRE(Mat4::identity != Mat4::zero);
+}
+
+TEST_CASE("Matrix arithmetic", "[matrices][Mat4]") {
+    for(uint32_t i = 0u; i < TEST_REPEATS; ++i) {
+        Mat4 const a = random_mat4();
+        Mat4 const b = random_mat4();
+
+        Mat4 const sum = a + b;
+        Mat4 const difference = a - b;
+        for(uint8_t c = 0u; c < 4u; ++c) {
+            REQUIRE(sum[c] == a[c] + b[c]);
+            REQUIRE(difference[c] == a[c] - b[c]);
+            REQUIRE((2.0f * a)[c] == a[c] * 2.0f);
+        }
+
+        Mat4 c = a;
+        c += b;
+        REQUIRE(c == sum);
+        c -= b;
+        REQUIRE(c == a);
+    }
+}
+
+TEST_CASE("Matrix-vector multiply", "[matrices][Mat4]") {
+    Vec4 const v(1.0f, 2.0f, 3.0f, 1.0f);
+
+    REQUIRE(Mat4::identity * v == v);
+    REQUIRE(Mat4::zero * v == Vec4::zero);
+
+    // A translation moves points, but not directions
+    Mat4 translate = Mat4::identity;
+    translate.w = Vec4(10.0f, -20.0f, 30.0f, 1.0f);
+    REQUIRE(translate * v == Vec4(11.0f, -18.0f, 33.0f, 1.0f));
+    REQUIRE(translate * Vec4::unit_x == Vec4::unit_x);
+
+    // Each component of the result is a row dotted with v
+    for(uint32_t i = 0u; i < TEST_REPEATS; ++i) {
+        Mat4 const m = random_mat4();
+        Vec4 const u = random_vec4();
+        Vec4 const result = m * u;
+
+        for(uint8_t row = 0u; row < 4u; ++row) {
+            Vec4 const m_row(m.x[row], m.y[row], m.z[row], m.w[row]);
+            REQUIRE_THAT(result[row], WithinAbs(dot(m_row, u), 1.0e-3f));
+        }
+    }
+}
+
+TEST_CASE("Matrix-matrix multiply", "[matrices][Mat4]") {
+    for(uint32_t i = 0u; i < TEST_REPEATS; ++i) {
+        Mat4 const a = random_mat4();
+        Mat4 const b = random_mat4();
+        Vec4 const v = random_vec4(-1.0f, 1.0f);
+
+        REQUIRE(a * Mat4::identity == a);
+        REQUIRE(Mat4::identity * a == a);
+
+        // (a * b) * v applies b first
+        Vec4 const expected = a * (b * v);
+        Vec4 const actual = (a * b) * v;
+        for(uint8_t c = 0u; c < 4u; ++c) {
+            REQUIRE_THAT(actual[c], WithinAbs(expected[c], 1.0e-3f));
+        }
+
+        Mat4 c = a;
+        c *= b;
+        REQUIRE(c == a * b);
+    }
+}
+
+TEST_CASE("Matrix transpose", "[matrices][Mat4]") {
+    Mat4 const m {
+        Vec4(0.0f, 1.0f, 2.0f, 3.0f),
+        Vec4(4.0f, 5.0f, 6.0f, 7.0f),
+        Vec4(8.0f, 9.0f, 10.0f, 11.0f),
+        Vec4(12.0f, 13.0f, 14.0f, 15.0f),
+    };
+
+    Mat4 const t = transpose(m);
+    REQUIRE(t.x == Vec4(0.0f, 4.0f, 8.0f, 12.0f));
+    REQUIRE(t.y == Vec4(1.0f, 5.0f, 9.0f, 13.0f));
+    REQUIRE(t.z == Vec4(2.0f, 6.0f, 10.0f, 14.0f));
+    REQUIRE(t.w == Vec4(3.0f, 7.0f, 11.0f, 15.0f));
+
+    REQUIRE(transpose(t) == m);
+    REQUIRE(transpose(Mat4::identity) == Mat4::identity);
+}
+
+TEST_CASE("Matrix inverse", "[matrices][Mat4]") {
+    for(uint32_t i = 0u; i < TEST_REPEATS; ++i) {
+        Mat4 const m = random_mat4();
+        REQUIRE(m * inverse(m) == Mat4::identity);
+        REQUIRE(inverse(m) * m == Mat4::identity);
+
+        Mat4 const affine = random_affine();
+        REQUIRE(affine * inverse_affine(affine) == Mat4::identity);
+        REQUIRE(inverse_affine(affine) * affine == Mat4::identity);
+        REQUIRE(inverse(affine) == inverse_affine(affine));
+
+        // The last row stays 0, 0, 0, 1
+        Mat4 const inv = inverse_affine(affine);
+        REQUIRE(inv.x.w == 0.0f);
+        REQUIRE(inv.y.w == 0.0f);
+        REQUIRE(inv.z.w == 0.0f);
+        REQUIRE(inv.w.w == 1.0f);
+    }
+
+    REQUIRE(inverse(Mat4::identity) == Mat4::identity);
+
+    // Singular matrices have no inverse
+    REQUIRE(inverse(Mat4::zero) == Mat4::zero);
+
+    Mat4 flat = Mat4::identity;
+    flat.z = Vec4::zero;
+    REQUIRE(inverse_affine(flat) == Mat4::zero);
+
+    flat.w.w = 2.0f;
+    REQUIRE(inverse(flat) == Mat4::zero);
+}
+
+TEST_CASE("Matrix printing", "[matrices][Mat4]") {
+    std::ostringstream out;
+    out << Mat4::identity;
+
+    std::string const text = out.str();
+    REQUIRE(std::count(text.begin(), text.end(), '\n') == 3);
+}
\ No newline at end of file
@@ -0,0 +1,253 @@
+#include "tests/helpers.hpp"
+
+#include "brasstacks/math/parallel.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace btx::math;
+using namespace Catch::Matchers;
+
+// Not a multiple of any grain below, so the last task is always short
+static std::size_t constexpr PARALLEL_SIZE = 1000u;
+
+namespace {
+
+// The same for VecArrays, padding included
+template <typename Array>
+bool same_bits(Array const &a, Array const &b) {
+    return a.size() == b.size() && a.stride() == b.stride()
+        && std::memcmp(a.lane(0u), b.lane(0u),
+                       a.stride() * Array::components * sizeof(float)) == 0;
+}
+
+} // namespace
+
+TEST_CASE("Thread pool ranges", "[parallel]") {
+    for(std::size_t const threads : { 1u, 2u, 3u, 8u }) {
+        ThreadPool pool(threads);
+        REQUIRE(pool.size() == threads);
+
+        for(std::size_t const grain : { 1u, 7u, 64u, 5000u }) {
+            // Every element is visited exactly once, in ranges of grain.
+            // Catch's assertions aren't thread-safe, so the tasks only count.
+            std::vector<std::atomic<uint32_t>> visits(PARALLEL_SIZE);
+            std::atomic<std::size_t> ranges { 0u };
+            std::atomic<std::size_t> misaligned { 0u };
+
+            pool.for_each_range(PARALLEL_SIZE, grain,
+                [&](std::size_t const begin, std::size_t const end) {
+                    if(begin % grain != 0u ||
+                       (end - begin != grain && end != PARALLEL_SIZE))
+                    {
+                        misaligned.fetch_add(1u);
+                    }
+
+                    for(std::size_t i = begin; i < end; ++i) {
+                        visits[i].fetch_add(1u);
+                    }
+                    ranges.fetch_add(1u);
+                }
+            );
+
+            for(auto const &count : visits) {
+                REQUIRE(count.load() == 1u);
+            }
+            REQUIRE(ranges.load() == (PARALLEL_SIZE + grain - 1u) / grain);
+            REQUIRE(misaligned.load() == 0u);
+        }
+
+        // Nothing to do
+        bool called = false;
+        pool.for_each_range(0u, 16u,
+            [&](std::size_t, std::size_t) { called = true; });
+        REQUIRE_FALSE(called);
+    }
+
+    REQUIRE(default_thread_pool().size() >= 1u);
+}
+
+TEST_CASE("Nested thread pool calls", "[parallel]") {
+    ThreadPool pool(4u);
+
+    // A call from inside a task runs on that task's thread instead of
+    // waiting on the pool it's already part of
+    std::atomic<std::size_t> total { 0u };
+    pool.for_each_range(64u, 8u,
+        [&](std::size_t const begin, std::size_t const end) {
+            pool.for_each_range(end - begin, 2u,
+                [&](std::size_t const inner_begin,
+                    std::size_t const inner_end)
+                {
+                    total.fetch_add(inner_end - inner_begin);
+                }
+            );
+        }
+    );
+    REQUIRE(total.load() == 64u);
+
+    // As does a call from a second thread while the pool is busy
+    std::atomic<std::size_t> outside { 0u };
+    std::thread other([&] {
+        pool.for_each_range(PARALLEL_SIZE, 10u,
+            [&](std::size_t const begin, std::size_t const end) {
+                outside.fetch_add(end - begin);
+            }
+        );
+    });
+    pool.for_each_range(PARALLEL_SIZE, 10u,
+        [&](std::size_t const begin, std::size_t const end) {
+            total.fetch_add(end - begin);
+        }
+    );
+    other.join();
+
+    REQUIRE(outside.load() == PARALLEL_SIZE);
+    REQUIRE(total.load() == 64u + PARALLEL_SIZE);
+}
+
+TEST_CASE("Parallel batch kernels", "[parallel][batch]") {
+    auto const a3 = random_vectors<Vec3>(PARALLEL_SIZE);
+    auto const b3 = random_vectors<Vec3>(PARALLEL_SIZE);
+    auto const a4 = random_vectors<Vec4>(PARALLEL_SIZE);
+    auto const b4 = random_vectors<Vec4>(PARALLEL_SIZE);
+    Mat4 const m { a4[0], a4[1], a4[2], a4[3] };
+
+    std::vector<float> dot_expected(PARALLEL_SIZE);
+    dot(a3, b3, dot_expected);
+
+    std::vector<Vec3> normalize_expected(PARALLEL_SIZE);
+    normalize(a3, normalize_expected, Accuracy::fast);
+
+    std::vector<Vec4> transform_expected(PARALLEL_SIZE);
+    transform(m, b4, transform_expected);
+
+    ThreadPool pool(3u);
+    for(std::size_t const grain : { 1u, 33u, 256u, 4096u }) {
+        Parallel const policy { grain, &pool };
+
+        // Exactly what the single-threaded versions give
+        std::vector<float> dots(PARALLEL_SIZE);
+        dot(policy, a3, b3, dots);
+        REQUIRE(same_bits(dots, dot_expected));
+
+        std::vector<Vec3> normalized(PARALLEL_SIZE);
+        normalize(policy, a3, normalized, Accuracy::fast);
+        REQUIRE(same_bits(normalized, normalize_expected));
+
+        std::vector<Vec4> transformed(PARALLEL_SIZE);
+        transform(policy, m, b4, transformed);
+        REQUIRE(same_bits(transformed, transform_expected));
+
+        // In place
+        transformed = b4;
+        transform(policy, m, transformed, transformed);
+        REQUIRE(same_bits(transformed, transform_expected));
+    }
+
+    // The default pool
+    std::vector<float> dots(PARALLEL_SIZE);
+    dot(Parallel { 16u }, a3, b3, dots);
+    REQUIRE(same_bits(dots, dot_expected));
+}
+
+TEST_CASE("Parallel array kernels", "[parallel][arrays]") {
+    Vec3Array const a { random_vectors<Vec3>(PARALLEL_SIZE) };
+    Vec3Array const b { random_vectors<Vec3>(PARALLEL_SIZE) };
+
+    Vec3Array sum_expected { PARALLEL_SIZE };
+    add(a, b, sum_expected);
+
+    Vec3Array scaled_expected { PARALLEL_SIZE };
+    scale(a, -2.5f, scaled_expected);
+
+    std::vector<float> dot_expected(PARALLEL_SIZE);
+    dot(a, b, dot_expected);
+
+    Vec3Array normalize_expected { PARALLEL_SIZE };
+    normalize(a, normalize_expected);
+
+    ThreadPool pool(4u);
+    for(std::size_t const grain : { 1u, 16u, 100u, 4096u }) {
+        Parallel const policy { grain, &pool };
+
+        Vec3Array out { PARALLEL_SIZE };
+        add(policy, a, b, out);
+        REQUIRE(same_bits(out, sum_expected));
+
+        scale(policy, a, -2.5f, out);
+        REQUIRE(same_bits(out, scaled_expected));
+
+        normalize(policy, a, out);
+        REQUIRE(same_bits(out, normalize_expected));
+
+        std::vector<float> dots(PARALLEL_SIZE);
+        dot(policy, a, b, dots);
+        REQUIRE(same_bits(dots, dot_expected));
+    }
+}
+
+TEST_CASE("Parallel skinning", "[parallel][arrays]") {
+    std::vector<Mat4> palette(8u);
+    for(auto &bone : palette) {
+        bone = { random_vec4(-1.0f, 1.0f), random_vec4(-1.0f, 1.0f),
+                 random_vec4(-1.0f, 1.0f), random_vec4() };
+    }
+
+    std::vector<BoneIndices> bones(PARALLEL_SIZE);
+    std::vector<Vec4> weights(PARALLEL_SIZE);
+    for(std::size_t i = 0u; i < PARALLEL_SIZE; ++i) {
+        for(auto &bone : bones[i]) {
+            bone = static_cast<uint16_t>(
+                Catch::Generators::random(0, 7).get());
+        }
+        weights[i] = random_vec4(0.0f, 1.0f);
+    }
+
+    Vec4Array const w { weights };
+    Vec3Array const positions { random_vectors<Vec3>(PARALLEL_SIZE) };
+    Vec3Array const normals { random_vectors<Vec3>(PARALLEL_SIZE) };
+
+    Vec3Array positions_expected { PARALLEL_SIZE };
+    Vec3Array normals_expected { PARALLEL_SIZE };
+    skin(palette, bones, w, positions, normals, positions_expected,
+         normals_expected);
+
+    ThreadPool pool(4u);
+    for(std::size_t const grain : { 1u, 16u, 100u, 4096u }) {
+        Parallel const policy { grain, &pool };
+
+        Vec3Array out_positions { PARALLEL_SIZE };
+        Vec3Array out_normals { PARALLEL_SIZE };
+        skin(policy, palette, bones, w, positions, normals, out_positions,
+             out_normals);
+        REQUIRE(same_bits(out_positions, positions_expected));
+        REQUIRE(same_bits(out_normals, normals_expected));
+
+        skin(policy, palette, bones, w, positions, out_positions);
+        REQUIRE(same_bits(out_positions, positions_expected));
+    }
+}
+
+TEST_CASE("Parallel particle update", "[parallel][examples]") {
+    // A step of a particle system: move every particle along its velocity,
+    // on a pool of four threads
+    ThreadPool pool(4u);
+    Parallel const policy { 256u, &pool };
+
+    auto const start = random_vectors<Vec3>(PARALLEL_SIZE);
+    auto const velocity = random_vectors<Vec3>(PARALLEL_SIZE, -1.0f, 1.0f);
+
+    Vec3Array positions { start };
+    Vec3Array step { velocity };
+
+    float const dt = 1.0f / 60.0f;
+    scale(policy, step, dt, step);
+    add(policy, positions, step, positions);
+
+    for(std::size_t i = 0u; i < PARALLEL_SIZE; ++i) {
+        REQUIRE(positions[i] == start[i] + velocity[i] * dt);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,175 @@
+#include "tests/helpers.hpp"
+
+#include <sstream>
+
+using namespace btx::math;
+using namespace Catch::Matchers;
+
+namespace {
+
+// q * v * q^-1 written out with full quaternion products, which is what
+// rotate() is meant to match
+Vec3 rotate_by_products(Quat const &q, Vec3 const &v) {
+    Quat const p = q * Quat(v.x, v.y, v.z, 0.0f) * conjugate(q);
+    return { p.x, p.y, p.z };
+}
+
+// The same rotation, up to the sign ambiguity between q and -q
+bool same_rotation(Quat const &a, Quat const &b) {
+    return a == b || a == -b;
+}
+
+} // namespace
+
+TEST_CASE("Quaternion structure", "[quaternions][Quat]") {
+    Quat q; // Default constructor gives the identity rotation
+    REQUIRE(q == Quat::identity);
+    REQUIRE_THAT(q.w, WithinAbs(1.0f, epsilon));
+
+    q[0] = 2.0f;
+    REQUIRE_THAT(q.x, WithinAbs(2.0f, epsilon));
+    REQUIRE_THAT(q[3], WithinAbs(1.0f, epsilon));
+
+    Quat const a(1.0f, 2.0f, 3.0f, 4.0f);
+    Quat const b(4.0f, 3.0f, 2.0f, 1.0f);
+    REQUIRE(a + b == Quat(5.0f, 5.0f, 5.0f, 5.0f));
+    REQUIRE(a - b == Quat(-3.0f, -1.0f, 1.0f, 3.0f));
+    REQUIRE(-a == Quat(-1.0f, -2.0f, -3.0f, -4.0f));
+    REQUIRE(2.0f * a == a * 2.0f);
+    REQUIRE_THAT(dot(a, b), WithinAbs(20.0f, epsilon));
+}
+
+TEST_CASE("Quaternion products", "[quaternions][Quat]") {
+    // i * j = k, j * k = i, k * i = j, and i * i = -1
+    Quat const i(1.0f, 0.0f, 0.0f, 0.0f);
+    Quat const j(0.0f, 1.0f, 0.0f, 0.0f);
+    Quat const k(0.0f, 0.0f, 1.0f, 0.0f);
+
+    REQUIRE(i * j == k);
+    REQUIRE(j * k == i);
+    REQUIRE(k * i == j);
+    REQUIRE(j * i == -k);
+    REQUIRE(i * i == Quat(0.0f, 0.0f, 0.0f, -1.0f));
+
+    Quat const a(1.0f, 2.0f, 3.0f, 4.0f);
+    Quat const b(-2.0f, 0.5f, 1.0f, 3.0f);
+    REQUIRE(a * b == Quat(-4.5f, 1.0f, 17.5f, 10.0f));
+
+    Quat c = a;
+    c *= b;
+    REQUIRE(c == a * b);
+
+    REQUIRE(a * inverse(a) == Quat::identity);
+    REQUIRE(inverse(Quat(0.0f, 0.0f, 0.0f, 0.0f)) ==
+            Quat(0.0f, 0.0f, 0.0f, 0.0f));
+
+    for(uint32_t n = 0u; n < TEST_REPEATS; ++n) {
+        Quat const q = random_quat();
+        REQUIRE_THAT(length_squared(q), WithinAbs(1.0f, epsilon));
+        REQUIRE(inverse(q) == conjugate(q));
+        REQUIRE(q * conjugate(q) == Quat::identity);
+    }
+}
+
+TEST_CASE("Quaternion from axis and angle", "[quaternions][Quat]") {
+    Quat const quarter_z = Quat::from_axis_angle(Vec3::unit_z, 90.0f);
+    REQUIRE(rotate(quarter_z, Vec3::unit_x) == Vec3::unit_y);
+    REQUIRE(rotate(quarter_z, Vec3::unit_y) == -Vec3::unit_x);
+    REQUIRE(rotate(quarter_z, Vec3::unit_z) == Vec3::unit_z);
+
+    // The axis doesn't need to be normalized
+    REQUIRE(Quat::from_axis_angle(Vec3(0.0f, 0.0f, 5.0f), 90.0f) ==
+            quarter_z);
+
+    // Two quarter turns make a half turn
+    Quat const half_z = Quat::from_axis_angle(Vec3::unit_z, 180.0f);
+    REQUIRE(same_rotation(quarter_z * quarter_z, half_z));
+    REQUIRE(rotate(half_z, Vec3::unit_x) == -Vec3::unit_x);
+
+    // The right-hand factor applies first. A quarter turn about x sends z to
+    // -y, which a quarter turn about y leaves alone, while turning about y
+    // first sends z to x, which the turn about x leaves alone.
+    Quat const about_x = Quat::from_axis_angle(Vec3::unit_x, 90.0f);
+    Quat const about_y = Quat::from_axis_angle(Vec3::unit_y, 90.0f);
+    REQUIRE(rotate(about_x, Vec3::unit_z) == -Vec3::unit_y);
+    REQUIRE(rotate(about_y * about_x, Vec3::unit_z) == -Vec3::unit_y);
+    REQUIRE(rotate(about_x * about_y, Vec3::unit_z) == Vec3::unit_x);
+}
+
+TEST_CASE("Quaternion rotation", "[quaternions][Quat]") {
+    for(uint32_t i = 0u; i < TEST_REPEATS; ++i) {
+        Quat const q = random_quat();
+        Vec3 const v = random_vec3();
+
+        Vec3 const rotated = rotate(q, v);
+        REQUIRE(rotated == rotate_by_products(q, v));
+
+        // Rotations preserve length, and the conjugate undoes them
+        REQUIRE_THAT(length_squared(rotated),
+                     WithinRel(length_squared(v), 1.0e-5f));
+        REQUIRE(rotate(conjugate(q), rotated) == v);
+
+        // Composing quaternions composes rotations
+        Quat const r = random_quat();
+        REQUIRE(rotate(r * q, v) == rotate(r, rotated));
+    }
+}
+
+TEST_CASE("Quaternion normalization", "[quaternions][Quat]") {
+    Quat const q(1.0f, 2.0f, 3.0f, 4.0f);
+    Quat const n = normalize(q);
+    REQUIRE_THAT(length_squared(n), WithinAbs(1.0f, 1.0e-6f));
+    REQUIRE(n * std::sqrt(30.0f) == q);
+
+    // Nearly unit quaternions are still corrected
+    Quat const drifted = Quat::identity * 1.00002f;
+    REQUIRE_THAT(normalize(drifted).w, WithinAbs(1.0f, 1.0e-7f));
+
+    Quat const zero(0.0f, 0.0f, 0.0f, 0.0f);
+    REQUIRE(normalize(zero) == zero);
+}
+
+TEST_CASE("Quaternion interpolation", "[quaternions][Quat]") {
+    Quat const a = Quat::identity;
+    Quat const b = Quat::from_axis_angle(Vec3::unit_y, 90.0f);
+
+    // Endpoints
+    REQUIRE(nlerp(a, b, 0.0f) == a);
+    REQUIRE(nlerp(a, b, 1.0f) == b);
+    REQUIRE(slerp(a, b, 0.0f) == a);
+    REQUIRE(slerp(a, b, 1.0f) == b);
+
+    // Both hit the middle exactly, but only slerp moves at a constant rate
+    Quat const middle = Quat::from_axis_angle(Vec3::unit_y, 45.0f);
+    REQUIRE(nlerp(a, b, 0.5f) == middle);
+    REQUIRE(slerp(a, b, 0.5f) == middle);
+    REQUIRE(slerp(a, b, 0.25f) ==
+            Quat::from_axis_angle(Vec3::unit_y, 22.5f));
+    REQUIRE_FALSE(nlerp(a, b, 0.25f) ==
+                  Quat::from_axis_angle(Vec3::unit_y, 22.5f));
+
+    // -b is the same rotation as b, and both take the shorter arc to it
+    REQUIRE(same_rotation(slerp(a, -b, 0.5f), middle));
+    REQUIRE(same_rotation(nlerp(a, -b, 0.5f), middle));
+
+    // Nearly identical quaternions fall back to nlerp
+    Quat const c = Quat::from_axis_angle(Vec3::unit_y, 0.01f);
+    REQUIRE(slerp(a, c, 0.5f) == nlerp(a, c, 0.5f));
+
+    for(uint32_t i = 0u; i < TEST_REPEATS; ++i) {
+        Quat const p = random_quat();
+        Quat const q = random_quat();
+        float const t = Catch::Generators::random(0.0f, 1.0f).get();
+
+        REQUIRE_THAT(length_squared(slerp(p, q, t)),
+                     WithinAbs(1.0f, 1.0e-5f));
+        REQUIRE_THAT(length_squared(nlerp(p, q, t)),
+                     WithinAbs(1.0f, 1.0e-5f));
+    }
+}
+
+TEST_CASE("Quaternion printing", "[quaternions][Quat]") {
+    std::ostringstream out;
+    out << Quat::identity;
+    REQUIRE(out.str().find("1.00000000") != std::string::npos);
+}
\ No newline at end of file
@@ -218,4 +218,20 @@ TEST_CASE("Vector scaling", "[vectors][vector basics][Vec4]") {
         // Scalar multiplication distributes over addition
         REQUIRE(-1.5f * (a + b) == (-1.5f * a) + (-1.5f * b));
     }
+}
+
+TEST_CASE("Vector alignment", "[vectors][vector basics][Vec4]") {
+#if defined(BTX_MATH_SIMD)
+    // The SIMD backend relies on every Vec4 being 16-byte aligned, including
+    // those in arrays
+    std::array<Vec4, 3> vectors { };
+    for(auto const &v : vectors) {
+        REQUIRE(reinterpret_cast<std::uintptr_t>(&v) % 16u == 0u);
+    }
+#endif
+
+    // Either way, the layout is still four tightly packed floats
+    Vec4 const a(1.0f, 2.0f, 3.0f, 4.0f);
+    float const *components = &a.x;
+    REQUIRE_THAT(components[3], WithinAbs(4.0f, epsilon));
 }
\ No newline at end of file
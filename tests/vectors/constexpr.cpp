@@ -0,0 +1,73 @@
+#include "tests/helpers.hpp"
+
+using namespace btx::math;
+
+// These only hold when the whole vector API is available at compile time
+#if defined(BTX_MATH_HEADER_ONLY)
+
+TEST_CASE("Constants and constructors", "[vectors][constexpr]") {
+    STATIC_REQUIRE(Vec2::unit_x.x == 1.0f);
+    STATIC_REQUIRE(Vec3::unit_y[1] == 1.0f);
+    STATIC_REQUIRE(Vec4::unit_w[3] == 1.0f);
+
+    constexpr Vec3 a(1.0f, 2.0f, 3.0f);
+    STATIC_REQUIRE(a[0] == 1.0f);
+    STATIC_REQUIRE(a[1] == 2.0f);
+    STATIC_REQUIRE(a[2] == 3.0f);
+}
+
+TEST_CASE("Arithmetic", "[vectors][constexpr]") {
+    constexpr Vec3 a(0.0f, 9.0f, -3.0f);
+    constexpr Vec3 b(2.0f, -1.0f, 6.0f);
+
+    STATIC_REQUIRE(a + b == Vec3(2.0f, 8.0f, 3.0f));
+    STATIC_REQUIRE(a - b == Vec3(-2.0f, 10.0f, -9.0f));
+    STATIC_REQUIRE(-a == Vec3(0.0f, -9.0f, 3.0f));
+    STATIC_REQUIRE(2.0f * a == a * 2.0f);
+    STATIC_REQUIRE(a / 2.0f == Vec3(0.0f, 4.5f, -1.5f));
+
+    constexpr Vec4 c = [] {
+        Vec4 result = Vec4::unit_x;
+        result += Vec4::unit_y;
+        result -= Vec4::unit_z;
+        result *= 4.0f;
+        result /= 2.0f;
+        return result;
+    }();
+    STATIC_REQUIRE(c == Vec4(2.0f, 2.0f, -2.0f, 0.0f));
+}
+
+TEST_CASE("Products and normalization", "[vectors][constexpr]") {
+    STATIC_REQUIRE(dot(Vec2(1.0f, 2.0f), Vec2(3.0f, 4.0f)) == 11.0f);
+    STATIC_REQUIRE(dot(Vec3::unit_x, Vec3::unit_y) == 0.0f);
+    STATIC_REQUIRE(cross(Vec3::unit_x, Vec3::unit_y) == Vec3::unit_z);
+
+    STATIC_REQUIRE(normalize(Vec3(0.0f, 3.0f, 4.0f)) ==
+                   Vec3(0.0f, 0.6f, 0.8f));
+    STATIC_REQUIRE(detail::abs(length(Vec4(2.0f, 2.0f, 2.0f, 2.0f)) - 4.0f)
+                   < epsilon);
+}
+
+TEST_CASE("Matrices", "[matrices][constexpr]") {
+    constexpr Mat4 translate {
+        Vec4::unit_x, Vec4::unit_y, Vec4::unit_z,
+        Vec4(1.0f, 2.0f, 3.0f, 1.0f),
+    };
+
+    STATIC_REQUIRE(Mat4::identity * Vec4::unit_z == Vec4::unit_z);
+    STATIC_REQUIRE(translate * Vec4::unit_w == Vec4(1.0f, 2.0f, 3.0f, 1.0f));
+    STATIC_REQUIRE(translate * inverse(translate) == Mat4::identity);
+    STATIC_REQUIRE(transpose(transpose(translate)) == translate);
+}
+
+TEST_CASE("Quaternions", "[quaternions][constexpr]") {
+    // A quarter turn about z
+    constexpr Quat q { 0.0f, 0.0f, 0.70710678f, 0.70710678f };
+
+    STATIC_REQUIRE(rotate(q, Vec3::unit_x) == Vec3::unit_y);
+    STATIC_REQUIRE(q * conjugate(q) == Quat::identity);
+    STATIC_REQUIRE(nlerp(Quat::identity, q, 1.0f) == q);
+    STATIC_REQUIRE(normalize(q * 2.0f) == q);
+}
+
+#endif // BTX_MATH_HEADER_ONLY
\ No newline at end of file
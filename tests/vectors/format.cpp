@@ -0,0 +1,242 @@
+#include "tests/helpers.hpp"
+
+#include "brasstacks/math/format.hpp"
+
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace btx::math;
+using namespace Catch::Matchers;
+
+namespace {
+
+template <typename Vector>
+std::string streamed(Vector const &v) {
+    std::ostringstream out;
+    out << v;
+    return out.str();
+}
+
+template <typename Vector>
+std::string formatted(Vector const &v) {
+    char text[max_chars<Vector>];
+    auto const [end, error] = to_chars(std::begin(text), std::end(text), v);
+    REQUIRE(error == std::errc { });
+    return { text, end };
+}
+
+} // namespace
+
+TEST_CASE("Formatting vectors matches operator<<", "[vectors][format]") {
+    for(uint32_t i = 0u; i < TEST_REPEATS; ++i) {
+        Vec2 const v2 = random_vec2();
+        Vec3 const v3 = random_vec3(-1.0e6f, 1.0e6f);
+        Vec4 const v4 = random_vec4();
+
+        REQUIRE(formatted(v2) == streamed(v2));
+        REQUIRE(formatted(v3) == streamed(v3));
+        REQUIRE(formatted(v4) == streamed(v4));
+        REQUIRE(formatted(DVec3(v3)) == streamed(DVec3(v3)));
+        IVec4 const cells(v4 * 1000.0f);
+        REQUIRE(formatted(cells) == streamed(cells));
+    }
+
+    // The widest values there are still fit
+    float constexpr most = std::numeric_limits<float>::max();
+    Vec4 const extreme(-most, most, -0.0f,
+                       std::numeric_limits<float>::denorm_min());
+    REQUIRE(formatted(extreme) == streamed(extreme));
+    REQUIRE(formatted(DVec2(-std::numeric_limits<double>::max(), 0.0))
+            == streamed(DVec2(-std::numeric_limits<double>::max(), 0.0)));
+    REQUIRE(formatted(IVec2(std::numeric_limits<int32_t>::min(), 0))
+            == streamed(IVec2(std::numeric_limits<int32_t>::min(), 0)));
+
+    REQUIRE(formatted(Vec3(1.0f, -2.5f, 0.0f)) ==
+            "        1.00000000        -2.50000000         0.00000000");
+}
+
+TEST_CASE("Formatting ranges of vectors", "[vectors][format]") {
+    auto const vectors = random_vectors<Vec3>(20u);
+    std::string expected;
+    for(auto const &v : vectors) {
+        expected += streamed(v) + '\n';
+    }
+
+    std::vector<char> text(vectors.size() * (max_chars<Vec3> + 1u));
+    auto const [end, error] =
+        to_chars(text.data(), text.data() + text.size(), vectors);
+    REQUIRE(error == std::errc { });
+    REQUIRE(std::string(text.data(), end) == expected);
+
+    // Spans too, and nothing at all
+    std::span<Vec3 const> const none;
+    auto const empty = to_chars(text.data(), text.data() + text.size(), none);
+    REQUIRE(empty.ec == std::errc { });
+    REQUIRE(empty.ptr == text.data());
+}
+
+TEST_CASE("Formatting into too small a buffer", "[vectors][format]") {
+    Vec3 const v(1.0f, 2.0f, 3.0f);
+    std::string const expected = streamed(v);
+
+    // Every length short of the whole text fails, without writing past it
+    std::vector<char> text(expected.size() + 1u, '#');
+    for(std::size_t size = 0u; size < expected.size(); ++size) {
+        auto const [end, error] = to_chars(text.data(), text.data() + size, v);
+        REQUIRE(error == std::errc::value_too_large);
+        REQUIRE(end == text.data() + size);
+        REQUIRE(text[size] == '#');
+    }
+
+    auto const exact =
+        to_chars(text.data(), text.data() + expected.size(), v);
+    REQUIRE(exact.ec == std::errc { });
+    REQUIRE(std::string(text.data(), exact.ptr) == expected);
+
+    // A range needs room for the newline after the last vector too
+    std::vector<Vec3> const one { v };
+    auto const no_newline =
+        to_chars(text.data(), text.data() + expected.size(), one);
+    REQUIRE(no_newline.ec == std::errc::value_too_large);
+}
+
+namespace {
+
+template <typename Vector>
+std::from_chars_result parse(std::string_view const text, Vector &v) {
+    return from_chars(text.data(), text.data() + text.size(), v);
+}
+
+template <typename Vector>
+ParseResult parse(std::string_view const text, std::vector<Vector> &out) {
+    return from_chars(text.data(), text.data() + text.size(), out);
+}
+
+} // namespace
+
+TEST_CASE("Parsing vectors", "[vectors][format]") {
+    std::string_view const text = "1.5, -2\t3e4";
+    Vec3 v;
+    auto const [end, error] = parse(text, v);
+    REQUIRE(error == std::errc { });
+    REQUIRE(end == text.data() + text.size());
+    REQUIRE(v == Vec3(1.5f, -2.0f, 3.0e4f));
+
+    // Leading whitespace is skipped, and parsing stops after the last
+    // component
+    Vec2 u;
+    std::string_view const padded = "  \n 1 2 x";
+    REQUIRE(parse(padded, u).ptr == padded.data() + 7);
+    REQUIRE(u == Vec2(1.0f, 2.0f));
+
+    IVec3 cell;
+    REQUIRE(parse("-4,5, 6", cell).ec == std::errc { });
+    REQUIRE(cell == IVec3(-4, 5, 6));
+}
+
+TEST_CASE("Parsing errors", "[vectors][format]") {
+    // Where the problem starts, and v left alone
+    auto const failure = [](std::string_view const text, auto v) {
+        auto const original = v;
+        auto const result = parse(text, v);
+        REQUIRE(v == original);
+        return std::pair { result.ptr - text.data(), result.ec };
+    };
+
+    using Failure = std::pair<std::ptrdiff_t, std::errc>;
+    auto constexpr invalid = std::errc::invalid_argument;
+
+    REQUIRE(failure("1 2", Vec3::unit_x) == Failure { 3, invalid });
+    REQUIRE(failure("1 2 ", Vec3::unit_x) == Failure { 4, invalid });
+    REQUIRE(failure("1 x 3", Vec3::unit_x) == Failure { 2, invalid });
+    REQUIRE(failure("1,,2", Vec2::unit_y) == Failure { 2, invalid });
+    REQUIRE(failure(", 1 2", Vec2::unit_y) == Failure { 0, invalid });
+    REQUIRE(failure("1.02.0 3", Vec2::unit_y) == Failure { 4, invalid });
+    REQUIRE(failure("", Vec2::unit_y) == Failure { 0, invalid });
+    REQUIRE(failure("1.5 2", IVec2(7, 7)) == Failure { 1, invalid });
+    REQUIRE(failure("0 1e50 0", Vec3::unit_x) ==
+            Failure { 2, std::errc::result_out_of_range });
+}
+
+TEST_CASE("Parsing what was formatted", "[vectors][format]") {
+    for(uint32_t i = 0u; i < TEST_REPEATS; ++i) {
+        Vec4 const v = random_vec4();
+        std::string const text = formatted(v);
+
+        // Eight decimals is all the text keeps, so parsed vectors come out
+        // the same when written again
+        Vec4 parsed;
+        auto const result = parse(text, parsed);
+        REQUIRE(result.ec == std::errc { });
+        REQUIRE(result.ptr == text.data() + text.size());
+        REQUIRE(parsed == v);
+        REQUIRE(formatted(parsed) == text);
+
+        DVec3 const d(random_vec3());
+        DVec3 parsed_d;
+        REQUIRE(parse(streamed(d), parsed_d).ec == std::errc { });
+        REQUIRE(formatted(parsed_d) == streamed(d));
+    }
+}
+
+TEST_CASE("Parsing ranges of vectors", "[vectors][format]") {
+    auto const vectors = random_vectors<Vec3>(20u);
+
+    std::vector<char> text(vectors.size() * (max_chars<Vec3> + 1u));
+    auto const written =
+        to_chars(text.data(), text.data() + text.size(), vectors);
+
+    // The whole of to_chars() output, up to the final newline
+    std::vector<Vec3> parsed(vectors.size());
+    auto const result = from_chars(text.data(), written.ptr, parsed);
+    REQUIRE(result.ec == std::errc { });
+    REQUIRE(result.count == vectors.size());
+    REQUIRE(result.ptr == written.ptr - 1);
+    for(std::size_t i = 0u; i < vectors.size(); ++i) {
+        REQUIRE(parsed[i] == vectors[i]);
+    }
+
+    // Separators mix freely, and running out of text isn't an error
+    std::vector<Vec2> out(10u);
+    std::string_view const mixed = "1 2, 3 4\n5,6\n\n";
+    auto const partial = parse(mixed, out);
+    REQUIRE(partial.ec == std::errc { });
+    REQUIRE(partial.count == 3u);
+    REQUIRE(partial.ptr == mixed.data() + 12);
+    REQUIRE(out[2] == Vec2(5.0f, 6.0f));
+
+    // Nor is running out of room
+    std::vector<Vec2> two(2u);
+    auto const full = parse(mixed, two);
+    REQUIRE(full.count == 2u);
+    REQUIRE(full.ptr == mixed.data() + 8);
+
+    // Errors say how many vectors came before
+    std::string_view const broken = "1 2\n3 x\n5 6";
+    auto const bad = parse(broken, out);
+    REQUIRE(bad.ec == std::errc::invalid_argument);
+    REQUIRE(bad.count == 1u);
+    REQUIRE(bad.ptr == broken.data() + 6);
+
+    std::string_view const cut_off = "1 2 3";
+    auto const short_one = parse(cut_off, out);
+    REQUIRE(short_one.ec == std::errc::invalid_argument);
+    REQUIRE(short_one.count == 1u);
+    REQUIRE(short_one.ptr == cut_off.data() + cut_off.size());
+
+    REQUIRE(parse("  \n", out).count == 0u);
+    REQUIRE(parse("  \n", out).ec == std::errc { });
+}
+
+#if defined(__cpp_lib_format)
+TEST_CASE("std::format with vectors", "[vectors][format]") {
+    Vec3 const v(1.0f, -2.5f, 3.0f);
+
+    REQUIRE(std::format("{}", v) == streamed(v));
+    REQUIRE(std::format("{:.2f}", v) == "1.00 -2.50 3.00");
+    REQUIRE(std::format("({:>5})", IVec2(3, -40)) == "(    3   -40)");
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "tests/helpers.hpp"
+
+#include "brasstacks/math/batch.hpp"
+#include "brasstacks/math/VecArray.hpp"
+
+#include <array>
+#include <vector>
+
+using namespace btx::math;
+using namespace Catch::Matchers;
+
+TEST_CASE("Fused multiply-add at compile time", "[vectors][fused]") {
+    // (1 + 2^-12)^2 - 1 is 2^-11 + 2^-24, but rounding the square first
+    // loses the 2^-24
+    float constexpr a = 1.0f + 0x1.0p-12f;
+    STATIC_REQUIRE(detail::fma(a, a, -1.0f) == 0x1.0p-11f + 0x1.0p-24f);
+    STATIC_REQUIRE(a * a - 1.0f == 0x1.0p-11f);
+
+    // Rounding the exact sum to a double and then to a float rounds twice,
+    // and gets this one wrong, where std::fma() doesn't
+    STATIC_REQUIRE(detail::fma(-0x1.5bbfbp-48f, 0x1.7p+103f, -0x1.4a63d2p-98f)
+                   == -0x1.f3e38ep+55f);
+
+    // Signs of zero and infinities carry through
+    STATIC_REQUIRE(detail::fma(-0.0f, 1.0f, 0.0f) == 0.0f);
+    STATIC_REQUIRE(detail::fma(2.0f, 3.0f, -6.0f) == 0.0f);
+    STATIC_REQUIRE(detail::fma(std::numeric_limits<float>::infinity(), 2.0f,
+                               1.0f) == std::numeric_limits<float>::infinity());
+}
+
+TEST_CASE("Fused multiply-add at runtime", "[vectors][fused]") {
+    for(uint32_t i = 0u; i < TEST_REPEATS; ++i) {
+        float const a = Catch::Generators::random(-10.0f, 10.0f).get();
+        float const b = Catch::Generators::random(-10.0f, 10.0f).get();
+        float const c = Catch::Generators::random(-100.0f, 100.0f).get();
+        REQUIRE(detail::fma(a, b, c) == std::fma(a, b, c));
+    }
+}
+
+namespace btx::math::tests {
+
+// The products as they should come out, with every multiply-add fused or
+// none of them. These are in fused_expected.cpp, which is built without
+// -ffast-math, so the expected values hold in every build type.
+float expected_dot(Vec3 const &a, Vec3 const &b);
+float expected_cross_x(Vec3 const &a, Vec3 const &b);
+
+// The same three products summed in the other two orders, unfused
+std::array<float, 2> reordered_dots(Vec3 const &a, Vec3 const &b);
+
+} // namespace btx::math::tests
+
+namespace {
+
+// Without BTX_MATH_FMA, -ffast-math still rules out fusing the scalar
+// functions' products but can reorder their sums, so any order will do there
+bool unfused_dot(float const result, Vec3 const &a, Vec3 const &b) {
+    if(result == tests::expected_dot(a, b)) {
+        return true;
+    }
+
+#if defined(__FAST_MATH__) && !defined(BTX_MATH_FMA)
+    auto const reordered = tests::reordered_dots(a, b);
+    return result == reordered[0] || result == reordered[1];
+#else
+    return false;
+#endif
+}
+
+} // namespace
+
+TEST_CASE("Products fused or not, as configured", "[vectors][fused]") {
+    std::size_t constexpr count = 37u;
+
+    auto const a = random_vectors<Vec3>(count);
+    auto const b = random_vectors<Vec3>(count);
+
+    std::vector<float> dots(count);
+    std::vector<float> lane_dots(count);
+    std::vector<Vec3> crosses(count);
+    dot(a, b, dots);
+    dot(Vec3Array { a }, Vec3Array { b }, lane_dots);
+    cross(a, b, crosses);
+
+    // The batch kernels add in order in every build, and the scalar
+    // functions round the same way
+    for(std::size_t i = 0u; i < count; ++i) {
+        float const expected = tests::expected_dot(a[i], b[i]);
+        REQUIRE(dots[i] == expected);
+        REQUIRE(lane_dots[i] == expected);
+        REQUIRE(unfused_dot(dot(a[i], b[i]), a[i], b[i]));
+        REQUIRE(unfused_dot(length_squared(a[i]), a[i], a[i]));
+
+        float const expected_x = tests::expected_cross_x(a[i], b[i]);
+        REQUIRE(cross(a[i], b[i]).x == expected_x);
+        REQUIRE(crosses[i].x == expected_x);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#include "brasstacks/math/math.hpp"
+
+#include <array>
+#include <cmath>
+
+// Built without -ffast-math (see tests/CMakeLists.txt), so these come out
+// exactly as written whatever the build type. The declarations are in
+// fused.cpp.
+
+namespace btx::math::tests {
+
+float expected_dot(Vec3 const &a, Vec3 const &b) {
+#if defined(BTX_MATH_FMA)
+    return std::fma(a.z, b.z, std::fma(a.y, b.y, a.x * b.x));
+#else
+    return (a.x * b.x) + (a.y * b.y) + (a.z * b.z);
+#endif
+}
+
+std::array<float, 2> reordered_dots(Vec3 const &a, Vec3 const &b) {
+    float const x = a.x * b.x;
+    float const y = a.y * b.y;
+    float const z = a.z * b.z;
+    return { x + (y + z), (x + z) + y };
+}
+
+float expected_cross_x(Vec3 const &a, Vec3 const &b) {
+#if defined(BTX_MATH_FMA)
+    return std::fma(a.y, b.z, -(a.z * b.y));
+#else
+    return (a.y * b.z) - (a.z * b.y);
+#endif
+}
+
+} // namespace btx::math::tests
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include "tests/helpers.hpp"
+
+#include <sstream>
+
+using namespace btx::math;
+using namespace Catch::Matchers;
+
+TEST_CASE("Vector layout", "[vectors][generic]") {
+    STATIC_REQUIRE(std::is_same_v<Vec3, Vec<float, 3u>>);
+    STATIC_REQUIRE(std::is_same_v<Vec3::value_type, float>);
+    STATIC_REQUIRE(Vec4::components == 4u);
+
+    // Every type and size packs its components with nothing in between
+    STATIC_REQUIRE(sizeof(DVec2) == sizeof(double) * 2);
+    STATIC_REQUIRE(sizeof(DVec3) == sizeof(double) * 3);
+    STATIC_REQUIRE(sizeof(IVec2) == sizeof(int32_t) * 2);
+    STATIC_REQUIRE(sizeof(IVec4) == sizeof(int32_t) * 4);
+    STATIC_REQUIRE(std::is_trivially_copyable_v<DVec4>);
+    STATIC_REQUIRE(std::is_trivially_copyable_v<IVec2>);
+
+    DVec3 d(1.0, 2.0, 3.0);
+    double const *components = &d.x;
+    REQUIRE(components[2] == 3.0);
+    REQUIRE(&d[1] == &d.y);
+}
+
+TEST_CASE("Double precision vectors", "[vectors][generic]") {
+    // Far enough from the origin that a float can't tell these apart
+    DVec3 const far(1.0e8, 0.0, -1.0e8);
+    DVec3 const step(0.25, 0.5, 0.125);
+    DVec3 const moved = far + step;
+
+    REQUIRE(moved - far == step);
+    REQUIRE(Vec3(moved) - Vec3(far) != Vec3(step));
+
+    REQUIRE(dot(step, DVec3::unit_y) == 0.5);
+    REQUIRE(cross(DVec3::unit_x, DVec3::unit_y) == DVec3::unit_z);
+    REQUIRE(length_squared(DVec2(3.0, 4.0)) == 25.0);
+    REQUIRE_THAT(length(DVec2(3.0, 4.0)), WithinAbs(5.0, 1.0e-12));
+
+    for(uint32_t i = 0u; i < TEST_REPEATS; ++i) {
+        DVec4 const v { random_vec4() };
+        if(length_squared(v) < epsilon) {
+            continue;
+        }
+
+        DVec4 const n = normalize(v);
+        REQUIRE_THAT(length_squared(n), WithinAbs(1.0, 1.0e-12));
+        REQUIRE(normalize(n) == n);
+    }
+}
+
+TEST_CASE("Integer vectors", "[vectors][generic]") {
+    IVec3 a(1, -2, 3);
+    IVec3 const b(4, 5, -6);
+
+    REQUIRE(a + b == IVec3(5, 3, -3));
+    REQUIRE(a - b == IVec3(-3, -7, 9));
+    REQUIRE(-a == IVec3(-1, 2, -3));
+    REQUIRE(3 * a == IVec3(3, -6, 9));
+    REQUIRE(b / 2 == IVec3(2, 2, -3));
+
+    // Equality is exact, with no epsilon to hide behind
+    REQUIRE(a != IVec3(1, -2, 4));
+
+    a += b;
+    a *= 2;
+    REQUIRE(a == IVec3(10, 6, -6));
+
+    REQUIRE(dot(a, IVec3::unit_x) == 10);
+    REQUIRE(length_squared(IVec2(3, 4)) == 25);
+    REQUIRE(cross(IVec3::unit_y, IVec3::unit_z) == IVec3::unit_x);
+
+    // Converting truncates toward zero, like static_cast
+    REQUIRE(IVec2(Vec2(1.75f, -1.75f)) == IVec2(1, -1));
+    REQUIRE(Vec2(IVec2(3, -4)) == Vec2(3.0f, -4.0f));
+}
+
+TEST_CASE("Printing", "[vectors][generic]") {
+    std::ostringstream out;
+    out << IVec4(1, 2, 3, 4);
+
+    // Every component is printed, separated by spaces
+    std::istringstream in { out.str() };
+    int32_t x = 0, y = 0, z = 0, w = 0;
+    in >> x >> y >> z >> w;
+    REQUIRE(IVec4(x, y, z, w) == IVec4(1, 2, 3, 4));
+}
+
+// Vec is a template, so unlike the float functions in math.hpp this holds in
+// every build mode
+TEST_CASE("Generic vectors at compile time", "[vectors][generic][constexpr]") {
+    constexpr DVec3 a(0.0, 9.0, -3.0);
+    constexpr DVec3 b(2.0, -1.0, 6.0);
+    STATIC_REQUIRE(a + b == DVec3(2.0, 8.0, 3.0));
+    STATIC_REQUIRE(a / 2.0 == DVec3(0.0, 4.5, -1.5));
+    STATIC_REQUIRE(dot(a, b) == -27.0);
+    STATIC_REQUIRE(cross(DVec3::unit_z, DVec3::unit_x) == DVec3::unit_y);
+    STATIC_REQUIRE(normalize(DVec2(0.0, 2.0)) == DVec2::unit_y);
+    STATIC_REQUIRE(length(DVec3(2.0, 3.0, 6.0)) == 7.0);
+
+    constexpr IVec4 c = [] {
+        IVec4 result = IVec4::unit_x;
+        result += IVec4::unit_w;
+        result[2] = 7;
+        result *= 3;
+        return result;
+    }();
+    STATIC_REQUIRE(c == IVec4(3, 0, 21, 3));
+
+    constexpr Vec3 d = Vec3::unit_x + Vec3::unit_z * 2.0f;
+    STATIC_REQUIRE(d[2] == 2.0f);
+    STATIC_REQUIRE(IVec3(Vec3(2.5f, -0.5f, 9.9f)) == IVec3(2, 0, 9));
+}
\ No newline at end of file